@@ -28,7 +28,7 @@ define $(BASE_DIR)/0textures.pk3
 endef
 
 define $(BASE_DIR)/0models.pk3
-	-r models/*.mdx models/*.md2 models/*.md3 models/*.dpm models/*.obj models/*.jpg models/*.png models/*.tga models/*.anm models/*.tag
+	-r models/*.mdx models/*.amc models/*.md2 models/*.md3 models/*.dpm models/*.obj models/*.jpg models/*.png models/*.tga models/*.anm models/*.tag
 endef
 
 define $(BASE_DIR)/0snd.pk3
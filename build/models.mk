@@ -2,6 +2,7 @@ MODELDIR ?= base/models
 
 UFOMODEL = ./$(ufomodel_FILE)
 UFOMODEL_PARAMS = -mdx -overwrite -v
+UFOMODEL_AMC_PARAMS = -amc -overwrite -v
 
 MODELS_MD2 := $(shell find $(MODELDIR) -name "*.md2")
 MODELS_MD3 := $(shell find $(MODELDIR) -name "*.md3")
@@ -28,7 +29,12 @@ MDXS_DPM := $(MODELS_DPM:.dpm=.mdx)
 #MDXS     := $(MDXS_MD2) $(MDXS_MD3) $(MDXS_OBJ) $(MDXS_DPM)
 MDXS     := $(MDXS_MD2) $(MDXS_MD3) $(MDXS_DPM)
 
-models: ufomodel $(MDXS)
+# cached vertex merging - only md2 and md3 models merge their vertices on load
+AMCS_MD2 := $(MODELS_MD2:.md2=.amc)
+AMCS_MD3 := $(MODELS_MD3:.md3=.amc)
+AMCS     := $(AMCS_MD2) $(AMCS_MD3)
+
+models: ufomodel $(MDXS) $(AMCS)
 
 $(MDXS_MD2): %.mdx: %.md2
 $(MDXS_MD3): %.mdx: %.md3
@@ -38,6 +44,13 @@ $(MDXS_DPM): %.mdx: %.dpm
 $(MDXS):
 	$(UFOMODEL) $(UFOMODEL_PARAMS) -s $(strip $(call get-smooth-value,$<)) -f $(<:base/%=%)
 
+$(AMCS_MD2): %.amc: %.md2
+$(AMCS_MD3): %.amc: %.md3
+
+$(AMCS):
+	$(UFOMODEL) $(UFOMODEL_AMC_PARAMS) -s $(strip $(call get-smooth-value,$<)) -f $(<:base/%=%)
+
 clean-mdx:
-	@echo "Deleting cached normals and tangents (*.mdx)..."
+	@echo "Deleting cached normals and tangents (*.mdx) and vertex merging (*.amc)..."
 	$(Q)find $(MODELDIR) -name '*.mdx' -delete
+	$(Q)find $(MODELDIR) -name '*.amc' -delete
@@ -20,6 +20,7 @@ ifneq ($(HARD_LINKED_CGAME),1)
 		shared/utf8.c \
 		shared/parse.c \
 		shared/infostring.c \
+		shared/idtable.c \
 		\
 		game/q_shared.c \
 		game/chr_shared.c \
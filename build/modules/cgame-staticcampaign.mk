@@ -22,6 +22,7 @@ ifneq ($(HARD_LINKED_CGAME),1)
 		shared/utf8.c \
 		shared/parse.c \
 		shared/infostring.c \
+		shared/idtable.c \
 		\
 		common/binaryexpressionparser.c \
 		\
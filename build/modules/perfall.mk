@@ -0,0 +1,24 @@
+TARGET             := perfall
+
+# if the linking should be static
+$(TARGET)_STATIC   ?= $(STATIC)
+ifeq ($($(TARGET)_STATIC),1)
+$(TARGET)_LDFLAGS  += -static
+endif
+
+$(TARGET)_LINKER   := $(CC)
+$(TARGET)_FILE     := $(TARGET)$(EXE_EXT)
+$(TARGET)_CFLAGS   += -DCOMPILE_UFO -DHARD_LINKED_GAME -DCOMPILE_UNITTESTS $(BFD_CFLAGS) $(SDL_CFLAGS) $(CURL_CFLAGS) $(OGG_CFLAGS) $(MXML_CFLAGS)
+$(TARGET)_LDFLAGS  += -lpng -ljpeg $(BFD_LIBS) $(INTL_LIBS) $(SDL_TTF_LIBS) $(SDL_MIXER_LIBS) $(OPENGL_LIBS) $(SDL_LIBS) $(CURL_LIBS) $(THEORA_LIBS) $(XVID_LIBS) $(VORBIS_LIBS) $(OGG_LIBS) $(MXML_LIBS) $(SO_LIBS) -lz
+
+$(TARGET)_SRCS      = \
+	tests/perf_all.c \
+	tests/perf_benchmarks.c \
+	\
+	$(TESTS_ENGINE_SRCS)
+
+$(TARGET)_DEPS     := $(TESTS_ENGINE_DEPS)
+
+$(TARGET)_OBJS     := $(call ASSEMBLE_OBJECTS,$(TARGET))
+$(TARGET)_CXXFLAGS := $($(TARGET)_CFLAGS)
+$(TARGET)_CCFLAGS  := $($(TARGET)_CFLAGS)
@@ -187,6 +187,7 @@ $(TARGET)_SRCS      = \
 	common/netpack.c \
 	common/dbuffer.c \
 	common/pqueue.c \
+	common/profiler.c \
 	common/scripts.c \
 	common/tracing.c \
 	common/routing.c \
@@ -244,6 +245,7 @@ $(TARGET)_SRCS      = \
 	shared/utf8.c \
 	shared/images.c \
 	shared/stringhunk.c \
+	shared/idtable.c \
 	shared/infostring.c \
 	shared/parse.c \
 	shared/shared.c \
@@ -31,6 +31,7 @@ $(TARGET)_SRCS      = \
 	common/net.c \
 	common/netpack.c \
 	common/pqueue.c \
+	common/profiler.c \
 	common/scripts.c \
 	common/tracing.c \
 	common/routing.c \
@@ -41,6 +42,8 @@ $(TARGET)_SRCS      = \
 	server/sv_log.c \
 	server/sv_main.c \
 	server/sv_mapcycle.c \
+	server/sv_masterserver.c \
+	server/sv_record.c \
 	server/sv_rma.c \
 	server/sv_send.c \
 	server/sv_user.c \
@@ -50,6 +53,7 @@ $(TARGET)_SRCS      = \
 	shared/bfd.c \
 	shared/byte.c \
 	shared/stringhunk.c \
+	shared/idtable.c \
 	shared/infostring.c \
 	shared/mathlib.c \
 	shared/mutex.c \
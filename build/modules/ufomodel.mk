@@ -28,6 +28,7 @@ $(TARGET)_SRCS      = \
 	\
 	common/files.c \
 	common/list.c \
+	common/md4.c \
 	common/mem.c \
 	common/unzip.c \
 	common/ioapi.c \
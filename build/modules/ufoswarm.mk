@@ -0,0 +1,23 @@
+TARGET             := ufoswarm
+
+# if the linking should be static
+$(TARGET)_STATIC   ?= $(STATIC)
+ifeq ($($(TARGET)_STATIC),1)
+$(TARGET)_LDFLAGS  += -static
+endif
+
+$(TARGET)_LINKER   := $(CC)
+$(TARGET)_FILE     := $(TARGET)$(EXE_EXT)
+$(TARGET)_LDFLAGS  += $(ufoded_LDFLAGS)
+$(TARGET)_CFLAGS   += $(ufoded_CFLAGS)
+
+# the dedicated server with the swarm instead of the client stub
+$(TARGET)_SRCS      = \
+	tools/ufoswarm.c \
+	$(filter-out server/sv_clientstub.c,$(ufoded_SRCS))
+
+$(TARGET)_DEPS     := $(ufoded_DEPS)
+
+$(TARGET)_OBJS     := $(call ASSEMBLE_OBJECTS,$(TARGET))
+$(TARGET)_CXXFLAGS := $($(TARGET)_CFLAGS)
+$(TARGET)_CCFLAGS  := $($(TARGET)_CFLAGS)
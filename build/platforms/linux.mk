@@ -6,7 +6,7 @@ SO_LIBS                  := -ldl
 CFLAGS                   += -DSHARED_EXT=\"$(SO_EXT)\"
 CFLAGS                   += -D_GNU_SOURCE -D_BSD_SOURCE -D_XOPEN_SOURCE
 
-LDFLAGS                  +=
+LDFLAGS                  += -lrt
 
 game_CFLAGS              += -DLUA_USE_LINUX
 testall_CFLAGS           += -DLUA_USE_LINUX
@@ -0,0 +1,21 @@
+/* This file is automatically generated */
+#ifndef CONFIG_H
+#define CONFIG_H
+
+/* #define HAVE_XVID_H  */
+/* #define HAVE_THEORA_THEORA_H  */
+#define HAVE_EXECINFO_H 1
+#define HAVE_SYS_UTSNAME_H 1
+#define HAVE_LINK_H 1
+/* #define HAVE_CUNIT_BASIC_H  */
+/* #define HAVE_MXML_H  */
+/* #define PARANOID  */
+/* #define PROFILER  */
+/* #define HARD_LINKED_GAME  */
+#define HARD_LINKED_CGAME 1
+#define USE_SIGNALS 1
+#define PKGDATADIR "/usr/local/games/ufoai"
+#define PKGLIBDIR "/usr/local/lib"
+/* #define LOCALEDIR "" */
+
+#endif
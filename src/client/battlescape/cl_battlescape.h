@@ -72,6 +72,9 @@ typedef struct clientBattleScape_s {
 
 	const char *leInlineModelList[MAX_EDICTS + 1];
 
+	int numLESectors;
+	leSector_t leSectors[LE_AREA_NODES];	/**< the sector tree the solid local entities are linked into */
+
 	qboolean spawned;		/**< soldiers already spawned? This is only true if we are already on battlescape but
 							 * our team is not yet spawned */
 	qboolean started;		/**< match already started? */
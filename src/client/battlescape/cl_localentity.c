@@ -351,6 +351,8 @@ void LE_Think (void)
 
 	while ((le = LE_GetNext(le))) {
 		LE_ExecuteThink(le);
+		/* keep the sector tree in sync with whatever the think function changed */
+		LE_Link(le);
 		/* do animation - even for invisible entities */
 		R_AnimRun(&le->as, le->model1, cls.frametime * 1000);
 	}
@@ -1159,6 +1161,9 @@ le_t *LE_Add (int entnum)
 		cl.numLEs++;
 	}
 
+	/* a reused slot might still be linked into the sector tree */
+	LE_Unlink(le);
+
 	/* initialize the new LE */
 	OBJZERO(*le);
 	le->inuse = qtrue;
@@ -1625,6 +1630,270 @@ static int32_t CL_HullForEntity (const le_t *le, int *tile, vec3_t rmaShift, vec
 	}
 }
 
+#define	LE_AREA_DEPTH	4
+
+/**
+ * @brief Builds a uniformly subdivided tree for the given world size
+ * @sa LE_ClearWorld
+ * @sa SV_CreateWorldSector
+ */
+static leSector_t *LE_CreateSector (int depth, const vec3_t mins, const vec3_t maxs)
+{
+	leSector_t *anode;
+	vec3_t size;
+	vec3_t mins1, maxs1, mins2, maxs2;
+
+	if (cl.numLESectors >= lengthof(cl.leSectors))
+		Com_Error(ERR_DROP, "LE_CreateSector: overflow");
+
+	anode = &cl.leSectors[cl.numLESectors];
+	cl.numLESectors++;
+
+	anode->entities = NULL;
+
+	if (depth == LE_AREA_DEPTH) {
+		anode->axis = LEAFNODE; /* end of tree */
+		anode->children[0] = anode->children[1] = NULL;
+		return anode;
+	}
+
+	VectorSubtract(maxs, mins, size);
+	if (size[0] > size[1])
+		anode->axis = PLANE_X;
+	else
+		anode->axis = PLANE_Y;
+
+	anode->dist = 0.5f * (maxs[anode->axis] + mins[anode->axis]);
+	VectorCopy(mins, mins1);
+	VectorCopy(mins, mins2);
+	VectorCopy(maxs, maxs1);
+	VectorCopy(maxs, maxs2);
+
+	maxs1[anode->axis] = mins2[anode->axis] = anode->dist;
+
+	anode->children[0] = LE_CreateSector(depth + 1, mins2, maxs2);
+	anode->children[1] = LE_CreateSector(depth + 1, mins1, maxs1);
+
+	return anode;
+}
+
+/**
+ * @brief Builds the sector tree for the current map and links all local entities
+ * that are already in use into it
+ * @note Called after the map was loaded
+ * @sa SV_ClearWorld
+ * @sa CL_ViewLoadMedia
+ */
+void LE_ClearWorld (void)
+{
+	le_t *le = NULL;
+
+	cl.numLESectors = 0;
+	LE_CreateSector(0, cl.mapData->mapMin, cl.mapData->mapMax);
+
+	while ((le = LE_GetNext(le))) {
+		le->sector = NULL;
+		le->nextInSector = NULL;
+		LE_Link(le);
+	}
+}
+
+/**
+ * @brief Calculates the world space bounding box a trace against the given local entity can hit
+ * @note Brush models are traced in the (rotated and maybe rma-shifted) frame of the inline model,
+ * see @c CM_HintedTransformedBoxTrace - rotated ones get a box around the bounding sphere.
+ */
+static void LE_GetAbsBox (const le_t *le, vec3_t absmin, vec3_t absmax)
+{
+	if (le->contents & CONTENTS_SOLID) {
+		const cBspModel_t *model = le->modelnum1 < lengthof(cl.model_clip) ? cl.model_clip[le->modelnum1] : NULL;
+		vec3_t mins, maxs;
+
+		if (!model) {
+			/* no clip model yet - make sure the le is never filtered out */
+			VectorSet(absmin, -MAX_WORLD_WIDTH, -MAX_WORLD_WIDTH, -MAX_WORLD_WIDTH);
+			VectorSet(absmax, MAX_WORLD_WIDTH, MAX_WORLD_WIDTH, MAX_WORLD_WIDTH);
+			return;
+		}
+
+		if (VectorNotEmpty(le->origin)) {
+			VectorSubtract(le->mins, model->shift, mins);
+			VectorSubtract(le->maxs, model->shift, maxs);
+		} else {
+			VectorCopy(le->mins, mins);
+			VectorCopy(le->maxs, maxs);
+		}
+
+		if (VectorNotEmpty(le->angles)) {
+			vec3_t corner;
+			float radius;
+			int i;
+
+			for (i = 0; i < 3; i++)
+				corner[i] = max(fabs(mins[i]), fabs(maxs[i]));
+			radius = VectorLength(corner);
+			VectorSet(mins, -radius, -radius, -radius);
+			VectorSet(maxs, radius, radius, radius);
+		}
+		VectorAdd(le->origin, mins, absmin);
+		VectorAdd(le->origin, maxs, absmax);
+	} else {
+		VectorAdd(le->origin, le->mins, absmin);
+		VectorAdd(le->origin, le->maxs, absmax);
+	}
+}
+
+/**
+ * @brief Call before reusing a local entity slot, it removes the local entity from the sector tree
+ * @sa SV_UnlinkEdict
+ */
+void LE_Unlink (le_t *le)
+{
+	leSector_t *ws = le->sector;
+	le_t *scan;
+
+	if (!ws)
+		return;					/* not linked in anywhere */
+
+	le->sector = NULL;
+
+	if (ws->entities == le) {
+		ws->entities = le->nextInSector;
+		return;
+	}
+
+	for (scan = ws->entities; scan; scan = scan->nextInSector) {
+		if (scan->nextInSector == le) {
+			scan->nextInSector = le->nextInSector;
+			return;
+		}
+	}
+
+	Com_Printf("WARNING: LE_Unlink: not found in sector\n");
+}
+
+/**
+ * @brief Needs to be called any time a local entity changes origin, angles, mins, maxs
+ * or contents. Automatically unlinks if needed.
+ * @note This is also done for every local entity once per frame in @c LE_Think
+ * @sa SV_LinkEdict
+ */
+void LE_Link (le_t *le)
+{
+	leSector_t *node;
+	vec3_t absmin, absmax;
+
+	if (!cl.numLESectors)
+		return;
+
+	/* only solid local entities can be hit by a trace */
+	if (!le->inuse || !le->contents) {
+		LE_Unlink(le);
+		return;
+	}
+
+	LE_GetAbsBox(le, absmin, absmax);
+	if (le->sector && VectorCompare(absmin, le->absmin) && VectorCompare(absmax, le->absmax))
+		return;
+
+	LE_Unlink(le);
+
+	VectorCopy(absmin, le->absmin);
+	VectorCopy(absmax, le->absmax);
+
+	/* find the first node that the le's box crosses */
+	node = cl.leSectors;
+	while (1) {
+		/* end of tree */
+		if (node->axis == LEAFNODE)
+			break;
+		if (le->absmin[node->axis] > node->dist)
+			node = node->children[0];
+		else if (le->absmax[node->axis] < node->dist)
+			node = node->children[1];
+		else
+			break;				/* crosses the node */
+	}
+
+	/* link it in */
+	le->nextInSector = node->entities;
+	node->entities = le;
+	le->sector = node;
+}
+
+typedef struct {
+	const float *areaMins, *areaMaxs;
+	le_t **areaList;
+	int areaListCount, areaListMaxCount;
+} leAreaParms_t;
+
+/**
+ * @brief fills in a table of local entity pointers with solid local entities that have
+ * bounding boxes that intersect the given area.
+ * @sa SV_AreaEdicts_r
+ */
+static void LE_AreaLEs_r (const leSector_t *node, leAreaParms_t *ap)
+{
+	le_t *check;
+
+	for (check = node->entities; check; check = check->nextInSector) {
+		if (!check->inuse)
+			continue;
+
+		if (check->absmin[0] > ap->areaMaxs[0] || check->absmin[1] > ap->areaMaxs[1] || check->absmin[2] > ap->areaMaxs[2]
+		 || check->absmax[0] < ap->areaMins[0] || check->absmax[1] < ap->areaMins[1] || check->absmax[2] < ap->areaMins[2])
+			continue;			/* not touching */
+
+		if (ap->areaListCount == ap->areaListMaxCount) {
+			Com_Printf("LE_AreaLEs_r: MAXCOUNT\n");
+			return;
+		}
+
+		ap->areaList[ap->areaListCount] = check;
+		ap->areaListCount++;
+	}
+
+	if (node->axis == LEAFNODE)
+		return;					/* terminal node - end of tree */
+
+	/* recurse down both sides */
+	if (ap->areaMaxs[node->axis] > node->dist)
+		LE_AreaLEs_r(node->children[0], ap);
+	if (ap->areaMins[node->axis] < node->dist)
+		LE_AreaLEs_r(node->children[1], ap);
+}
+
+/**
+ * @brief Collects the solid local entities that might be hit by a trace through the given box
+ * @note Falls back to all local entities that are in use if the sector tree was not yet built
+ * @param[in] mins The mins of the bounding box
+ * @param[in] maxs The maxs of the bounding box
+ * @param[out] list The local entity list that this trace is hitting
+ * @param[in] maxCount The size of the given @c list
+ * @return the number of pointers filled in
+ * @sa SV_AreaEdicts
+ */
+static int LE_AreaLEs (const vec3_t mins, const vec3_t maxs, le_t **list, int maxCount)
+{
+	leAreaParms_t ap;
+
+	ap.areaMins = mins;
+	ap.areaMaxs = maxs;
+	ap.areaList = list;
+	ap.areaListCount = 0;
+	ap.areaListMaxCount = maxCount;
+
+	if (cl.numLESectors) {
+		LE_AreaLEs_r(cl.leSectors, &ap);
+	} else {
+		le_t *le = NULL;
+		while ((le = LE_GetNextInUse(le)) && ap.areaListCount < maxCount)
+			list[ap.areaListCount++] = le;
+	}
+
+	return ap.areaListCount;
+}
+
 /**
  * @brief Clip against solid entities
  * @sa CL_Trace
@@ -1632,12 +1901,15 @@ static int32_t CL_HullForEntity (const le_t *le, int *tile, vec3_t rmaShift, vec
  */
 static void CL_ClipMoveToLEs (moveclip_t * clip)
 {
-	le_t *le = NULL;
+	le_t *touchList[MAX_EDICTS];
+	int i, num;
 
 	if (clip->trace.allsolid)
 		return;
 
-	while ((le = LE_GetNextInUse(le))) {
+	num = LE_AreaLEs(clip->boxmins, clip->boxmaxs, touchList, lengthof(touchList));
+	for (i = 0; i < num; i++) {
+		le_t *le = touchList[i];
 		int tile = 0;
 		trace_t trace;
 		int32_t headnode;
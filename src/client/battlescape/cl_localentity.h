@@ -94,6 +94,9 @@ typedef struct le_s {
 	int contents;			/**< content flags for this LE - used for tracing */
 	vec3_t mins, maxs;
 	vec3_t size;
+	vec3_t absmin, absmax;	/**< the world space bounding box this LE was linked into the sector tree with */
+	struct leSector_s *sector;	/**< the sector this LE is linked into - @c NULL if not linked */
+	struct le_s *nextInSector;
 
 	char inlineModelName[8];	/**< for bmodels */
 	unsigned int modelnum1;	/**< the number of the body model in the cl.model_draw array */
@@ -148,6 +151,20 @@ typedef struct le_s {
 						 * this le_t.  Used to limit to one event per le_t struct at any time. */
 } le_t;
 
+/**
+ * @brief To avoid linearly searching through all local entities for every @c CL_Trace call,
+ * the world is carved up with an evenly spaced, axially aligned bsp tree.
+ * @sa worldSector_t
+ */
+typedef struct leSector_s {
+	int axis;					/**< -1 = leaf node */
+	float dist;
+	struct leSector_s *children[2];
+	le_t *entities;
+} leSector_t;
+
+#define LE_AREA_NODES	32
+
 #define MAX_LOCALMODELS		1024
 
 /** @brief local models */
@@ -260,6 +277,9 @@ le_t *LE_FindRadius(le_t *from, const vec3_t org, float rad, entity_type_t type)
 le_t *LE_GetFromPos(const pos3_t pos);
 void LE_PlaceItem(le_t *le);
 void LE_Cleanup(void);
+void LE_ClearWorld(void);
+void LE_Link(le_t *le);
+void LE_Unlink(le_t *le);
 void LE_AddToScene(void);
 void LE_CenterView(const le_t *le);
 const cBspModel_t *LE_GetClipModel(const le_t *le);
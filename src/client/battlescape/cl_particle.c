@@ -104,6 +104,16 @@ static const size_t pf_values[] = {
 };
 CASSERT(lengthof(pf_values) == PF_NUM_PTLFUNCS);
 
+/** @brief offsets of the compiled particle functions - see pf_values */
+static const size_t pf_ops[] = {
+	offsetof(ptlDef_t, initOps),
+	offsetof(ptlDef_t, runOps),
+	offsetof(ptlDef_t, thinkOps),
+	offsetof(ptlDef_t, roundOps),
+	offsetof(ptlDef_t, physicsOps)
+};
+CASSERT(lengthof(pf_ops) == PF_NUM_PTLFUNCS);
+
 /** @brief particle commands - see pc_strings */
 typedef enum pc_s {
 	PC_END,
@@ -118,7 +128,10 @@ typedef enum pc_s {
 	PC_KILL,
 	PC_SPAWN, PC_NSPAWN, PC_TNSPAWN, PC_CHILD,
 
-	PC_NUM_PTLCMDS
+	PC_NUM_PTLCMDS,
+
+	/* compiled commands - they can't be used in the scripts, see CL_CompilePtlCmds */
+	PC_SET = PC_NUM_PTLCMDS	/**< a push followed by a pop into the particle */
 } pc_t;
 
 /** @brief particle commands - see pc_t */
@@ -231,6 +244,44 @@ static byte cmdStack[MAX_STACK_DATA];
 static void *stackPtr[MAX_STACK_DEPTH];
 static byte stackType[MAX_STACK_DEPTH];
 
+/** @brief where the operand of a compiled particle command is - see ptlOp_t */
+typedef enum ptlOpArg_s {
+	PTL_ARG_DATA,		/**< a constant on the particle command hunk */
+	PTL_ARG_PARTICLE,	/**< a value of the particle */
+	PTL_ARG_STACK		/**< a value on the stack */
+} ptlOpArg_t;
+
+typedef struct ptlOp_s ptlOp_t;
+
+/**
+ * @brief Executes one compiled particle command
+ * @return @c qfalse if the particle was freed - the function stops then
+ */
+typedef qboolean (*ptlOpFunc_t) (ptl_t *p, const ptlOp_t *op);
+
+/**
+ * @brief A particle command with everything resolved that the interpreter looks up each time it
+ * runs the command - the types are checked and the stack positions are known after compiling
+ * @sa CL_CompileParticleFunction
+ */
+struct ptlOp_s {
+	ptlOpFunc_t func;	/**< @c NULL terminates the function */
+	byte src;			/**< ptlOpArg_t of @c srcOfs */
+	byte dst;			/**< ptlOpArg_t of @c dstOfs */
+	byte n;				/**< the amount of bytes to copy or of floats to calculate */
+	int srcOfs;			/**< offset of the operand */
+	int dstOfs;			/**< offset of the value that is written */
+	const char *string;	/**< the particle to spawn */
+};
+
+/** @brief every command becomes at most one compiled command - and the end of a function
+ * becomes the terminating one */
+static ptlOp_t ptlOps[MAX_PTLCMDS];
+static int numPtlOps;
+
+/** @brief lowest index in @c r_particleArray that might be free - speeds up the spawning of many particles */
+static int ptlFreeHint;
+
 /**
  * @brief Will spawn a @c n particles @c deltaTime ms after the parent was spawned
  * @param[in] name The id of the particle (see ptl_*.ufo script files in base/ufos)
@@ -381,6 +432,7 @@ void PTL_InitStartup (void)
 {
 	r_numParticles = 0;
 	numPtlCmds = 0;
+	numPtlOps = 0;
 	numPtlDefs = 0;
 
 	r_numParticlesArt = 0;
@@ -444,6 +496,12 @@ static void CL_ParticleFunction (ptl_t * p, ptlCmd_t * cmd)
 		}
 
 		switch (cmd->cmd) {
+		case PC_SET:
+			/* the next command is the pop that was merged into this one */
+			cmd++;
+			memmove(CL_ParticleCommandGetDataLocation(p, cmd), cmdData, cmd->size);
+			break;
+
 		case PC_PUSH:
 			/* check for stack overflow */
 			if (stackIdx >= MAX_STACK_DEPTH)
@@ -696,6 +754,246 @@ static void CL_ParticleFunction (ptl_t * p, ptlCmd_t * cmd)
 	}
 }
 
+/* =========================================================== */
+
+static inline void *CL_ParticleOpGetLocation (ptl_t *p, ptlOpArg_t arg, int ofs)
+{
+	switch (arg) {
+	case PTL_ARG_PARTICLE:
+		return (byte *)p + ofs;
+	case PTL_ARG_STACK:
+		return cmdStack + ofs;
+	default:
+		return pcmdData + ofs;
+	}
+}
+
+#define PTL_OP_SRC(p, op) CL_ParticleOpGetLocation((p), (ptlOpArg_t)(op)->src, (op)->srcOfs)
+#define PTL_OP_DST(p, op) CL_ParticleOpGetLocation((p), (ptlOpArg_t)(op)->dst, (op)->dstOfs)
+
+static qboolean CL_ParticleOpCopy (ptl_t *p, const ptlOp_t *op)
+{
+	memmove(PTL_OP_DST(p, op), PTL_OP_SRC(p, op), op->n);
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpCopyString (ptl_t *p, const ptlOp_t *op)
+{
+	Q_strncpyz((char *)PTL_OP_DST(p, op), (const char *)PTL_OP_SRC(p, op), MAX_VAR);
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpAdd (ptl_t *p, const ptlOp_t *op)
+{
+	const float *src = (const float *)PTL_OP_SRC(p, op);
+	float *dst = (float *)PTL_OP_DST(p, op);
+	int i;
+
+	for (i = 0; i < op->n; i++)
+		dst[i] += src[i];
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpSub (ptl_t *p, const ptlOp_t *op)
+{
+	const float *src = (const float *)PTL_OP_SRC(p, op);
+	float *dst = (float *)PTL_OP_DST(p, op);
+	int i;
+
+	for (i = 0; i < op->n; i++)
+		dst[i] -= src[i];
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpMul (ptl_t *p, const ptlOp_t *op)
+{
+	const float *src = (const float *)PTL_OP_SRC(p, op);
+	float *dst = (float *)PTL_OP_DST(p, op);
+	int i;
+
+	for (i = 0; i < op->n; i++)
+		dst[i] *= src[i];
+	return qtrue;
+}
+
+/** @note multiplies with the reciprocal like the interpreter to get the same values */
+static qboolean CL_ParticleOpDiv (ptl_t *p, const ptlOp_t *op)
+{
+	const float *src = (const float *)PTL_OP_SRC(p, op);
+	float *dst = (float *)PTL_OP_DST(p, op);
+	int i;
+
+	for (i = 0; i < op->n; i++) {
+		const float arg = 1.0 / src[i];
+		dst[i] *= arg;
+	}
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpMulScalar (ptl_t *p, const ptlOp_t *op)
+{
+	const float arg = *(const float *)PTL_OP_SRC(p, op);
+	float *dst = (float *)PTL_OP_DST(p, op);
+	int i;
+
+	for (i = 0; i < op->n; i++)
+		dst[i] *= arg;
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpDivScalar (ptl_t *p, const ptlOp_t *op)
+{
+	const float arg = 1.0 / *(const float *)PTL_OP_SRC(p, op);
+	float *dst = (float *)PTL_OP_DST(p, op);
+	int i;
+
+	for (i = 0; i < op->n; i++)
+		dst[i] *= arg;
+	return qtrue;
+}
+
+/** @note sin, cos and tan are all calculated with sin - just like the interpreter does */
+static qboolean CL_ParticleOpSin (ptl_t *p, const ptlOp_t *op)
+{
+	*(float *)PTL_OP_DST(p, op) = sin(*(const float *)PTL_OP_SRC(p, op) * (2 * M_PI));
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpRand (ptl_t *p, const ptlOp_t *op)
+{
+	const float *src = (const float *)PTL_OP_SRC(p, op);
+	float *dst = (float *)PTL_OP_DST(p, op);
+	int i;
+
+	for (i = 0; i < op->n; i++)
+		dst[i] = src[i] * frand();
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpCrand (ptl_t *p, const ptlOp_t *op)
+{
+	const float *src = (const float *)PTL_OP_SRC(p, op);
+	float *dst = (float *)PTL_OP_DST(p, op);
+	int i;
+
+	for (i = 0; i < op->n; i++)
+		dst[i] = src[i] * crand();
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpPic (ptl_t *p, const ptlOp_t *op)
+{
+	p->pic = CL_ParticleGetArt((const char *)PTL_OP_SRC(p, op), p->frame, ART_PIC);
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpModel (ptl_t *p, const ptlOp_t *op)
+{
+	p->model = CL_ParticleGetArt((const char *)PTL_OP_SRC(p, op), p->frame, ART_MODEL);
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpProgram (ptl_t *p, const ptlOp_t *op)
+{
+	p->program = R_LoadProgram((const char *)PTL_OP_SRC(p, op), R_InitParticleProgram, R_UseParticleProgram);
+	if (p->program)
+		p->program->userdata = p;
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpKill (ptl_t *p, const ptlOp_t *op)
+{
+	CL_ParticleFree(p);
+	return qfalse;
+}
+
+static qboolean CL_ParticleOpSpawn (ptl_t *p, const ptlOp_t *op)
+{
+	if (!CL_ParticleSpawn(op->string, p->levelFlags, p->s, p->v, p->a))
+		Com_Printf("PC_SPAWN: Could not spawn child particle for '%s'\n", p->ctrl->name);
+	return qtrue;
+}
+
+/** @note the amount of particles is on the stack */
+static qboolean CL_ParticleOpNSpawn (ptl_t *p, const ptlOp_t *op)
+{
+	const int n = *(const int *)PTL_OP_SRC(p, op);
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (!CL_ParticleSpawn(op->string, p->levelFlags, p->s, p->v, p->a))
+			Com_Printf("PC_NSPAWN: Could not spawn child particle for '%s'\n", p->ctrl->name);
+	return qtrue;
+}
+
+/** @note the delta time and the amount of particles are on the stack */
+static qboolean CL_ParticleOpTNSpawn (ptl_t *p, const ptlOp_t *op)
+{
+	const int *args = (const int *)PTL_OP_SRC(p, op);
+
+	/** @todo make the children boolean configurable */
+	CL_ParticleSpawnTimed(op->string, p, qtrue, args[0], args[1]);
+	return qtrue;
+}
+
+static qboolean CL_ParticleOpChild (ptl_t *p, const ptlOp_t *op)
+{
+	ptl_t *pnew = CL_ParticleSpawn(op->string, p->levelFlags, p->s, p->v, p->a);
+
+	if (pnew) {
+		pnew->next = p->children;
+		pnew->parent = p;
+		p->children = pnew;
+	} else {
+		Com_Printf("PC_CHILD: Could not spawn child particle for '%s'\n", p->ctrl->name);
+	}
+	return qtrue;
+}
+
+/**
+ * @brief Runs a particle function - the compiled one if there is one
+ * @param[in,out] p The particle to run the function for
+ * @param[in] cmd The command chain for the interpreter
+ * @param[in] op The compiled command chain or @c NULL
+ * @sa CL_CompileParticleFunction
+ */
+static void CL_ParticleRunFunction (ptl_t *p, ptlCmd_t *cmd, const ptlOp_t *op)
+{
+	if (!op) {
+		CL_ParticleFunction(p, cmd);
+		return;
+	}
+
+	for (; op->func; op++)
+		if (!op->func(p, op))
+			return;
+}
+
+#ifdef COMPILE_UNITTESTS
+/**
+ * @brief Runs a function of the particle definition either with the interpreter or compiled
+ * @param[in] function The name of the function, e.g. @c run
+ * @return @c qfalse if the definition doesn't have this function or if it wasn't compiled
+ */
+qboolean CL_ParticlePrivateRunFunction (ptl_t *p, const char *function, qboolean compiled)
+{
+	int i;
+
+	for (i = 0; i < PF_NUM_PTLFUNCS; i++) {
+		if (Q_streq(function, pf_strings[i])) {
+			ptlCmd_t *cmd = *(ptlCmd_t **)((byte *)p->ctrl + pf_values[i]);
+			const ptlOp_t *op = *(ptlOp_t **)((byte *)p->ctrl + pf_ops[i]);
+			if (!cmd || (compiled && !op))
+				return qfalse;
+			CL_ParticleRunFunction(p, cmd, compiled ? op : NULL);
+			return qtrue;
+		}
+	}
+
+	return qfalse;
+}
+#endif
+
 ptlDef_t *CL_ParticleGet (const char *name)
 {
 	int i;
@@ -741,8 +1039,8 @@ ptl_t *CL_ParticleSpawn (const char *name, int levelFlags, const vec3_t s, const
 		return NULL;
 	}
 
-	/* add the particle */
-	for (i = 0; i < r_numParticles; i++)
+	/* add the particle - all the slots in front of the hint are used */
+	for (i = min(ptlFreeHint, r_numParticles); i < r_numParticles; i++)
 		if (!r_particleArray[i].inuse)
 			break;
 
@@ -758,6 +1056,7 @@ ptl_t *CL_ParticleSpawn (const char *name, int levelFlags, const vec3_t s, const
 	/* allocate particle */
 	p = &r_particleArray[i];
 	OBJZERO(*p);
+	ptlFreeHint = i + 1;
 
 	/* set basic values */
 	p->inuse = qtrue;
@@ -784,7 +1083,7 @@ ptl_t *CL_ParticleSpawn (const char *name, int levelFlags, const vec3_t s, const
 	p->levelFlags = levelFlags;
 
 	/* run init function */
-	CL_ParticleFunction(p, pd->init);
+	CL_ParticleRunFunction(p, pd->init, pd->initOps);
 	if (p->inuse && !p->tps && !p->life) {
 		Com_DPrintf(DEBUG_CLIENT, "Particle %s does not have a tps nor a life set - this is only valid for projectile particles\n",
 				name);
@@ -817,9 +1116,12 @@ void CL_ParticleVisible (ptl_t *p, qboolean hide)
  */
 void CL_ParticleFree (ptl_t *p)
 {
+	const int index = p - r_particleArray;
 	ptl_t *c;
 
 	p->inuse = qfalse;
+	if (index < ptlFreeHint)
+		ptlFreeHint = index;
 	p->invis = qtrue;
 	for (c = p->children; c; c = c->next) {
 		CL_ParticleFree(c);
@@ -878,7 +1180,7 @@ void CL_ParticleCheckRounds (void)
 	for (i = 0, p = r_particleArray; i < r_numParticles; i++, p++)
 		if (p->inuse) {
 			/* run round function */
-			CL_ParticleFunction(p, p->ctrl->round);
+			CL_ParticleRunFunction(p, p->ctrl->round, p->ctrl->roundOps);
 
 			if (p->rounds) {
 				p->roundsCnt--;
@@ -922,41 +1224,65 @@ static inline trace_t PTL_Trace (ptl_t *ptl, const vec3_t mins, const vec3_t max
 }
 
 /**
- * @brief Prepares the particle rendering, calculate new position, velocity and all the
- * other particle values that are needed to display it
- * @sa CL_ParticleRun
- * @param[in,out] p The particle to handle
+ * @brief Advances the time of the given particles and integrates their movement
+ * @note This is the part of the update that doesn't depend on the particle scripts, so it
+ * runs as one tight loop over the particle array before any script is executed.
+ * @sa CL_ParticleRun2
+ * @param[in,out] particles The first particle to handle
+ * @param[in] num The amount of particles (free ones included)
  */
-static void CL_ParticleRun2 (ptl_t *p)
+static void CL_ParticleIntegrate (ptl_t *particles, int num)
 {
-	/* advance time */
-	p->dt = cls.frametime;
-	p->t = (cl.time - p->startTime) * 0.001f;
-	p->lastThink += p->dt;
-	p->lastFrame += p->dt;
-
-	if (p->rounds && !p->roundsCnt)
-		p->roundsCnt = p->rounds;
-
-	/* test for end of life */
-	if (p->life && p->t >= p->life && !p->parent) {
-		CL_ParticleFree(p);
-		return;
-	/* don't play the weather particles if a user don't want them there can
-	 * be a lot of weather particles - which might slow the computer down */
-	} else if (p->weather && !cl_particleweather->integer) {
-		CL_ParticleFree(p);
-		return;
-	}
+	const float dt = cls.frametime;
+	const float halfDtSqr = 0.5f * dt * dt;
+	const qboolean weather = cl_particleweather->integer;
+	const int time = cl.time;
+	ptl_t *p;
+	int i;
+
+	for (i = 0, p = particles; i < num; i++, p++) {
+		if (!p->inuse)
+			continue;
+
+		/* advance time */
+		p->dt = dt;
+		p->t = (time - p->startTime) * 0.001f;
+		p->lastThink += dt;
+		p->lastFrame += dt;
+
+		if (p->rounds && !p->roundsCnt)
+			p->roundsCnt = p->rounds;
 
-	/* kinematics */
-	if (p->style != STYLE_LINE) {
-		VectorMA(p->s, 0.5 * p->dt * p->dt, p->a, p->s);
-		VectorMA(p->s, p->dt, p->v, p->s);
-		VectorMA(p->v, p->dt, p->a, p->v);
-		VectorMA(p->angles, p->dt, p->omega, p->angles);
+		/* test for end of life */
+		if (p->life && p->t >= p->life && !p->parent) {
+			CL_ParticleFree(p);
+			continue;
+		/* don't play the weather particles if a user don't want them there can
+		 * be a lot of weather particles - which might slow the computer down */
+		} else if (p->weather && !weather) {
+			CL_ParticleFree(p);
+			continue;
+		}
+
+		/* kinematics */
+		if (p->style != STYLE_LINE) {
+			VectorMA(p->s, halfDtSqr, p->a, p->s);
+			VectorMA(p->s, dt, p->v, p->s);
+			VectorMA(p->v, dt, p->a, p->v);
+			VectorMA(p->angles, dt, p->omega, p->angles);
+		}
 	}
+}
 
+/**
+ * @brief Prepares the particle rendering, runs the physics and the particle scripts and
+ * calculates all the other particle values that are needed to display it
+ * @note Time and movement are already advanced by @c CL_ParticleIntegrate
+ * @sa CL_ParticleRun
+ * @param[in,out] p The particle to handle
+ */
+static void CL_ParticleRun2 (ptl_t *p)
+{
 	/* basic 'physics' for particles */
 	if (p->physics) {
 		trace_t tr;
@@ -986,7 +1312,7 @@ static void CL_ParticleRun2 (ptl_t *p)
 
 			/* now execute the physics handler */
 			if (p->ctrl->physics)
-				CL_ParticleFunction(p, p->ctrl->physics);
+				CL_ParticleRunFunction(p, p->ctrl->physics, p->ctrl->physicsOps);
 			/* let them stay on the ground until they fade out or die */
 			if (!p->stayalive) {
 				CL_ParticleFree(p);
@@ -1006,11 +1332,11 @@ static void CL_ParticleRun2 (ptl_t *p)
 	}
 
 	/* run */
-	CL_ParticleFunction(p, p->ctrl->run);
+	CL_ParticleRunFunction(p, p->ctrl->run, p->ctrl->runOps);
 
 	/* think */
 	while (p->tps && p->lastThink * p->tps >= 1) {
-		CL_ParticleFunction(p, p->ctrl->think);
+		CL_ParticleRunFunction(p, p->ctrl->think, p->ctrl->thinkOps);
 		p->lastThink -= 1.0 / p->tps;
 	}
 
@@ -1114,16 +1440,25 @@ static void CL_ParticleRunTimed (void)
 void CL_ParticleRun (void)
 {
 	ptl_t *p;
-	int i;
+	int i, num;
 
 	if (cls.state != ca_active)
 		return;
 
 	CL_ParticleRunTimed();
 
-	for (i = 0, p = r_particleArray; i < r_numParticles; i++, p++)
+	/* particles that are spawned by the scripts of this frame are updated with the next one */
+	num = r_numParticles;
+	CL_ParticleIntegrate(r_particleArray, num);
+
+	for (i = 0, p = r_particleArray; i < num; i++, p++)
 		if (p->inuse)
 			CL_ParticleRun2(p);
+
+	/* after an explosion there are a lot of free slots at the end - neither the
+	 * simulation nor the renderer have to look at them */
+	while (r_numParticles > 0 && !r_particleArray[r_numParticles - 1].inuse)
+		r_numParticles--;
 }
 
 /**
@@ -1209,7 +1544,7 @@ void CL_RunMapParticles (void)
 
 			/* init the particle */
 			CL_ParseMapParticle(ptl, mp->info, qfalse);
-			CL_ParticleFunction(ptl, ptl->ctrl->init);
+			CL_ParticleRunFunction(ptl, ptl->ctrl->init, ptl->ctrl->initOps);
 			CL_ParseMapParticle(ptl, mp->info, qtrue);
 
 			/* prepare next spawning */
@@ -1221,8 +1556,329 @@ void CL_RunMapParticles (void)
 }
 
 
-static void CL_ParsePtlCmds (const char *name, const char **text)
+/**
+ * @brief Size of the particle values that can be copied without @c Com_SetValue
+ * @return 0 for the values that need special handling (strings, art and programs)
+ */
+static size_t CL_ParticleValueSize (int type)
+{
+	switch (type) {
+	case V_BOOL:
+		return sizeof(qboolean);
+	case V_INT:
+		return sizeof(int);
+	case V_FLOAT:
+		return sizeof(float);
+	case V_POS:
+		return sizeof(vec2_t);
+	case V_VECTOR:
+		return sizeof(vec3_t);
+	case V_COLOR:
+		return sizeof(vec4_t);
+	case V_BLEND:
+		return sizeof(blend_t);
+	case V_STYLE:
+		return sizeof(style_t);
+	case V_FADE:
+		return sizeof(fade_t);
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Compiles a parsed command chain for the interpreter
+ * @note Most of the commands are plain assignments (every value set in a script is translated
+ * into a push and a pop) - they are merged into a single @c PC_SET that copies the value
+ * without going over the stack.
+ * @sa CL_ParticleFunction
+ */
+static void CL_CompilePtlCmds (ptlCmd_t *cmd)
+{
+	for (; cmd->cmd != PC_END; cmd++) {
+		ptlCmd_t *pop = cmd + 1;
+		size_t size;
+
+		if (cmd->cmd != PC_PUSH || pop->cmd != PC_POP)
+			continue;
+		/* stack references are resolved at runtime */
+		if (cmd->ref <= RSTACK || pop->ref <= RSTACK)
+			continue;
+		if (cmd->type != pop->type)
+			continue;
+
+		size = CL_ParticleValueSize(pop->type);
+		if (!size)
+			continue;
+
+		cmd->cmd = PC_SET;
+		pop->size = size;
+		cmd++;
+	}
+}
+
+/**
+ * @brief Compiles a command chain into commands that don't need any checks or lookups at runtime
+ * @note The types of all the values on the stack are known from the script - so the checks of the
+ * interpreter are done once here and the vector commands (v2, v3, v4) vanish. Chains the interpreter
+ * would stop with an error, or where it would convert between types, are not compiled. They stay
+ * with the interpreter, which behaves just like before for them.
+ * @return The compiled function or @c NULL if the chain is interpreted
+ * @sa CL_ParticleFunction
+ * @sa CL_ParticleRunFunction
+ */
+static ptlOp_t *CL_CompileParticleFunction (const ptlCmd_t *cmd)
 {
+	ptlOp_t *const first = &ptlOps[numPtlOps];
+	ptlOp_t *op = first;
+	/* the types and positions the values on the stack will have */
+	int stackTypes[MAX_STACK_DEPTH];
+	int stackOfs[MAX_STACK_DEPTH];
+	int stackIdx = 0, e = 0;
+
+	for (; cmd->cmd != PC_END; cmd++) {
+		int type, i, n;
+
+		/* leave room for the terminating command */
+		if (op - ptlOps >= MAX_PTLCMDS - 1)
+			return NULL;
+
+		OBJZERO(*op);
+
+		/* the operand - the interpreter does the same for each run */
+		if (cmd->ref > RSTACK) {
+			type = cmd->type;
+			if (cmd->ref < 0) {
+				op->src = PTL_ARG_PARTICLE;
+				op->srcOfs = -cmd->ref;
+			} else {
+				op->src = PTL_ARG_DATA;
+				op->srcOfs = cmd->ref;
+			}
+		} else {
+			if (!stackIdx)
+				return NULL;
+
+			/* pop an element off the stack */
+			e = stackOfs[--stackIdx];
+			op->src = PTL_ARG_STACK;
+
+			i = RSTACK - cmd->ref;
+			if (!i) {
+				type = stackTypes[stackIdx];
+				op->srcOfs = e;
+			} else if ((1 << stackTypes[stackIdx]) & V_VECS) {
+				/* element of a vector */
+				type = V_FLOAT;
+				op->srcOfs = e + (i - 1) * sizeof(float);
+			} else {
+				return NULL;
+			}
+		}
+
+		switch (cmd->cmd) {
+		case PC_SET:
+			/* the next command is the pop that was merged into this one */
+			cmd++;
+			op->func = CL_ParticleOpCopy;
+			op->dst = PTL_ARG_PARTICLE;
+			op->dstOfs = -cmd->ref;
+			op->n = cmd->size;
+			break;
+
+		case PC_PUSH:
+			if (stackIdx >= MAX_STACK_DEPTH)
+				return NULL;
+			if (type == V_STRING) {
+				/* only constant strings - they are the names of the art */
+				if (op->src != PTL_ARG_DATA)
+					return NULL;
+				n = min(strlen((const char *)pcmdData + op->srcOfs) + 1, MAX_VAR);
+				op->func = CL_ParticleOpCopyString;
+			} else {
+				n = CL_ParticleValueSize(type);
+				if (!n)
+					return NULL;
+				op->func = CL_ParticleOpCopy;
+			}
+			if (e + n > MAX_STACK_DATA)
+				return NULL;
+			op->dst = PTL_ARG_STACK;
+			op->dstOfs = e;
+			op->n = n;
+			stackTypes[stackIdx] = type;
+			stackOfs[stackIdx++] = e;
+			e += n;
+			break;
+
+		case PC_POP:
+		case PC_KPOP:
+			/* the operand is where the value goes to */
+			if (!stackIdx || op->src != PTL_ARG_PARTICLE)
+				return NULL;
+			op->dst = PTL_ARG_PARTICLE;
+			op->dstOfs = op->srcOfs;
+			op->src = PTL_ARG_STACK;
+
+			/* get pics and models - they are always popped */
+			if (op->dstOfs == offsetof(ptl_t, pic) || op->dstOfs == offsetof(ptl_t, model) || op->dstOfs == offsetof(ptl_t, program)) {
+				if (stackTypes[--stackIdx] != V_STRING)
+					return NULL;
+				if (op->dstOfs == offsetof(ptl_t, pic))
+					op->func = CL_ParticleOpPic;
+				else if (op->dstOfs == offsetof(ptl_t, model))
+					op->func = CL_ParticleOpModel;
+				else
+					op->func = CL_ParticleOpProgram;
+				op->srcOfs = e = stackOfs[stackIdx];
+				break;
+			}
+
+			/* the interpreter copies as much as the target type needs */
+			n = CL_ParticleValueSize(type);
+			if (!n || type != stackTypes[stackIdx - 1])
+				return NULL;
+			op->func = CL_ParticleOpCopy;
+			op->srcOfs = stackOfs[stackIdx - 1];
+			op->n = n;
+			if (cmd->cmd == PC_POP) {
+				stackIdx--;
+				e -= n;
+			}
+			break;
+
+		case PC_ADD:
+		case PC_SUB:
+			if (!stackIdx || !((1 << stackTypes[stackIdx - 1]) & V_VECS) || type != stackTypes[stackIdx - 1])
+				return NULL;
+			op->func = cmd->cmd == PC_ADD ? CL_ParticleOpAdd : CL_ParticleOpSub;
+			op->dst = PTL_ARG_STACK;
+			op->dstOfs = stackOfs[stackIdx - 1];
+			op->n = type - V_FLOAT + 1;
+			break;
+
+		case PC_MUL:
+		case PC_DIV:
+			if (!stackIdx || !((1 << stackTypes[stackIdx - 1]) & V_VECS) || !((1 << type) & V_VECS))
+				return NULL;
+			op->dst = PTL_ARG_STACK;
+			op->dstOfs = stackOfs[stackIdx - 1];
+			op->n = stackTypes[stackIdx - 1] - V_FLOAT + 1;
+			if (stackTypes[stackIdx - 1] > V_FLOAT && type > V_FLOAT) {
+				/* component wise multiplication */
+				if (type != stackTypes[stackIdx - 1])
+					return NULL;
+				op->func = cmd->cmd == PC_MUL ? CL_ParticleOpMul : CL_ParticleOpDiv;
+			} else {
+				/* scalar multiplication with scalar in second argument */
+				if (type > V_FLOAT)
+					return NULL;
+				op->func = cmd->cmd == PC_MUL ? CL_ParticleOpMulScalar : CL_ParticleOpDivScalar;
+			}
+			break;
+
+		case PC_SIN:
+		case PC_COS:
+		case PC_TAN:
+			if (type != V_FLOAT || stackIdx >= MAX_STACK_DEPTH || e + sizeof(float) > MAX_STACK_DATA)
+				return NULL;
+			op->func = CL_ParticleOpSin;
+			op->dst = PTL_ARG_STACK;
+			op->dstOfs = e;
+			stackTypes[stackIdx] = V_FLOAT;
+			stackOfs[stackIdx++] = e;
+			e += sizeof(float);
+			break;
+
+		case PC_RAND:
+		case PC_CRAND:
+			n = type - V_FLOAT + 1;
+			if (!((1 << type) & V_VECS) || stackIdx >= MAX_STACK_DEPTH || e + n * sizeof(float) > MAX_STACK_DATA)
+				return NULL;
+			op->func = cmd->cmd == PC_RAND ? CL_ParticleOpRand : CL_ParticleOpCrand;
+			op->dst = PTL_ARG_STACK;
+			op->dstOfs = e;
+			op->n = n;
+			stackTypes[stackIdx] = type;
+			stackOfs[stackIdx++] = e;
+			e += n * sizeof(float);
+			break;
+
+		case PC_V2:
+		case PC_V3:
+		case PC_V4:
+			/* the values are already next to each other on the stack - only their type changes */
+			n = cmd->cmd - PC_V2 + 2;
+			if (stackIdx < n)
+				return NULL;
+			for (type = 0, i = 0; i < n; i++) {
+				if (!((1 << stackTypes[--stackIdx]) & V_VECS))
+					return NULL;
+				type += stackTypes[stackIdx] - V_FLOAT + 1;
+			}
+			if (type > 4)
+				return NULL;
+			stackTypes[stackIdx++] = V_FLOAT + type - 1;
+			continue;
+
+		case PC_KILL:
+			/* nothing after this is ever run */
+			op->func = CL_ParticleOpKill;
+			op++;
+			OBJZERO(*op);
+			numPtlOps = op - ptlOps + 1;
+			return first;
+
+		case PC_SPAWN:
+		case PC_CHILD:
+			if (op->src != PTL_ARG_DATA)
+				return NULL;
+			op->func = cmd->cmd == PC_SPAWN ? CL_ParticleOpSpawn : CL_ParticleOpChild;
+			op->string = (const char *)pcmdData + op->srcOfs;
+			break;
+
+		case PC_NSPAWN:
+			if (op->src != PTL_ARG_DATA || !stackIdx || stackTypes[stackIdx - 1] != V_INT)
+				return NULL;
+			op->func = CL_ParticleOpNSpawn;
+			op->string = (const char *)pcmdData + op->srcOfs;
+			op->src = PTL_ARG_STACK;
+			op->srcOfs = stackOfs[--stackIdx];
+			e -= sizeof(int);
+			break;
+
+		case PC_TNSPAWN:
+			/* the delta time and the amount of particles */
+			if (op->src != PTL_ARG_DATA || stackIdx < 2 || stackTypes[stackIdx - 1] != V_INT || stackTypes[stackIdx - 2] != V_INT)
+				return NULL;
+			if (stackOfs[stackIdx - 1] != stackOfs[stackIdx - 2] + (int)sizeof(int))
+				return NULL;
+			op->func = CL_ParticleOpTNSpawn;
+			op->string = (const char *)pcmdData + op->srcOfs;
+			op->src = PTL_ARG_STACK;
+			op->srcOfs = stackOfs[stackIdx - 2];
+			stackIdx -= 2;
+			e -= 2 * sizeof(int);
+			break;
+
+		default:
+			return NULL;
+		}
+
+		op++;
+	}
+
+	OBJZERO(*op);
+	numPtlOps = op - ptlOps + 1;
+	return first;
+}
+
+/**
+ * @return The compiled command chain or @c NULL if it is interpreted
+ */
+static ptlOp_t *CL_ParsePtlCmds (const char *name, const char **text)
+{
+	ptlCmd_t *const first = &ptlCmd[numPtlCmds];
 	ptlCmd_t *pc;
 	const value_t *pp;
 	const char *errhead = "CL_ParsePtlCmds: unexpected end of file";
@@ -1234,7 +1890,7 @@ static void CL_ParsePtlCmds (const char *name, const char **text)
 
 	if (!*text || *token != '{') {
 		Com_Printf("CL_ParsePtlCmds: particle cmds \"%s\" without body ignored\n", name);
-		return;
+		return NULL;
 	}
 
 	do {
@@ -1260,7 +1916,7 @@ static void CL_ParsePtlCmds (const char *name, const char **text)
 				/* get parameter type */
 				token = Com_EParse(text, errhead, name);
 				if (!*text)
-					return;
+					return NULL;
 
 				/* operate on the top element on the stack */
 				if (token[0] == '#') {
@@ -1356,7 +2012,7 @@ static void CL_ParsePtlCmds (const char *name, const char **text)
 					/* get the value */
 					token = Com_EParse(text, errhead, name);
 					if (!*text)
-						return;
+						return NULL;
 				}
 
 				/* set the values */
@@ -1378,7 +2034,7 @@ static void CL_ParsePtlCmds (const char *name, const char **text)
 				/* get parameter */
 				token = Com_EParse(text, errhead, name);
 				if (!*text)
-					return;
+					return NULL;
 
 				/* translate set to a push and pop */
 				if (numPtlCmds >= MAX_PTLCMDS)
@@ -1408,6 +2064,9 @@ static void CL_ParsePtlCmds (const char *name, const char **text)
 		Com_Error(ERR_DROP, "CL_ParsePtlCmds: MAX_PTLCMDS exceeded");
 	pc = &ptlCmd[numPtlCmds++];
 	OBJZERO(*pc);
+
+	CL_CompilePtlCmds(first);
+	return CL_CompileParticleFunction(first);
 }
 
 /**
@@ -1470,8 +2129,8 @@ void CL_ParseParticle (const char *name, const char **text)
 				pc = (ptlCmd_t **) ((byte *) pd + pf_values[i]);
 				*pc = &ptlCmd[numPtlCmds];
 
-				/* parse the commands */
-				CL_ParsePtlCmds(name, text);
+				/* parse and compile the commands */
+				*(ptlOp_t **) ((byte *) pd + pf_ops[i]) = CL_ParsePtlCmds(name, text);
 				break;
 			}
 
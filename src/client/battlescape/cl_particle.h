@@ -39,4 +39,8 @@ ptl_t *CL_ParticleSpawn(const char *name, int levelFlags, const vec3_t s, const
 ptlDef_t *CL_ParticleGet(const char *particleID);
 void CL_ParticleVisible(ptl_t *p, qboolean hide);
 
+#ifdef COMPILE_UNITTESTS
+qboolean CL_ParticlePrivateRunFunction(ptl_t *p, const char *function, qboolean compiled);
+#endif
+
 #endif
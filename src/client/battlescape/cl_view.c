@@ -109,6 +109,9 @@ void CL_ViewLoadMedia (void)
 			le->model2 = LE_GetDrawModel(le->modelnum2);
 	}
 
+	/* build the sector tree that speeds up the tracing against local entities */
+	LE_ClearWorld();
+
 	loadingPercent = 100.0f;
 
 	refdef.ready = qtrue;
@@ -140,6 +140,7 @@ void CL_ActorAppear (const eventRegister_t *self, struct dbuffer *msg)
 		VectorCopy(player_dead_maxs, le->maxs);
 	else
 		VectorCopy(player_maxs, le->maxs);
+	LE_Link(le);
 
 	LE_SetThink(le, LET_StartIdle);
 
@@ -135,6 +135,7 @@ void CL_ActorDie (const eventRegister_t *self, struct dbuffer *msg)
 	CL_ActorPlaySound(le, SND_DEATH);
 
 	VectorCopy(player_dead_maxs, le->maxs);
+	LE_Link(le);
 	CL_ActorRemoveFromTeamList(le);
 
 	/* update pathing as we maybe can walk onto the dead actor now */
@@ -87,6 +87,7 @@ void CL_ActorRevitalised (const eventRegister_t *self, struct dbuffer *msg)
 	}
 
 	VectorCopy(player_maxs, le->maxs);
+	LE_Link(le);
 
 	/* add team members to the actor list */
 	CL_ActorAddToTeamList(le);
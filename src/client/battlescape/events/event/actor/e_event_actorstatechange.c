@@ -63,6 +63,7 @@ void CL_ActorStateChange (const eventRegister_t *self, struct dbuffer *msg)
 		FLOOR(le) = NULL;
 		LE_SetThink(le, NULL);
 		VectorCopy(player_dead_maxs, le->maxs);
+		LE_Link(le);
 		CL_ActorRemoveFromTeamList(le);
 		return;
 	} else {
@@ -92,6 +92,7 @@ void CL_AddBrushModel (const eventRegister_t *self, struct dbuffer *msg)
 		CM_SetInlineModelOrientation(cl.mapTiles, le->inlineModelName, le->origin, le->angles);
 
 		le->contents = CONTENTS_SOLID;
+		LE_Link(le);
 
 		CL_RecalcRouting(le);
 	}
@@ -56,6 +56,7 @@ void CL_DoorClose (const eventRegister_t *self, struct dbuffer *msg)
 			le->angles[le->dir & 3] -= DOOR_ROTATION_ANGLE;
 
 		CM_SetInlineModelOrientation(cl.mapTiles, le->inlineModelName, le->origin, le->angles);
+		LE_Link(le);
 		CL_RecalcRouting(le);
 	} else if (le->type == ET_DOOR_SLIDING) {
 		LE_SetThink(le, LET_DoorSlidingClose);
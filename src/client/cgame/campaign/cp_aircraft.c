@@ -696,16 +696,9 @@ aircraft_t *AIR_GetAircraftFromBaseByIDXSafe (const base_t* base, int index)
  */
 const aircraft_t *AIR_GetAircraftSilent (const char *name)
 {
-	int i;
-
 	if (!name)
 		return NULL;
-	for (i = 0; i < ccs.numAircraftTemplates; i++) {
-		const aircraft_t *aircraftTemplate = &ccs.aircraftTemplates[i];
-		if (Q_streq(aircraftTemplate->id, name))
-			return aircraftTemplate;
-	}
-	return NULL;
+	return (const aircraft_t *)IDT_Get(&ccs.aircraftTemplatesByID, name);
 }
 
 /**
@@ -1456,6 +1449,8 @@ void AIR_ParseAircraft (const char *name, const char **text, qboolean assignAirc
 		RADAR_InitialiseUFOs(&aircraftTemplate->radar);
 
 		ccs.numAircraftTemplates++;
+		if (!IDT_Add(&ccs.aircraftTemplatesByID, aircraftTemplate->id, aircraftTemplate))
+			Com_Printf("AIR_ParseAircraft: could not add \"%s\" to the lookup table\n", name);
 	} else {
 		aircraftTemplate = NULL;
 		for (i = 0; i < ccs.numAircraftTemplates; i++) {
@@ -190,6 +190,8 @@ void B_ParseBuildings (const char *name, const char **text, qboolean link)
 		building->size[1] = 1;
 
 		ccs.numBuildingTemplates++;
+		if (!IDT_Add(&ccs.buildingTemplatesByID, building->id, building))
+			Com_Printf("B_ParseBuildings: could not add \"%s\" to the lookup table\n", name);
 		do {
 			/* get the name type */
 			token = Com_EParse(text, errhead, name);
@@ -222,6 +224,7 @@ void B_ParseBuildings (const char *name, const char **text, qboolean link)
 		if (building->size[0] < 1 || building->size[1] < 1 || building->size[0] >= BASE_SIZE || building->size[1] >= BASE_SIZE) {
 			Com_Printf("B_ParseBuildings: Invalid size for building %s (%i, %i)\n", building->id, (int)building->size[0], (int)building->size[1]);
 			ccs.numBuildingTemplates--;
+			IDT_Remove(&ccs.buildingTemplatesByID, building->id, building);
 		}
 	} else {
 		building = B_GetBuildingTemplate(name);
@@ -290,14 +293,12 @@ qboolean B_BuildingScriptSanityCheck (void)
  */
 building_t *B_GetBuildingTemplate (const char *buildingName)
 {
-	int i = 0;
+	building_t *template;
 
 	assert(buildingName);
-	for (i = 0; i < ccs.numBuildingTemplates; i++) {
-		building_t *template = &ccs.buildingTemplates[i];
-		if (Q_streq(template->id, buildingName))
-			return template;
-	}
+	template = IDT_Get(&ccs.buildingTemplatesByID, buildingName);
+	if (template != NULL)
+		return template;
 
 	Com_Printf("Building %s not found\n", buildingName);
 	return NULL;
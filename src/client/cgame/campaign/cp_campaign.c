@@ -1011,6 +1011,37 @@ static void CP_DebugFullCredits_f (void)
 {
 	CP_UpdateCredits(MAX_CREDITS);
 }
+
+/** @brief The id lookup tables of the campaign definitions and their counters for debug_cplookups */
+static struct {
+	const char *name;
+	idTable_t *table;
+	idTableCounters_t counters;
+} cp_lookupTables[] = {
+	{"aircraft", &ccs.aircraftTemplatesByID},
+	{"buildings", &ccs.buildingTemplatesByID},
+	{"nations", &ccs.nationsByID}
+};
+
+/**
+ * @brief Debug function to show the lookups into the campaign definition tables and their probe lengths
+ * @note Command to call this: debug_cplookups
+ */
+static void CP_DebugLookups_f (void)
+{
+	int i;
+
+	Com_Printf("table        entries  removed  avg probes  max probes    lookups     misses\n");
+	for (i = 0; i < lengthof(cp_lookupTables); i++) {
+		const idTable_t *table = cp_lookupTables[i].table;
+		const idTableCounters_t *counters = &cp_lookupTables[i].counters;
+		idTableStats_t stats;
+
+		IDT_GetStats(table, &stats);
+		Com_Printf("%-12s %7i %8i %11.2f %11i %10i %10i\n", cp_lookupTables[i].name, table->numEntries,
+				stats.numRemoved, stats.avgProbes, stats.maxProbes, counters->numLookups, counters->numMisses);
+	}
+}
 #endif
 
 /* ===================================================================== */
@@ -1033,6 +1064,7 @@ static const cmdList_t game_commands[] = {
 	{"debug_fullcredits", CP_DebugFullCredits_f, "Debug function to give the player full credits"},
 	{"debug_additems", CP_DebugAllItems_f, "Debug function to add one item of every type to base storage and mark related tech collected"},
 	{"debug_listitem", CP_DebugShowItems_f, "Debug function to show all items in base storage"},
+	{"debug_cplookups", CP_DebugLookups_f, "Debug function to show the id lookups into the campaign definition tables and their probe lengths"},
 #endif
 	{NULL, NULL, NULL}
 };
@@ -1255,6 +1287,10 @@ void CP_ResetCampaignData (void)
 	E_ResetEmployees();
 
 	OBJZERO(ccs);
+#ifdef DEBUG
+	for (i = 0; i < lengthof(cp_lookupTables); i++)
+		IDT_SetCounters(cp_lookupTables[i].table, &cp_lookupTables[i].counters);
+#endif
 
 	ccs.missionSpawnCallback = CP_SpawnNewMissions;
 
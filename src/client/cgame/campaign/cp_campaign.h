@@ -466,6 +466,7 @@ typedef struct ccs_s {
 	/* == Nations == */
 	nation_t nations[MAX_NATIONS];
 	int numNations;
+	idTable_t nationsByID;	/**< nations by nation_t::id */
 
 	/* == Cities == */
 	linkedList_t *cities;
@@ -511,6 +512,7 @@ typedef struct ccs_s {
 	/* A list of all possible unique buildings. */
 	building_t buildingTemplates[MAX_BUILDINGS];
 	int numBuildingTemplates;
+	idTable_t buildingTemplatesByID;	/**< buildingTemplates by building_t::id */
 	/*  A list of the building-list per base. (new buildings in a base get copied from buildingTypes) */
 	building_t buildings[MAX_BASES][MAX_BUILDINGS];
 	/* Total number of buildings per base. */
@@ -557,6 +559,7 @@ typedef struct ccs_s {
 
 	aircraft_t aircraftTemplates[MAX_AIRCRAFT];		/**< Available aircraft types/templates/samples. */
 	int numAircraftTemplates;		/**< Number of aircraft templates. */
+	idTable_t aircraftTemplatesByID;	/**< aircraftTemplates by aircraft_t::id */
 
 	missionSpawnFunction_t missionSpawnCallback;
 	missionResultFunction_t missionResultCallback;
@@ -32,13 +32,131 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "cp_popup.h"
 #include "save/save_employee.h"
 
+#define EMPLOYEE_HASH_SIZE 256
+
+/** @brief UCN lookup for all employees in @c ccs.employees, chained via employee_t::hashNext */
+static employee_t *employeeHash[EMPLOYEE_HASH_SIZE];
+
+/** @brief Counters kept up to date by @c E_TrackEmployee - they answer the count queries
+ * without walking the employee lists */
+static int employeesHired[MAX_BASES][MAX_EMPL];
+static int employeesAssigned[MAX_BASES][MAX_EMPL];
+static int employeesHiredTotal[MAX_EMPL];
+static int employeesUnhired[MAX_EMPL];
+
+/**
+ * @brief Adds or removes the given employee from the per base and per type counters
+ * @param[in] employee The employee to count
+ * @param[in] delta @c 1 to add the employee, @c -1 to remove it again
+ * @note Must be called with @c -1 before and with @c 1 after changing the base or the
+ * assigned flag of an employee - see @c E_SetBaseHired and @c E_SetAssigned
+ */
+static void E_TrackEmployee (const employee_t *employee, int delta)
+{
+	const employeeType_t type = employee->type;
+	const base_t *base = employee->baseHired;
+
+	assert(type < MAX_EMPL);
+
+	if (base) {
+		assert(base->idx >= 0 && base->idx < MAX_BASES);
+		employeesHired[base->idx][type] += delta;
+		employeesHiredTotal[type] += delta;
+		if (employee->assigned)
+			employeesAssigned[base->idx][type] += delta;
+	} else {
+		employeesUnhired[type] += delta;
+	}
+}
+
+static inline unsigned int E_HashUCN (int uniqueCharacterNumber)
+{
+	return (unsigned int)uniqueCharacterNumber % EMPLOYEE_HASH_SIZE;
+}
+
+/**
+ * @brief Registers an employee that was just added to @c ccs.employees
+ * @sa E_UnlinkEmployee
+ */
+static employee_t* E_LinkEmployee (employee_t *employee)
+{
+	const unsigned int hash = E_HashUCN(employee->chr.ucn);
+
+	employee->hashNext = employeeHash[hash];
+	employeeHash[hash] = employee;
+	E_TrackEmployee(employee, 1);
+
+	return employee;
+}
+
+/**
+ * @brief Unregisters an employee before it is removed from @c ccs.employees
+ * @sa E_LinkEmployee
+ */
+static void E_UnlinkEmployee (employee_t *employee)
+{
+	employee_t **anchor = &employeeHash[E_HashUCN(employee->chr.ucn)];
+
+	for (; *anchor; anchor = &(*anchor)->hashNext) {
+		if (*anchor == employee) {
+			*anchor = employee->hashNext;
+			break;
+		}
+	}
+	employee->hashNext = NULL;
+	E_TrackEmployee(employee, -1);
+}
+
+/**
+ * @brief Forgets about all registered employees
+ * @note Only call this when the employee lists are deleted, too
+ */
+static void E_ResetRegistry (void)
+{
+	OBJZERO(employeeHash);
+	OBJZERO(employeesHired);
+	OBJZERO(employeesAssigned);
+	OBJZERO(employeesHiredTotal);
+	OBJZERO(employeesUnhired);
+}
+
+/**
+ * @brief Changes the base the employee is hired in (@c NULL for unhired) and keeps the
+ * employee counters in sync
+ * @note This doesn't do any capacity or building handling - see @c E_HireEmployee,
+ * @c E_UnhireEmployee and @c E_MoveIntoNewBase for this
+ */
+void E_SetBaseHired (employee_t *employee, base_t *base)
+{
+	if (employee->baseHired == base)
+		return;
+
+	E_TrackEmployee(employee, -1);
+	employee->baseHired = base;
+	E_TrackEmployee(employee, 1);
+}
+
+/**
+ * @brief Marks the employee as (un)assigned to a building and keeps the employee
+ * counters in sync
+ */
+void E_SetAssigned (employee_t *employee, qboolean assigned)
+{
+	if (employee->assigned == assigned)
+		return;
+
+	E_TrackEmployee(employee, -1);
+	employee->assigned = assigned;
+	E_TrackEmployee(employee, 1);
+}
+
 /**
  * @brief Returns number of employees of a type
  * @param[in] type Employeetype to check
  */
 int E_CountByType (employeeType_t type)
 {
-	return LIST_Count(ccs.employees[type]);
+	return employeesHiredTotal[type] + employeesUnhired[type];
 }
 
 /**
@@ -48,6 +166,9 @@ int E_CountByType (employeeType_t type)
  */
 employee_t* E_GetUnhired (employeeType_t type)
 {
+	if (!employeesUnhired[type])
+		return NULL;
+
 	E_Foreach(type, employee) {
 		if (!E_IsHired(employee))
 			return employee;
@@ -164,7 +285,7 @@ qboolean E_MoveIntoNewBase (employee_t *employee, base_t *newBase)
 	if (employee) {
 		base_t *oldBase = employee->baseHired;
 		assert(oldBase);
-		employee->baseHired = newBase;
+		E_SetBaseHired(employee, newBase);
 		/* Remove employee from corresponding capacity */
 		switch (employee->type) {
 		case EMPL_PILOT:
@@ -239,6 +360,7 @@ void E_ResetEmployees (void)
 	Com_DPrintf(DEBUG_CLIENT, "E_ResetEmployees: Delete all employees\n");
 	for (i = EMPL_SOLDIER; i < MAX_EMPL; i++)
 		LIST_Delete(&ccs.employees[i]);
+	E_ResetRegistry();
 }
 
 /**
@@ -258,6 +380,9 @@ int E_GetHiredEmployees (const base_t* const base, employeeType_t type, linkedLi
 
 	LIST_Delete(hiredEmployees);
 
+	if (!E_CountHired(base, type))
+		return 0;
+
 	E_Foreach(type, employee) {
 		if (!E_IsHired(employee))
 			continue;
@@ -295,6 +420,9 @@ static inline qboolean E_EmployeeIsUnassigned (const employee_t * employee)
  */
 employee_t* E_GetAssignedEmployee (const base_t* const base, const employeeType_t type)
 {
+	if (!employeesAssigned[base->idx][type])
+		return NULL;
+
 	E_Foreach(type, employee) {
 		if (!E_IsInBase(employee, base))
 			continue;
@@ -314,6 +442,9 @@ employee_t* E_GetAssignedEmployee (const base_t* const base, const employeeType_
  */
 employee_t* E_GetUnassignedEmployee (const base_t* const base, const employeeType_t type)
 {
+	if (!E_CountUnassigned(base, type))
+		return NULL;
+
 	E_Foreach(type, employee) {
 		if (!E_IsInBase(employee, base))
 			continue;
@@ -339,7 +470,7 @@ qboolean E_HireEmployee (base_t* base, employee_t* employee)
 
 	if (employee) {
 		/* Now uses quarter space. */
-		employee->baseHired = base;
+		E_SetBaseHired(employee, base);
 		/* Update other capacities */
 		switch (employee->type) {
 		case EMPL_WORKER:
@@ -410,7 +541,7 @@ qboolean E_UnhireEmployee (employee_t* employee)
 		 * should take place in E_RemoveEmployeeFromBuildingOrAircraft */
 		E_ResetEmployee(employee);
 		/* Set all employee-tags to 'unhired'. */
-		employee->baseHired = NULL;
+		E_SetBaseHired(employee, NULL);
 
 		/* Remove employee from corresponding capacity */
 		switch (employee->type) {
@@ -442,6 +573,9 @@ void E_UnhireAllEmployees (base_t* base, employeeType_t type)
 
 	assert(type < MAX_EMPL);
 
+	if (!employeesHired[base->idx][type])
+		return;
+
 	E_Foreach(type, employee) {
 		if (!E_IsInBase(employee, base))
 			continue;
@@ -502,7 +636,7 @@ employee_t* E_CreateEmployee (employeeType_t type, const nation_t *nation)
 
 	Com_DPrintf(DEBUG_CLIENT, "Generate character for type: %i\n", type);
 
-	return (employee_t*) LIST_Add(&ccs.employees[type], (void*) &employee, sizeof(employee))->data;
+	return E_LinkEmployee((employee_t*) LIST_Add(&ccs.employees[type], (void*) &employee, sizeof(employee))->data);
 }
 
 /**
@@ -538,6 +672,7 @@ qboolean E_DeleteEmployee (employee_t *employee)
 	}
 
 	/* Remove the employee from the global list. */
+	E_UnlinkEmployee(employee);
 	return LIST_Remove(&ccs.employees[type], (void*) employee);
 }
 
@@ -703,15 +838,9 @@ qboolean E_RemoveEmployeeFromBuildingOrAircraft (employee_t *employee)
  */
 int E_CountHired (const base_t* const base, employeeType_t type)
 {
-	int count = 0;
-
-	E_Foreach(type, employee) {
-		if (!E_IsHired(employee))
-			continue;
-		if (!base || E_IsInBase(employee, base))
-			count++;
-	}
-	return count;
+	if (!base)
+		return employeesHiredTotal[type];
+	return employeesHired[base->idx][type];
 }
 
 /**
@@ -742,13 +871,7 @@ int E_CountAllHired (const base_t* const base)
  */
 int E_CountUnhired (employeeType_t type)
 {
-	int count = 0;
-
-	E_Foreach(type, employee) {
-		if (!E_IsHired(employee))
-			count++;
-	}
-	return count;
+	return employeesUnhired[type];
 }
 
 /**
@@ -758,20 +881,10 @@ int E_CountUnhired (employeeType_t type)
  */
 int E_CountUnassigned (const base_t* const base, employeeType_t type)
 {
-	int count;
-
 	if (!base)
 		return 0;
 
-	count = 0;
-
-	E_Foreach(type, employee) {
-		if (!E_IsInBase(employee, base))
-			continue;
-		if (E_EmployeeIsUnassigned(employee))
-			count++;
-	}
-	return count;
+	return employeesHired[base->idx][type] - employeesAssigned[base->idx][type];
 }
 
 /**
@@ -853,10 +966,10 @@ static void CL_DebugNewEmployees_f (void)
  */
 employee_t* E_GetEmployeeByTypeFromChrUCN (employeeType_t type, int uniqueCharacterNumber)
 {
-	E_Foreach(type, employee) {
-		if (employee->chr.ucn == uniqueCharacterNumber)
-			return employee;
-	}
+	employee_t *employee = E_GetEmployeeFromChrUCN(uniqueCharacterNumber);
+
+	if (employee && employee->type == type)
+		return employee;
 
 	return NULL;
 }
@@ -867,11 +980,10 @@ employee_t* E_GetEmployeeByTypeFromChrUCN (employeeType_t type, int uniqueCharac
  */
 employee_t* E_GetEmployeeFromChrUCN (int uniqueCharacterNumber)
 {
-	employeeType_t emplType;
+	employee_t *employee;
 
-	for (emplType = EMPL_SOLDIER; emplType < MAX_EMPL; emplType++) {
-		employee_t *employee = E_GetEmployeeByTypeFromChrUCN(emplType, uniqueCharacterNumber);
-		if (employee)
+	for (employee = employeeHash[E_HashUCN(uniqueCharacterNumber)]; employee; employee = employee->hashNext) {
+		if (employee->chr.ucn == uniqueCharacterNumber)
 			return employee;
 	}
 
@@ -974,7 +1086,7 @@ qboolean E_LoadXML (xmlNode_t *p)
 				success = qfalse;
 				break;
 			}
-			LIST_Add(&ccs.employees[emplType], (void*) &e, sizeof(e));
+			E_LinkEmployee((employee_t*) LIST_Add(&ccs.employees[emplType], (void*) &e, sizeof(e))->data);
 		}
 		if (!success)
 			break;
@@ -1047,6 +1159,7 @@ void E_Shutdown (void)
 
 	for (employeeType = EMPL_SOLDIER; employeeType < MAX_EMPL; employeeType++)
 		LIST_Delete(&ccs.employees[employeeType]);
+	E_ResetRegistry();
 
 	E_ShutdownCallbacks();
 #ifdef DEBUG
@@ -59,6 +59,7 @@ typedef struct employee_s {
 	character_t chr;				/**< employee stats */
 	employeeType_t type;			/**< employee type */
 	const struct nation_s *nation;	/**< What nation this employee came from. This is NULL if the nation is unknown for some (code-related) reason. */
+	struct employee_s *hashNext;	/**< next employee in the ucn hash chain */
 } employee_t;
 
 void E_ResetEmployees(void);
@@ -89,6 +90,8 @@ employee_t* E_GetAssignedEmployee(const base_t* const base, employeeType_t type)
 employee_t* E_GetEmployeeFromChrUCN(int uniqueCharacterNumber);
 employee_t* E_GetEmployeeByTypeFromChrUCN(employeeType_t type, int uniqueCharacterNumber);
 qboolean E_MoveIntoNewBase(employee_t *employee, base_t *newBase);
+void E_SetBaseHired(employee_t *employee, base_t *base);
+void E_SetAssigned(employee_t *employee, qboolean assigned);
 
 int E_CountHired(const base_t* const base, employeeType_t type);
 int E_CountAllHired(const base_t* const base);
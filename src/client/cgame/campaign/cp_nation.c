@@ -49,17 +49,15 @@ nation_t *NAT_GetNationByIDX (const int index)
  */
 nation_t *NAT_GetNationByID (const char *nationID)
 {
-	int i;
+	nation_t *nation;
 
 	if (!nationID) {
 		Com_Printf("NAT_GetNationByID: NULL nationID\n");
 		return NULL;
 	}
-	for (i = 0; i < ccs.numNations; i++) {
-		nation_t *nation = NAT_GetNationByIDX(i);
-		if (Q_streq(nation->id, nationID))
-			return nation;
-	}
+	nation = IDT_Get(&ccs.nationsByID, nationID);
+	if (nation != NULL)
+		return nation;
 
 	Com_Printf("NAT_GetNationByID: Could not find nation '%s'\n", nationID);
 
@@ -331,6 +329,8 @@ void CL_ParseNations (const char *name, const char **text)
 
 		Com_DPrintf(DEBUG_CLIENT, "...found nation %s\n", name);
 		nation->id = Mem_PoolStrDup(name, cp_campaignPool, 0);
+		if (!IDT_Add(&ccs.nationsByID, nation->id, nation))
+			Com_Printf("CL_ParseNations: could not add \"%s\" to the lookup table\n", name);
 	}
 }
 
@@ -655,7 +655,7 @@ void RS_AssignScientist (technology_t* tech, base_t *base, employee_t *employee)
 			tech->scientists++;
 			tech->base = base;
 			CAP_AddCurrent(base, CAP_LABSPACE, 1);
-			employee->assigned = qtrue;
+			E_SetAssigned(employee, qtrue);
 		} else {
 			CP_Popup(_("Not enough laboratories"), _("No free space in laboratories left.\nBuild more laboratories.\n"));
 			return;
@@ -691,7 +691,7 @@ void RS_RemoveScientist (technology_t* tech, employee_t *employee)
 		tech->scientists--;
 		/* Update capacity. */
 		CAP_AddCurrent(tech->base, CAP_LABSPACE, -1);
-		employee->assigned = qfalse;
+		E_SetAssigned(employee, qfalse);
 	} else {
 		Com_Error(ERR_DROP, "No assigned scientists found - serious inconsistency.");
 	}
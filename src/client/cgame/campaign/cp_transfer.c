@@ -84,7 +84,7 @@ static void TR_EmptyTransferCargo (base_t *destination, transfer_t *transfer, qb
 			}
 			for (i = EMPL_SOLDIER; i < MAX_EMPL; i++) {
 				TR_ForeachEmployee(employee, transfer, i) {
-					employee->baseHired = transfer->srcBase;	/* Restore back the original baseid. */
+					E_SetBaseHired(employee, transfer->srcBase);	/* Restore back the original baseid. */
 					employee->transfer = qfalse;
 					E_UnhireEmployee(employee);
 				}
@@ -93,7 +93,7 @@ static void TR_EmptyTransferCargo (base_t *destination, transfer_t *transfer, qb
 			employeeType_t i;
 			for (i = EMPL_SOLDIER; i < MAX_EMPL; i++) {
 				TR_ForeachEmployee(employee, transfer, i) {
-					employee->baseHired = transfer->srcBase;	/* Restore back the original baseid. */
+					E_SetBaseHired(employee, transfer->srcBase);	/* Restore back the original baseid. */
 					employee->transfer = qfalse;
 					E_UnhireEmployee(employee);
 					E_HireEmployee(destination, employee);
@@ -321,7 +321,7 @@ transfer_t* TR_TransferStart (base_t *srcBase, transferData_t *transData)
 			transfer.hasEmployees = qtrue;
 			E_ResetEmployee(employee);
 			LIST_AddPointer(&transfer.employees[i], (void*) employee);
-			employee->baseHired = NULL;
+			E_SetBaseHired(employee, NULL);
 			employee->transfer = qtrue;
 		}
 	}
@@ -224,12 +224,44 @@ void GAME_SetServerInfo (const char *server, const char *serverport)
 	Q_strncpyz(cls.serverport, serverport, sizeof(cls.serverport));
 }
 
+/** @brief A masterserver query of the cgame that waits for its response */
+typedef struct masterServerQuery_s {
+	http_callback_t callback;	/**< @c NULL if the gametype was shut down in the meantime */
+	struct masterServerQuery_s *next;
+} masterServerQuery_t;
+
+static masterServerQuery_t *masterServerQueries;
+
+static void CL_QueryMasterServerResponse (const char *response, void *userdata)
+{
+	masterServerQuery_t *query = (masterServerQuery_t *)userdata;
+	masterServerQuery_t **anchor;
+
+	for (anchor = &masterServerQueries; *anchor; anchor = &(*anchor)->next) {
+		if (*anchor == query) {
+			*anchor = query->next;
+			break;
+		}
+	}
+
+	if (query->callback != NULL)
+		query->callback(response);
+	Mem_Free(query);
+}
+
 /**
+ * @note The query is asynchronous, the callback is called from the main loop once the
+ * masterserver answered - it is dropped if the gametype is shut down in the meantime
  * @sa CL_PingServers_f
  */
 static void CL_QueryMasterServer (const char *action, http_callback_t callback)
 {
-	HTTP_GetURL(va("%s/ufo/masterserver.php?%s", masterserver_url->string, action), callback);
+	masterServerQuery_t *query = Mem_AllocType(masterServerQuery_t);
+
+	query->callback = callback;
+	query->next = masterServerQueries;
+	masterServerQueries = query;
+	HTTP_GetURLAsync(va("%s/ufo/masterserver.php?%s", masterserver_url->string, action), CL_QueryMasterServerResponse, query, 0);
 }
 
 qboolean GAME_HandleServerCommand (const char *command, struct dbuffer *msg)
@@ -649,8 +681,13 @@ void GAME_SetMode (const cgame_export_t *gametype)
 
 	list = GAME_GetCurrentType();
 	if (list) {
+		masterServerQuery_t *query;
+
 		Com_Printf("Shutdown gametype '%s'\n", list->name);
 		list->Shutdown();
+		/* the pending masterserver queries must not call into the old gametype */
+		for (query = masterServerQueries; query; query = query->next)
+			query->callback = NULL;
 
 		/* we dont need to go back to "main" stack if we are already on this stack */
 		if (!UI_IsWindowOnStack("main"))
@@ -13,6 +13,11 @@
 #include "../renderer/r_draw.h"
 #include "../sound/s_main.h"
 #include "../sound/s_music.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
 
 #include <ogg/ogg.h>
 #include <vorbis/codec.h>
@@ -356,7 +361,69 @@ static inline byte CIN_THEORA_ClampByte (int value)
 	return value;
 }
 
-static void CIN_THEORA_FrameYUVtoRGB24 (const unsigned char* y, const unsigned char* u, const unsigned char* v, int width,
+/** the widest frame that is converted row by row - wider frames use the generic conversion */
+#define OGM_MAX_ROW_WIDTH 2048
+
+/**
+ * @brief Converts a row of a frame with luma in full resolution
+ * @param[in] cr The red chroma term for every pixel of the row
+ * @param[in] cg The green chroma term for every pixel of the row
+ * @param[in] cb The blue chroma term for every pixel of the row
+ * @note The vectorised conversion gives exactly the same result as the table based one - the terms
+ * fit into 16 bit and the luma table is (y << 6) | (y >> 2)
+ */
+static void CIN_THEORA_RowYUVtoRGB24 (const unsigned char* y, const short *cr, const short *cg, const short *cb, int width,
+		uint32_t* output)
+{
+	int i = 0;
+
+#if defined(__SSE2__)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i alpha = _mm_set1_epi8((char)255);
+		for (; i + 8 <= width; i += 8) {
+			const __m128i luma = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(y + i)), zero);
+			const __m128i yy = _mm_or_si128(_mm_slli_epi16(luma, 6), _mm_srli_epi16(luma, 2));
+			const __m128i r = _mm_srai_epi16(_mm_add_epi16(yy, _mm_loadu_si128((const __m128i *)(cr + i))), 6);
+			const __m128i g = _mm_srai_epi16(_mm_add_epi16(yy, _mm_loadu_si128((const __m128i *)(cg + i))), 6);
+			const __m128i b = _mm_srai_epi16(_mm_add_epi16(yy, _mm_loadu_si128((const __m128i *)(cb + i))), 6);
+			/* the saturation of the packing does the clamping */
+			const __m128i rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_packus_epi16(g, g));
+			const __m128i ba = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), alpha);
+			_mm_storeu_si128((__m128i *)(output + i), _mm_unpacklo_epi16(rg, ba));
+			_mm_storeu_si128((__m128i *)(output + i + 4), _mm_unpackhi_epi16(rg, ba));
+		}
+	}
+#elif defined(__ARM_NEON__)
+	for (; i + 8 <= width; i += 8) {
+		const int16x8_t luma = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y + i)));
+		const int16x8_t yy = vorrq_s16(vshlq_n_s16(luma, 6), vshrq_n_s16(luma, 2));
+		uint8x8x4_t rgba;
+		/* the saturation of the narrowing does the clamping */
+		rgba.val[0] = vqmovun_s16(vshrq_n_s16(vaddq_s16(yy, vld1q_s16(cr + i)), 6));
+		rgba.val[1] = vqmovun_s16(vshrq_n_s16(vaddq_s16(yy, vld1q_s16(cg + i)), 6));
+		rgba.val[2] = vqmovun_s16(vshrq_n_s16(vaddq_s16(yy, vld1q_s16(cb + i)), 6));
+		rgba.val[3] = vdup_n_u8(255);
+		vst4_u8((uint8_t *)(output + i), rgba);
+	}
+#endif
+
+	for (; i < width; i++) {
+		const long YY = ogmCin_yuvTable.yy[y[i]];
+		const byte r = CIN_THEORA_ClampByte((YY + cr[i]) >> 6);
+		const byte g = CIN_THEORA_ClampByte((YY + cg[i]) >> 6);
+		const byte b = CIN_THEORA_ClampByte((YY + cb[i]) >> 6);
+
+		output[i] = LittleLong(r | (g << 8) | (b << 16) | (255 << 24));
+	}
+}
+
+/**
+ * @brief Converts the frame pixel by pixel
+ * @note This is the reference for the row by row conversion and handles every chroma and luma layout
+ * @sa CIN_THEORA_FrameYUVtoRGB24
+ */
+static void CIN_THEORA_FrameYUVtoRGB24Generic (const unsigned char* y, const unsigned char* u, const unsigned char* v, int width,
 		int height, int y_stride, int uv_stride, int yWShift, int uvWShift, int yHShift, int uvHShift,
 		uint32_t* output)
 {
@@ -377,6 +444,58 @@ static void CIN_THEORA_FrameYUVtoRGB24 (const unsigned char* y, const unsigned c
 	}
 }
 
+static void CIN_THEORA_FrameYUVtoRGB24 (const unsigned char* y, const unsigned char* u, const unsigned char* v, int width,
+		int height, int y_stride, int uv_stride, int yWShift, int uvWShift, int yHShift, int uvHShift,
+		uint32_t* output)
+{
+	static short cr[OGM_MAX_ROW_WIDTH], cg[OGM_MAX_ROW_WIDTH], cb[OGM_MAX_ROW_WIDTH];
+	int uvRow = -1;
+	int i, j;
+
+	if (yWShift || yHShift || width > OGM_MAX_ROW_WIDTH) {
+		CIN_THEORA_FrameYUVtoRGB24Generic(y, u, v, width, height, y_stride, uv_stride, yWShift, uvWShift, yHShift,
+				uvHShift, output);
+		return;
+	}
+
+	for (j = 0; j < height; j++, output += width) {
+		/* the chroma terms are shared by all the rows of a subsampled chroma row */
+		if ((j >> uvHShift) != uvRow) {
+			const unsigned char *uRow, *vRow;
+
+			uvRow = j >> uvHShift;
+			uRow = u + uvRow * uv_stride;
+			vRow = v + uvRow * uv_stride;
+			for (i = 0; i < width; i++) {
+				const int uvI = i >> uvWShift;
+				cr[i] = ogmCin_yuvTable.vr[vRow[uvI]];
+				cg[i] = ogmCin_yuvTable.ug[uRow[uvI]] + ogmCin_yuvTable.vg[vRow[uvI]];
+				cb[i] = ogmCin_yuvTable.ub[uRow[uvI]];
+			}
+		}
+
+		CIN_THEORA_RowYUVtoRGB24(y + j * y_stride, cr, cg, cb, width, output);
+	}
+}
+
+#ifdef COMPILE_UNITTESTS
+/**
+ * @brief Converts a frame either row by row or pixel by pixel
+ * Only used for white box unittests that compare both conversions
+ */
+void CIN_THEORA_PrivateFrameYUVtoRGB24 (qboolean generic, const unsigned char* y, const unsigned char* u,
+		const unsigned char* v, int width, int height, int y_stride, int uv_stride, int yWShift, int uvWShift,
+		int yHShift, int uvHShift, uint32_t* output)
+{
+	if (generic)
+		CIN_THEORA_FrameYUVtoRGB24Generic(y, u, v, width, height, y_stride, uv_stride, yWShift, uvWShift, yHShift,
+				uvHShift, output);
+	else
+		CIN_THEORA_FrameYUVtoRGB24(y, u, v, width, height, y_stride, uv_stride, yWShift, uvWShift, yHShift,
+				uvHShift, output);
+}
+#endif
+
 static int CIN_THEORA_NextNeededFrame (cinematic_t *cin)
 {
 	return (int) (OGMCIN.currentTime * (ogg_int64_t) 10000 / OGMCIN.Vtime_unit);
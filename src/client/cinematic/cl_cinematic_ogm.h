@@ -35,4 +35,10 @@ qboolean CIN_OGM_RunCinematic(struct cinematic_s *cin);
 
 void CIN_OGM_Init(void);
 
+#if defined(COMPILE_UNITTESTS) && defined(HAVE_THEORA_THEORA_H)
+void CIN_THEORA_PrivateFrameYUVtoRGB24(qboolean generic, const unsigned char* y, const unsigned char* u,
+		const unsigned char* v, int width, int height, int y_stride, int uv_stride, int yWShift, int uvWShift,
+		int yHShift, int uvHShift, uint32_t* output);
+#endif
+
 #endif
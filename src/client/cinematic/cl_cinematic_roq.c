@@ -30,6 +30,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../renderer/r_draw.h"
 #include "../sound/s_main.h"
 #include "../sound/s_music.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
 
 typedef struct {
 	int vr[256];
@@ -117,6 +122,181 @@ static inline byte CIN_ROQ_ClampByte (int value)
 	return value;
 }
 
+/**
+ * @brief Writes the pixels of a 2x2 vector into the frame
+ * @param[in] width The width of the frame in pixels
+ * @sa CIN_ROQ_CopyVector2x2
+ */
+static inline void CIN_ROQ_CopyVector2x2Generic (unsigned int *dst, const unsigned int *src, int width)
+{
+	dst[0] = src[0];
+	dst[1] = src[1];
+
+	dst += width;
+
+	dst[0] = src[2];
+	dst[1] = src[3];
+}
+
+/**
+ * @brief Writes the pixels of a 2x2 vector doubled in both directions into the frame
+ * @param[in] width The width of the frame in pixels
+ * @sa CIN_ROQ_CopyVector4x4
+ */
+static inline void CIN_ROQ_CopyVector4x4Generic (unsigned int *dst, const unsigned int *src, int width)
+{
+	dst[0] = src[0];
+	dst[1] = src[0];
+	dst[2] = src[1];
+	dst[3] = src[1];
+
+	dst += width;
+
+	dst[0] = src[0];
+	dst[1] = src[0];
+	dst[2] = src[1];
+	dst[3] = src[1];
+
+	dst += width;
+
+	dst[0] = src[2];
+	dst[1] = src[2];
+	dst[2] = src[3];
+	dst[3] = src[3];
+
+	dst += width;
+
+	dst[0] = src[2];
+	dst[1] = src[2];
+	dst[2] = src[3];
+	dst[3] = src[3];
+}
+
+/**
+ * @brief Copies a square block of the previous frame into the frame
+ * @param[in] width The width of both frames in pixels
+ * @param[in] size The edge length of the block in pixels
+ */
+static inline void CIN_ROQ_CopyBlockGeneric (unsigned int *dst, const unsigned int *src, int width, int size)
+{
+	int i, j;
+
+	for (i = 0; i < size; i++, src += width, dst += width)
+		for (j = 0; j < size; j++)
+			dst[j] = src[j];
+}
+
+#if defined(__SSE2__) || defined(__ARM_NEON__)
+static inline void CIN_ROQ_CopyVector2x2 (unsigned int *dst, const unsigned int *src, int width)
+{
+#if defined(__SSE2__)
+	const __m128i v = _mm_loadu_si128((const __m128i *)src);
+
+	_mm_storel_epi64((__m128i *)dst, v);
+	_mm_storel_epi64((__m128i *)(dst + width), _mm_srli_si128(v, 8));
+#else
+	const uint32x4_t v = vld1q_u32(src);
+
+	vst1_u32(dst, vget_low_u32(v));
+	vst1_u32(dst + width, vget_high_u32(v));
+#endif
+}
+
+static inline void CIN_ROQ_CopyVector4x4 (unsigned int *dst, const unsigned int *src, int width)
+{
+	/* every pixel of the 2x2 vector is doubled in both directions */
+#if defined(__SSE2__)
+	const __m128i v = _mm_loadu_si128((const __m128i *)src);
+	const __m128i top = _mm_unpacklo_epi32(v, v);
+	const __m128i bottom = _mm_unpackhi_epi32(v, v);
+
+	_mm_storeu_si128((__m128i *)dst, top);
+	_mm_storeu_si128((__m128i *)(dst + width), top);
+	_mm_storeu_si128((__m128i *)(dst + 2 * width), bottom);
+	_mm_storeu_si128((__m128i *)(dst + 3 * width), bottom);
+#else
+	const uint32x4_t v = vld1q_u32(src);
+	const uint32x4x2_t doubled = vzipq_u32(v, v);
+
+	vst1q_u32(dst, doubled.val[0]);
+	vst1q_u32(dst + width, doubled.val[0]);
+	vst1q_u32(dst + 2 * width, doubled.val[1]);
+	vst1q_u32(dst + 3 * width, doubled.val[1]);
+#endif
+}
+
+static inline void CIN_ROQ_CopyBlock4x4 (unsigned int *dst, const unsigned int *src, int width)
+{
+	int i;
+
+	for (i = 0; i < 4; i++, src += width, dst += width) {
+#if defined(__SSE2__)
+		_mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+#else
+		vst1q_u32(dst, vld1q_u32(src));
+#endif
+	}
+}
+
+static inline void CIN_ROQ_CopyBlock8x8 (unsigned int *dst, const unsigned int *src, int width)
+{
+	int i;
+
+	for (i = 0; i < 8; i++, src += width, dst += width) {
+#if defined(__SSE2__)
+		_mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+		_mm_storeu_si128((__m128i *)(dst + 4), _mm_loadu_si128((const __m128i *)(src + 4)));
+#else
+		vst1q_u32(dst, vld1q_u32(src));
+		vst1q_u32(dst + 4, vld1q_u32(src + 4));
+#endif
+	}
+}
+#else
+#define CIN_ROQ_CopyVector2x2 CIN_ROQ_CopyVector2x2Generic
+#define CIN_ROQ_CopyVector4x4 CIN_ROQ_CopyVector4x4Generic
+#define CIN_ROQ_CopyBlock4x4(dst, src, width) CIN_ROQ_CopyBlockGeneric((dst), (src), (width), 4)
+#define CIN_ROQ_CopyBlock8x8(dst, src, width) CIN_ROQ_CopyBlockGeneric((dst), (src), (width), 8)
+#endif
+
+#ifdef COMPILE_UNITTESTS
+/**
+ * @brief Runs one of the block copies of the decoder
+ * Only used for white box unittests that compare the vectorised copies with the generic ones
+ */
+void CIN_ROQ_PrivateCopyBlock (roqBlockCopy_t type, qboolean generic, unsigned int *dst, const unsigned int *src, int width)
+{
+	switch (type) {
+	case ROQ_COPY_VECTOR2X2:
+		if (generic)
+			CIN_ROQ_CopyVector2x2Generic(dst, src, width);
+		else
+			CIN_ROQ_CopyVector2x2(dst, src, width);
+		break;
+	case ROQ_COPY_VECTOR4X4:
+		if (generic)
+			CIN_ROQ_CopyVector4x4Generic(dst, src, width);
+		else
+			CIN_ROQ_CopyVector4x4(dst, src, width);
+		break;
+	case ROQ_COPY_MOTION4X4:
+		if (generic)
+			CIN_ROQ_CopyBlockGeneric(dst, src, width, 4);
+		else
+			CIN_ROQ_CopyBlock4x4(dst, src, width);
+		break;
+	case ROQ_COPY_MOTION8X8:
+		if (generic)
+			CIN_ROQ_CopyBlockGeneric(dst, src, width, 8);
+		else
+			CIN_ROQ_CopyBlock8x8(dst, src, width);
+		break;
+	default:
+		break;
+	}
+}
+#endif
+
 /**
  * @sa CIN_ROQ_DecodeVideo
  */
@@ -130,13 +310,7 @@ static void CIN_ROQ_ApplyVector2x2 (cinematic_t *cin, int x, int y, const byte *
 		const unsigned int *src = (const unsigned int *)ROQCIN.quadVectors + (indices[i] * 4);
 		unsigned int *dst = (unsigned int *)ROQCIN.frameBuffer[0] + (yp * ROQCIN.frameWidth + xp);
 
-		dst[0] = src[0];
-		dst[1] = src[1];
-
-		dst += ROQCIN.frameWidth;
-
-		dst[0] = src[2];
-		dst[1] = src[3];
+		CIN_ROQ_CopyVector2x2(dst, src, ROQCIN.frameWidth);
 	}
 }
 
@@ -153,31 +327,7 @@ static void CIN_ROQ_ApplyVector4x4 (cinematic_t *cin, int x, int y, const byte *
 		const unsigned int *src = (const unsigned int *)ROQCIN.quadVectors + (indices[i] * 4);
 		unsigned int *dst = (unsigned int *)ROQCIN.frameBuffer[0] + (yp * ROQCIN.frameWidth + xp);
 
-		dst[0] = src[0];
-		dst[1] = src[0];
-		dst[2] = src[1];
-		dst[3] = src[1];
-
-		dst += ROQCIN.frameWidth;
-
-		dst[0] = src[0];
-		dst[1] = src[0];
-		dst[2] = src[1];
-		dst[3] = src[1];
-
-		dst += ROQCIN.frameWidth;
-
-		dst[0] = src[2];
-		dst[1] = src[2];
-		dst[2] = src[3];
-		dst[3] = src[3];
-
-		dst += ROQCIN.frameWidth;
-
-		dst[0] = src[2];
-		dst[1] = src[2];
-		dst[2] = src[3];
-		dst[3] = src[3];
+		CIN_ROQ_CopyVector4x4(dst, src, ROQCIN.frameWidth);
 	}
 }
 
@@ -186,18 +336,12 @@ static void CIN_ROQ_ApplyVector4x4 (cinematic_t *cin, int x, int y, const byte *
  */
 static void CIN_ROQ_ApplyMotion4x4 (cinematic_t *cin, int x, int y, int mx, int my, int mv)
 {
-	int i;
 	const int xp = x + 8 - (mv >> 4) - mx;
 	const int yp = y + 8 - (mv & 15) - my;
 	const unsigned int *src = (const unsigned int *)ROQCIN.frameBuffer[1] + (yp * ROQCIN.frameWidth + xp);
 	unsigned int *dst = (unsigned int *)ROQCIN.frameBuffer[0] + (y * ROQCIN.frameWidth + x);
 
-	for (i = 0; i < 4; i++, src += ROQCIN.frameWidth, dst += ROQCIN.frameWidth) {
-		dst[0] = src[0];
-		dst[1] = src[1];
-		dst[2] = src[2];
-		dst[3] = src[3];
-	}
+	CIN_ROQ_CopyBlock4x4(dst, src, ROQCIN.frameWidth);
 }
 
 /**
@@ -205,22 +349,12 @@ static void CIN_ROQ_ApplyMotion4x4 (cinematic_t *cin, int x, int y, int mx, int
  */
 static void CIN_ROQ_ApplyMotion8x8 (cinematic_t *cin, int x, int y, int mx, int my, int mv)
 {
-	int i;
 	const int xp = x + 8 - (mv >> 4) - mx;
 	const int yp = y + 8 - (mv & 15) - my;
 	const unsigned int *src = (const unsigned int *)ROQCIN.frameBuffer[1] + (yp * ROQCIN.frameWidth + xp);
 	unsigned int *dst = (unsigned int *)ROQCIN.frameBuffer[0] + (y * ROQCIN.frameWidth + x);
 
-	for (i = 0; i < 8; i++, src += ROQCIN.frameWidth, dst += ROQCIN.frameWidth) {
-		dst[0] = src[0];
-		dst[1] = src[1];
-		dst[2] = src[2];
-		dst[3] = src[3];
-		dst[4] = src[4];
-		dst[5] = src[5];
-		dst[6] = src[6];
-		dst[7] = src[7];
-	}
+	CIN_ROQ_CopyBlock8x8(dst, src, ROQCIN.frameWidth);
 }
 
 /**
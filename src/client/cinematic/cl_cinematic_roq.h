@@ -35,4 +35,18 @@ qboolean CIN_ROQ_RunCinematic(struct cinematic_s *cin);
 
 void CIN_ROQ_Init(void);
 
+#ifdef COMPILE_UNITTESTS
+/** @brief The block copies of the decoder */
+typedef enum {
+	ROQ_COPY_VECTOR2X2,
+	ROQ_COPY_VECTOR4X4,
+	ROQ_COPY_MOTION4X4,
+	ROQ_COPY_MOTION8X8,
+
+	ROQ_COPY_MAX
+} roqBlockCopy_t;
+
+void CIN_ROQ_PrivateCopyBlock(roqBlockCopy_t type, qboolean generic, unsigned int *dst, const unsigned int *src, int width);
+#endif
+
 #endif
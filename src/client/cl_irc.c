@@ -1825,7 +1825,7 @@ static void Irc_Client_Kick_f (void)
 		Com_Printf("Usage: %s <channel> <nick> [<reason>]\n", Cmd_Argv(0));
 }
 
-static void Irc_GetExternalIP (const char *externalIP)
+static void Irc_GetExternalIP (const char *externalIP, void *userdata)
 {
 	const irc_user_t *user;
 	char buf[128];
@@ -1864,7 +1864,7 @@ static void Irc_Client_Invite_f (void)
 		return;
 	}
 
-	HTTP_GetURL(va("%s/ufo/masterserver.php?ip", masterserver_url->string), Irc_GetExternalIP);
+	HTTP_GetURLAsync(va("%s/ufo/masterserver.php?ip", masterserver_url->string), Irc_GetExternalIP, NULL, 0);
 }
 
 static void Irc_Client_Who_f (void)
@@ -99,6 +99,7 @@ typedef struct {
 typedef struct ptlCmd_s {
 	byte cmd;	/**< the type of the command - @sa pc_t */
 	byte type;	/**< the type of the data refereced by this particle command */
+	byte size;	/**< size of the copied data for the compiled set command - @sa CL_CompilePtlCmds */
 	int ref;	/**< This is the location of the data for this particle command. If negative this is relative
 				 * to the particle, otherwise relative to particle command hunk */
 } ptlCmd_t;
@@ -110,6 +111,12 @@ typedef struct ptlDef_s {
 	ptlCmd_t *think;	/**< depends on the tps value of the particle */
 	ptlCmd_t *round;	/**< called for each ended round */
 	ptlCmd_t *physics;	/**< called when the particle origin hits something solid */
+	/* the functions above compiled with @c CL_CompileParticleFunction - @c NULL if they are interpreted */
+	struct ptlOp_s *initOps;
+	struct ptlOp_s *runOps;
+	struct ptlOp_s *thinkOps;
+	struct ptlOp_s *roundOps;
+	struct ptlOp_s *physicsOps;
 } ptlDef_t;
 
 /** @brief particle art type */
@@ -29,12 +29,18 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../../shared/utf8.h"
 
 #define MAX_CACHE_STRING	128
-#define MAX_CHUNK_CACHE		1024 /* making this bigger uses more GL textures */
+#define MAX_CHUNK_CACHE		1024 /* making this bigger uses more memory */
 #define MAX_WRAP_CACHE		1024 /* making this bigger uses more memory */
 #define MAX_WRAP_HASH		4096 /* making this bigger reduces collisions */
 #define MAX_FONTS			16
 #define MAX_FONTNAME		32
 #define MAX_TRUNCMARKER		16   /* enough for 3 chinese chars */
+#define MAX_FONT_GLYPHS		1024 /* glyph slots per font - must be a power of two */
+#define MAX_FONT_QUADS		512  /* glyphs per draw call */
+#define FONT_ATLAS_SIZE		512  /* width and height of the glyph texture of one font */
+#define FONT_KERNING_FIRST	32   /* kerning pairs are only cached for printable ascii */
+#define FONT_KERNING_CHARS	95
+#define FONT_KERNING_UNKNOWN	-128
 
 #define BUF_SIZE 4096
 
@@ -52,19 +58,16 @@ typedef struct {
 	int width;		/**< text chunk rendered width in pixels */
 	/* no need for individual line height, just use font->height */
 	qboolean truncated;	/**< needs ellipsis after text */
-	vec2_t texsize;	/**< texture width and height */
-	GLuint texnum;	/**< bound texture ID (0 if not textured yet) */
 } chunkCache_t;
 
 /**
  * @brief This structure caches information about rendering a text
  * in one font wrapped to a specific width. It points to structures
- * in the chunkCache that cache detailed information and the textures used.
+ * in the chunkCache that cache detailed information about the lines.
  *
- * @note Caching text-wrapping information is particularly important
- * for Cyrillic and possibly other non-ascii text, where TTF_SizeUTF8()
- * is almost as slow as rendering. Intro sequence went from 4 fps to 50
- * after introducing the wrapCache.
+ * @note The wrapping itself only works on the cached glyph metrics, the
+ * cache just saves the walk over the text for strings that are drawn
+ * every frame.
  */
 typedef struct wrapCache_s {
 	char text[MAX_CACHE_STRING];	/**< hash id */
@@ -78,8 +81,63 @@ typedef struct wrapCache_s {
 	qboolean aborted;	/**< true if we can't finish the chunk generation */
 } wrapCache_t;
 
+/**
+ * @brief A rendered character of a font and its metrics
+ * @note The metrics are also used for fonts that are never drawn (e.g. to
+ * layout the text in the unittests), the image is only rendered into the
+ * atlas when the glyph is drawn the first time.
+ */
+typedef struct fontGlyph_s {
+	int codepoint;		/**< 0 marks an unused slot */
+	short advance;		/**< horizontal distance to the pen position of the next glyph */
+	short left;			/**< offset of the glyph image to the pen position (<= 0) */
+	short width;		/**< width of the glyph image in pixels */
+	short height;		/**< height of the glyph image in the atlas, 0 for empty glyphs */
+	short s, t;			/**< position of the glyph image in the atlas */
+	qboolean rendered;	/**< the glyph image was already rendered into the atlas */
+} fontGlyph_t;
+
+/**
+ * @brief Glyph cache and texture atlas of one font (and thus one size)
+ * @note The glyphs are packed in rows (shelves) into the atlas. If the atlas or the
+ * glyph table runs full, all glyphs are dropped and rendered again on demand.
+ */
+typedef struct fontAtlas_s {
+	fontGlyph_t glyphs[MAX_FONT_GLYPHS];	/**< open addressing hash table keyed by the codepoint */
+	int numGlyphs;
+	signed char kerning[FONT_KERNING_CHARS][FONT_KERNING_CHARS];	/**< pair adjustments, filled on demand */
+	GLuint texnum;		/**< 0 until the first glyph of this font is drawn */
+	int packX, packY;	/**< next free position in the atlas */
+	int shelfHeight;	/**< height of the current row of glyphs in the atlas */
+} fontAtlas_t;
+
+/**
+ * @brief Position in a line of text while walking over the glyphs
+ */
+typedef struct fontPen_s {
+	int x;			/**< pen position */
+	int right;		/**< rightmost pixel covered by a glyph so far - the width of the text */
+	int prev;		/**< previous character for kerning, 0 at the start of the line */
+} fontPen_t;
+
 static int numFonts = 0;
 static font_t fonts[MAX_FONTS];
+static fontAtlas_t fontAtlases[MAX_FONTS];
+
+/**
+ * @brief Glyph quads of one font that are waiting to be drawn in one batch
+ */
+static struct {
+	const fontAtlas_t *atlas;
+	int numQuads;
+#ifdef HAVE_GLES
+	GLshort verts[MAX_FONT_QUADS * 12];
+	GLfloat texcoords[MAX_FONT_QUADS * 12];
+#else
+	GLshort verts[MAX_FONT_QUADS * 8];
+	GLfloat texcoords[MAX_FONT_QUADS * 8];
+#endif
+} r_glyph_arrays;
 
 static chunkCache_t chunkCache[MAX_CHUNK_CACHE];
 static wrapCache_t wrapCache[MAX_WRAP_CACHE];
@@ -116,22 +174,10 @@ void R_FontSetTruncationMarker (const char *marker)
 
 
 /**
- * @brief Clears font cache and frees memory associated with the cache
+ * @brief Clears the wrap and chunk cache
  */
 static void R_FontCleanCache (void)
 {
-	int i;
-
-	R_CheckError();
-
-	/* free the surfaces */
-	for (i = 0; i < numChunks; i++) {
-		if (!chunkCache[i].texnum)
-			continue;
-		glDeleteTextures(1, &(chunkCache[i].texnum));
-		R_CheckError();
-	}
-
 	OBJZERO(chunkCache);
 	OBJZERO(wrapCache);
 	OBJZERO(hash);
@@ -149,14 +195,20 @@ void R_FontShutdown (void)
 
 	R_FontCleanCache();
 
-	for (i = 0; i < numFonts; i++)
+	for (i = 0; i < numFonts; i++) {
 		if (fonts[i].font) {
 			TTF_CloseFont(fonts[i].font);
 			FS_FreeFile(fonts[i].buffer);
 			SDL_RWclose(fonts[i].rw);
 		}
+		if (fontAtlases[i].texnum) {
+			glDeleteTextures(1, &fontAtlases[i].texnum);
+			R_CheckError();
+		}
+	}
 
 	OBJZERO(fonts);
+	OBJZERO(fontAtlases);
 	numFonts = 0;
 
 	/* now quit SDL_ttf, too */
@@ -177,6 +229,8 @@ static font_t *R_FontAnalyze (const char *name, const char *path, int renderStyl
 	/* allocate new font */
 	f = &fonts[numFonts];
 	OBJZERO(*f);
+	OBJZERO(fontAtlases[numFonts]);
+	memset(fontAtlases[numFonts].kerning, FONT_KERNING_UNKNOWN, sizeof(fontAtlases[numFonts].kerning));
 
 	/* copy fontname */
 	f->name = name;
@@ -242,6 +296,11 @@ void R_FontListCache_f (void)
 	Com_Printf("Font cache info\n========================\n");
 	Com_Printf("...wrap cache size: %i - used %i\n", MAX_WRAP_CACHE, numWraps);
 	Com_Printf("...chunk cache size: %i - used %i\n", MAX_CHUNK_CACHE, numChunks);
+	for (i = 0; i < numFonts; i++) {
+		const fontAtlas_t *atlas = &fontAtlases[i];
+		Com_Printf("...font %s: %i glyphs, atlas %s (%i/%i rows used)\n", fonts[i].name, atlas->numGlyphs,
+				atlas->texnum ? "uploaded" : "not uploaded", atlas->packY + atlas->shelfHeight, FONT_ATLAS_SIZE);
+	}
 
 	for (i = 0; i < numWraps; i++) {
 		const wrapCache_t *wrap = &wrapCache[i];
@@ -274,80 +333,237 @@ static int R_FontHash (const char *string)
 }
 
 /**
- * @brief Calculate the width in pixels needed to render a piece of text.
- * Can temporarily modify the caller's string but leaves it unchanged.
+ * @brief Draws the queued glyph quads
+ * @note Must be called before the atlas they refer to changes
+ * @sa R_FontQueueGlyph
+ */
+static void R_FontFlushGlyphs (void)
+{
+	if (!r_glyph_arrays.numQuads)
+		return;
+
+	R_BindTexture(r_glyph_arrays.atlas->texnum);
+
+	R_BindArray(GL_TEXTURE_COORD_ARRAY, GL_FLOAT, r_glyph_arrays.texcoords);
+	glVertexPointer(2, GL_SHORT, 0, r_glyph_arrays.verts);
+
+#ifdef HAVE_GLES
+	glDrawArrays(GL_TRIANGLES, 0, r_glyph_arrays.numQuads * 6);
+#else
+	glDrawArrays(GL_QUADS, 0, r_glyph_arrays.numQuads * 4);
+#endif
+
+	refdef.batchCount++;
+
+	r_glyph_arrays.numQuads = 0;
+	r_glyph_arrays.atlas = NULL;
+
+	/* and restore them */
+	R_BindDefaultArray(GL_TEXTURE_COORD_ARRAY);
+	R_BindDefaultArray(GL_VERTEX_ARRAY);
+}
+
+/**
+ * @brief Drops all glyphs of a font, they are measured and rendered again on demand
  */
-static int R_FontChunkLength (const font_t *f, char *text, int len)
+static void R_FontResetGlyphs (fontAtlas_t *atlas)
 {
-	int width;
-	char old;
+	if (r_glyph_arrays.atlas == atlas)
+		R_FontFlushGlyphs();
 
-	if (len == 0)
+	OBJZERO(atlas->glyphs);
+	atlas->numGlyphs = 0;
+	atlas->packX = atlas->packY = atlas->shelfHeight = 0;
+}
+
+static inline fontAtlas_t *R_FontGetAtlas (const font_t *f)
+{
+	return &fontAtlases[f - fonts];
+}
+
+/**
+ * @brief Looks up the metrics of a character and measures it if it is not yet in the glyph cache
+ * @note The returned pointer is only valid until the next lookup for this font
+ */
+static fontGlyph_t *R_FontGetGlyph (const font_t *f, int codepoint)
+{
+	fontAtlas_t *atlas = R_FontGetAtlas(f);
+	fontGlyph_t *glyph;
+	char buf[8] = "";
+	int minx, maxx, miny, maxy, advance, width;
+	int slot;
+
+	/* SDL_ttf only knows the basic multilingual plane */
+	if (codepoint <= 0 || codepoint > 0xFFFF)
+		codepoint = '?';
+
+	for (slot = codepoint & (MAX_FONT_GLYPHS - 1);; slot = (slot + 1) & (MAX_FONT_GLYPHS - 1)) {
+		glyph = &atlas->glyphs[slot];
+		if (glyph->codepoint == codepoint)
+			return glyph;
+		if (!glyph->codepoint)
+			break;
+	}
+
+	/* keep the probe chains short */
+	if (atlas->numGlyphs >= MAX_FONT_GLYPHS * 3 / 4) {
+		R_FontResetGlyphs(atlas);
+		glyph = &atlas->glyphs[codepoint & (MAX_FONT_GLYPHS - 1)];
+	}
+
+	UTF8_insert_char(buf, sizeof(buf), 0, codepoint);
+	if (TTF_GlyphMetrics(f->font, codepoint, &minx, &maxx, &miny, &maxy, &advance) == -1)
+		minx = advance = 0;
+	if (TTF_SizeUTF8(f->font, buf, &width, NULL) == -1)
+		width = 0;
+
+	glyph->codepoint = codepoint;
+	glyph->advance = advance;
+	glyph->left = min(minx, 0);
+	glyph->width = width;
+	atlas->numGlyphs++;
+
+	return glyph;
+}
+
+/**
+ * @brief Pair adjustment between two characters
+ * @note There is no portable way to get the kerning of a pair out of SDL_ttf,
+ * so it is measured once per pair by comparing the size of the pair with the
+ * size of the two glyphs placed without kerning. Only pairs of printable ascii
+ * characters are kerned.
+ */
+static int R_FontKerning (const font_t *f, int prev, int codepoint)
+{
+	fontAtlas_t *atlas = R_FontGetAtlas(f);
+	const unsigned int i = prev - FONT_KERNING_FIRST;
+	const unsigned int j = codepoint - FONT_KERNING_FIRST;
+	signed char *kerning;
+
+	if (i >= FONT_KERNING_CHARS || j >= FONT_KERNING_CHARS)
 		return 0;
 
-	old = text[len];
-	text[len] = '\0';
-	TTF_SizeUTF8(f->font, text, &width, NULL);
-	text[len] = old;
+	kerning = &atlas->kerning[i][j];
+	if (*kerning == FONT_KERNING_UNKNOWN) {
+		const char buf[3] = {prev, codepoint, '\0'};
+		const fontGlyph_t *glyph;
+		int x, right, width;
+
+		glyph = R_FontGetGlyph(f, prev);
+		x = -glyph->left;
+		right = glyph->width;
+		x += glyph->advance;
+		glyph = R_FontGetGlyph(f, codepoint);
+		right = max(right, x + glyph->left + glyph->width);
+
+		if (TTF_SizeUTF8(f->font, buf, &width, NULL) == -1)
+			width = right;
+		*kerning = max(min(width - right, 127), -127);
+	}
 
-	return width;
+	return *kerning;
+}
+
+/**
+ * @brief Moves the pen over the next character of a line
+ * @return The glyph of the character - only valid until the next glyph lookup of this font
+ */
+static const fontGlyph_t *R_FontAdvancePen (const font_t *f, fontPen_t *pen, int codepoint)
+{
+	const fontGlyph_t *glyph;
+
+	if (pen->prev)
+		pen->x += R_FontKerning(f, pen->prev, codepoint);
+	glyph = R_FontGetGlyph(f, codepoint);
+
+	/* the first glyph is moved right if it would start left of the text */
+	if (!pen->prev)
+		pen->x = -glyph->left;
+
+	pen->right = max(pen->right, pen->x + glyph->left + glyph->width);
+	pen->x += glyph->advance;
+	pen->prev = codepoint;
+
+	return glyph;
+}
+
+/**
+ * @brief Moves the pen over the given text
+ * @param[in] len Length of the text in bytes
+ */
+static void R_FontAdvancePenText (const font_t *f, fontPen_t *pen, const char *text, int len)
+{
+	const char *end = text + len;
+
+	while (text < end && text[0] != '\0')
+		R_FontAdvancePen(f, pen, UTF8_next(&text));
+}
+
+/**
+ * @brief Calculate the width in pixels needed to render a piece of text.
+ */
+static int R_FontChunkLength (const font_t *f, const char *text, int len)
+{
+	fontPen_t pen;
+
+	OBJZERO(pen);
+	R_FontAdvancePenText(f, &pen, text, len);
+
+	return pen.right;
 }
 
 /**
  * @brief Find longest part of text that fits in maxWidth pixels,
  * with a clean break such as at a word boundary.
- * Can temporarily modify the caller's string but leaves it unchanged.
  * Assumes whole string won't fit.
  * @param[out] widthp Pixel width of part that fits.
  * @return String length of part that fits.
  */
-static int R_FontFindFit (const font_t *f, char *text, int maxlen, int maxWidth, int *widthp)
+static int R_FontFindFit (const font_t *f, const char *text, int maxlen, int maxWidth, int *widthp)
 {
-	int bestbreak = 0;
-	int width;
-	int len;
+	int wordbreak = 0, wordwidth = 0;
+	int charbreak = 0, charwidth = 0;
+	fontPen_t pen;
+	const char *c = text;
 
 	*widthp = 0;
-
-	/* Fit whole words */
-	for (len = 1; len < maxlen; len++) {
-		if (text[len] == ' ') {
-			width = R_FontChunkLength(f, text, len);
-			if (width > maxWidth)
-				break;
-			bestbreak = len;
-			*widthp = width;
+	OBJZERO(pen);
+
+	/* the text width only grows, so the walk can stop at the first position that doesn't fit */
+	while (c < text + maxlen) {
+		const int pos = c - text;
+		const int codepoint = UTF8_next(&c);
+
+		if (pos > 0) {
+			/* Fit whole words */
+			if (codepoint == ' ') {
+				wordbreak = pos;
+				wordwidth = pen.right;
+			}
+			/** @todo Smart breaking of Chinese text */
+			charbreak = pos;
+			charwidth = pen.right;
 		}
-	}
 
-	/* Fit hyphenated word parts */
-	for (len = bestbreak + 1; len < maxlen; len++) {
-		if (text[len] == '-') {
-			width = R_FontChunkLength(f, text, len + 1);
-			if (width > maxWidth)
-				break;
-			bestbreak = len + 1;
-			*widthp = width;
+		R_FontAdvancePen(f, &pen, codepoint);
+		if (pen.right > maxWidth)
+			break;
+
+		/* Fit hyphenated word parts */
+		if (codepoint == '-' && pos > 0) {
+			wordbreak = c - text;
+			wordwidth = pen.right;
 		}
 	}
 
-	if (bestbreak > 0)
-		return bestbreak;
-
-	/** @todo Smart breaking of Chinese text */
-
-	/* Can't fit even one word. Break first word anywhere. */
-	for (len = 1; len < maxlen; len++) {
-		if (UTF8_CONTINUATION_BYTE(text[len]))
-			continue;
-		width = R_FontChunkLength(f, text, len);
-		if (width > maxWidth)
-			break;
-		bestbreak = len;
-		*widthp = width;
+	if (wordbreak > 0) {
+		*widthp = wordwidth;
+		return wordbreak;
 	}
 
-	return bestbreak;
+	/* Can't fit even one word. Break first word anywhere. */
+	*widthp = charwidth;
+	return charbreak;
 }
 
 /**
@@ -358,27 +574,30 @@ static int R_FontFindFit (const font_t *f, char *text, int maxlen, int maxWidth,
  */
 static int R_FontFindTruncFit (const font_t *f, const char *text, int maxlen, int maxWidth, qboolean mark, int *widthp)
 {
-	char buf[BUF_SIZE];
-	int width;
-	int len;
-	int breaklen;
+	int breaklen = 0;
+	fontPen_t pen;
+	const char *c = text;
 
-	breaklen = 0;
 	*widthp = 0;
+	OBJZERO(pen);
 
-	for (len = 1; len < maxlen; len++) {
-		buf[len - 1] = text[len - 1];
-		if (UTF8_CONTINUATION_BYTE(text[len]))
-			continue;
-		if (mark)
-			Q_strncpyz(&buf[len], truncmarker, sizeof(buf) - len);
-		else
-			buf[len] = '\0';
-		TTF_SizeUTF8(f->font, buf, &width, NULL);
-		if (width > maxWidth)
-			return breaklen;
-		breaklen = len;
-		*widthp = width;
+	while (c < text + maxlen) {
+		R_FontAdvancePen(f, &pen, UTF8_next(&c));
+		if (c >= text + maxlen)
+			break;
+
+		if (mark) {
+			fontPen_t marked = pen;
+			R_FontAdvancePenText(f, &marked, truncmarker, sizeof(truncmarker));
+			if (marked.right > maxWidth)
+				return breaklen;
+			*widthp = marked.right;
+		} else {
+			if (pen.right > maxWidth)
+				return breaklen;
+			*widthp = pen.right;
+		}
+		breaklen = c - text;
 	}
 
 	return maxlen;
@@ -564,23 +783,74 @@ void R_FontTextSize (const char *fontId, const char *text, int maxWidth, longlin
 }
 
 /**
- * @brief Renders the text surface and converts to 32bit SDL_Surface that is stored in font_t structure
- * @sa R_FontCacheGLSurface
+ * @brief Creates the (empty) atlas texture of a font
+ */
+static void R_FontCreateAtlas (fontAtlas_t *atlas)
+{
+#ifdef HAVE_GLES
+	const int samples = GL_RGBA;
+#else
+	/* the glyphs are updated with glTexSubImage2D - so no compressed format here */
+	const int samples = r_config.gl_alpha_format;
+#endif
+	byte *pixels = (byte *)Mem_Alloc(FONT_ATLAS_SIZE * FONT_ATLAS_SIZE * 4);
+
+	glGenTextures(1, &atlas->texnum);
+	R_BindTexture(atlas->texnum);
+	glTexImage2D(GL_TEXTURE_2D, 0, samples, FONT_ATLAS_SIZE, FONT_ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	R_CheckError();
+
+	Mem_Free(pixels);
+}
+
+/**
+ * @brief Reserves space for a glyph image in the atlas
+ * @note Every glyph gets a one pixel border to the next one to not filter into it
+ * @return @c false if the atlas is full
+ */
+static qboolean R_FontPackGlyph (fontAtlas_t *atlas, int w, int h, int *s, int *t)
+{
+	if (w + 1 > FONT_ATLAS_SIZE || h + 1 > FONT_ATLAS_SIZE)
+		return qfalse;
+
+	/* start a new row */
+	if (atlas->packX + w + 1 > FONT_ATLAS_SIZE) {
+		atlas->packX = 0;
+		atlas->packY += atlas->shelfHeight;
+		atlas->shelfHeight = 0;
+	}
+	if (atlas->packY + h + 1 > FONT_ATLAS_SIZE)
+		return qfalse;
+
+	*s = atlas->packX;
+	*t = atlas->packY;
+	atlas->packX += w + 1;
+	atlas->shelfHeight = max(atlas->shelfHeight, h + 1);
+
+	return qtrue;
+}
+
+/**
+ * @brief Renders a glyph into the atlas of its font if this wasn't done yet
+ * @note The glyph is rendered as a text of its own, so the image starts at the
+ * left side of the glyph (or the pen position) and covers the whole line height.
+ * @return The glyph or @c NULL if it can't be drawn at all
  * @sa TTF_RenderUTF8_Blended
  * @sa SDL_CreateRGBSurface
  * @sa SDL_LowerBlit
- * @sa SDL_FreeSurface
  */
-static void R_FontGenerateTexture (const font_t *font, const char *text, chunkCache_t *chunk)
+static const fontGlyph_t *R_FontRenderGlyph (const font_t *f, int codepoint)
 {
-	int w, h;
+	fontAtlas_t *atlas = R_FontGetAtlas(f);
+	fontGlyph_t *glyph = R_FontGetGlyph(f, codepoint);
 	SDL_Surface *textSurface;
 	SDL_Surface *openGLSurface;
 	SDL_Rect rect = {0, 0, 0, 0};
-	char buf[BUF_SIZE];
+	char buf[8] = "";
+	int s, t;
 	static const SDL_Color color = {255, 255, 255, 0};	/* The 4th value is unused */
-	const int samples = r_config.gl_compressed_alpha_format ? r_config.gl_compressed_alpha_format : r_config.gl_alpha_format;
-	int colordepth = 32;
 #ifdef HAVE_GLES
 	int pixelFormat = GL_RGBA;
 #else
@@ -605,36 +875,38 @@ static void R_FontGenerateTexture (const font_t *font, const char *text, chunkCa
 	Uint32 amask = 0xff000000;
 #endif
 
-	if (chunk->texnum != 0)
-		return;  /* already generated */
-
-	assert(strlen(text) >= chunk->pos + chunk->len);
-	if (chunk->len >= sizeof(buf))
-		return;
-	memcpy(buf, &text[chunk->pos], chunk->len);
-	buf[chunk->len] = 0;
+	if (glyph->rendered)
+		return glyph;
 
-	if (chunk->truncated)
-		Q_strncpyz(buf + chunk->len, truncmarker, sizeof(buf) - chunk->len);
+	glyph->rendered = qtrue;
+	if (glyph->codepoint == ' ' || glyph->width <= 0)
+		return glyph;
 
-	textSurface = TTF_RenderUTF8_Blended(font->font, buf, color);
+	UTF8_insert_char(buf, sizeof(buf), 0, glyph->codepoint);
+	textSurface = TTF_RenderUTF8_Blended(f->font, buf, color);
 	if (!textSurface) {
 		Com_Printf("%s (%s)\n", TTF_GetError(), buf);
-		return;
+		return glyph;
 	}
 
-	/* copy text to a surface of suitable size for a texture (power of two) */
-	for (w = 2; w < textSurface->w; w <<= 1) {}
-	for (h = 2; h < textSurface->h; h <<= 1) {}
+	if (!R_FontPackGlyph(atlas, textSurface->w, textSurface->h, &s, &t)) {
+		/* atlas is full - start over, the glyphs that are still needed are rendered again */
+		R_FontResetGlyphs(atlas);
+		glyph = R_FontGetGlyph(f, codepoint);
+		glyph->rendered = qtrue;
+		if (!R_FontPackGlyph(atlas, textSurface->w, textSurface->h, &s, &t)) {
+			SDL_FreeSurface(textSurface);
+			return NULL;
+		}
+	}
 
-	openGLSurface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, colordepth, rmask, gmask, bmask, amask);
-	if (!openGLSurface)
-		return;
+	openGLSurface = SDL_CreateRGBSurface(SDL_SWSURFACE, textSurface->w, textSurface->h, 32, rmask, gmask, bmask, amask);
+	if (!openGLSurface) {
+		SDL_FreeSurface(textSurface);
+		return glyph;
+	}
 
-	rect.x = rect.y = 0;
 	rect.w = textSurface->w;
-	if (rect.w > chunk->width)
-		rect.w = chunk->width;
 	rect.h = textSurface->h;
 
 	/* ignore alpha when blitting - just copy it over */
@@ -643,53 +915,121 @@ static void R_FontGenerateTexture (const font_t *font, const char *text, chunkCa
 	SDL_LowerBlit(textSurface, &rect, openGLSurface, &rect);
 	SDL_FreeSurface(textSurface);
 
-	glGenTextures(1, &chunk->texnum);
-	R_BindTexture(chunk->texnum);
-#ifdef HAVE_GLES
-	glTexImage2D(GL_TEXTURE_2D, 0, pixelFormat, w, h, 0, pixelFormat, GL_UNSIGNED_BYTE, openGLSurface->pixels);
-#else
-	glTexImage2D(GL_TEXTURE_2D, 0, samples, w, h, 0, pixelFormat, GL_UNSIGNED_BYTE, openGLSurface->pixels);
-#endif
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	Vector2Set(chunk->texsize, w, h);
+	if (!atlas->texnum)
+		R_FontCreateAtlas(atlas);
+
+	R_BindTexture(atlas->texnum);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, s, t, openGLSurface->w, openGLSurface->h, pixelFormat, GL_UNSIGNED_BYTE, openGLSurface->pixels);
 	R_CheckError();
 	SDL_FreeSurface(openGLSurface);
-}
 
-static const float font_texcoords[] = {
-	0.0, 0.0, 1.0, 0.0, 0.0, 1.0, 1.0, 1.0
-};
+	glyph->s = s;
+	glyph->t = t;
+	glyph->height = rect.h;
+
+	return glyph;
+}
 
-static void R_FontDrawTexture (int texId, int x, int y, int w, int h)
+/**
+ * @brief Adds the quad of a rendered glyph to the current batch
+ * @param[in] x Left side of the glyph image in normalized coordinates
+ * @param[in] y Top of the line in normalized coordinates
+ * @sa R_FontFlushGlyphs
+ */
+static void R_FontQueueGlyph (const fontAtlas_t *atlas, const fontGlyph_t *glyph, int x, int y)
 {
 	const float nx = x * viddef.rx;
 	const float ny = y * viddef.ry;
-	const float nw = w * viddef.rx;
-	const float nh = h * viddef.ry;
-
-	R_BindTexture(texId);
-
-	glVertexPointer(2, GL_SHORT, 0, r_state.vertex_array_2d);
-
-	memcpy(texunit_diffuse.texcoord_array, font_texcoords, sizeof(font_texcoords));
-
-	r_state.vertex_array_2d[0] = nx;
-	r_state.vertex_array_2d[1] = ny;
-	r_state.vertex_array_2d[2] = nx + nw;
-	r_state.vertex_array_2d[3] = ny;
-
-	r_state.vertex_array_2d[4] = nx;
-	r_state.vertex_array_2d[5] = ny + nh;
-	r_state.vertex_array_2d[6] = nx + nw;
-	r_state.vertex_array_2d[7] = ny + nh;
+	const float nw = glyph->width * viddef.rx;
+	const float nh = glyph->height * viddef.ry;
+	const float s1 = glyph->s / (float)FONT_ATLAS_SIZE;
+	const float t1 = glyph->t / (float)FONT_ATLAS_SIZE;
+	const float s2 = (glyph->s + glyph->width) / (float)FONT_ATLAS_SIZE;
+	const float t2 = (glyph->t + glyph->height) / (float)FONT_ATLAS_SIZE;
+	GLshort *verts;
+	GLfloat *texcoords;
+
+	if (r_glyph_arrays.numQuads >= MAX_FONT_QUADS || (r_glyph_arrays.atlas && r_glyph_arrays.atlas != atlas))
+		R_FontFlushGlyphs();
+
+	r_glyph_arrays.atlas = atlas;
+#ifdef HAVE_GLES
+	verts = &r_glyph_arrays.verts[r_glyph_arrays.numQuads * 12];
+	texcoords = &r_glyph_arrays.texcoords[r_glyph_arrays.numQuads * 12];
+#else
+	verts = &r_glyph_arrays.verts[r_glyph_arrays.numQuads * 8];
+	texcoords = &r_glyph_arrays.texcoords[r_glyph_arrays.numQuads * 8];
+#endif
+	r_glyph_arrays.numQuads++;
+
+	verts[0] = nx;
+	verts[1] = ny;
+	verts[2] = nx + nw;
+	verts[3] = ny;
+	verts[4] = nx + nw;
+	verts[5] = ny + nh;
+	texcoords[0] = s1;
+	texcoords[1] = t1;
+	texcoords[2] = s2;
+	texcoords[3] = t1;
+	texcoords[4] = s2;
+	texcoords[5] = t2;
+#ifdef HAVE_GLES
+	verts[6] = nx + nw;
+	verts[7] = ny + nh;
+	verts[8] = nx;
+	verts[9] = ny + nh;
+	verts[10] = nx;
+	verts[11] = ny;
+	texcoords[6] = s2;
+	texcoords[7] = t2;
+	texcoords[8] = s1;
+	texcoords[9] = t2;
+	texcoords[10] = s1;
+	texcoords[11] = t1;
+#else
+	verts[6] = nx;
+	verts[7] = ny + nh;
+	texcoords[6] = s1;
+	texcoords[7] = t2;
+#endif
+}
 
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+/**
+ * @brief Queues the glyphs of one text chunk (and the truncation marker)
+ * @note Uses the same pen walk as the layout - so the drawn text has exactly the width of the chunk
+ */
+static void R_FontDrawChunk (const font_t *f, const char *text, const chunkCache_t *chunk, int x, int y)
+{
+	const fontAtlas_t *atlas = R_FontGetAtlas(f);
+	const char *c = &text[chunk->pos];
+	const char *end = c + chunk->len;
+	const char *marker = truncmarker;
+	fontPen_t pen;
+
+	OBJZERO(pen);
+
+	for (;;) {
+		const fontGlyph_t *glyph;
+		int codepoint;
+		int left;
+
+		if (c < end && c[0] != '\0')
+			codepoint = UTF8_next(&c);
+		else if (chunk->truncated && marker[0] != '\0')
+			codepoint = UTF8_next(&marker);
+		else
+			break;
 
-	refdef.batchCount++;
+		R_FontAdvancePen(f, &pen, codepoint);
+		/* the pen walk may only hand out the metrics - rendering might drop the glyph cache */
+		glyph = R_FontRenderGlyph(f, codepoint);
+		if (!glyph || !glyph->height)
+			continue;
 
-	/* set back to standard 3d pointer */
-	glVertexPointer(3, GL_FLOAT, 0, r_state.vertex_array_3d);
+		left = pen.x - glyph->advance + glyph->left;
+		R_FontQueueGlyph(atlas, glyph, x + left, y);
+	}
 }
 
 /**
@@ -742,10 +1082,11 @@ int R_FontDrawString (const char *fontId, align_t align, int x, int y, int absX,
 		if (linenum < scrollPos || linenum >= scrollPos + boxHeight)
 			continue;
 
-		R_FontGenerateTexture(font, c, chunk);
-		R_FontDrawTexture(chunk->texnum, x + xalign, y + (linenum - scrollPos) * lineHeight, chunk->texsize[0], chunk->texsize[1]);
+		R_FontDrawChunk(font, c, chunk, x + xalign, y + (linenum - scrollPos) * lineHeight);
 	}
 
+	R_FontFlushGlyphs();
+
 	return wrap->numLines;
 }
 
@@ -765,6 +1106,8 @@ void R_FontInit (void)
 
 	numFonts = 0;
 	OBJZERO(fonts);
+	OBJZERO(fontAtlases);
+	OBJZERO(r_glyph_arrays);
 
 	OBJZERO(chunkCache);
 	OBJZERO(wrapCache);
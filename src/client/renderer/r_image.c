@@ -26,6 +26,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "r_error.h"
 #include "r_geoscape.h"
 #include "../../shared/images.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
 
 #define MAX_IMAGEHASH 256
 static image_t *imageHash[MAX_IMAGEHASH];
@@ -140,6 +145,286 @@ void R_ImageList_f (void)
 	Com_Printf("Total texel count (not counting mipmaps): %i\n", texels);
 }
 
+/*
+===============================================================================
+IMAGE CACHE
+===============================================================================
+*/
+
+#define IMAGE_CACHE_IDENT	(('C'<<24)+('G'<<16)+('M'<<8)+'I')
+#define IMAGE_CACHE_VERSION	2
+#define IMAGE_CACHE_DIR		"imagecache"
+
+/**
+ * @brief Identifies the image file an entry was made from - without reading the file
+ * @sa FS_GetFileStamp
+ */
+typedef struct imageCacheKey_s {
+	char filename[MAX_QPATH];	/**< the image file including the type extension */
+	unsigned stamp;				/**< crc32 from the pk3 directory or modification time of the image file */
+	int length;					/**< length of the image file */
+	int gamma;					/**< gamma (times 1000) the colours were corrected with - @c 0 for none */
+} imageCacheKey_t;
+
+/**
+ * @brief Header of a cached image. It is followed by the image name (including the type extension)
+ * and the mip levels of the texture as they are uploaded.
+ * @sa R_SaveImageCache
+ */
+typedef struct imageCacheHeader_s {
+	int ident;
+	int version;
+	int created;			/**< time of creation - the oldest entries are evicted first */
+	int nameLength;			/**< length of the image name including the terminating zero */
+	unsigned stamp;
+	int length;
+	int gamma;
+	int width;				/**< size of the image file */
+	int height;
+	int uploadWidth;		/**< size of the first mip level */
+	int uploadHeight;
+	int numLevels;
+	int hasAlpha;
+	int decodeTime;			/**< microseconds the decoding and the mip levels took - a hit has to be faster */
+} imageCacheHeader_t;
+
+/** @brief set when an entry was added - the cache size is only checked after that */
+static qboolean r_imageCacheModified;
+
+static inline qboolean R_ImageCacheEnabled (void)
+{
+	return r_imagecache != NULL && r_imagecache->integer;
+}
+
+/**
+ * @brief The cache file is addressed by the checksum of the image name, the name itself is
+ * stored in the file, too, to rule out collisions
+ */
+static void R_GetImageCacheName (const char *filename, char *cachename, size_t size)
+{
+	Com_sprintf(cachename, size, IMAGE_CACHE_DIR "/%08x.ric", Com_BlockChecksum(filename, strlen(filename)));
+}
+
+/**
+ * @return The amount of pixels of all the mip levels of a texture
+ */
+static int R_GetLevelsSize (int width, int height, int numLevels)
+{
+	int i, size = 0;
+
+	for (i = 0; i < numLevels; i++)
+		size += max(width >> i, 1) * max(height >> i, 1);
+
+	return size;
+}
+
+/**
+ * @brief Loads the mip levels of an image from the cache
+ * @param[in] key The image file the entry has to be made from
+ * @param[out] header The header of the entry
+ * @return The mip levels allocated in @c vid_imagePool or @c NULL if there is no valid cache entry
+ * @sa R_SaveImageCache
+ */
+static unsigned *R_LoadImageCache (const imageCacheKey_t *key, imageCacheHeader_t *header)
+{
+	char cachename[MAX_QPATH];
+	char name[MAX_QPATH];
+	unsigned *levels;
+	int size;
+	int length;
+	qFILE f;
+
+	R_GetImageCacheName(key->filename, cachename, sizeof(cachename));
+	length = FS_OpenFile(cachename, &f, FILE_READ);
+	if (!f.f && !f.z)
+		return NULL;
+
+	if (length < sizeof(*header) || FS_Read2(header, sizeof(*header), &f, qfalse) != sizeof(*header)) {
+		FS_CloseFile(&f);
+		return NULL;
+	}
+
+	header->ident = LittleLong(header->ident);
+	header->version = LittleLong(header->version);
+	header->nameLength = LittleLong(header->nameLength);
+	header->stamp = LittleLong(header->stamp);
+	header->length = LittleLong(header->length);
+	header->gamma = LittleLong(header->gamma);
+	header->width = LittleLong(header->width);
+	header->height = LittleLong(header->height);
+	header->uploadWidth = LittleLong(header->uploadWidth);
+	header->uploadHeight = LittleLong(header->uploadHeight);
+	header->numLevels = LittleLong(header->numLevels);
+	header->hasAlpha = LittleLong(header->hasAlpha);
+	header->decodeTime = LittleLong(header->decodeTime);
+
+	if (header->ident != IMAGE_CACHE_IDENT || header->version != IMAGE_CACHE_VERSION || header->stamp != key->stamp
+	 || header->length != key->length || header->gamma != key->gamma || header->nameLength != strlen(key->filename) + 1
+	 || header->width <= 0 || header->height <= 0 || header->uploadWidth <= 0 || header->uploadHeight <= 0
+	 || header->uploadWidth > MAX_TEXTURE_SIZE || header->uploadHeight > MAX_TEXTURE_SIZE
+	 || header->numLevels < 1 || header->numLevels > 32) {
+		FS_CloseFile(&f);
+		return NULL;
+	}
+
+	size = R_GetLevelsSize(header->uploadWidth, header->uploadHeight, header->numLevels) * sizeof(unsigned);
+	if (sizeof(*header) + header->nameLength + size != length
+	 || FS_Read2(name, header->nameLength, &f, qfalse) != header->nameLength
+	 || memcmp(name, key->filename, header->nameLength)) {
+		Com_DPrintf(DEBUG_RENDERER, "R_LoadImageCache: %s doesn't match %s\n", cachename, key->filename);
+		FS_CloseFile(&f);
+		return NULL;
+	}
+
+	levels = (unsigned *)Mem_PoolAllocExt(size, qfalse, vid_imagePool, 0);
+	if (FS_Read2(levels, size, &f, qfalse) != size) {
+		Com_Printf("R_LoadImageCache: %s is truncated\n", cachename);
+		Mem_Free(levels);
+		levels = NULL;
+	}
+
+	FS_CloseFile(&f);
+	return levels;
+}
+
+/**
+ * @brief Stores the mip levels of an image in the cache
+ * @param[in] key The image file the levels were made from
+ * @param[in] image The image with the upload size and alpha flag set
+ * @param[in] levels The mip levels one after another
+ * @param[in] numLevels The amount of mip levels
+ * @param[in] decodeTime The microseconds it took to decode the image file and to build the levels
+ * @sa R_LoadImageCache
+ */
+static void R_SaveImageCache (const imageCacheKey_t *key, const image_t *image, const unsigned *levels, int numLevels, int decodeTime)
+{
+	char cachename[MAX_QPATH];
+	imageCacheHeader_t header;
+	const int nameLength = strlen(key->filename) + 1;
+	const int size = R_GetLevelsSize(image->upload_width, image->upload_height, numLevels) * sizeof(unsigned);
+	qFILE f;
+
+	R_GetImageCacheName(key->filename, cachename, sizeof(cachename));
+	FS_OpenFile(cachename, &f, FILE_WRITE);
+	if (!f.f) {
+		Com_Printf("R_SaveImageCache: Could not write %s\n", cachename);
+		return;
+	}
+
+	header.ident = LittleLong(IMAGE_CACHE_IDENT);
+	header.version = LittleLong(IMAGE_CACHE_VERSION);
+	header.created = LittleLong((int)time(NULL));
+	header.nameLength = LittleLong(nameLength);
+	header.stamp = LittleLong(key->stamp);
+	header.length = LittleLong(key->length);
+	header.gamma = LittleLong(key->gamma);
+	header.width = LittleLong(image->width);
+	header.height = LittleLong(image->height);
+	header.uploadWidth = LittleLong(image->upload_width);
+	header.uploadHeight = LittleLong(image->upload_height);
+	header.numLevels = LittleLong(numLevels);
+	header.hasAlpha = LittleLong(image->has_alpha);
+	header.decodeTime = LittleLong(decodeTime);
+
+	if (FS_Write(&header, sizeof(header), &f) != sizeof(header) || FS_Write(key->filename, nameLength, &f) != nameLength
+	 || FS_Write(levels, size, &f) != size) {
+		Com_Printf("R_SaveImageCache: failed to finish writing %s\n", cachename);
+		FS_CloseFile(&f);
+		FS_RemoveFile(va("%s/%s", FS_Gamedir(), cachename));
+		return;
+	}
+
+	FS_CloseFile(&f);
+	r_imageCacheModified = qtrue;
+}
+
+/**
+ * @brief Removes the oldest image cache entries until the cache fits into @c r_imagecachesize
+ * @note Not done for every new entry - the whole cache directory is scanned here
+ * @sa R_FreeWorldImages
+ */
+static void R_EvictImageCache (void)
+{
+	char findname[MAX_OSPATH];
+	char **filenames;
+	int *sizes, *created;
+	int numFiles, i;
+	int64_t total;
+	const int64_t maxSize = (int64_t)max(r_imagecachesize->integer, 0) * 1024 * 1024;
+
+	if (!r_imageCacheModified)
+		return;
+	r_imageCacheModified = qfalse;
+
+	Com_sprintf(findname, sizeof(findname), "%s/" IMAGE_CACHE_DIR "/*.ric", FS_Gamedir());
+	FS_NormPath(findname);
+	filenames = FS_ListFiles(findname, &numFiles, 0, SFF_SUBDIR | SFF_HIDDEN | SFF_SYSTEM);
+	if (!filenames)
+		return;
+
+	/* the last entry is a guard */
+	numFiles--;
+	sizes = (int *)Mem_PoolAlloc(numFiles * sizeof(*sizes), vid_imagePool, 0);
+	created = (int *)Mem_PoolAlloc(numFiles * sizeof(*created), vid_imagePool, 0);
+
+	total = 0;
+	for (i = 0; i < numFiles; i++) {
+		imageCacheHeader_t header;
+		qFILE f;
+
+		sizes[i] = FS_OpenFile(va(IMAGE_CACHE_DIR "/%s", Com_SkipPath(filenames[i])), &f, FILE_READ);
+		if (sizes[i] <= 0)
+			continue;
+		if (FS_Read2(&header, sizeof(header), &f, qfalse) == sizeof(header))
+			created[i] = LittleLong(header.created);
+		FS_CloseFile(&f);
+		total += sizes[i];
+	}
+
+	while (total > maxSize) {
+		int oldest = -1;
+		for (i = 0; i < numFiles; i++) {
+			if (sizes[i] <= 0)
+				continue;
+			if (oldest == -1 || created[i] < created[oldest])
+				oldest = i;
+		}
+		if (oldest == -1)
+			break;
+		FS_RemoveFile(filenames[oldest]);
+		total -= sizes[oldest];
+		sizes[oldest] = 0;
+	}
+
+	for (i = 0; i < numFiles; i++)
+		Mem_Free(filenames[i]);
+	Mem_Free(filenames);
+	Mem_Free(sizes);
+	Mem_Free(created);
+}
+
+/**
+ * @brief Loads the RGBA data of an image. The image types are tried in the order of @c Img_GetImageTypes.
+ * @param[in] name The image name without extension
+ * @return The RGBA data allocated in @c vid_imagePool or @c NULL if the image wasn't found
+ */
+static byte *R_ReadImage (const char *name, int *width, int *height)
+{
+	byte *pic = NULL;
+	SDL_Surface *surf = Img_LoadImage(name);
+
+	if (surf) {
+		const size_t size = (surf->w * surf->h) * 4;
+		*width = surf->w;
+		*height = surf->h;
+		pic = (byte *)Mem_PoolAllocExt(size, qfalse, vid_imagePool, 0);
+		memcpy(pic, surf->pixels, size);
+		SDL_FreeSurface(surf);
+	}
+
+	return pic;
+}
+
 /**
  * @brief Generic image-data loading fucntion.
  * @param[in] name (Full) pathname to the image to load. Extension (if given) will be ignored.
@@ -151,27 +436,27 @@ void R_ImageList_f (void)
 void R_LoadImage (const char *name, byte **pic, int *width, int *height)
 {
 	char filenameTemp[MAX_QPATH];
-	SDL_Surface *surf;
+	byte *data;
 
 	if (Q_strnull(name))
 		Com_Error(ERR_FATAL, "R_LoadImage: NULL name");
 
 	Com_StripExtension(name, filenameTemp, sizeof(filenameTemp));
 
-	if ((surf = Img_LoadImage(filenameTemp))) {
-		const size_t size = (surf->w * surf->h) * 4;
-		*width = surf->w;
-		*height = surf->h;
-		*pic = (byte *)Mem_PoolAlloc(size, vid_imagePool, 0);
-		memcpy(*pic, surf->pixels, size);
-		SDL_FreeSurface(surf);
-	}
+	if ((data = R_ReadImage(filenameTemp, width, height)))
+		*pic = data;
 }
 
+/**
+ * @brief Averages four source pixels for each target pixel
+ * @note The SSE2 and NEON paths do four pixels at once and give exactly the same result
+ * as the plain C loop, which is also used for the remaining pixels of a row.
+ */
 void R_ScaleTexture (unsigned *in, int inwidth, int inheight, unsigned *out, int outwidth, int outheight)
 {
 	int i, j;
 	unsigned frac;
+	/* pixel offsets of the two source columns of each target column */
 	unsigned p1[MAX_TEXTURE_SIZE], p2[MAX_TEXTURE_SIZE];
 	const unsigned fracstep = inwidth * 0x10000 / outwidth;
 
@@ -179,12 +464,12 @@ void R_ScaleTexture (unsigned *in, int inwidth, int inheight, unsigned *out, int
 
 	frac = fracstep >> 2;
 	for (i = 0; i < outwidth; i++) {
-		p1[i] = 4 * (frac >> 16);
+		p1[i] = frac >> 16;
 		frac += fracstep;
 	}
 	frac = 3 * (fracstep >> 2);
 	for (i = 0; i < outwidth; i++) {
-		p2[i] = 4 * (frac >> 16);
+		p2[i] = frac >> 16;
 		frac += fracstep;
 	}
 
@@ -197,11 +482,49 @@ void R_ScaleTexture (unsigned *in, int inwidth, int inheight, unsigned *out, int
 		assert(index < inwidth * inheight);
 		assert(index2 < inwidth * inheight);
 
-		for (j = 0; j < outwidth; j++) {
-			const byte *pix1 = (const byte *) inrow + p1[j];
-			const byte *pix2 = (const byte *) inrow + p2[j];
-			const byte *pix3 = (const byte *) inrow2 + p1[j];
-			const byte *pix4 = (const byte *) inrow2 + p2[j];
+		j = 0;
+#if defined(__SSE2__)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			for (; j + 4 <= outwidth; j += 4) {
+				const __m128i a = _mm_set_epi32(inrow[p1[j + 3]], inrow[p1[j + 2]], inrow[p1[j + 1]], inrow[p1[j]]);
+				const __m128i b = _mm_set_epi32(inrow[p2[j + 3]], inrow[p2[j + 2]], inrow[p2[j + 1]], inrow[p2[j]]);
+				const __m128i c = _mm_set_epi32(inrow2[p1[j + 3]], inrow2[p1[j + 2]], inrow2[p1[j + 1]], inrow2[p1[j]]);
+				const __m128i d = _mm_set_epi32(inrow2[p2[j + 3]], inrow2[p2[j + 2]], inrow2[p2[j + 1]], inrow2[p2[j]]);
+				/* widen to 16 bit to not lose the carry of the sum */
+				__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+				__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+				lo = _mm_add_epi16(lo, _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero)));
+				hi = _mm_add_epi16(hi, _mm_add_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero)));
+				lo = _mm_srli_epi16(lo, 2);
+				hi = _mm_srli_epi16(hi, 2);
+				_mm_storeu_si128((__m128i *)(out + j), _mm_packus_epi16(lo, hi));
+			}
+		}
+#elif defined(__ARM_NEON__)
+		for (; j + 4 <= outwidth; j += 4) {
+			const uint32_t pa[4] = {inrow[p1[j]], inrow[p1[j + 1]], inrow[p1[j + 2]], inrow[p1[j + 3]]};
+			const uint32_t pb[4] = {inrow[p2[j]], inrow[p2[j + 1]], inrow[p2[j + 2]], inrow[p2[j + 3]]};
+			const uint32_t pc[4] = {inrow2[p1[j]], inrow2[p1[j + 1]], inrow2[p1[j + 2]], inrow2[p1[j + 3]]};
+			const uint32_t pd[4] = {inrow2[p2[j]], inrow2[p2[j + 1]], inrow2[p2[j + 2]], inrow2[p2[j + 3]]};
+			const uint8x16_t a = vreinterpretq_u8_u32(vld1q_u32(pa));
+			const uint8x16_t b = vreinterpretq_u8_u32(vld1q_u32(pb));
+			const uint8x16_t c = vreinterpretq_u8_u32(vld1q_u32(pc));
+			const uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(pd));
+			/* widen to 16 bit to not lose the carry of the sum */
+			uint16x8_t lo = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+			uint16x8_t hi = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+			lo = vaddw_u8(vaddw_u8(lo, vget_low_u8(c)), vget_low_u8(d));
+			hi = vaddw_u8(vaddw_u8(hi, vget_high_u8(c)), vget_high_u8(d));
+			vst1q_u8((uint8_t *)(out + j), vcombine_u8(vshrn_n_u16(lo, 2), vshrn_n_u16(hi, 2)));
+		}
+#endif
+
+		for (; j < outwidth; j++) {
+			const byte *pix1 = (const byte *) (inrow + p1[j]);
+			const byte *pix2 = (const byte *) (inrow + p2[j]);
+			const byte *pix3 = (const byte *) (inrow2 + p1[j]);
+			const byte *pix4 = (const byte *) (inrow2 + p2[j]);
 			((byte *) (out + j))[0] = (pix1[0] + pix2[0] + pix3[0] + pix4[0]) >> 2;
 			((byte *) (out + j))[1] = (pix1[1] + pix2[1] + pix3[1] + pix4[1]) >> 2;
 			((byte *) (out + j))[2] = (pix1[2] + pix2[2] + pix3[2] + pix4[2]) >> 2;
@@ -210,6 +533,173 @@ void R_ScaleTexture (unsigned *in, int inwidth, int inheight, unsigned *out, int
 	}
 }
 
+/**
+ * @brief Checks the RGBA data for any alpha value that is not 255
+ * @param[in] data The RGBA pixels
+ * @param[in] count The amount of pixels
+ */
+qboolean R_ImageHasAlpha (const unsigned *data, int count)
+{
+	const byte opaque[4] = {0, 0, 0, 255};
+	unsigned alphaMask;
+	int i = 0;
+
+	/* endian independent mask of the alpha byte */
+	memcpy(&alphaMask, opaque, sizeof(alphaMask));
+
+#if defined(__SSE2__)
+	{
+		const __m128i mask = _mm_set1_epi32(alphaMask);
+		for (; i + 4 <= count; i += 4) {
+			const __m128i pixels = _mm_loadu_si128((const __m128i *)(data + i));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(pixels, mask), mask)) != 0xFFFF)
+				return qtrue;
+		}
+	}
+#elif defined(__ARM_NEON__)
+	{
+		const uint32x4_t mask = vdupq_n_u32(alphaMask);
+		for (; i + 4 <= count; i += 4) {
+			const uint32x4_t opaquePixels = vceqq_u32(vandq_u32(vld1q_u32(data + i), mask), mask);
+			const uint32x2_t folded = vand_u32(vget_low_u32(opaquePixels), vget_high_u32(opaquePixels));
+			if ((vget_lane_u32(folded, 0) & vget_lane_u32(folded, 1)) != 0xFFFFFFFFU)
+				return qtrue;
+		}
+	}
+#endif
+
+	for (; i < count; i++) {
+		if ((data[i] & alphaMask) != alphaMask)
+			return qtrue;
+	}
+
+	return qfalse;
+}
+
+/**
+ * @brief Builds the next smaller mip level - every target pixel is the rounded average of a 2x2 block
+ * @param[in] in The RGBA pixels of the level
+ * @param[in] width The width of @c in - a width of 1 stays 1 and only the rows are averaged
+ * @param[in] height The height of @c in - a height of 1 stays 1 and only the columns are averaged
+ * @param[out] out Gets max(width / 2, 1) * max(height / 2, 1) pixels
+ * @note The SSE2 and NEON paths do four pixels at once and give exactly the same result
+ * as the plain C loop, which is also used for the remaining pixels of a row.
+ */
+void R_MipMap (const unsigned *in, int width, int height, unsigned *out)
+{
+	const int outwidth = max(width >> 1, 1);
+	const int outheight = max(height >> 1, 1);
+	/* offsets of the right and of the lower pixels of a block */
+	const int dx = width > 1 ? 1 : 0;
+	const int dy = height > 1 ? width : 0;
+	int i, j;
+
+	for (i = 0; i < outheight; i++, out += outwidth) {
+		const unsigned *row = in + 2 * i * width;
+
+		j = 0;
+		if (dx) {
+#if defined(__SSE2__)
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i two = _mm_set1_epi16(2);
+			for (; j + 4 <= outwidth; j += 4) {
+				const unsigned *p = row + 2 * j;
+				const __m128i a = _mm_loadu_si128((const __m128i *)p);
+				const __m128i b = _mm_loadu_si128((const __m128i *)(p + 4));
+				const __m128i c = _mm_loadu_si128((const __m128i *)(p + dy));
+				const __m128i d = _mm_loadu_si128((const __m128i *)(p + dy + 4));
+				/* add the rows in 16 bit - two pixels per register */
+				const __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(c, zero));
+				const __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(c, zero));
+				const __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(d, zero));
+				const __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(d, zero));
+				/* and the neighbouring columns */
+				__m128i lo = _mm_add_epi16(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+				__m128i hi = _mm_add_epi16(_mm_unpacklo_epi64(s2, s3), _mm_unpackhi_epi64(s2, s3));
+				lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+				hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+				_mm_storeu_si128((__m128i *)(out + j), _mm_packus_epi16(lo, hi));
+			}
+#elif defined(__ARM_NEON__)
+			for (; j + 4 <= outwidth; j += 4) {
+				const unsigned *p = row + 2 * j;
+				/* the even and the odd columns of both rows */
+				const uint32x4x2_t top = vld2q_u32(p);
+				const uint32x4x2_t bottom = vld2q_u32(p + dy);
+				const uint8x16_t a = vreinterpretq_u8_u32(top.val[0]);
+				const uint8x16_t b = vreinterpretq_u8_u32(top.val[1]);
+				const uint8x16_t c = vreinterpretq_u8_u32(bottom.val[0]);
+				const uint8x16_t d = vreinterpretq_u8_u32(bottom.val[1]);
+				/* widen to 16 bit to not lose the carry of the sum */
+				uint16x8_t lo = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+				uint16x8_t hi = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+				lo = vaddw_u8(vaddw_u8(lo, vget_low_u8(c)), vget_low_u8(d));
+				hi = vaddw_u8(vaddw_u8(hi, vget_high_u8(c)), vget_high_u8(d));
+				/* the rounding shift adds the 2 of the plain C loop */
+				vst1q_u8((uint8_t *)(out + j), vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+			}
+#endif
+		}
+
+		for (; j < outwidth; j++) {
+			const byte *pix1 = (const byte *) (row + 2 * j);
+			const byte *pix2 = (const byte *) (row + 2 * j + dx);
+			const byte *pix3 = (const byte *) (row + 2 * j + dy);
+			const byte *pix4 = (const byte *) (row + 2 * j + dx + dy);
+			((byte *) (out + j))[0] = (pix1[0] + pix2[0] + pix3[0] + pix4[0] + 2) >> 2;
+			((byte *) (out + j))[1] = (pix1[1] + pix2[1] + pix3[1] + pix4[1] + 2) >> 2;
+			((byte *) (out + j))[2] = (pix1[2] + pix2[2] + pix3[2] + pix4[2] + 2) >> 2;
+			((byte *) (out + j))[3] = (pix1[3] + pix2[3] + pix3[3] + pix4[3] + 2) >> 2;
+		}
+	}
+}
+
+/**
+ * @return The amount of mip levels down to 1x1 for a texture of the given size
+ */
+static int R_GetMipLevels (int width, int height)
+{
+	int levels = 1;
+
+	while (width > 1 || height > 1) {
+		width = max(width >> 1, 1);
+		height = max(height >> 1, 1);
+		levels++;
+	}
+
+	return levels;
+}
+
+/**
+ * @brief Gamma corrects the colour channels, the alpha channel is kept
+ * @param[in,out] data The RGBA pixels
+ * @param[in] count The amount of pixels
+ * @param[in] gamma The same value as given to the gamma ramp of the display
+ * @note This stays a table lookup - SSE2 and NEON can't look up 256 entries at once, and a
+ * vectorised lookup built from 16 entry shuffles is several times slower than this loop
+ */
+void R_GammaTexture (unsigned *data, int count, float gamma)
+{
+	static byte gammaTable[256];
+	static float gammaTableValue;
+	byte *pixel = (byte *)data;
+	int i;
+
+	if (gamma != gammaTableValue) {
+		for (i = 0; i < 256; i++) {
+			const int value = pow(i / 255.0, 1.0 / gamma) * 255.0 + 0.5;
+			gammaTable[i] = min(max(value, 0), 255);
+		}
+		gammaTableValue = gamma;
+	}
+
+	for (i = 0; i < count; i++, pixel += 4) {
+		pixel[0] = gammaTable[pixel[0]];
+		pixel[1] = gammaTable[pixel[1]];
+		pixel[2] = gammaTable[pixel[2]];
+	}
+}
+
 /**
  * @brief Calculates the texture size that should be used to upload the texture data
  * @param[in] width The width of the source texture data
@@ -239,42 +729,98 @@ void R_GetScaledTextureSize (int width, int height, int *scaledWidth, int *scale
 }
 
 #define R_IsClampedImageType(type) ((type) == it_pic || (type) == it_worldrelated)
+#define R_IsMipmappedImageType(type) ((type) != it_pic && (type) != it_worldrelated && (type) != it_chars)
+/** the image types that hold colours - the others hold normals, material or light data */
+#define R_IsColorImageType(type) ((type) != it_normalmap && (type) != it_specularmap && (type) != it_roughnessmap \
+		&& (type) != it_lightmap && (type) != it_deluxemap)
 
 /**
- * @brief Uploads the opengl texture to the server
+ * @return The gamma the colour textures are corrected with, or @c 0 if the gamma ramp of the
+ * display does it
+ * @sa R_GammaTexture
+ */
+static int R_GetTextureGamma (void)
+{
+	if (r_config.hwgamma || !vid_gamma || !vid_ignoregamma || vid_ignoregamma->integer)
+		return 0;
+	if (vid_gamma->value == 1.0f)
+		return 0;
+	/* stored in the image cache - so not as float */
+	return vid_gamma->value * 1000;
+}
+
+/**
+ * @brief Brings the texture data into the form it is uploaded in
  * @param[in] data Must be in RGBA format
  * @param width Width of the image
  * @param height Height of the image
- * @param[in,out] image Pointer to the image structure to initialize
+ * @param[in,out] image Gets the upload size and the alpha flag
+ * @param[in] gamma The gamma (times 1000) the colours are corrected with or @c 0
+ * @param[out] numLevels The amount of mip levels
+ * @return The mip levels one after another - this is @c data itself if it can be uploaded as it is,
+ * otherwise it is allocated in @c vid_imagePool
+ * @sa R_UploadTextureLevels
  */
-void R_UploadTexture (unsigned *data, int width, int height, image_t* image)
+static unsigned *R_PrepareTexture (unsigned *data, int width, int height, image_t *image, int gamma, int *numLevels)
 {
-	unsigned *scaled;
-	int scaledWidth, scaledHeight;
-	int samples = r_config.gl_compressed_solid_format ? r_config.gl_compressed_solid_format : r_config.gl_solid_format;
-	int i, c;
-	byte *scan;
-	const qboolean mipmap = (image->type != it_pic && image->type != it_worldrelated && image->type != it_chars);
-	const qboolean clamp = R_IsClampedImageType(image->type);
+	unsigned *levels, *level;
+	int scaledWidth, scaledHeight, size, i;
 
 	/* scan the texture for any non-255 alpha */
-	c = width * height;
-	/* set scan to the first alpha byte */
-	for (i = 0, scan = ((byte *) data) + 3; i < c; i++, scan += 4) {
-		if (*scan != 255) {
-			samples = r_config.gl_compressed_alpha_format ? r_config.gl_compressed_alpha_format : r_config.gl_alpha_format;
-			break;
-		}
-	}
+	image->has_alpha = R_ImageHasAlpha(data, width * height);
 
 	R_GetScaledTextureSize(width, height, &scaledWidth, &scaledHeight);
-
-	image->has_alpha = (samples == r_config.gl_alpha_format || samples == r_config.gl_compressed_alpha_format);
 	image->upload_width = scaledWidth;	/* after power of 2 and scales */
 	image->upload_height = scaledHeight;
 
+	*numLevels = R_IsMipmappedImageType(image->type) ? R_GetMipLevels(scaledWidth, scaledHeight) : 1;
+	if (*numLevels == 1 && !gamma && scaledWidth == width && scaledHeight == height)
+		return data;
+
+	size = R_GetLevelsSize(scaledWidth, scaledHeight, *numLevels);
+	levels = (unsigned *)Mem_PoolAllocExt(size * sizeof(unsigned), qfalse, vid_imagePool, 0);
+
+	if (scaledWidth != width || scaledHeight != height)  /* whereas others need to be scaled */
+		R_ScaleTexture(data, width, height, levels, scaledWidth, scaledHeight);
+	else
+		memcpy(levels, data, width * height * sizeof(unsigned));
+
+	if (gamma)
+		R_GammaTexture(levels, scaledWidth * scaledHeight, gamma / 1000.0f);
+
+	/* and mipmapped */
+	level = levels;
+	for (i = 1; i < *numLevels; i++) {
+		const int levelWidth = max(scaledWidth >> (i - 1), 1);
+		const int levelHeight = max(scaledHeight >> (i - 1), 1);
+		R_MipMap(level, levelWidth, levelHeight, level + levelWidth * levelHeight);
+		level += levelWidth * levelHeight;
+	}
+
+	return levels;
+}
+
+/**
+ * @brief Uploads the prepared texture data to the bound texture
+ * @param[in] levels The mip levels one after another
+ * @param[in] numLevels The amount of mip levels - more than one for mipmapped image types
+ * @param[in] image The image with the upload size and alpha flag set
+ * @sa R_PrepareTexture
+ */
+static void R_UploadTextureLevels (const unsigned *levels, int numLevels, const image_t* image)
+{
+	const int scaledWidth = image->upload_width;
+	const int scaledHeight = image->upload_height;
+	const qboolean mipmap = R_IsMipmappedImageType(image->type);
+	const qboolean clamp = R_IsClampedImageType(image->type);
+	int samples = r_config.gl_compressed_solid_format ? r_config.gl_compressed_solid_format : r_config.gl_solid_format;
+	int i;
+
+	if (image->has_alpha)
+		samples = r_config.gl_compressed_alpha_format ? r_config.gl_compressed_alpha_format : r_config.gl_alpha_format;
+
 	/* some images need very little attention (pics, fonts, etc..) */
-	if (!mipmap && scaledWidth == width && scaledHeight == height) {
+	if (!mipmap && scaledWidth == image->width && scaledHeight == image->height) {
 		/* no mipmapping for these images to save memory */
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -285,25 +831,16 @@ void R_UploadTexture (unsigned *data, int width, int height, image_t* image)
 			R_CheckError();
 		}
 #ifdef HAVE_GLES
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, scaledWidth, scaledHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, scaledWidth, scaledHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, levels);
 #else
-		glTexImage2D(GL_TEXTURE_2D, 0, samples, scaledWidth, scaledHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		glTexImage2D(GL_TEXTURE_2D, 0, samples, scaledWidth, scaledHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, levels);
 #endif
 		return;
 	}
 
-	if (scaledWidth != width || scaledHeight != height) {  /* whereas others need to be scaled */
-		scaled = (unsigned *)Mem_PoolAllocExt(scaledWidth * scaledHeight * sizeof(unsigned), qfalse, vid_imagePool, 0);
-		R_ScaleTexture(data, width, height, scaled, scaledWidth, scaledHeight);
-	} else {
-		scaled = data;
-	}
-
-	/* and mipmapped */
 	if (mipmap) {
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, r_config.gl_filter_min);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, r_config.gl_filter_max);
-		glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
 		if (r_config.anisotropic) {
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, r_config.maxAnisotropic);
 			R_CheckError();
@@ -331,15 +868,36 @@ void R_UploadTexture (unsigned *data, int width, int height, image_t* image)
 		R_CheckError();
 	}
 
+	/* the mip levels are built by R_PrepareTexture */
+	for (i = 0; i < numLevels; i++) {
+		const int levelWidth = max(scaledWidth >> i, 1);
+		const int levelHeight = max(scaledHeight >> i, 1);
 #ifdef HAVE_GLES
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, scaledWidth, scaledHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, scaled);
+		glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, levels);
 #else
-	glTexImage2D(GL_TEXTURE_2D, 0, samples, scaledWidth, scaledHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, scaled);
+		glTexImage2D(GL_TEXTURE_2D, i, samples, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, levels);
 #endif
-	R_CheckError();
+		R_CheckError();
+		levels += levelWidth * levelHeight;
+	}
+}
+
+/**
+ * @brief Uploads the opengl texture to the server
+ * @param[in] data Must be in RGBA format
+ * @param width Width of the image
+ * @param height Height of the image
+ * @param[in,out] image Pointer to the image structure to initialize
+ */
+void R_UploadTexture (unsigned *data, int width, int height, image_t* image)
+{
+	int numLevels;
+	unsigned *levels = R_PrepareTexture(data, width, height, image, 0, &numLevels);
 
-	if (scaled != data)
-		Mem_Free(scaled);
+	R_UploadTextureLevels(levels, numLevels, image);
+
+	if (levels != data)
+		Mem_Free(levels);
 }
 
 /**
@@ -552,6 +1110,124 @@ static void R_ChangeImageType(image_t *img, imagetype_t type)
 	}
 }
 
+/** @brief the first cache hits are timed to check that the cache is faster than the decoding */
+#define IMAGE_CACHE_PROBE_HITS 32
+
+static int r_imageCacheHits;
+/** @brief microseconds the timed hits took to read - and the decoding of their images took */
+static int64_t r_imageCacheHitTime, r_imageCacheDecodeTime;
+
+/**
+ * @return The gamma (times 1000) the textures of the given type are corrected with - or @c 0
+ */
+static inline int R_GetImageGamma (imagetype_t type)
+{
+	return R_IsColorImageType(type) ? R_GetTextureGamma() : 0;
+}
+
+/**
+ * @brief Fills the cache key for the image file @c R_ReadImage would load
+ * @param[in] name The image name without extension
+ * @return @c qfalse if there is no image file
+ */
+static qboolean R_GetImageCacheKey (const char *name, imagetype_t type, imageCacheKey_t *key)
+{
+	char const* const* types;
+
+	for (types = Img_GetImageTypes(); *types; types++) {
+		Com_sprintf(key->filename, sizeof(key->filename), "%s.%s", name, *types);
+		key->length = FS_GetFileStamp(key->filename, &key->stamp);
+		if (key->length != -1) {
+			key->gamma = R_GetImageGamma(type);
+			return qtrue;
+		}
+	}
+
+	return qfalse;
+}
+
+/**
+ * @brief Creates and uploads the image from its image cache entry
+ * @return @c NULL if there is no valid entry
+ * @note The first hits are timed. If reading them took longer than decoding their image files,
+ * the cache is turned off - the storage is too slow for it then.
+ * @sa R_LoadImageFile
+ */
+static image_t *R_LoadImageFromCache (const char *name, imagetype_t type, const imageCacheKey_t *key)
+{
+	const uint64_t start = Sys_Nanoseconds();
+	imageCacheHeader_t header;
+	image_t *image;
+	unsigned *levels;
+	int uploadWidth, uploadHeight;
+
+	levels = R_LoadImageCache(key, &header);
+	if (!levels)
+		return NULL;
+
+	/* r_maxtexres or the image type might have changed since the entry was made */
+	R_GetScaledTextureSize(header.width, header.height, &uploadWidth, &uploadHeight);
+	if (uploadWidth != header.uploadWidth || uploadHeight != header.uploadHeight
+	 || header.numLevels != (R_IsMipmappedImageType(type) ? R_GetMipLevels(uploadWidth, uploadHeight) : 1)) {
+		Mem_Free(levels);
+		return NULL;
+	}
+
+	if (r_imageCacheHits < IMAGE_CACHE_PROBE_HITS) {
+		r_imageCacheHitTime += (Sys_Nanoseconds() - start) / 1000;
+		r_imageCacheDecodeTime += header.decodeTime;
+		if (++r_imageCacheHits == IMAGE_CACHE_PROBE_HITS && r_imageCacheHitTime > r_imageCacheDecodeTime) {
+			Com_Printf("Reading the image cache took longer than decoding the images (%i ms vs. %i ms) - turning off r_imagecache\n",
+					(int)(r_imageCacheHitTime / 1000), (int)(r_imageCacheDecodeTime / 1000));
+			Cvar_Set("r_imagecache", "0");
+		}
+	}
+
+	image = R_LoadImageData(name, NULL, header.width, header.height, type);
+	image->upload_width = uploadWidth;
+	image->upload_height = uploadHeight;
+	image->has_alpha = header.hasAlpha;
+	R_BindTexture(image->texnum);
+	R_UploadTextureLevels(levels, header.numLevels, image);
+	Mem_Free(levels);
+
+	return image;
+}
+
+/**
+ * @brief Decodes and uploads the image file
+ * @param[in] name The image name without extension
+ * @param[in] key The image cache entry to write - or @c NULL
+ * @return @c NULL if there is no image file
+ * @sa R_LoadImageFromCache
+ */
+static image_t *R_LoadImageFile (const char *name, imagetype_t type, const imageCacheKey_t *key)
+{
+	const uint64_t start = Sys_Nanoseconds();
+	image_t *image;
+	unsigned *levels;
+	byte *pic;
+	int width, height, numLevels;
+
+	pic = R_ReadImage(name, &width, &height);
+	if (!pic)
+		return NULL;
+
+	image = R_LoadImageData(name, NULL, width, height, type);
+	levels = R_PrepareTexture((unsigned *)pic, width, height, image, key ? key->gamma : R_GetImageGamma(type), &numLevels);
+	if (key)
+		R_SaveImageCache(key, image, levels, numLevels, (Sys_Nanoseconds() - start) / 1000);
+
+	R_BindTexture(image->texnum);
+	R_UploadTextureLevels(levels, numLevels, image);
+
+	if (levels != (unsigned *)pic)
+		Mem_Free(levels);
+	Mem_Free(pic);
+
+	return image;
+}
+
 /**
  * @brief Finds or loads the given image
  * @sa R_RegisterImage
@@ -566,8 +1242,8 @@ static void R_ChangeImageType(image_t *img, imagetype_t type)
 image_t *R_FindImage (const char *pname, imagetype_t type)
 {
 	char lname[MAX_QPATH];
+	imageCacheKey_t key;
 	image_t *image;
-	SDL_Surface *surf;
 
 	if (!pname || !pname[0])
 		Com_Error(ERR_FATAL, "R_FindImage: NULL name");
@@ -589,9 +1265,15 @@ image_t *R_FindImage (const char *pname, imagetype_t type)
 		return image;
 	}
 
-	if ((surf = Img_LoadImage(lname))) {
-		image = R_LoadImageData(lname, (byte *)surf->pixels, surf->w, surf->h, type);
-		SDL_FreeSurface(surf);
+	if (R_ImageCacheEnabled() && R_GetImageCacheKey(lname, type, &key)) {
+		image = R_LoadImageFromCache(lname, type, &key);
+		if (!image)
+			image = R_LoadImageFile(lname, type, &key);
+	} else {
+		image = R_LoadImageFile(lname, type, NULL);
+	}
+
+	if (image) {
 		if (image->type == it_world) {
 			image->normalmap = R_FindImage(va("%s_nm", image->name), it_normalmap);
 			if (image->normalmap == r_noTexture)
@@ -733,6 +1415,9 @@ void R_FreeWorldImages (void)
 		/* free it */
 		R_FreeImage(image);
 	}
+
+	if (R_ImageCacheEnabled())
+		R_EvictImageCache();
 }
 
 void R_InitImages (void)
@@ -85,6 +85,9 @@ void R_UploadTexture(unsigned *data, int width, int height, image_t* image);
 void R_SoftenTexture(byte *in, int width, int height, int bpp);
 void R_GetScaledTextureSize(int width, int height, int *scaledWidth, int *scaledHeight);
 void R_ScaleTexture(unsigned *in, int inwidth, int inheight, unsigned *out, int outwidth, int outheight);
+void R_MipMap(const unsigned *in, int width, int height, unsigned *out);
+void R_GammaTexture(unsigned *data, int count, float gamma);
+qboolean R_ImageHasAlpha(const unsigned *data, int count);
 image_t* R_RenderToTexture(const char *name, int x, int y, int w, int h);
 
 void R_ImageList_f(void);
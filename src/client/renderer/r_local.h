@@ -58,6 +58,8 @@ extern cvar_t *r_nocull;
 extern cvar_t *r_isometric;
 extern cvar_t *r_anisotropic;
 extern cvar_t *r_texture_lod;   /* lod_bias */
+extern cvar_t *r_imagecache;
+extern cvar_t *r_imagecachesize;
 extern cvar_t *r_materials;
 extern cvar_t *r_default_specular;
 extern cvar_t *r_default_hardness;
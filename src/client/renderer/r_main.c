@@ -54,6 +54,8 @@ cvar_t *r_nocull;
 cvar_t *r_isometric;
 cvar_t *r_anisotropic;
 cvar_t *r_texture_lod;			/* lod_bias */
+cvar_t *r_imagecache;
+cvar_t *r_imagecachesize;
 cvar_t *r_screenshot_format;
 cvar_t *r_screenshot_jpeg_quality;
 cvar_t *r_lightmap;
@@ -285,6 +287,8 @@ void R_BeginFrame (void)
  */
 void R_RenderFrame (void)
 {
+	PROF_BEGIN(PROF_R_RENDERFRAME);
+
 	R_Setup3D();
 
 	/* activate wire mode */
@@ -415,6 +419,8 @@ void R_RenderFrame (void)
 	R_Setup2D();
 
 	R_CheckError();
+
+	PROF_END(PROF_R_RENDERFRAME);
 }
 
 /**
@@ -435,7 +441,9 @@ void R_EndFrame (void)
 	if (vid_gamma->modified) {
 		if (!vid_ignoregamma->integer) {
 			const float g = vid_gamma->value;
-			SDL_SetGamma(g, g, g);
+			r_config.hwgamma = SDL_SetGamma(g, g, g) == 0;
+			if (!r_config.hwgamma)
+				Com_Printf("No gamma ramp available - the new gamma is applied to the textures after a vid_restart\n");
 		}
 		vid_gamma->modified = qfalse;
 	}
@@ -541,6 +549,10 @@ static void R_RegisterSystemVars (void)
 #else
 	r_texture_lod = Cvar_Get("r_texture_lod", "0", CVAR_ARCHIVE, NULL);
 #endif
+	/* the source image is still read and checksummed, the cache only saves the decompression
+	 * for the price of writing the uncompressed data - that doesn't pay off on slow storage */
+	r_imagecache = Cvar_Get("r_imagecache", "1", CVAR_ARCHIVE, "Store the decoded and mipmapped textures on disk to skip the png and jpg decompression next time - turns itself off if reading them is slower");
+	r_imagecachesize = Cvar_Get("r_imagecachesize", "256", CVAR_ARCHIVE, "Max. size of the image cache in MB");
 	r_screenshot_format = Cvar_Get("r_screenshot_format", "jpg", CVAR_ARCHIVE, "png, jpg or tga are valid screenshot formats");
 	r_screenshot_jpeg_quality = Cvar_Get("r_screenshot_jpeg_quality", "75", CVAR_ARCHIVE, "jpeg quality in percent for jpeg screenshots");
 	r_threads = Cvar_Get("r_threads", "0", CVAR_ARCHIVE, "Activate threads for the renderer");
@@ -144,7 +144,7 @@ static qboolean R_LoadModel (model_t *mod, const char *filename)
 
 	case IDMD3HEADER:
 		/* MD3 header */
-		R_ModLoadAliasMD3Model(mod, buf, modfilelen);
+		R_ModLoadAliasMD3Model(mod, buf, modfilelen, qtrue);
 		break;
 
 	case IDBSPHEADER:
@@ -287,36 +287,33 @@ qboolean R_ModLoadMDX (model_t *mod)
 }
 
 /**
- * @brief Calculates normals and tangents for all frames and does vertex merging based on smoothness
+ * @brief Calculates normals and tangents for the first frame and decides which vertices can be merged based on smoothness
+ * @note This is the expensive part of the vertex merging - the result can be stored in the mesh cache
  * @param mesh The mesh to calculate normals for
- * @param nFrames How many frames the mesh has
  * @param smoothness How aggressively should normals be smoothed; value is compared with dotproduct of vectors to decide if they should be merged
- * @sa R_ModCalcNormalsAndTangents
+ * @param[out] newIndexArray The merged vertex for each of the @c num_tris * 3 triangle vertices
+ * @param[out] sourceVerts The vertex of @c mesh every merged vertex is taken from
+ * @return The amount of merged vertices
+ * @sa R_ModMergeVertices
  */
-void R_ModCalcUniqueNormalsAndTangents (mAliasMesh_t *mesh, int nFrames, float smoothness)
+int R_ModFindUniqueVertices (const mAliasMesh_t *mesh, float smoothness, int32_t *newIndexArray, int32_t *sourceVerts)
 {
 	int i, j;
 	vec3_t triangleNormals[MAX_ALIAS_TRIS];
 	vec3_t triangleTangents[MAX_ALIAS_TRIS];
 	vec3_t triangleBitangents[MAX_ALIAS_TRIS];
 	const mAliasVertex_t *vertexes = mesh->vertexes;
-	mAliasCoord_t *stcoords = mesh->stcoords;
-	mAliasVertex_t *newVertexes;
+	const mAliasCoord_t *stcoords = mesh->stcoords;
 	mAliasComplexVertex_t tmpVertexes[MAX_ALIAS_VERTS];
 	vec3_t tmpBitangents[MAX_ALIAS_VERTS];
-	mAliasCoord_t *newStcoords;
 	const int numIndexes = mesh->num_tris * 3;
 	const int32_t *indexArray = mesh->indexes;
-	int32_t *newIndexArray;
 	int indRemap[MAX_ALIAS_VERTS];
-	int sharedTris[MAX_ALIAS_VERTS];
 	int numVerts = 0;
 
 	if (numIndexes >= MAX_ALIAS_VERTS)
 		Com_Error(ERR_DROP, "model %s has too many tris", mesh->name);
 
-	newIndexArray = (int32_t *)Mem_PoolAlloc(sizeof(int32_t) * numIndexes, vid_modelPool, 0);
-
 	/* calculate per-triangle surface normals */
 	for (i = 0, j = 0; i < numIndexes; i += 3, j++) {
 		vec3_t dir1, dir2;
@@ -450,10 +447,35 @@ void R_ModCalcUniqueNormalsAndTangents (mAliasMesh_t *mesh, int nFrames, float s
 		VectorCopy(n, tmpVertexes[i].normal);
 		VectorCopy(t, tmpVertexes[i].tangent);
 
+		sourceVerts[numVerts] = indexArray[i];
 		newIndexArray[i] = numVerts++;
 		indRemap[i] = i;
 	}
 
+	return numVerts;
+}
+
+/**
+ * @brief Replaces the vertices of the mesh with the merged vertices
+ * @param mesh The mesh to merge the vertices for
+ * @param nFrames How many frames the mesh has
+ * @param numVerts The amount of merged vertices
+ * @param indexes The merged vertex for each of the @c num_tris * 3 triangle vertices
+ * @param sourceVerts The vertex of @c mesh every merged vertex is taken from
+ * @sa R_ModFindUniqueVertices
+ */
+void R_ModMergeVertices (mAliasMesh_t *mesh, int nFrames, int numVerts, const int32_t *indexes, const int32_t *sourceVerts)
+{
+	int i, j;
+	const int numIndexes = mesh->num_tris * 3;
+	mAliasVertex_t *newVertexes;
+	mAliasCoord_t *newStcoords;
+	int32_t *newIndexArray;
+	int sharedTris[MAX_ALIAS_VERTS];
+
+	newIndexArray = (int32_t *)Mem_PoolAlloc(sizeof(int32_t) * numIndexes, vid_modelPool, 0);
+	memcpy(newIndexArray, indexes, sizeof(int32_t) * numIndexes);
+
 	for (i = 0; i < numVerts; i++)
 		sharedTris[i] = 0;
 
@@ -467,27 +489,20 @@ void R_ModCalcUniqueNormalsAndTangents (mAliasMesh_t *mesh, int nFrames, float s
 		mesh->revIndexes[i].list = (int32_t *)Mem_PoolAlloc(sizeof(int32_t) * sharedTris[i], vid_modelPool, 0);
 	}
 
-	/* merge identical vertexes, storing only unique ones */
-	newVertexes = (mAliasVertex_t *)Mem_PoolAlloc(sizeof(mAliasVertex_t) * numVerts * nFrames, vid_modelPool, 0);
-	newStcoords = (mAliasCoord_t *)Mem_PoolAlloc(sizeof(mAliasCoord_t) * numVerts, vid_modelPool, 0);
 	for (i = 0; i < numIndexes; i++) {
-		const int idx = indexArray[indRemap[i]];
 		const int idx2 = newIndexArray[i];
-
-		/* add vertex to new vertex array */
-		VectorCopy(vertexes[idx].point, newVertexes[idx2].point);
-		Vector2Copy(stcoords[idx], newStcoords[idx2]);
 		mesh->revIndexes[idx2].list[mesh->revIndexes[idx2].length++] = i;
 	}
 
-	/* copy over the points from successive frames */
-	for (i = 1; i < nFrames; i++) {
-		for (j = 0; j < numIndexes; j++) {
-			const int idx = indexArray[indRemap[j]] + (mesh->num_verts * i);
-			const int idx2 = newIndexArray[j] + (numVerts * i);
+	/* merge identical vertexes, storing only unique ones */
+	newVertexes = (mAliasVertex_t *)Mem_PoolAlloc(sizeof(mAliasVertex_t) * numVerts * nFrames, vid_modelPool, 0);
+	newStcoords = (mAliasCoord_t *)Mem_PoolAlloc(sizeof(mAliasCoord_t) * numVerts, vid_modelPool, 0);
+	for (i = 0; i < numVerts; i++) {
+		Vector2Copy(mesh->stcoords[sourceVerts[i]], newStcoords[i]);
 
-			VectorCopy(vertexes[idx].point, newVertexes[idx2].point);
-		}
+		/* copy over the points of all frames */
+		for (j = 0; j < nFrames; j++)
+			VectorCopy(mesh->vertexes[sourceVerts[i] + mesh->num_verts * j].point, newVertexes[i + numVerts * j].point);
 	}
 
 	/* copy new arrays back into original mesh */
@@ -501,6 +516,135 @@ void R_ModCalcUniqueNormalsAndTangents (mAliasMesh_t *mesh, int nFrames, float s
 	mesh->indexes = newIndexArray;
 }
 
+/**
+ * @brief Calculates normals and tangents for all frames and does vertex merging based on smoothness
+ * @param mesh The mesh to calculate normals for
+ * @param nFrames How many frames the mesh has
+ * @param smoothness How aggressively should normals be smoothed; value is compared with dotproduct of vectors to decide if they should be merged
+ * @sa R_ModCalcNormalsAndTangents
+ * @sa R_ModLoadMeshCache
+ */
+void R_ModCalcUniqueNormalsAndTangents (mAliasMesh_t *mesh, int nFrames, float smoothness)
+{
+	int32_t newIndexArray[MAX_ALIAS_VERTS];
+	int32_t sourceVerts[MAX_ALIAS_VERTS];
+	const int numVerts = R_ModFindUniqueVertices(mesh, smoothness, newIndexArray, sourceVerts);
+
+	R_ModMergeVertices(mesh, nFrames, numVerts, newIndexArray, sourceVerts);
+}
+
+/**
+ * @brief Reads the cached vertex merging of one mesh from a mesh cache file
+ * @param[in] mesh The mesh the entry should belong to
+ * @param[in,out] data The current read position in the cache file
+ * @param[in] end The end of the cache file
+ * @return The amount of merged vertices or @c -1 if the entry doesn't fit to the mesh
+ * @sa R_ModLoadMeshCache
+ */
+static int R_ModReadMeshCacheEntry (const mAliasMesh_t *mesh, const byte **data, const byte *end, int32_t *indexes, int32_t *sourceVerts)
+{
+	dAMCMesh_t entry;
+	const int32_t *in;
+	int i, numVerts, numIndexes;
+
+	if (end - *data < sizeof(entry))
+		return -1;
+	memcpy(&entry, *data, sizeof(entry));
+	numVerts = LittleLong(entry.numVerts);
+	numIndexes = LittleLong(entry.numIndexes);
+
+	if (numIndexes != mesh->num_tris * 3 || numIndexes >= MAX_ALIAS_VERTS
+	 || numVerts <= 0 || numVerts > numIndexes
+	 || end - *data < sizeof(entry) + (numIndexes + numVerts) * sizeof(int32_t))
+		return -1;
+
+	in = (const int32_t *)(*data + sizeof(entry));
+	for (i = 0; i < numIndexes; i++, in++) {
+		indexes[i] = LittleLong(*in);
+		if (indexes[i] < 0 || indexes[i] >= numVerts)
+			return -1;
+	}
+	for (i = 0; i < numVerts; i++, in++) {
+		sourceVerts[i] = LittleLong(*in);
+		if (sourceVerts[i] < 0 || sourceVerts[i] >= mesh->num_verts)
+			return -1;
+	}
+
+	*data = (const byte *)in;
+	return numVerts;
+}
+
+/**
+ * @brief Merges the vertices of all meshes of a model file with the data of its mesh cache (amc) file
+ * instead of calculating it with @c R_ModCalcUniqueNormalsAndTangents
+ * @param[in] fileName The model file the meshes were loaded from
+ * @param[in] buffer The content of the model file - the cache is only used if it was generated for this content
+ * @param[in] bufSize The size of @c buffer
+ * @param[in,out] meshes The meshes that were loaded from the model file, their vertices are not merged yet
+ * @param[in] numMeshes The amount of meshes that were loaded from the model file
+ * @param[in] nFrames How many frames the meshes have
+ * @return @c false if there is no valid cache file - the meshes are untouched then
+ * @note The amc files are generated by ufomodel
+ */
+qboolean R_ModLoadMeshCache (const char *fileName, const byte *buffer, int bufSize, mAliasMesh_t *meshes, int numMeshes, int nFrames)
+{
+	char amcFileName[MAX_QPATH];
+	int32_t indexes[MAX_ALIAS_VERTS];
+	int32_t sourceVerts[MAX_ALIAS_VERTS];
+	dAMCHeader_t header;
+	const byte *data, *end;
+	byte *buf;
+	int i, length;
+
+	Com_StripExtension(fileName, amcFileName, sizeof(amcFileName));
+	Com_DefaultExtension(amcFileName, sizeof(amcFileName), ".amc");
+
+	length = FS_LoadFile(amcFileName, &buf);
+	if (!buf)
+		return qfalse;
+
+	if (length < sizeof(header)) {
+		Com_Printf("R_ModLoadMeshCache: %s is truncated\n", amcFileName);
+		FS_FreeFile(buf);
+		return qfalse;
+	}
+
+	memcpy(&header, buf, sizeof(header));
+	header.ident = LittleLong(header.ident);
+	header.version = LittleLong(header.version);
+	header.checksum = LittleLong(header.checksum);
+	header.numMeshes = LittleLong(header.numMeshes);
+
+	if (header.ident != IDAMCHEADER || header.version != AMC_VERSION || header.numMeshes != numMeshes
+	 || header.checksum != Com_BlockChecksum(buffer, bufSize)) {
+		Com_DPrintf(DEBUG_RENDERER, "R_ModLoadMeshCache: %s doesn't match %s\n", amcFileName, fileName);
+		FS_FreeFile(buf);
+		return qfalse;
+	}
+
+	/* check all entries first to not leave some of the meshes merged and the others not */
+	end = buf + length;
+	data = buf + sizeof(header);
+	for (i = 0; i < numMeshes; i++) {
+		if (R_ModReadMeshCacheEntry(&meshes[i], &data, end, indexes, sourceVerts) == -1)
+			break;
+	}
+	if (i != numMeshes || data != end) {
+		Com_Printf("R_ModLoadMeshCache: %s is corrupted\n", amcFileName);
+		FS_FreeFile(buf);
+		return qfalse;
+	}
+
+	data = buf + sizeof(header);
+	for (i = 0; i < numMeshes; i++) {
+		const int numVerts = R_ModReadMeshCacheEntry(&meshes[i], &data, end, indexes, sourceVerts);
+		R_ModMergeVertices(&meshes[i], nFrames, numVerts, indexes, sourceVerts);
+	}
+
+	FS_FreeFile(buf);
+	return qtrue;
+}
+
 image_t* R_AliasModelGetSkin (const char *modelFileName, const char *skin)
 {
 	image_t* result;
@@ -170,6 +170,9 @@ typedef	struct	mAliasModel_s {
 void R_ModLoadAnims(mAliasModel_t *mod, const char *buffer);
 qboolean R_ModLoadMDX(struct model_s *mod);
 void R_ModCalcUniqueNormalsAndTangents(mAliasMesh_t *mesh, int nFrames, float smoothness);
+int R_ModFindUniqueVertices(const mAliasMesh_t *mesh, float smoothness, int32_t *newIndexArray, int32_t *sourceVerts);
+void R_ModMergeVertices(mAliasMesh_t *mesh, int nFrames, int numVerts, const int32_t *indexes, const int32_t *sourceVerts);
+qboolean R_ModLoadMeshCache(const char *fileName, const byte *buffer, int bufSize, mAliasMesh_t *meshes, int numMeshes, int nFrames);
 void R_FillArrayData(mAliasModel_t* mod, mAliasMesh_t *mesh, float backlerp, int framenum, int oldframenum, qboolean prerender);
 void R_ModLoadArrayData(mAliasModel_t *mod, mAliasMesh_t *mesh, qboolean loadNormals);
 #endif
@@ -992,7 +992,7 @@ static void R_ModAddMapTile (const char *name, qboolean day, int sX, int sY, int
 	/* test version */
 	header = (dBspHeader_t *) buffer;
 	i = LittleLong(header->version);
-	if (i != BSPVERSION)
+	if (!BSP_IsSupportedVersion(i))
 		Com_Error(ERR_DROP, "R_ModAddMapTile: %s has wrong version number (%i should be %i)", r_worldmodel->name, i, BSPVERSION);
 
 	/* swap all the lumps */
@@ -418,8 +418,9 @@ static void R_ModLoadAliasMD2MeshIndexed (model_t *mod, const dMD2Model_t *md2,
 
 /**
  * @brief See if the model has an MDX file, and then load the model data appropriately for either case
+ * @param fileName The md2 file the mesh is loaded from - differs from the model name for lod meshes
  */
-static void R_ModLoadAliasMD2Mesh (model_t *mod, const dMD2Model_t *md2, int bufSize, qboolean loadNormals)
+static void R_ModLoadAliasMD2Mesh (model_t *mod, const char *fileName, const dMD2Model_t *md2, int bufSize, qboolean loadNormals)
 {
 	int version;
 	size_t size;
@@ -446,8 +447,11 @@ static void R_ModLoadAliasMD2Mesh (model_t *mod, const dMD2Model_t *md2, int buf
 		if (R_ModLoadMDX(mod)) {
 			R_ModLoadAliasMD2MeshIndexed(mod, md2, bufSize);
 		} else {
-			/* compute normals and tangents */
-			R_ModLoadAliasMD2MeshUnindexed(mod, md2, bufSize, qtrue);
+			mAliasMesh_t *mesh = &mod->alias.meshes[mod->alias.num_meshes - 1];
+			R_ModLoadAliasMD2MeshUnindexed(mod, md2, bufSize, qfalse);
+			/* compute normals and tangents - unless the mesh cache already has them */
+			if (!R_ModLoadMeshCache(fileName, (const byte *)md2, bufSize, mesh, 1, mod->alias.num_frames))
+				R_ModCalcUniqueNormalsAndTangents(mesh, mod->alias.num_frames, 0.5);
 		}
 	} else {
 		/* don't load normals and tangents */
@@ -486,7 +490,7 @@ static void R_ModLoadLevelOfDetailData (model_t* mod, qboolean loadNormals)
 			/* get the disk data */
 			md2 = (const dMD2Model_t *) buf;
 
-			R_ModLoadAliasMD2Mesh(mod, md2, bufSize, loadNormals);
+			R_ModLoadAliasMD2Mesh(mod, fileName, md2, bufSize, loadNormals);
 
 			FS_FreeFile(buf);
 		}
@@ -515,7 +519,7 @@ void R_ModLoadAliasMD2Model (model_t *mod, byte *buffer, int bufSize, qboolean l
 
 	ClearBounds(mod->mins, mod->maxs);
 
-	R_ModLoadAliasMD2Mesh(mod, md2, bufSize, loadNormals);
+	R_ModLoadAliasMD2Mesh(mod, mod->name, md2, bufSize, loadNormals);
 
 	/* load the tags */
 	Com_StripExtension(mod->name, tagname, sizeof(tagname));
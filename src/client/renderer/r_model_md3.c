@@ -34,8 +34,9 @@ MD3 ALIAS MODELS
 /**
  * @brief Load MD3 models from file.
  * @note Some Vic code here not fully used
+ * @param loadNormals If false the vertices are not merged and no normals and tangents are calculated
  */
-void R_ModLoadAliasMD3Model (model_t *mod, byte *buffer, int bufSize)
+void R_ModLoadAliasMD3Model (model_t *mod, byte *buffer, int bufSize, qboolean loadNormals)
 {
 	int version, i, j, l;
 	const dmd3_t *md3;
@@ -204,10 +205,15 @@ void R_ModLoadAliasMD3Model (model_t *mod, byte *buffer, int bufSize)
 			}
 		}
 
-		R_ModCalcUniqueNormalsAndTangents(poutmesh, mod->alias.num_frames, 0.5);
-
 		pinmesh = (const dmd3mesh_t *)((const byte *)pinmesh + LittleLong(pinmesh->meshsize));
+	}
 
-		R_ModLoadArrayData(&mod->alias, poutmesh, qtrue);
+	/* the vertex merging is the most expensive part of the loading - take it from the mesh cache if possible */
+	if (loadNormals && !R_ModLoadMeshCache(mod->name, buffer, bufSize, mod->alias.meshes, mod->alias.num_meshes, mod->alias.num_frames)) {
+		for (i = 0, poutmesh = mod->alias.meshes; i < mod->alias.num_meshes; i++, poutmesh++)
+			R_ModCalcUniqueNormalsAndTangents(poutmesh, mod->alias.num_frames, 0.5);
 	}
+
+	for (i = 0, poutmesh = mod->alias.meshes; i < mod->alias.num_meshes; i++, poutmesh++)
+		R_ModLoadArrayData(&mod->alias, poutmesh, loadNormals);
 }
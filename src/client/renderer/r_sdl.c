@@ -264,6 +264,14 @@ qboolean R_InitGraphics (const viddefContext_t *context)
 
 	SDL_ShowCursor(SDL_DISABLE);
 
+	/* without a gamma ramp the colour textures are gamma corrected while they are loaded */
+	r_config.hwgamma = qfalse;
+	if (!vid_ignoregamma->integer) {
+		const float g = vid_gamma->value;
+		r_config.hwgamma = SDL_SetGamma(g, g, g) == 0;
+		vid_gamma->modified = qfalse;
+	}
+
 	return qtrue;
 }
 
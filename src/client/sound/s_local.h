@@ -39,11 +39,32 @@ extern memPool_t *cl_soundSysPool;
 /** @brief Supported sound file extensions */
 #define SAMPLE_TYPES { "ogg", "wav", NULL }
 
+/** @brief The decoding state of a sample - @sa S_SampleReady */
+typedef enum {
+	SAMPLE_UNLOADED,	/**< registered, but not (or no longer) decoded */
+	SAMPLE_LOADING,		/**< queued for the decoding thread */
+	SAMPLE_READY,		/**< the chunk can be played */
+	SAMPLE_FAILED		/**< the sound file could not be decoded */
+} sampleState_t;
+
 typedef struct s_sample_s {
 	char *name;
 	int lastPlayed;		/**< used to determine whether this sample should be send to the mixer or skipped if played
 						 * too fast after each other */
-	Mix_Chunk* chunk;
+	Mix_Chunk* chunk;	/**< only valid for @c SAMPLE_READY */
+	sampleState_t state;
+	int extension;		/**< index of the file extension in @c SAMPLE_TYPES */
+	qboolean pinned;	/**< precached samples that are never dropped from the sample cache */
+	int lastUsed;		/**< used to drop the least recently used samples from the sample cache */
+
+	/* play request that was issued while the sample was still decoded */
+	qboolean pendingPlay;
+	qboolean pendingHasOrigin;
+	vec3_t pendingOrigin;
+	float pendingAtten;
+	float pendingVolume;
+	int pendingTime;
+
 	struct s_sample_s* hashNext;	/**< next hash entry */
 	int index;			/** index in the array of samples */
 } s_sample_t;
@@ -73,6 +94,8 @@ typedef struct s_env_s {
 
 extern cvar_t *snd_volume;
 extern cvar_t *snd_distance_scale;
+extern cvar_t *snd_samplecache;
+extern cvar_t *snd_async;
 
 extern s_env_t s_env;
 
@@ -40,7 +40,10 @@ s_env_t s_env;
 
 cvar_t *snd_volume;
 cvar_t *snd_distance_scale;
+cvar_t *snd_samplecache;
+cvar_t *snd_async;
 static cvar_t *snd_init;
+static cvar_t *snd_driver;
 static cvar_t *snd_rate;
 static cvar_t *snd_chunkbufsize;
 
@@ -76,6 +79,7 @@ void S_Frame (void)
 	if (!s_env.initialized)
 		return;
 
+	S_UpdateSamples();
 	M_Frame();
 
 	if (CL_OnBattlescape()) {
@@ -217,6 +221,9 @@ void S_Init (void)
 #else
 	snd_chunkbufsize = Cvar_Get("snd_chunkbufsize", "1024", CVAR_ARCHIVE, "The sound buffer chunk size");
 #endif
+	snd_samplecache = Cvar_Get("snd_samplecache", "32", CVAR_ARCHIVE, "Maximum size of the decoded sound samples in megabytes - 0 means no limit");
+	snd_async = Cvar_Get("snd_async", "1", CVAR_ARCHIVE, "Decode the sound samples in a background thread");
+	snd_driver = Cvar_Get("snd_driver", "", CVAR_ARCHIVE, "The SDL audio driver - 'dummy' runs the sound system without a sound device");
 	/* set volumes to be changed so they are applied again for next sound/music playing */
 	/** @todo implement the volume change for already loaded sample chunks */
 	snd_volume->modified = qtrue;
@@ -225,6 +232,8 @@ void S_Init (void)
 	Cmd_AddParamCompleteFunction("snd_play", S_CompleteSounds);
 
 	if (SDL_WasInit(SDL_INIT_AUDIO) == 0) {
+		if (snd_driver->string[0] != '\0')
+			Sys_Setenv("SDL_AUDIODRIVER", snd_driver->string);
 		if (SDL_Init(SDL_INIT_AUDIO) < 0) {
 			Com_Printf("S_Init: %s.\n", SDL_GetError());
 			return;
@@ -338,6 +347,7 @@ void S_PlayStdSample(const stdsound_t sId, const vec3_t origin, float attenuatio
 /**
  * @brief Loads and registers a sound file for later use
  * @param[in] soundFile The name of the soundfile, relative to the sounds dir
+ * @note The sample is decoded in the background - see @c S_SampleReady
  */
 s_sample_t *S_LoadSample (const char *soundFile)
 {
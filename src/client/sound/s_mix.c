@@ -107,6 +107,18 @@ void S_PlaySample (const vec3_t origin, s_sample_t* sample, float atten, float r
 	if (!sample)
 		return;
 
+	if (!S_SampleReady(sample)) {
+		/* play it as soon as the decoding thread is done with it */
+		sample->pendingPlay = qtrue;
+		sample->pendingHasOrigin = (origin != NULL);
+		if (origin != NULL)
+			VectorCopy(origin, sample->pendingOrigin);
+		sample->pendingAtten = atten;
+		sample->pendingVolume = relVolume;
+		sample->pendingTime = CL_Milliseconds();
+		return;
+	}
+
 	/* if the last mix of this particular sample is less than half a second ago, skip it */
 	if (sample->lastPlayed > CL_Milliseconds() - s_env.sampleRepeatRate)
 		return;
@@ -140,7 +152,7 @@ void S_LoopSample (const vec3_t org, s_sample_t *sample, float relVolume, float
 	s_channel_t *ch;
 	int i;
 
-	if (!sample || !sample->chunk)
+	if (!sample || !S_SampleReady(sample))
 		return;
 
 	ch = NULL;
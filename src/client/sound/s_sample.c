@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "s_main.h"		/* for MAX_SOUNDIDS */
 #include "../../common/filesys.h"	/* for MAX_QPATH */
 #include "../../common/common.h"	/* for many */
+#include "../../shared/mutex.h"
 
 #define SAMPLE_HASH_SIZE 64
 static s_sample_t *sampleHash[SAMPLE_HASH_SIZE];
@@ -39,6 +40,32 @@ static int sampleIndexLast = 0;
 /** this pool is reloaded on every sound system restart */
 s_sample_t *stdSoundPool[MAX_SOUNDIDS];
 
+/** play requests for samples that are still decoded are dropped if the decoding took longer than this (in ms) */
+#define SAMPLE_MAX_PLAY_DELAY 300
+#define SAMPLE_MAX_JOBS 256
+
+/** @brief A sound file that is decoded by the decoding thread */
+typedef struct sampleJob_s {
+	s_sample_t *sample;
+	byte *buffer;		/**< the file content - it's loaded on the main thread, the filesystem is not thread safe */
+	int length;
+	Mix_Chunk *chunk;	/**< the decoded sample, @c NULL if the decoding failed */
+} sampleJob_t;
+
+/* the job queue - the jobs between collected and decoded are done, the jobs
+ * between decoded and queued are waiting for the decoding thread */
+static sampleJob_t sampleJobs[SAMPLE_MAX_JOBS];
+static unsigned int sampleJobsQueued;
+static unsigned int sampleJobsDecoded;
+static unsigned int sampleJobsCollected;
+static qboolean sampleThreadShutdown;
+static threads_mutex_t *sampleLock;
+static SDL_cond *sampleCond;
+static SDL_Thread *sampleThread;
+
+static size_t sampleCacheSize;	/**< bytes of all the decoded samples */
+static int sampleUseCount;		/**< increased with every use of a sample - for the least recently used order */
+
 /**
  * @brief Searches the hash for a given sound file
  * @param name The soundfile (relative to the sound dir and without extension)
@@ -56,60 +83,287 @@ static s_sample_t *S_FindByName (const char *name)
 	return NULL;
 }
 
-static Mix_Chunk* S_LoadSampleChunk (const char *sound)
+/**
+ * @note Thread safe - no filesystem or engine functions are used
+ */
+static Mix_Chunk* S_DecodeSampleChunk (byte *buffer, int length)
 {
-	size_t len;
-	byte *buf;
-	const char *soundExtensions[] = SAMPLE_TYPES;
-	const char **extension = soundExtensions;
 	SDL_RWops *rw;
 	Mix_Chunk *chunk;
 
-	if (!sound || sound[0] == '*')
+	if (!(rw = SDL_RWFromMem(buffer, length)))
 		return NULL;
 
-	len = strlen(sound);
-	if (len + 4 >= MAX_QPATH) {
-		Com_Printf("S_LoadSound: MAX_QPATH exceeded for: '%s'\n", sound);
-		return NULL;
+	chunk = Mix_LoadWAV_RW(rw, qfalse);
+	SDL_FreeRW(rw);
+
+	return chunk;
+}
+
+/**
+ * @brief Loads the sound file of a sample, starting at the sample's current file extension
+ * @return The length of the file or @c -1 if there is no (further) sound file
+ */
+static int S_LoadSampleFile (s_sample_t *sample, byte **buffer)
+{
+	const char *soundExtensions[] = SAMPLE_TYPES;
+
+	for (; soundExtensions[sample->extension]; sample->extension++) {
+		const int length = FS_LoadFile(va("sound/%s.%s", sample->name, soundExtensions[sample->extension]), buffer);
+		if (length != -1)
+			return length;
 	}
 
-	while (*extension) {
-		if ((len = FS_LoadFile(va("sound/%s.%s", sound, *extension++), &buf)) == -1)
-			continue;
+	return -1;
+}
+
+static qboolean S_SamplePlaying (const s_sample_t *sample)
+{
+	int i;
+
+	for (i = 0; i < MAX_CHANNELS; i++)
+		if (s_env.channels[i].sample == sample)
+			return qtrue;
+
+	return qfalse;
+}
+
+static void S_UnloadSample (s_sample_t *sample)
+{
+	sampleCacheSize -= sample->chunk->alen;
+	Mix_FreeChunk(sample->chunk);
+	sample->chunk = NULL;
+	sample->state = SAMPLE_UNLOADED;
+}
+
+/**
+ * @brief Drops the least recently used samples until the decoded samples fit into @c snd_samplecache
+ * @note Pinned samples and samples that are currently played are kept
+ */
+static void S_TrimSampleCache (void)
+{
+	const size_t maxSize = (size_t)max(snd_samplecache->integer, 0) * 1024 * 1024;
+
+	/* no limit */
+	if (!maxSize)
+		return;
 
-		if (!(rw = SDL_RWFromMem(buf, len))){
-			FS_FreeFile(buf);
-			continue;
+	while (sampleCacheSize > maxSize) {
+		s_sample_t *oldest = NULL;
+		int i;
+
+		for (i = 1; i <= sampleIndexLast; i++) {
+			s_sample_t *sample = sampleIndex[i];
+			if (sample->state != SAMPLE_READY || sample->pinned)
+				continue;
+			if (oldest && oldest->lastUsed <= sample->lastUsed)
+				continue;
+			if (S_SamplePlaying(sample))
+				continue;
+			oldest = sample;
 		}
 
-		if (!(chunk = Mix_LoadWAV_RW(rw, qfalse)))
-			Com_Printf("S_LoadSound: %s.\n", Mix_GetError());
+		if (!oldest)
+			break;
 
-		FS_FreeFile(buf);
+		Com_DPrintf(DEBUG_SOUND, "S_TrimSampleCache: drop sample '%s'\n", oldest->name);
+		S_UnloadSample(oldest);
+	}
+}
 
-		SDL_FreeRW(rw);
+static void S_QueueSample(s_sample_t *sample);
 
-		if (chunk)
-			return chunk;
+/**
+ * @brief Takes over the decoded chunk of a sample and plays the sample if this was requested in the meantime
+ * @param[in] chunk The decoded chunk - if this is @c NULL the next sound file of the sample is tried
+ */
+static void S_FinishSample (s_sample_t *sample, Mix_Chunk *chunk)
+{
+	if (!chunk) {
+		Com_Printf("S_LoadSound: Could not decode sound file: '%s'\n", sample->name);
+		sample->state = SAMPLE_UNLOADED;
+		sample->extension++;
+		S_QueueSample(sample);
+		return;
 	}
 
-	Com_Printf("S_LoadSound: Could not find sound file: '%s'\n", sound);
-	return NULL;
+	sample->chunk = chunk;
+	sample->state = SAMPLE_READY;
+	sampleCacheSize += chunk->alen;
+
+	if (sample->pendingPlay) {
+		sample->pendingPlay = qfalse;
+		/* don't play e.g. a shot when the fire animation is already over */
+		if (CL_Milliseconds() - sample->pendingTime < SAMPLE_MAX_PLAY_DELAY)
+			S_PlaySample(sample->pendingHasOrigin ? sample->pendingOrigin : NULL, sample, sample->pendingAtten, sample->pendingVolume);
+	}
+
+	S_TrimSampleCache();
+}
+
+/**
+ * @brief Decoding thread - works off the job queue
+ * @sa S_QueueSample
+ */
+static int S_DecodeThread (void *data)
+{
+	for (;;) {
+		sampleJob_t *job;
+
+		TH_MutexLock(sampleLock);
+		while (sampleJobsDecoded == sampleJobsQueued && !sampleThreadShutdown)
+			TH_MutexCondWait(sampleLock, sampleCond);
+		if (sampleThreadShutdown) {
+			TH_MutexUnlock(sampleLock);
+			break;
+		}
+		job = &sampleJobs[sampleJobsDecoded % SAMPLE_MAX_JOBS];
+		TH_MutexUnlock(sampleLock);
+
+		job->chunk = S_DecodeSampleChunk(job->buffer, job->length);
+
+		TH_MutexLock(sampleLock);
+		sampleJobsDecoded++;
+		TH_MutexUnlock(sampleLock);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Loads the sound file of an unloaded sample and hands it over to the decoding thread
+ * @note If @c snd_async is off the sample is decoded right away
+ * @sa S_UpdateSamples
+ */
+static void S_QueueSample (s_sample_t *sample)
+{
+	sampleJob_t *job;
+	byte *buffer;
+	int length;
+
+	if (sample->state != SAMPLE_UNLOADED)
+		return;
+
+	/* the next play request tries again */
+	if (sampleJobsQueued - sampleJobsCollected >= SAMPLE_MAX_JOBS)
+		return;
+
+	length = S_LoadSampleFile(sample, &buffer);
+	if (length == -1) {
+		Com_Printf("S_LoadSound: Could not find sound file: '%s'\n", sample->name);
+		sample->state = SAMPLE_FAILED;
+		return;
+	}
+
+	if (!snd_async->integer) {
+		Mix_Chunk *chunk = S_DecodeSampleChunk(buffer, length);
+		FS_FreeFile(buffer);
+		S_FinishSample(sample, chunk);
+		return;
+	}
+
+	if (!sampleThread) {
+		sampleLock = TH_MutexCreate("sound samples");
+		sampleCond = SDL_CreateCond();
+		sampleThread = SDL_CreateThread(S_DecodeThread, NULL);
+	}
+
+	sample->state = SAMPLE_LOADING;
+	job = &sampleJobs[sampleJobsQueued % SAMPLE_MAX_JOBS];
+	job->sample = sample;
+	job->buffer = buffer;
+	job->length = length;
+	job->chunk = NULL;
+
+	TH_MutexLock(sampleLock);
+	sampleJobsQueued++;
+	SDL_CondSignal(sampleCond);
+	TH_MutexUnlock(sampleLock);
+}
+
+/**
+ * @brief Takes over the samples that were decoded by the decoding thread
+ * @sa S_Frame
+ */
+void S_UpdateSamples (void)
+{
+	unsigned int decoded;
+
+	if (!sampleThread)
+		return;
+
+	TH_MutexLock(sampleLock);
+	decoded = sampleJobsDecoded;
+	TH_MutexUnlock(sampleLock);
+
+	while (sampleJobsCollected != decoded) {
+		const sampleJob_t *job = &sampleJobs[sampleJobsCollected % SAMPLE_MAX_JOBS];
+		s_sample_t *sample = job->sample;
+		Mix_Chunk *chunk = job->chunk;
+
+		FS_FreeFile(job->buffer);
+		sampleJobsCollected++;
+		S_FinishSample(sample, chunk);
+	}
+}
+
+static void S_ShutdownDecodeThread (void)
+{
+	if (!sampleThread)
+		return;
+
+	TH_MutexLock(sampleLock);
+	sampleThreadShutdown = qtrue;
+	SDL_CondSignal(sampleCond);
+	TH_MutexUnlock(sampleLock);
+	SDL_WaitThread(sampleThread, NULL);
+
+	/* drop the jobs that were not collected yet */
+	for (; sampleJobsCollected != sampleJobsQueued; sampleJobsCollected++) {
+		sampleJob_t *job = &sampleJobs[sampleJobsCollected % SAMPLE_MAX_JOBS];
+		if (job->chunk)
+			Mix_FreeChunk(job->chunk);
+		FS_FreeFile(job->buffer);
+	}
+
+	SDL_DestroyCond(sampleCond);
+	TH_MutexDestroy(sampleLock);
+	sampleCond = NULL;
+	sampleLock = NULL;
+	sampleThread = NULL;
+	sampleThreadShutdown = qfalse;
+	sampleJobsQueued = sampleJobsDecoded = sampleJobsCollected = 0;
 }
 
 /**
- * @brief Loads and registers a sound file for later use
+ * @brief Marks the sample as used and starts the decoding if the sample is not in memory
+ * @return @c true if the sample can be played right away
+ * @sa S_PlaySample
+ */
+qboolean S_SampleReady (s_sample_t *sample)
+{
+	sample->lastUsed = ++sampleUseCount;
+
+	if (sample->state == SAMPLE_UNLOADED)
+		S_QueueSample(sample);
+
+	return sample->state == SAMPLE_READY;
+}
+
+/**
+ * @brief Registers a sound file for later use and starts decoding it in the background
  * @param[in] soundFile The name of the soundfile, relative to the sounds dir
- * @return The index of the loaded sample or 0
+ * @return The index of the sample or 0 if there is no such sound file
+ * @note The returned sample might not be decoded yet - it's played as soon as the decoding is done
  * @sa S_LoadSound
  */
 int S_LoadSampleIdx (const char *soundFile)
 {
-	Mix_Chunk *chunk;
+	const char *soundExtensions[] = SAMPLE_TYPES;
 	s_sample_t *sample;
 	char name[MAX_QPATH];
 	unsigned hash;
+	int extension;
 
 	if (!s_env.initialized)
 		return 0;
@@ -120,19 +374,40 @@ int S_LoadSampleIdx (const char *soundFile)
 	if (sample)
 		return sample->index;
 
-	/* make sure the sound is loaded */
-	chunk = S_LoadSampleChunk(name);
-	if (!chunk)
-		return 0;		/* couldn't load the sound's data */
+	if (name[0] == '\0' || name[0] == '*')
+		return 0;
+
+	if (strlen(name) + 4 >= MAX_QPATH) {
+		Com_Printf("S_LoadSound: MAX_QPATH exceeded for: '%s'\n", name);
+		return 0;
+	}
+
+	/* make sure the sound exists */
+	for (extension = 0; soundExtensions[extension]; extension++)
+		if (FS_CheckFile("sound/%s.%s", name, soundExtensions[extension]) != -1)
+			break;
+	if (!soundExtensions[extension]) {
+		Com_Printf("S_LoadSound: Could not find sound file: '%s'\n", name);
+		return 0;
+	}
+
+	if (sampleIndexLast >= SAMPLE_MAX_COUNT - 1) {
+		Com_Printf("S_LoadSound: SAMPLE_MAX_COUNT exceeded for: '%s'\n", name);
+		return 0;
+	}
 
 	hash = Com_HashKey(name, SAMPLE_HASH_SIZE);
 	sample = (s_sample_t *)Mem_PoolAlloc(sizeof(*sample), cl_soundSysPool, 0);
 	sample->name = Mem_PoolStrDup(name, cl_soundSysPool, 0);
-	sample->chunk = chunk;
+	sample->extension = extension;
+	sample->state = SAMPLE_UNLOADED;
 	sample->hashNext = sampleHash[hash];
 	sampleHash[hash] = sample;
 	sampleIndex[++sampleIndexLast] = sample;
 	sample->index = sampleIndexLast;
+
+	S_SampleReady(sample);
+
 	return sample->index;
 }
 
@@ -149,9 +424,12 @@ void S_FreeSamples (void)
 	int i;
 	s_sample_t* sample;
 
+	S_ShutdownDecodeThread();
+
 	for (i = 0; i < SAMPLE_HASH_SIZE; i++)
 		for (sample = sampleHash[i]; sample; sample = sample->hashNext) {
-			Mix_FreeChunk(sample->chunk);
+			if (sample->chunk)
+				Mix_FreeChunk(sample->chunk);
 			Mem_Free(sample->name);
 		}
 
@@ -164,10 +442,27 @@ void S_FreeSamples (void)
 	}
 
 	OBJZERO(sampleHash);
+	OBJZERO(sampleIndex);
+	sampleIndexLast = 0;
+	sampleCacheSize = 0;
+	sampleUseCount = 0;
+}
+
+/**
+ * @brief Loads a sample that is never dropped from the sample cache
+ */
+static s_sample_t *S_PrecacheSample (const char *soundFile)
+{
+	s_sample_t *sample = S_LoadSample(soundFile);
+	if (sample)
+		sample->pinned = qtrue;
+	return sample;
 }
 
 /**
  * @note Called at precache phase - only load these soundfiles once at startup or on sound restart
+ * @note The weapon sounds are only decoded in the background and can be dropped from the sample
+ * cache again, the standard sounds stay in memory
  * @sa S_Restart_f
  */
 void S_PrecacheSamples (void)
@@ -196,7 +491,7 @@ void S_PrecacheSamples (void)
 	}
 
 	/* precache the sound pool */
-	stdSoundPool[SOUND_WATER_IN] = S_LoadSample("footsteps/water_in");
-	stdSoundPool[SOUND_WATER_OUT] = S_LoadSample("footsteps/water_out");
-	stdSoundPool[SOUND_WATER_MOVE] = S_LoadSample("footsteps/water_under");
+	stdSoundPool[SOUND_WATER_IN] = S_PrecacheSample("footsteps/water_in");
+	stdSoundPool[SOUND_WATER_OUT] = S_PrecacheSample("footsteps/water_out");
+	stdSoundPool[SOUND_WATER_MOVE] = S_PrecacheSample("footsteps/water_under");
 }
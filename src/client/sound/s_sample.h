@@ -32,6 +32,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 void S_PrecacheSamples(void);
 void S_FreeSamples(void);
+void S_UpdateSamples(void);
+qboolean S_SampleReady(s_sample_t *sample);
 s_sample_t *S_LoadSample(const char *s);
 s_sample_t *S_GetSample (const int soundIdx);
 void S_PlaySample(const vec3_t origin, s_sample_t* sample, float atten, float volume);
@@ -306,6 +306,7 @@ void UI_InsertNode (uiNode_t* const node, uiNode_t *prevNode, uiNode_t *newNode)
 	if (newNode->root && newNode->indexed)
 		UI_WindowNodeAddIndexedNode(newNode->root, newNode);
 
+	UI_InvalidateNodePathCache();
 	UI_Invalidate(node);
 }
 
@@ -348,6 +349,7 @@ uiNode_t* UI_RemoveNode (uiNode_t* const node, uiNode_t *child)
 	if (child->root && child->indexed)
 		UI_WindowNodeRemoveIndexedNode(child->root, child);
 
+	UI_InvalidateNodePathCache();
 	child->next = NULL;
 	return child;
 }
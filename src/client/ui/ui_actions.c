@@ -196,22 +196,37 @@ const char* UI_GetParam (const uiCallContext_t *context, int paramID)
 }
 
 /**
- * @brief Replace injection identifiers (e.g. &lt;eventParam&gt;) by a value
- * @note The injection identifier can be every node value - e.g. &lt;image&gt; or &lt;width&gt;.
- * It's also possible to do something like
- * @code
- * cmd "set someCvar &lt;min&gt;/&lt;max&gt;"
- * @endcode
+ * @brief Copy an injected value into the output buffer
+ * @param[out] cout Output buffer
+ * @param[in] length Free space into the output buffer
+ * @param[in] value Value to inject
+ * @param[in] valueLength Length of the value
+ * @return Number of chars written
  */
-const char* UI_GenInjectedString (const char* input, qboolean addNewLine, const uiCallContext_t *context)
+static inline int UI_InjectValue (char *cout, int length, const char *value, int valueLength)
 {
-	static char cmd[256];
-	int length = sizeof(cmd) - (addNewLine ? 2 : 1);
+	if (valueLength > length)
+		valueLength = length;
+	memcpy(cout, value, valueLength);
+	return valueLength;
+}
+
+/**
+ * @brief Interpret injection identifiers of a string and write the result into a buffer
+ * @param[in] input String to interpret
+ * @param[out] cout Output buffer
+ * @param[in] end End of the output buffer, nothing is written after it
+ * @param[in] context Call context of the script
+ * @return Position after the last char written into the output buffer
+ * @sa UI_GenInjectedString
+ */
+static char* UI_InterpretInjectedString (const char* input, char *cout, const char *end, const uiCallContext_t *context)
+{
+	int length = end - cout;
 	static char propertyName[MAX_VAR];
 	const char *cin = input;
-	char *cout = cmd;
 
-	while (length && cin[0] != '\0') {
+	while (length > 0 && cin[0] != '\0') {
 		if (cin[0] == '<') {
 			/* read propertyName between '<' and '>' */
 			const char *next = UI_GenCommandReadProperty(cin, propertyName, sizeof(propertyName));
@@ -219,7 +234,7 @@ const char* UI_GenInjectedString (const char* input, qboolean addNewLine, const
 				/* cvar injection */
 				if (Q_strstart(propertyName, "cvar:")) {
 					const cvar_t *cvar = Cvar_Get(propertyName + 5, "", 0, NULL);
-					const int l = snprintf(cout, length, "%s", cvar->string);
+					const int l = UI_InjectValue(cout, length, cvar->string, strlen(cvar->string));
 					cout += l;
 					cin = next;
 					length -= l;
@@ -249,7 +264,7 @@ const char* UI_GenInjectedString (const char* input, qboolean addNewLine, const
 						}
 					}
 
-					l = snprintf(cout, length, "%s", string);
+					l = UI_InjectValue(cout, length, string, strlen(string));
 					cout += l;
 					cin = next;
 					length -= l;
@@ -270,7 +285,8 @@ const char* UI_GenInjectedString (const char* input, qboolean addNewLine, const
 							Com_Printf("UI_GenCommand: Command '%s' for path injection unknown\n", command);
 
 						if (node) {
-							const int l = snprintf(cout, length, "%s", UI_GetPath(node));
+							const char *path = UI_GetPath(node);
+							const int l = UI_InjectValue(cout, length, path, strlen(path));
 							cout += l;
 							cin = next;
 							length -= l;
@@ -291,7 +307,7 @@ const char* UI_GenInjectedString (const char* input, qboolean addNewLine, const
 							value = UI_GetStringFromNodeProperty(context->source, property);
 							if (value == NULL)
 								value = "";
-							l = snprintf(cout, length, "%s", value);
+							l = UI_InjectValue(cout, length, value, strlen(value));
 							cout += l;
 							cin = next;
 							length -= l;
@@ -304,7 +320,8 @@ const char* UI_GenInjectedString (const char* input, qboolean addNewLine, const
 						int arg;
 						const int checked = sscanf(propertyName, "%d", &arg);
 						if (checked == 1 && arg >= 1 && arg <= UI_GetParamNumber(context)) {
-							const int l = snprintf(cout, length, "%s", UI_GetParam(context, arg));
+							const char *param = UI_GetParam(context, arg);
+							const int l = UI_InjectValue(cout, length, param, strlen(param));
 							cout += l;
 							cin = next;
 							length -= l;
@@ -321,6 +338,293 @@ const char* UI_GenInjectedString (const char* input, qboolean addNewLine, const
 	/* is buffer too small? */
 	assert(cin[0] == '\0');
 
+	return cout;
+}
+
+/**
+ * @brief Replace injection identifiers (e.g. &lt;eventParam&gt;) by a value
+ * @note The injection identifier can be every node value - e.g. &lt;image&gt; or &lt;width&gt;.
+ * It's also possible to do something like
+ * @code
+ * cmd "set someCvar &lt;min&gt;/&lt;max&gt;"
+ * @endcode
+ * @sa UI_GenInjectedActionString
+ */
+const char* UI_GenInjectedString (const char* input, qboolean addNewLine, const uiCallContext_t *context)
+{
+	static char cmd[256];
+	char *cout = UI_InterpretInjectedString(input, cmd, cmd + sizeof(cmd) - (addNewLine ? 2 : 1), context);
+
+	if (addNewLine)
+		*cout++ = '\n';
+
+	*cout++ = '\0';
+
+	/* copy the result into a free va slot */
+	return va("%s", cmd);
+}
+
+/** @brief Type of a part of a compiled string with injection */
+typedef enum {
+	UI_INJECTION_END,		/**< end of the compiled string */
+	UI_INJECTION_TEXT,		/**< raw text */
+	UI_INJECTION_CVAR,		/**< &lt;cvar:name&gt; */
+	UI_INJECTION_NODE,		/**< &lt;node:path&gt; */
+	UI_INJECTION_PATH,		/**< &lt;path:root&gt;, &lt;path:this&gt; or &lt;path:parent&gt; */
+	UI_INJECTION_PROPERTY	/**< &lt;name&gt;, a property of the source node or a param */
+} uiInjectionType_t;
+
+/** @brief Commands of UI_INJECTION_PATH */
+enum {
+	UI_INJECTIONPATH_UNKNOWN,
+	UI_INJECTIONPATH_ROOT,
+	UI_INJECTIONPATH_THIS,
+	UI_INJECTIONPATH_PARENT
+};
+
+/** @brief Max number of parts a string with injection can be compiled into */
+#define UI_MAX_INJECTIONS 32
+
+/**
+ * @brief Part of a string with injection, pre-parsed when the scripts are loaded
+ * @note A compiled string is an array of parts terminated by UI_INJECTION_END
+ * @sa UI_CompileInjectedString
+ */
+typedef struct uiInjection_s {
+	uiInjectionType_t type;
+	const char *source;		/**< start of the part into the source string */
+	const char *string;		/**< raw text, cvar name, node path, path command or property name */
+	int length;				/**< length of the raw text */
+	int param;				/**< param id (else 0) or path command */
+
+	/* resolution caches */
+	cvar_t *cvar;			/**< resolved cvar */
+	int cvarRevision;		/**< value of Cvar_GetRevision when the cvar was resolved */
+	const uiBehaviour_t *behaviour;	/**< behaviour the property was resolved from */
+	const value_t *property;		/**< resolved property, else NULL */
+} uiInjection_t;
+
+/**
+ * @brief Compile the injection identifiers of an action string, so that the string is not
+ * parsed anymore at each execution, and cvars and properties can be cached
+ * @param[in,out] action Action with a string with injection as @c d1; the compiled
+ * form is stored into @c d2
+ * @note If the string can't be compiled, UI_GenInjectedActionString will use the
+ * string interpreter
+ * @sa UI_GenInjectedActionString
+ */
+void UI_CompileInjectedString (uiAction_t *action)
+{
+	uiInjection_t injections[UI_MAX_INJECTIONS];
+	char propertyName[MAX_VAR];
+	const char *cin = action->d.terminal.d1.constString;
+	const char *text = NULL;
+	uiInjection_t *result;
+	int num = 0;
+
+	action->d.terminal.d2.data = NULL;
+	if (cin == NULL || !UI_IsInjectedString(cin))
+		return;
+
+	OBJZERO(injections);
+	while (cin[0] != '\0') {
+		if (cin[0] == '<') {
+			const char *next = UI_GenCommandReadProperty(cin, propertyName, sizeof(propertyName));
+			if (next) {
+				uiInjection_t *injection;
+				/* keep place for the text before and the end mark */
+				if (num + 3 > UI_MAX_INJECTIONS)
+					return;
+				if (text) {
+					injection = &injections[num++];
+					injection->type = UI_INJECTION_TEXT;
+					injection->source = injection->string = text;
+					injection->length = cin - text;
+					text = NULL;
+				}
+
+				injection = &injections[num++];
+				injection->source = cin;
+				if (Q_strstart(propertyName, "cvar:")) {
+					injection->type = UI_INJECTION_CVAR;
+					injection->string = UI_AllocStaticString(propertyName + 5, 0);
+				} else if (Q_strstart(propertyName, "node:")) {
+					injection->type = UI_INJECTION_NODE;
+					injection->string = UI_AllocStaticString(propertyName + 5, 0);
+				} else if (Q_strstart(propertyName, "path:")) {
+					const char *command = propertyName + 5;
+					injection->type = UI_INJECTION_PATH;
+					injection->string = UI_AllocStaticString(command, 0);
+					if (Q_streq(command, "root"))
+						injection->param = UI_INJECTIONPATH_ROOT;
+					else if (Q_streq(command, "this"))
+						injection->param = UI_INJECTIONPATH_THIS;
+					else if (Q_streq(command, "parent"))
+						injection->param = UI_INJECTIONPATH_PARENT;
+					else
+						injection->param = UI_INJECTIONPATH_UNKNOWN;
+				} else {
+					injection->type = UI_INJECTION_PROPERTY;
+					injection->string = UI_AllocStaticString(propertyName, 0);
+					if (sscanf(propertyName, "%d", &injection->param) != 1 || injection->param < 1)
+						injection->param = 0;
+				}
+				cin = next;
+				continue;
+			}
+		}
+		if (!text)
+			text = cin;
+		cin++;
+	}
+
+	if (text) {
+		uiInjection_t *injection;
+		if (num + 2 > UI_MAX_INJECTIONS)
+			return;
+		injection = &injections[num++];
+		injection->type = UI_INJECTION_TEXT;
+		injection->source = injection->string = text;
+		injection->length = cin - text;
+	}
+	injections[num++].type = UI_INJECTION_END;
+
+	result = (uiInjection_t *) UI_AllocHunkMemory(num * sizeof(*result), STRUCT_MEMORY_ALIGN, qfalse);
+	if (result == NULL)
+		return;
+	memcpy(result, injections, num * sizeof(*result));
+	action->d.terminal.d2.data = result;
+}
+
+/**
+ * @brief Compute the value of a compiled injection
+ * @param[in,out] injection The injection, its caches are updated
+ * @param[in] context Call context of the script
+ * @return The value to inject, else NULL if the injection can't be resolved
+ * and must be handled as raw text
+ */
+static const char* UI_GetInjectionValue (uiInjection_t *injection, const uiCallContext_t *context)
+{
+	switch (injection->type) {
+	case UI_INJECTION_CVAR:
+		if (injection->cvar == NULL || injection->cvarRevision != Cvar_GetRevision()) {
+			injection->cvar = Cvar_Get(injection->string, "", 0, NULL);
+			injection->cvarRevision = Cvar_GetRevision();
+		}
+		return injection->cvar->string;
+
+	case UI_INJECTION_NODE:
+	{
+		const char *path = injection->string;
+		const char *string;
+		uiNode_t *node;
+		const value_t *property;
+		UI_ReadCachedNodePath(path, context->source, &node, &property);
+		if (!node) {
+			Com_Printf("UI_GenInjectedString: Node '%s' wasn't found; '' returned\n", path);
+#ifdef DEBUG
+			Com_Printf("UI_GenInjectedString: Path relative to '%s'\n", UI_GetPath(context->source));
+#endif
+			return "";
+		}
+		if (!property) {
+			Com_Printf("UI_GenInjectedString: Property '%s' wasn't found; '' returned\n", path);
+			return "";
+		}
+		string = UI_GetStringFromNodeProperty(node, property);
+		if (string == NULL) {
+			Com_Printf("UI_GenInjectedString: String getter for '%s' property do not exists; '' injected\n", path);
+			return "";
+		}
+		return string;
+	}
+
+	case UI_INJECTION_PATH:
+	{
+		const uiNode_t *node = NULL;
+		if (!context->source)
+			return NULL;
+		switch (injection->param) {
+		case UI_INJECTIONPATH_ROOT:
+			node = context->source->root;
+			break;
+		case UI_INJECTIONPATH_THIS:
+			node = context->source;
+			break;
+		case UI_INJECTIONPATH_PARENT:
+			node = context->source->parent;
+			break;
+		default:
+			Com_Printf("UI_GenCommand: Command '%s' for path injection unknown\n", injection->string);
+			break;
+		}
+		if (node)
+			return UI_GetPath(node);
+		return NULL;
+	}
+
+	case UI_INJECTION_PROPERTY:
+		/* source property injection */
+		if (context->source) {
+			const char* value;
+			if (injection->behaviour != context->source->behaviour) {
+				injection->behaviour = context->source->behaviour;
+				injection->property = UI_GetPropertyFromBehaviour(injection->behaviour, injection->string);
+			}
+			if (injection->property) {
+				value = UI_GetStringFromNodeProperty(context->source, injection->property);
+				if (value == NULL)
+					value = "";
+				return value;
+			}
+		}
+
+		/* param injection */
+		if (injection->param != 0 && injection->param <= UI_GetParamNumber(context))
+			return UI_GetParam(context, injection->param);
+		return NULL;
+
+	default:
+		Com_Error(ERR_FATAL, "UI_GetInjectionValue: Unexpected injection type %i", injection->type);
+	}
+}
+
+/**
+ * @brief Replace injection identifiers of an action string by a value
+ * @param[in] action Action with a string with injection as @c d1
+ * @param[in] addNewLine If true, a new line is added at the end of the string
+ * @param[in] context Call context of the script
+ * @note Use the compiled form of the string when it exists, else interpret the string
+ * @sa UI_CompileInjectedString
+ * @sa UI_GenInjectedString
+ */
+const char* UI_GenInjectedActionString (const uiAction_t* action, qboolean addNewLine, const uiCallContext_t *context)
+{
+	static char cmd[256];
+	const char *end = cmd + sizeof(cmd) - (addNewLine ? 2 : 1);
+	uiInjection_t *injection = (uiInjection_t *) action->d.terminal.d2.data;
+	char *cout = cmd;
+
+	if (injection == NULL)
+		return UI_GenInjectedString(action->d.terminal.d1.constString, addNewLine, context);
+
+	for (; injection->type != UI_INJECTION_END && cout < end; injection++) {
+		const char *value;
+		if (injection->type == UI_INJECTION_TEXT) {
+			cout += UI_InjectValue(cout, end - cout, injection->string, injection->length);
+			continue;
+		}
+
+		value = UI_GetInjectionValue(injection, context);
+		if (value == NULL) {
+			/* unresolved, the '<' is raw text, and the interpreter reads the rest of the string */
+			*cout++ = '<';
+			cout = UI_InterpretInjectedString(injection->source + 1, cout, end, context);
+			break;
+		}
+		cout += UI_InjectValue(cout, end - cout, value, strlen(value));
+	}
+
 	if (addNewLine)
 		*cout++ = '\n';
 
@@ -396,7 +700,7 @@ static inline void UI_ExecuteSetAction (const uiAction_t* action, const uiCallCo
 		if (left->type == EA_VALUE_CVARNAME)
 			cvarName = left->d.terminal.d1.constString;
 		else
-			cvarName = UI_GenInjectedString(left->d.terminal.d1.constString, qfalse, context);
+			cvarName = UI_GenInjectedActionString(left, qfalse, context);
 
 		textValue = UI_GetStringFromExpression(right, context);
 
@@ -408,14 +712,15 @@ static inline void UI_ExecuteSetAction (const uiAction_t* action, const uiCallCo
 	}
 
 	/* search the node */
-	if (left->type == EA_VALUE_PATHPROPERTY)
+	if (left->type == EA_VALUE_PATHPROPERTY) {
 		path = left->d.terminal.d1.constString;
-	else if (left->type == EA_VALUE_PATHPROPERTY_WITHINJECTION)
-		path = UI_GenInjectedString(left->d.terminal.d1.constString, qfalse, context);
-	else
+		UI_ReadCachedNodePath(path, context->source, &node, &property);
+	} else if (left->type == EA_VALUE_PATHPROPERTY_WITHINJECTION) {
+		path = UI_GenInjectedActionString(left, qfalse, context);
+		UI_ReadNodePath(path, context->source, &node, &property);
+	} else
 		Com_Error(ERR_FATAL, "UI_ExecuteSetAction: Property setter with wrong type '%d'", left->type);
 
-	UI_ReadNodePath(path, context->source, &node, &property);
 	if (!node) {
 		Com_Printf("UI_ExecuteSetAction: node \"%s\" doesn't exist (source: %s)\n", path, UI_GetPath(context->source));
 		return;
@@ -437,11 +742,11 @@ static inline void UI_ExecuteCallAction (const uiAction_t* action, const uiCallC
 	const value_t* callProperty = NULL;
 	const char* path = left->d.terminal.d1.constString;
 
-	if (left->type == EA_VALUE_PATHPROPERTY || left->type == EA_VALUE_PATHNODE)
-		path = left->d.terminal.d1.constString;
-	else if (left->type == EA_VALUE_PATHPROPERTY_WITHINJECTION || left->type == EA_VALUE_PATHNODE_WITHINJECTION)
-		path = UI_GenInjectedString(left->d.terminal.d1.constString, qfalse, context);
-	UI_ReadNodePath(path, context->source, &callNode, &callProperty);
+	if (left->type == EA_VALUE_PATHPROPERTY_WITHINJECTION || left->type == EA_VALUE_PATHNODE_WITHINJECTION) {
+		path = UI_GenInjectedActionString(left, qfalse, context);
+		UI_ReadNodePath(path, context->source, &callNode, &callProperty);
+	} else
+		UI_ReadCachedNodePath(path, context->source, &callNode, &callProperty);
 
 	if (callNode == NULL) {
 		Com_Printf("UI_ExecuteCallAction: Node from path \"%s\" not found (relative to \"%s\").\n", path, UI_GetPath(context->source));
@@ -550,7 +855,7 @@ static void UI_ExecuteAction (const uiAction_t* action, uiCallContext_t *context
 	case EA_CMD:
 		/* execute a command */
 		if (action->d.terminal.d1.constString)
-			Cbuf_AddText(UI_GenInjectedString(action->d.terminal.d1.constString, qtrue, context));
+			Cbuf_AddText(UI_GenInjectedActionString(action, qtrue, context));
 		break;
 
 	case EA_CALL:
@@ -875,6 +1180,8 @@ void UI_RemoveListener (uiNode_t *node, const value_t *property, uiNode_t *funct
 		}
 		if (tmp) {
 			uiAction_t* value = tmp->d.nonTerminal.left;
+			/* the path is a key of the node path cache */
+			UI_InvalidateNodePathCache();
 			Mem_Free(value->d.terminal.d1.data);
 			Mem_Free(value);
 			Mem_Free(tmp);
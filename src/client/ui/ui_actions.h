@@ -220,6 +220,8 @@ void UI_ExecuteEventActionsEx (struct uiNode_s* source, const uiAction_t* firstA
 qboolean UI_IsInjectedString(const char *string);
 void UI_FreeStringProperty(void* pointer);
 const char* UI_GenInjectedString(const char* input, qboolean addNewLine, const uiCallContext_t *context);
+const char* UI_GenInjectedActionString(const uiAction_t* action, qboolean addNewLine, const uiCallContext_t *context);
+void UI_CompileInjectedString(uiAction_t *action);
 int UI_GetActionTokenType(const char* token, int group);
 uiValue_t* UI_GetVariable (const uiCallContext_t *context, int relativeVarId);
 
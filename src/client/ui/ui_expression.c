@@ -64,10 +64,11 @@ uiNode_t* UI_GetNodeFromExpression (uiAction_t *expression, const uiCallContext_
 			uiNode_t *node;
 			const value_t *propertyTmp;
 			const char *path = expression->d.terminal.d1.constString;
-			if (expression->type == EA_VALUE_PATHNODE_WITHINJECTION)
-				path = UI_GenInjectedString(path, qfalse, context);
-
-			UI_ReadNodePath(path, context->source, &node, &propertyTmp);
+			if (expression->type == EA_VALUE_PATHNODE_WITHINJECTION) {
+				path = UI_GenInjectedActionString(expression, qfalse, context);
+				UI_ReadNodePath(path, context->source, &node, &propertyTmp);
+			} else
+				UI_ReadCachedNodePath(path, context->source, &node, &propertyTmp);
 			if (!node) {
 				Com_Printf("UI_GetNodeFromExpression: Node '%s' wasn't found; NULL returned\n", path);
 				return NULL;
@@ -84,10 +85,11 @@ uiNode_t* UI_GetNodeFromExpression (uiAction_t *expression, const uiCallContext_
 				uiNode_t *node;
 				const value_t *propertyTmp;
 				const char *path = expression->d.terminal.d1.constString;
-				if (expression->type == EA_VALUE_PATHPROPERTY_WITHINJECTION)
-					path = UI_GenInjectedString(path, qfalse, context);
-
-				UI_ReadNodePath(path, context->source, &node, &propertyTmp);
+				if (expression->type == EA_VALUE_PATHPROPERTY_WITHINJECTION) {
+					path = UI_GenInjectedActionString(expression, qfalse, context);
+					UI_ReadNodePath(path, context->source, &node, &propertyTmp);
+				} else
+					UI_ReadCachedNodePath(path, context->source, &node, &propertyTmp);
 				if (!node) {
 					Com_Printf("UI_GetNodeFromExpression: Node '%s' wasn't found; NULL returned\n", path);
 					return NULL;
@@ -123,7 +125,7 @@ uiNode_t* UI_GetNodeFromExpression (uiAction_t *expression, const uiCallContext_
 				uiNode_t *node;
 				const value_t *propertyTmp;
 				const char* path = expression->d.terminal.d2.constString;
-				UI_ReadNodePath(path, relativeTo, &node, &propertyTmp);
+				UI_ReadCachedNodePath(path, relativeTo, &node, &propertyTmp);
 				if (!node) {
 					Com_Printf("UI_GetNodeFromExpression: Path '%s' from node '%s' found no node; NULL returned\n", path, UI_GetPath(relativeTo));
 					return NULL;
@@ -187,7 +189,7 @@ float UI_GetFloatFromExpression (uiAction_t *expression, const uiCallContext_t *
 			{
 				const char* string = expression->d.terminal.d1.constString;
 				if (expression->type == EA_VALUE_STRING_WITHINJECTION)
-					string = UI_GenInjectedString(string, qfalse, context);
+					string = UI_GenInjectedActionString(expression, qfalse, context);
 				return atof(string);
 			}
 		case EA_VALUE_FLOAT:
@@ -198,7 +200,7 @@ float UI_GetFloatFromExpression (uiAction_t *expression, const uiCallContext_t *
 				cvar_t *cvar = NULL;
 				const char *cvarName = expression->d.terminal.d1.constString;
 				if (expression->type == EA_VALUE_CVARNAME_WITHINJECTION)
-					cvarName = UI_GenInjectedString(cvarName, qfalse, context);
+					cvarName = UI_GenInjectedActionString(expression, qfalse, context);
 				cvar = Cvar_Get(cvarName, "", 0, "Cvar from UI script expression");
 				return cvar->value;
 			}
@@ -330,7 +332,7 @@ const char* UI_GetStringFromExpression (uiAction_t *expression, const uiCallCont
 			{
 				const char* string = expression->d.terminal.d1.constString;
 				if (expression->type == EA_VALUE_STRING_WITHINJECTION)
-					string = UI_GenInjectedString(string, qfalse, context);
+					string = UI_GenInjectedActionString(expression, qfalse, context);
 				return string;
 			}
 		case EA_VALUE_FLOAT:
@@ -349,7 +351,7 @@ const char* UI_GetStringFromExpression (uiAction_t *expression, const uiCallCont
 			cvar_t *cvar = NULL;
 			const char *cvarName = expression->d.terminal.d1.constString;
 			if (expression->type == EA_VALUE_CVARNAME_WITHINJECTION)
-				cvarName = UI_GenInjectedString(cvarName, qfalse, context);
+				cvarName = UI_GenInjectedActionString(expression, qfalse, context);
 			cvar = Cvar_Get(cvarName, "", 0, "Cvar from UI script expression");
 			return cvar->string;
 		}
@@ -485,7 +487,7 @@ qboolean UI_GetBooleanFromExpression (uiAction_t *expression, const uiCallContex
 				assert(e->type == EA_VALUE_CVARNAME || e->type == EA_VALUE_CVARNAME_WITHINJECTION);
 				cvarName = e->d.terminal.d1.constString;
 				if (e->type == EA_VALUE_CVARNAME_WITHINJECTION)
-					cvarName = UI_GenInjectedString(cvarName, qfalse, context);
+					cvarName = UI_GenInjectedActionString(e, qfalse, context);
 				return Cvar_FindVar(cvarName) != NULL;
 			}
 		case EA_OPERATOR_PATHPROPERTYFROM:
@@ -553,9 +555,10 @@ static uiAction_t *UI_ParseValueExpression (const char **text)
 	/* it is a const string (or an injection tag for compatibility) */
 	if (Com_ParsedTokenIsQuoted() || token[0] == '<') {
 		expression->d.terminal.d1.constString = UI_AllocStaticString(token, 0);
-		if (UI_IsInjectedString(token))
+		if (UI_IsInjectedString(token)) {
 			expression->type = EA_VALUE_STRING_WITHINJECTION;
-		else
+			UI_CompileInjectedString(expression);
+		} else
 			expression->type = EA_VALUE_STRING;
 		return expression;
 	}
@@ -582,9 +585,10 @@ static uiAction_t *UI_ParseValueExpression (const char **text)
 	if (Q_strstart(token, "*cvar:")) {
 		const char* cvarName = token + 6;
 		expression->d.terminal.d1.constString = UI_AllocStaticString(cvarName, 0);
-		if (UI_IsInjectedString(cvarName))
+		if (UI_IsInjectedString(cvarName)) {
 			expression->type = EA_VALUE_CVARNAME_WITHINJECTION;
-		else
+			UI_CompileInjectedString(expression);
+		} else
 			expression->type = EA_VALUE_CVARNAME;
 		return expression;
 	}
@@ -612,6 +616,8 @@ static uiAction_t *UI_ParseValueExpression (const char **text)
 			path = va("root.%s", path);
 		}
 		expression->d.terminal.d1.constString = UI_AllocStaticString(path, 0);
+		if (expression->type == EA_VALUE_PATHPROPERTY_WITHINJECTION)
+			UI_CompileInjectedString(expression);
 
 		/* get property name */
 		propertyName = strchr(path, '@');
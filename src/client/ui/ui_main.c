@@ -191,6 +191,7 @@ void UI_Shutdown (void)
 		Mem_Free(ui_global.adata);
 	ui_global.adata = NULL;
 	ui_global.adataize = 0;
+	UI_InvalidateNodePathCache();
 
 	/* release pools */
 	Mem_FreePool(ui_sysPool);
@@ -225,6 +226,7 @@ void UI_Init (void)
 
 	/* reset global UI structures */
 	OBJZERO(ui_global);
+	UI_InvalidateNodePathCache();
 
 	ui_sounds = Cvar_Get("ui_sounds", "1", CVAR_ARCHIVE, "Activates UI sounds");
 
@@ -280,6 +280,66 @@ void UI_ReadNodePath (const char* path, const uiNode_t *relativeNode, uiNode_t *
 	return;
 }
 
+/** @brief Number of entries into the node path cache, must be a power of 2 */
+#define UI_NODEPATH_CACHE_SIZE 256
+
+/**
+ * @brief Result of a node path resolution
+ * @sa UI_ReadCachedNodePath
+ */
+typedef struct uiNodePathCache_s {
+	const char *path;				/**< static path, the pointer is the key */
+	const uiNode_t *relativeNode;	/**< node the path is relative to */
+	int revision;					/**< value of nodeTreeRevision when the entry was computed */
+	uiNode_t *node;
+	const value_t *property;
+} uiNodePathCache_t;
+
+static uiNodePathCache_t nodePathCache[UI_NODEPATH_CACHE_SIZE];
+
+/**
+ * @brief Updated each time the node tree changes, it invalidates all the
+ * entries of the node path cache. Starts at 1 so that zeroed entries are never valid.
+ */
+static int nodeTreeRevision = 1;
+
+/**
+ * @brief Invalidate all the resolved node paths
+ * @note Must be called every time nodes or windows are added, removed, deleted or cloned
+ * @sa UI_ReadCachedNodePath
+ */
+void UI_InvalidateNodePathCache (void)
+{
+	nodeTreeRevision++;
+}
+
+/**
+ * @brief Same as UI_ReadNodePath, but the result is cached until the node tree changes
+ * @param[in] path Path to read. The pointer is used as cache key, so the string
+ * must not change while it is used (e.g. strings coming from the parsed scripts)
+ * @param[in] relativeNode relative node where the path start
+ * @param[out] resultNode Node found. Else NULL.
+ * @param[out] resultProperty Property found. Else NULL.
+ * @sa UI_ReadNodePath
+ * @sa UI_InvalidateNodePathCache
+ */
+void UI_ReadCachedNodePath (const char* path, const uiNode_t *relativeNode, uiNode_t **resultNode, const value_t **resultProperty)
+{
+	const uintptr_t key = ((uintptr_t)path >> 2) ^ ((uintptr_t)relativeNode >> 4);
+	uiNodePathCache_t *entry = &nodePathCache[(key ^ (key >> 8)) & (UI_NODEPATH_CACHE_SIZE - 1)];
+
+	if (entry->revision != nodeTreeRevision || entry->path != path || entry->relativeNode != relativeNode) {
+		UI_ReadNodePath(path, relativeNode, &entry->node, &entry->property);
+		entry->path = path;
+		entry->relativeNode = relativeNode;
+		entry->revision = nodeTreeRevision;
+	}
+
+	*resultNode = entry->node;
+	if (resultProperty)
+		*resultProperty = entry->property;
+}
+
 /**
  * @brief Return a node by a path name (names with dot separation)
  * It is a simplification facade over UI_ReadNodePath
@@ -541,6 +601,7 @@ void UI_DeleteNode (uiNode_t* node)
 		return;
 
 	UI_BeforeDeletingNode(node);
+	UI_InvalidateNodePathCache();
 
 	UI_DeleteAllChild(node);
 	if (node->firstChild != NULL) {
@@ -589,6 +650,8 @@ uiNode_t* UI_CloneNode (const uiNode_t* node, uiNode_t *newWindow, qboolean recu
 {
 	uiNode_t* newNode = UI_AllocNodeWithoutNew(NULL, node->behaviour->name, isDynamic);
 
+	UI_InvalidateNodePathCache();
+
 	/* clone all data */
 	memcpy(newNode, node, sizeof(*node) + node->behaviour->extraDataSize);
 	newNode->dynamic = isDynamic;
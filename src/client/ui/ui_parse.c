@@ -303,7 +303,11 @@ static qboolean UI_ParseSetAction (uiNode_t *node, uiAction_t *action, const cha
 		return qtrue;
 	}
 
-	property = (const value_t *) action->d.nonTerminal.left->d.terminal.d2.data;
+	/* d2 of values with injection is the compiled string */
+	if (type == EA_VALUE_PATHPROPERTY)
+		property = (const value_t *) action->d.nonTerminal.left->d.terminal.d2.data;
+	else
+		property = NULL;
 
 	*token = Com_EParse(text, errhead, NULL);
 	if (!*text)
@@ -342,6 +346,7 @@ static qboolean UI_ParseSetAction (uiNode_t *node, uiAction_t *action, const cha
 		localAction = UI_AllocStaticAction();
 		localAction->type = EA_VALUE_STRING_WITHINJECTION;
 		localAction->d.terminal.d1.data = UI_AllocStaticString(*token, 0);
+		UI_CompileInjectedString(localAction);
 		action->d.nonTerminal.right = localAction;
 		return qtrue;
 	}
@@ -479,6 +484,7 @@ static uiAction_t *UI_ParseActionList (uiNode_t *node, const char **text, const
 
 			/* get the value */
 			action->d.terminal.d1.constString = UI_AllocStaticString(*token, 0);
+			UI_CompileInjectedString(action);
 			break;
 
 		case EA_ASSIGN:
@@ -673,6 +673,7 @@ void UI_InsertWindow (uiNode_t* window)
 
 	/* insert */
 	ui_global.windows[pos] = window;
+	UI_InvalidateNodePathCache();
 	ui_global.numWindows++;
 }
 
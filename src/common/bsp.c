@@ -28,10 +28,47 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "tracing.h"
 #include "routing.h"
 #include "../shared/parse.h"
+#include <SDL_thread.h>
 
 /** @note this is a zeroed surface structure */
 static cBspSurface_t nullSurface;
 
+/** @brief Max. amount of tiles whose routing lumps are decoded at the same time */
+#define CM_MAX_LOADTHREADS	8
+
+/** @brief The decoded routing lump of a map tile */
+typedef struct cmRouting_s {
+	ipos3_t wpMins;
+	ipos3_t wpMaxs;
+	routing_t map[ACTOR_MAX_SIZE];
+} cmRouting_t;
+
+/**
+ * @brief A map tile of CM_LoadMap. The file is loaded on the main thread, the routing
+ * lump is decoded on a loader thread and the tile is merged into the map on the main
+ * thread again - in the order of the tiles.
+ * @sa CMod_StartTileLoad
+ */
+typedef struct cmTileLoad_s {
+	char name[MAX_VAR];
+	ipos3_t shift;			/**< the grid position of the tile */
+	byte *buf;				/**< the bsp file */
+	int length;
+	dBspHeader_t header;
+	unsigned checksum;
+	cmRouting_t *routing;	/**< the decoded routing lump */
+	const char *error;		/**< set by the loader thread, it can't call Com_Error */
+	SDL_Thread *thread;
+} cmTileLoad_t;
+
+static cmTileLoad_t cmTileLoads[MAX_MAPTILES];
+/** @brief amount of entries in @c cmTileLoads that belong to the current map load */
+static int cmNumTileLoads;
+
+static cvar_t *cm_loadThreads;
+/** @brief The routing buffer of the non-threaded load - the threaded load uses it as first buffer */
+static cmRouting_t cmRouting;
+
 /*
 ===============================================================================
 MAP LOADING
@@ -399,43 +436,6 @@ static void CMod_LoadBrushSides (mapTile_t *tile, const byte *base, const lump_t
 	}
 }
 
-/**
- * @param[in] source Source will be set to the end of the compressed data block!
- * @param[in] dataStart where to place the uncompressed data
- * @sa CompressRouting (ufo2map)
- * @sa CMod_LoadRouting
- */
-static int CMod_DeCompressRouting (const byte ** source, byte * dataStart)
-{
-	int i, c;
-	byte *data_p;
-	const byte *src;
-
-	data_p = dataStart;
-	src = *source;
-
-	while (*src) {
-		if (*src & 0x80) {
-			/* repetitions */
-			c = *src++ & ~0x80;
-			/* Remember that the total bytes that are the same is c + 2 */
-			for (i = 0; i < c + 2; i++)
-				*data_p++ = *src;
-			src++;
-		} else {
-			/* identities */
-			c = *src++;
-			for (i = 0; i < c; i++)
-				*data_p++ = *src++;
-		}
-	}
-
-	src++;
-	*source = src;
-
-	return data_p - dataStart;
-}
-
 /*
 ===============================================================================
 TRACING NODES
@@ -475,59 +475,31 @@ static void CM_MakeTracingNodes (mapTile_t *tile)
 }
 
 /**
+ * @brief Merges the decoded routing lump of a tile into the routing table of the map
  * @param[in] tile Stores the data of the map tile
- * @param[in] base The start of the data loaded from the file.
  * @param[in] mapData The loaded data is stored here.
+ * @param[in] routing The routing lump of the tile - decoded by CMod_DecodeTile
  * @param[in] name The name of the maptile
- * @param[in] l Routing lump ... (routing data lump from bsp file)
  * @param[in] sX The x position on the world plane (grid position) - values from -(PATHFINDING_WIDTH/2) up to PATHFINDING_WIDTH/2 are allowed
  * @param[in] sY The y position on the world plane (grid position) - values from -(PATHFINDING_WIDTH/2) up to PATHFINDING_WIDTH/2 are allowed
  * @param[in] sZ The height level on the world plane (grid position) - values from 0 - PATHFINDING_HEIGHT are allowed
  * @sa CM_AddMapTile
  * @todo TEST z-level routing
  */
-static void CMod_LoadRouting (mapTile_t *tile, mapData_t *mapData, const byte *base, const char *name, const lump_t * l, const int sX, const int sY, const int sZ)
+static void CMod_LoadRouting (mapTile_t *tile, mapData_t *mapData, const cmRouting_t *routing, const char *name, const int sX, const int sY, const int sZ)
 {
-	/** @todo this eats a lot of memory - load directory into mapData->map */
-	static routing_t tempMap[ACTOR_MAX_SIZE];
-	const byte *source;
-	int length;
-	int x, y, z, size, dir;
+	const routing_t *tempMap = routing->map;
+	int x, y, z, size;
 	int minX, minY, minZ;
 	int maxX, maxY, maxZ;
-	unsigned int i;
-	double start, end;
-	const int targetLength = sizeof(tile->wpMins) + sizeof(tile->wpMaxs) + sizeof(tempMap);
-
-	start = time(NULL);
-
-	if (!l)
-		Com_Error(ERR_DROP, "CMod_LoadRouting: No lump given");
-
-	if (!l->filelen)
-		Com_Error(ERR_DROP, "CMod_LoadRouting: Map has NO routing lump");
+	const int start = Sys_Milliseconds();
 
 	assert((sX > -(PATHFINDING_WIDTH / 2)) && (sX < (PATHFINDING_WIDTH / 2)));
 	assert((sY > -(PATHFINDING_WIDTH / 2)) && (sY < (PATHFINDING_WIDTH / 2)));
 	assert((sZ >= 0) && (sZ < PATHFINDING_HEIGHT));
 
-	source = base + l->fileofs;
-
-	i = CMod_DeCompressRouting(&source, (byte*)tile->wpMins);
-	length = i;
-	i = CMod_DeCompressRouting(&source, (byte*)tile->wpMaxs);
-	length += i;
-	i = CMod_DeCompressRouting(&source, (byte*)tempMap);
-	length += i;
-
-	if (length != targetLength)
-		Com_Error(ERR_DROP, "CMod_LoadRouting: Map has BAD routing lump; expected %i got %i", targetLength, length);
-
-	/* endian swap possibly necessary */
-	for (i = 0; i < 3; i++) {
-		tile->wpMins[i] = LittleLong(tile->wpMins[i]);
-		tile->wpMaxs[i] = LittleLong(tile->wpMaxs[i]);
-	}
+	VectorCopy(routing->wpMins, tile->wpMins);
+	VectorCopy(routing->wpMaxs, tile->wpMaxs);
 
 	Com_DPrintf(DEBUG_ROUTING, "Map:%s  Offset:(%i, %i, %i)\n", name, sX, sY, sZ);
 	Com_DPrintf(DEBUG_ROUTING, "wpMins:(%i, %i, %i) wpMaxs:(%i, %i, %i)\n", tile->wpMins[0], tile->wpMins[1],
@@ -566,33 +538,38 @@ static void CMod_LoadRouting (mapTile_t *tile, mapData_t *mapData, const byte *b
 	Com_DPrintf(DEBUG_ROUTING, "Source bounds: (%i, %i, %i) to (%i, %i, %i)\n", minX - sX, minY - sY, minZ - sZ,
 			maxX - sX, maxY - sY, maxZ - sZ);
 
-	for (size = 0; size < ACTOR_MAX_SIZE; size++)
-		/* Adjust starting x and y by size to catch large actor cell overlap. */
-		for (y = minY - size; y <= maxY; y++)
-			for (x = minX - size; x <= maxX; x++) {
-				/* Just incase x or y start negative. */
-				if (x < 0 || y < 0)
-					continue;
-				for (z = minZ; z <= maxZ; z++) {
-					mapData->map[size].floor[z][y][x] = tempMap[size].floor[z - sZ][y - sY][x - sX];
-					mapData->map[size].ceil[z][y][x] = tempMap[size].ceil[z - sZ][y - sY][x - sX];
-					for (dir = 0; dir < CORE_DIRECTIONS; dir++) {
-						mapData->map[size].route[z][y][x][dir] = tempMap[size].route[z - sZ][y - sY][x - sX][dir];
-						mapData->map[size].stepup[z][y][x][dir] = tempMap[size].stepup[z - sZ][y - sY][x - sX][dir];
-					}
-				}
-				/* Update the reroute table */
+	for (size = 0; size < ACTOR_MAX_SIZE; size++) {
+		/* Adjust starting x and y by size to catch large actor cell overlap - but not below zero. */
+		const int startX = max(minX - size, 0);
+		const int width = maxX - startX + 1;
+		routing_t *dest = &mapData->map[size];
+		const routing_t *src = &tempMap[size];
+
+		if (width <= 0)
+			continue;
+
+		for (y = max(minY - size, 0); y <= maxY; y++) {
+			/* the cells of a row are next to each other in all the tables */
+			for (z = minZ; z <= maxZ; z++) {
+				memcpy(&dest->floor[z][y][startX], &src->floor[z - sZ][y - sY][startX - sX], width * sizeof(dest->floor[0][0][0]));
+				memcpy(&dest->ceil[z][y][startX], &src->ceil[z - sZ][y - sY][startX - sX], width * sizeof(dest->ceil[0][0][0]));
+				memcpy(dest->route[z][y][startX], src->route[z - sZ][y - sY][startX - sX], width * sizeof(dest->route[0][0][0]));
+				memcpy(dest->stepup[z][y][startX], src->stepup[z - sZ][y - sY][startX - sX], width * sizeof(dest->stepup[0][0][0]));
+			}
+			/* Update the reroute table */
+			for (x = startX; x <= maxX; x++) {
 				if (!mapData->reroute[size][y][x]) {
 					mapData->reroute[size][y][x] = tile->idx + 1;
 				} else {
 					mapData->reroute[size][y][x] = ROUTING_NOT_REACHABLE;
 				}
 			}
+		}
+	}
 
 	Com_DPrintf(DEBUG_ROUTING, "Done copying data.\n");
 
-	end = time(NULL);
-	Com_DPrintf(DEBUG_ROUTING, "Loaded routing for tile %s in %5.1fs\n", name, end - start);
+	Com_DPrintf(DEBUG_ROUTING, "Merged routing for tile %s in %5.1fs\n", name, (Sys_Milliseconds() - start) / 1000.0f);
 }
 
 
@@ -765,56 +742,151 @@ static void CM_InitBoxHull (mapTile_t *tile)
 	}
 }
 
+/**
+ * @brief Decodes the routing lump of a map tile
+ * @note Runs on a loader thread - it must neither use the filesystem nor call Com_Error
+ * @sa CMod_StartTileLoad
+ */
+static int CMod_DecodeTile (void *data)
+{
+	cmTileLoad_t *load = (cmTileLoad_t *)data;
+	cmRouting_t *routing = load->routing;
+	const lump_t *l = &load->header.lumps[LUMP_ROUTING];
+	const byte *source, *end;
+	int i;
+
+	if (!l->filelen) {
+		load->error = "Map has NO routing lump";
+		return 1;
+	}
+	if (l->fileofs > load->length || l->filelen > load->length - l->fileofs) {
+		load->error = "Map has a truncated routing lump";
+		return 1;
+	}
+
+	source = load->buf + l->fileofs;
+	end = source + l->filelen;
+	if (RT_DeCompressRouting(&source, end, (byte *)routing->wpMins, sizeof(routing->wpMins), load->header.version) != sizeof(routing->wpMins)
+	 || RT_DeCompressRouting(&source, end, (byte *)routing->wpMaxs, sizeof(routing->wpMaxs), load->header.version) != sizeof(routing->wpMaxs)
+	 || RT_DeCompressRouting(&source, end, (byte *)routing->map, sizeof(routing->map), load->header.version) != sizeof(routing->map)) {
+		load->error = "Map has BAD routing lump";
+		return 1;
+	}
+
+	/* endian swap possibly necessary */
+	for (i = 0; i < 3; i++) {
+		routing->wpMins[i] = LittleLong(routing->wpMins[i]);
+		routing->wpMaxs[i] = LittleLong(routing->wpMaxs[i]);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Loads the bsp file of a tile and starts to decode its routing lump
+ * @note The file is loaded on the main thread because the filesystem is not thread safe
+ * @param[in,out] load The tile to load
+ * @param[in] routing Buffer for the decoded routing lump - must not be used by another load
+ * that is still running
+ * @param[in] threaded Decode the routing lump on a loader thread instead of right away
+ * @sa CMod_FinishTileLoad
+ */
+static void CMod_StartTileLoad (cmTileLoad_t *load, cmRouting_t *routing, qboolean threaded)
+{
+	char filename[MAX_QPATH];
+
+	Com_DPrintf(DEBUG_ENGINE, "CMod_StartTileLoad: %s at %i,%i,%i\n", load->name, load->shift[0], load->shift[1], load->shift[2]);
+
+	Com_sprintf(filename, sizeof(filename), "maps/%s.bsp", load->name);
+	load->length = FS_LoadFile(filename, &load->buf);
+	if (!load->buf)
+		Com_Error(ERR_DROP, "Couldn't load %s", filename);
+
+	/* the checksum code is not thread safe */
+	load->checksum = LittleLong(Com_BlockChecksum(load->buf, load->length));
+
+	if (load->length < sizeof(load->header))
+		Com_Error(ERR_DROP, "CMod_StartTileLoad: %s is truncated", filename);
+	load->header = *(dBspHeader_t *) load->buf;
+	BSP_SwapHeader(&load->header, filename);
+
+	if (!BSP_IsSupportedVersion(load->header.version))
+		Com_Error(ERR_DROP, "CMod_StartTileLoad: %s has wrong version number (%i should be %i)", load->name, load->header.version, BSPVERSION);
+
+	load->routing = routing;
+	load->error = NULL;
+	load->thread = NULL;
+	if (threaded)
+		load->thread = SDL_CreateThread(CMod_DecodeTile, load);
+	if (!load->thread)
+		CMod_DecodeTile(load);
+}
+
+/**
+ * @brief Waits until the routing lump of the tile is decoded
+ * @sa CMod_StartTileLoad
+ */
+static void CMod_FinishTileLoad (cmTileLoad_t *load)
+{
+	if (load->thread) {
+		SDL_WaitThread(load->thread, NULL);
+		load->thread = NULL;
+	}
+
+	if (load->error)
+		Com_Error(ERR_DROP, "CMod_LoadRouting: %s: %s", load->name, load->error);
+}
+
+/**
+ * @brief Cleans up after a map load that was aborted by an error
+ * @note The loader threads may still be using the file buffers and the routing buffers -
+ * this must be called before the cmodel pool is freed
+ */
+static void CMod_AbortTileLoads (void)
+{
+	int i;
+
+	for (i = 0; i < cmNumTileLoads; i++) {
+		cmTileLoad_t *load = &cmTileLoads[i];
+		if (load->thread)
+			SDL_WaitThread(load->thread, NULL);
+		if (load->buf)
+			FS_FreeFile(load->buf);
+	}
+
+	OBJZERO(cmTileLoads);
+	cmNumTileLoads = 0;
+}
+
 /**
  * @brief Adds in a single map tile
- * @param[in] name The (file-)name of the tile to add.
+ * @param[in,out] load The tile to add - its routing lump must already be decoded
  * @param[in] day whether the lighting for day or night should be loaded.
- * @param[in] sX The x position on the world plane (grid position) - values from -(PATHFINDING_WIDTH / 2) up to PATHFINDING_WIDTH / 2 are allowed
- * @param[in] sY The y position on the world plane (grid position) - values from -(PATHFINDING_WIDTH / 2) up to PATHFINDING_WIDTH / 2 are allowed
- * @param[in] sZ The height level on the world plane (grid position) - values from 0 up to PATHFINDING_HEIGHT are allowed
  * @param[in] mapData The loaded data is stored here.
  * @param[in] mapTiles List of tiles the current (RMA-)map is composed of
- * @note The sX and sY values are grid positions - max. grid size is PATHFINDING_WIDTH - unit size is
+ * @note The shift values are grid positions - max. grid size is PATHFINDING_WIDTH - unit size is
  * UNIT_SIZE => ends up at 2*MAX_WORLD_WIDTH (the worldplace size - or [-MAX_WORLD_WIDTH, MAX_WORLD_WIDTH])
  * @return The checksum of the maptile
- * @return 0 on error
  * @sa CM_LoadMap
  * @sa R_ModAddMapTile
  */
-static void CM_AddMapTile (const char *name, const qboolean day, const int sX, const int sY, const byte sZ, mapData_t *mapData, mapTiles_t *mapTiles)
+static unsigned CM_AddMapTile (cmTileLoad_t *load, const qboolean day, mapData_t *mapData, mapTiles_t *mapTiles)
 {
-	char filename[MAX_QPATH];
-	unsigned checksum;
-	byte *buf;
-	int length;
-	dBspHeader_t header;
+	const dBspHeader_t *header = &load->header;
+	const int sX = load->shift[0];
+	const int sY = load->shift[1];
+	const int sZ = load->shift[2];
 	/* use for random map assembly for shifting origins and so on */
 	vec3_t shift;
 	const byte *base;
 	mapTile_t *tile;
 
-	Com_DPrintf(DEBUG_ENGINE, "CM_AddMapTile: %s at %i,%i,%i\n", name, sX, sY, sZ);
-	assert(name);
-	assert(name[0]);
+	Com_DPrintf(DEBUG_ENGINE, "CM_AddMapTile: %s at %i,%i,%i\n", load->name, sX, sY, sZ);
 	assert((sX > -(PATHFINDING_WIDTH / 2)) && (sX < (PATHFINDING_WIDTH / 2)));
 	assert((sY > -(PATHFINDING_WIDTH / 2)) && (sY < (PATHFINDING_WIDTH / 2)));
 	assert(sZ < PATHFINDING_HEIGHT);
 
-	/* load the file */
-	Com_sprintf(filename, sizeof(filename), "maps/%s.bsp", name);
-	length = FS_LoadFile(filename, &buf);
-	if (!buf)
-		Com_Error(ERR_DROP, "Couldn't load %s", filename);
-
-	checksum = LittleLong(Com_BlockChecksum(buf, length));
-
-	header = *(dBspHeader_t *) buf;
-	BSP_SwapHeader(&header, filename);
-
-	if (header.version != BSPVERSION)
-		Com_Error(ERR_DROP, "CM_AddMapTile: %s has wrong version number (%i should be %i)", name, header.version, BSPVERSION);
-
-	base = (const byte *) buf;
+	base = (const byte *) load->buf;
 
 	/* init */
 	if (mapTiles->numTiles >= MAX_MAPTILES)
@@ -823,44 +895,43 @@ static void CM_AddMapTile (const char *name, const qboolean day, const int sX, c
 	tile = &(mapTiles->mapTiles[mapTiles->numTiles]);
 	OBJZERO(*tile);
 	tile->idx = mapTiles->numTiles;
-	Q_strncpyz(tile->name, name, sizeof(tile->name));
+	Q_strncpyz(tile->name, load->name, sizeof(tile->name));
 
 	/* pathfinding and the like must be shifted on the worldplane when we
 	 * are assembling a map */
 	VectorSet(shift, sX * UNIT_SIZE, sY * UNIT_SIZE, sZ * UNIT_HEIGHT);
 
 	/* load into heap */
-	CMod_LoadSurfaces(tile, base, &header.lumps[LUMP_TEXINFO]);
-	CMod_LoadLeafs(tile, base, &header.lumps[LUMP_LEAFS]);
-	CMod_LoadLeafBrushes(tile, base, &header.lumps[LUMP_LEAFBRUSHES]);
-	CMod_LoadPlanes(tile, base, &header.lumps[LUMP_PLANES], shift);
-	CMod_LoadBrushes(tile, base, &header.lumps[LUMP_BRUSHES]);
-	CMod_LoadBrushSides(tile, base, &header.lumps[LUMP_BRUSHSIDES]);
-	CMod_LoadSubmodels(tile, base, &header.lumps[LUMP_MODELS], shift);
-	CMod_LoadNodes(tile, base, &header.lumps[LUMP_NODES], shift);
-	CMod_LoadEntityString(tile, mapData, base, &header.lumps[LUMP_ENTITIES], shift);
+	CMod_LoadSurfaces(tile, base, &header->lumps[LUMP_TEXINFO]);
+	CMod_LoadLeafs(tile, base, &header->lumps[LUMP_LEAFS]);
+	CMod_LoadLeafBrushes(tile, base, &header->lumps[LUMP_LEAFBRUSHES]);
+	CMod_LoadPlanes(tile, base, &header->lumps[LUMP_PLANES], shift);
+	CMod_LoadBrushes(tile, base, &header->lumps[LUMP_BRUSHES]);
+	CMod_LoadBrushSides(tile, base, &header->lumps[LUMP_BRUSHSIDES]);
+	CMod_LoadSubmodels(tile, base, &header->lumps[LUMP_MODELS], shift);
+	CMod_LoadNodes(tile, base, &header->lumps[LUMP_NODES], shift);
+	CMod_LoadEntityString(tile, mapData, base, &header->lumps[LUMP_ENTITIES], shift);
 	if (day)
-		CMod_LoadLighting(tile, base, &header.lumps[LUMP_LIGHTING_DAY]);
+		CMod_LoadLighting(tile, base, &header->lumps[LUMP_LIGHTING_DAY]);
 	else
-		CMod_LoadLighting(tile, base, &header.lumps[LUMP_LIGHTING_NIGHT]);
+		CMod_LoadLighting(tile, base, &header->lumps[LUMP_LIGHTING_NIGHT]);
 
 	CM_InitBoxHull(tile);
 	CM_MakeTracingNodes(tile);
 
 	mapData->numInline += tile->nummodels - NUM_REGULAR_MODELS;
 
-	CMod_LoadRouting(tile, mapData, base, name, &header.lumps[LUMP_ROUTING], sX, sY, sZ);
+	CMod_LoadRouting(tile, mapData, load->routing, load->name, sX, sY, sZ);
 
 	/* now increase the amount of loaded tiles */
 	mapTiles->numTiles++;
 
-	/* Now find the map bounds with the updated numTiles. */
-	/* calculate new border after merge */
-	RT_GetMapSize(mapTiles, mapData->mapMin, mapData->mapMax);
+	FS_FreeFile(load->buf);
+	load->buf = NULL;
 
-	FS_FreeFile(buf);
+	mapData->mapChecksum += load->checksum;
 
-	mapData->mapChecksum += checksum;
+	return load->checksum;
 }
 
 static void CMod_RerouteMap (mapTiles_t *mapTiles, mapData_t *mapData)
@@ -869,9 +940,7 @@ static void CMod_RerouteMap (mapTiles_t *mapTiles, mapData_t *mapData)
 	int x, y, z, dir;
 	int i;
 	pos3_t mins, maxs;
-	double start, end;
-
-	start = time(NULL);
+	const int start = Sys_Milliseconds();
 
 	VecToPos(mapData->mapMin, mins);
 	VecToPos(mapData->mapMax, maxs);
@@ -933,14 +1002,292 @@ static void CMod_RerouteMap (mapTiles_t *mapTiles, mapData_t *mapData)
 			}
 		}
 	}
-	end = time(NULL);
-	Com_Printf("Rerouted for RMA in %5.1fs\n", end - start);
+	Com_Printf("Rerouted for RMA in %5.1fs\n", (Sys_Milliseconds() - start) / 1000.0f);
+}
+
+/*
+===============================================================================
+ROUTING CACHE
+===============================================================================
+*/
+
+#define ROUTING_CACHE_IDENT		(('C'<<24)+('T'<<16)+('R'<<8)+'U')
+#define ROUTING_CACHE_VERSION	2
+#define ROUTING_CACHE_DIR		"routing"
+
+/**
+ * @brief Header of a cached routing table. It is followed by the key string and the
+ * routing table of all actor sizes, compressed with RT_CompressRouting like the routing lump.
+ * @sa CMod_SaveRoutingCache
+ */
+typedef struct dRoutingCacheHeader_s {
+	int ident;
+	int version;
+	int created;			/**< time of creation - the oldest entries are evicted first */
+	int keyLength;			/**< length of the key string including the terminating zero */
+	int dataLength;			/**< length of the compressed routing table */
+	unsigned dataChecksum;	/**< checksum of the compressed routing table */
+} dRoutingCacheHeader_t;
+
+static cvar_t *cm_routingCache;
+static cvar_t *cm_routingCacheSize;
+
+/**
+ * @brief Registers the cvars of the map loader - without calling this the routing cache is disabled
+ * and the tiles are loaded on the main thread only
+ * @sa CM_LoadMap
+ */
+void CM_Init (void)
+{
+	cm_routingCache = Cvar_Get("cm_routingcache", "1", CVAR_ARCHIVE, "Store the rerouted routing table of assembled maps on disk to skip the rerouting next time");
+	cm_routingCacheSize = Cvar_Get("cm_routingcachesize", "64", CVAR_ARCHIVE, "Max. size of the routing cache in MB");
+	cm_loadThreads = Cvar_Get("cm_loadthreads", "0", CVAR_ARCHIVE, "Amount of threads that decode the routing of the tiles of assembled maps - 0 decodes them on the main thread. Every thread needs its own routing buffer of about 19MB");
+}
+
+/**
+ * @return @c true if the rerouted routing tables of assembled maps should be cached on disk
+ */
+qboolean CM_RoutingCacheEnabled (void)
+{
+	return cm_routingCache != NULL && cm_routingCache->integer;
+}
+
+/**
+ * @brief The cache file is addressed by the checksum of the key, the key itself is
+ * stored in the file, too, to rule out collisions
+ */
+static void CMod_GetRoutingCacheName (const char *key, char *filename, size_t size)
+{
+	Com_sprintf(filename, size, ROUTING_CACHE_DIR "/%08x.rtc", Com_BlockChecksum(key, strlen(key)));
+}
+
+/**
+ * @brief Loads the rerouted routing table for the given assembly from the cache
+ * @param[in] key Identifies the assembly - all tiles with their positions and checksums
+ * @param[out] mapData The routing table is stored in here. It stays untouched if there is no
+ * valid cache entry.
+ * @return @c true if the routing table was loaded from the cache and no rerouting is needed
+ * @sa CMod_SaveRoutingCache
+ */
+static qboolean CMod_LoadRoutingCache (const char *key, mapData_t *mapData)
+{
+	char filename[MAX_QPATH];
+	dRoutingCacheHeader_t header;
+	const byte *data, *source;
+	byte *buf;
+	int length;
+
+	if (!CM_RoutingCacheEnabled())
+		return qfalse;
+
+	CMod_GetRoutingCacheName(key, filename, sizeof(filename));
+	length = FS_LoadFile(filename, &buf);
+	if (!buf)
+		return qfalse;
+
+	if (length < sizeof(header)) {
+		Com_Printf("CMod_LoadRoutingCache: %s is truncated\n", filename);
+		FS_FreeFile(buf);
+		return qfalse;
+	}
+
+	memcpy(&header, buf, sizeof(header));
+	header.ident = LittleLong(header.ident);
+	header.version = LittleLong(header.version);
+	header.keyLength = LittleLong(header.keyLength);
+	header.dataLength = LittleLong(header.dataLength);
+	header.dataChecksum = LittleLong(header.dataChecksum);
+
+	data = buf + sizeof(header);
+	if (header.ident != ROUTING_CACHE_IDENT || header.version != ROUTING_CACHE_VERSION
+	 || header.keyLength != strlen(key) + 1 || header.dataLength <= 0
+	 || sizeof(header) + header.keyLength + header.dataLength != length
+	 || memcmp(data, key, header.keyLength)) {
+		Com_DPrintf(DEBUG_ENGINE, "CMod_LoadRoutingCache: %s doesn't match the assembly\n", filename);
+		FS_FreeFile(buf);
+		return qfalse;
+	}
+
+	data += header.keyLength;
+	source = data;
+	if (Com_BlockChecksum(data, header.dataLength) != header.dataChecksum
+	 || RT_DeCompressRouting(&source, data + header.dataLength, NULL, sizeof(mapData->map), BSPVERSION) != sizeof(mapData->map)) {
+		Com_Printf("CMod_LoadRoutingCache: %s is corrupted\n", filename);
+		FS_FreeFile(buf);
+		return qfalse;
+	}
+
+	RT_DeCompressRouting(&data, data + header.dataLength, (byte*)mapData->map, sizeof(mapData->map), BSPVERSION);
+	FS_FreeFile(buf);
+
+	Com_Printf("Loaded routing for RMA from %s\n", filename);
+	return qtrue;
+}
+
+/**
+ * @brief Removes the oldest routing cache entries until the cache fits into @c cm_routingcachesize
+ */
+static void CMod_EvictRoutingCache (void)
+{
+	char findname[MAX_OSPATH];
+	char **filenames;
+	int *sizes, *created;
+	int numFiles, i, total;
+	const int maxSize = max(cm_routingCacheSize->integer, 0) * 1024 * 1024;
+
+	Com_sprintf(findname, sizeof(findname), "%s/" ROUTING_CACHE_DIR "/*.rtc", FS_Gamedir());
+	FS_NormPath(findname);
+	filenames = FS_ListFiles(findname, &numFiles, 0, SFF_SUBDIR | SFF_HIDDEN | SFF_SYSTEM);
+	if (!filenames)
+		return;
+
+	/* the last entry is a guard */
+	numFiles--;
+	sizes = (int *)Mem_PoolAlloc(numFiles * sizeof(*sizes), com_cmodelSysPool, 0);
+	created = (int *)Mem_PoolAlloc(numFiles * sizeof(*created), com_cmodelSysPool, 0);
+
+	total = 0;
+	for (i = 0; i < numFiles; i++) {
+		dRoutingCacheHeader_t header;
+		qFILE f;
+
+		sizes[i] = FS_OpenFile(va(ROUTING_CACHE_DIR "/%s", Com_SkipPath(filenames[i])), &f, FILE_READ);
+		if (sizes[i] <= 0)
+			continue;
+		if (FS_Read(&header, sizeof(header), &f) == sizeof(header))
+			created[i] = LittleLong(header.created);
+		FS_CloseFile(&f);
+		total += sizes[i];
+	}
+
+	while (total > maxSize) {
+		int oldest = -1;
+		for (i = 0; i < numFiles; i++) {
+			if (sizes[i] <= 0)
+				continue;
+			if (oldest == -1 || created[i] < created[oldest])
+				oldest = i;
+		}
+		if (oldest == -1)
+			break;
+		FS_RemoveFile(filenames[oldest]);
+		total -= sizes[oldest];
+		sizes[oldest] = 0;
+	}
+
+	for (i = 0; i < numFiles; i++)
+		Mem_Free(filenames[i]);
+	Mem_Free(filenames);
+	Mem_Free(sizes);
+	Mem_Free(created);
+}
+
+/**
+ * @brief Stores the rerouted routing table of an assembly in the cache
+ * @param[in] key Identifies the assembly - all tiles with their positions and checksums
+ * @param[in] mapData The rerouted map
+ * @sa CMod_LoadRoutingCache
+ */
+static void CMod_SaveRoutingCache (const char *key, const mapData_t *mapData)
+{
+	char filename[MAX_QPATH];
+	dRoutingCacheHeader_t header;
+	const int mapLength = sizeof(mapData->map);
+	const int keyLength = strlen(key) + 1;
+	byte *buf, *data, *end;
+
+	if (!CM_RoutingCacheEnabled())
+		return;
+
+	buf = (byte *)Mem_PoolAllocExt(sizeof(header) + keyLength + RT_COMPRESSED_MAXLENGTH(mapLength), qfalse, com_cmodelSysPool, 0);
+	data = buf + sizeof(header) + keyLength;
+	end = RT_CompressRouting((const byte *)mapData->map, data, mapLength);
+
+	header.ident = LittleLong(ROUTING_CACHE_IDENT);
+	header.version = LittleLong(ROUTING_CACHE_VERSION);
+	header.created = LittleLong((int)time(NULL));
+	header.keyLength = LittleLong(keyLength);
+	header.dataLength = LittleLong(end - data);
+	header.dataChecksum = LittleLong(Com_BlockChecksum(data, end - data));
+	memcpy(buf, &header, sizeof(header));
+	memcpy(buf + sizeof(header), key, keyLength);
+
+	CMod_GetRoutingCacheName(key, filename, sizeof(filename));
+	if (FS_WriteFile(buf, end - buf, filename) != end - buf)
+		Com_Printf("CMod_SaveRoutingCache: Could not write %s\n", filename);
+	Mem_Free(buf);
+
+	CMod_EvictRoutingCache();
+}
+
+/**
+ * @brief Splits the tile and position strings of CM_LoadMap into the entries of @c cmTileLoads
+ * @param[in] tiles Map name(s) relative to base/maps or random map assembly string
+ * @param[in] pos The positions of the tiles of an assembled map
+ * @param[out] numTiles The amount of parsed tiles
+ * @return @c true if the tiles are placed at the given positions (an assembled map)
+ */
+static qboolean CMod_ParseTiles (const char *tiles, const char *pos, int *numTiles)
+{
+	char base[MAX_QPATH];
+	int i;
+
+	base[0] = 0;
+	*numTiles = 0;
+
+	while (tiles) {
+		cmTileLoad_t *load;
+		/* get tile name */
+		const char *token = Com_Parse(&tiles);
+		if (!tiles)
+			return qtrue;
+
+		/* get base path */
+		if (token[0] == '-') {
+			Q_strncpyz(base, token + 1, sizeof(base));
+			continue;
+		}
+
+		if (*numTiles >= MAX_MAPTILES)
+			Com_Error(ERR_FATAL, "CM_LoadMap: too many tiles loaded %i", *numTiles);
+		load = &cmTileLoads[(*numTiles)++];
+
+		/* get tile name */
+		Com_DPrintf(DEBUG_ENGINE, "CM_LoadMap: token: %s\n", token);
+		if (token[0] == '+')
+			Com_sprintf(load->name, sizeof(load->name), "%s%s", base, token + 1);
+		else
+			Q_strncpyz(load->name, token, sizeof(load->name));
+
+		/* load only a single tile, if no positions are specified */
+		if (!pos || !pos[0])
+			return qfalse;
+
+		/* get position */
+		for (i = 0; i < 3; i++) {
+			token = Com_Parse(&pos);
+			if (!pos)
+				Com_Error(ERR_DROP, "CM_LoadMap: invalid positions");
+			load->shift[i] = atoi(token);
+		}
+		if (load->shift[0] <= -(PATHFINDING_WIDTH / 2) || load->shift[0] >= PATHFINDING_WIDTH / 2)
+			Com_Error(ERR_DROP, "CM_LoadMap: invalid x position given: %i\n", load->shift[0]);
+		if (load->shift[1] <= -(PATHFINDING_WIDTH / 2) || load->shift[1] >= PATHFINDING_WIDTH / 2)
+			Com_Error(ERR_DROP, "CM_LoadMap: invalid y position given: %i\n", load->shift[1]);
+		if (load->shift[2] >= PATHFINDING_HEIGHT)
+			Com_Error(ERR_DROP, "CM_LoadMap: invalid z position given: %i\n", load->shift[2]);
+	}
+
+	Com_Error(ERR_DROP, "CM_LoadMap: invalid tile names");
 }
 
 /**
  * @brief Loads in the map and all submodels
  * @note This function loads the collision data from the bsp file. For
  * rendering @c R_ModBeginLoading is used.
+ * @note The routing lumps of the tiles are decoded on up to @c cm_loadthreads threads while
+ * the tiles that are already decoded are merged into the map - in the order of the tiles,
+ * so the result doesn't depend on the threads.
  * @param[in] tiles	Map name(s) relative to base/maps or random map assembly string
  * @param[in] day Use the day (@c true) or the night (@c false) version of the map
  * @param[in] pos In case you gave more than one tile (Random map assembly [rma]) you also
@@ -952,15 +1299,19 @@ static void CMod_RerouteMap (mapTiles_t *mapTiles, mapData_t *mapData)
  */
 void CM_LoadMap (const char *tiles, qboolean day, const char *pos, mapData_t *mapData, mapTiles_t *mapTiles)
 {
-	const char *token;
-	char name[MAX_VAR];
-	char base[MAX_QPATH];
-	int i;
+	/* all tiles with their position and checksum - identifies the assembly in the routing cache */
+	char cacheKey[MAX_MAPTILES * (MAX_VAR + 48)];
+	cmRouting_t *routing[CM_MAX_LOADTHREADS];
+	qboolean assembled, threaded;
+	int numTiles, numBuffers, started, i;
+
+	/* a load that was aborted by an error might have left running threads behind */
+	CMod_AbortTileLoads();
 
 	Mem_FreePool(com_cmodelSysPool);
 
 	/* init */
-	base[0] = 0;
+	Q_strncpyz(cacheKey, UFO_VERSION ";", sizeof(cacheKey));
 
 	/* Reset the map related data */
 	OBJZERO(*mapData);
@@ -969,52 +1320,40 @@ void CM_LoadMap (const char *tiles, qboolean day, const char *pos, mapData_t *ma
 	if (pos && *pos)
 		Com_Printf("CM_LoadMap: \"%s\" \"%s\"\n", tiles, pos);
 
-	/* load tiles */
-	while (tiles) {
-		/* get tile name */
-		token = Com_Parse(&tiles);
-		if (!tiles) {
-			CMod_RerouteMap(mapTiles, mapData);
-			return;
-		}
+	assembled = CMod_ParseTiles(tiles, pos, &numTiles);
+	cmNumTileLoads = numTiles;
 
-		/* get base path */
-		if (token[0] == '-') {
-			Q_strncpyz(base, token + 1, sizeof(base));
-			continue;
-		}
+	threaded = cm_loadThreads != NULL && cm_loadThreads->integer > 0 && numTiles > 1;
+	numBuffers = threaded ? min(min(cm_loadThreads->integer, CM_MAX_LOADTHREADS), numTiles) : 1;
+	routing[0] = &cmRouting;
+	for (i = 1; i < numBuffers; i++)
+		routing[i] = (cmRouting_t *)Mem_PoolAllocExt(sizeof(*routing[i]), qfalse, com_cmodelSysPool, 0);
 
-		/* get tile name */
-		Com_DPrintf(DEBUG_ENGINE, "CM_LoadMap: token: %s\n", token);
-		if (token[0] == '+')
-			Com_sprintf(name, sizeof(name), "%s%s", base, token + 1);
-		else
-			Q_strncpyz(name, token, sizeof(name));
-
-		if (pos && pos[0]) {
-			ipos3_t sh;
-			/* get position and add a tile */
-			for (i = 0; i < 3; i++) {
-				token = Com_Parse(&pos);
-				if (!pos)
-					Com_Error(ERR_DROP, "CM_LoadMap: invalid positions");
-				sh[i] = atoi(token);
-			}
-			if (sh[0] <= -(PATHFINDING_WIDTH / 2) || sh[0] >= PATHFINDING_WIDTH / 2)
-				Com_Error(ERR_DROP, "CM_LoadMap: invalid x position given: %i\n", sh[0]);
-			if (sh[1] <= -(PATHFINDING_WIDTH / 2) || sh[1] >= PATHFINDING_WIDTH / 2)
-				Com_Error(ERR_DROP, "CM_LoadMap: invalid y position given: %i\n", sh[1]);
-			if (sh[2] >= PATHFINDING_HEIGHT)
-				Com_Error(ERR_DROP, "CM_LoadMap: invalid z position given: %i\n", sh[2]);
-			CM_AddMapTile(name, day, sh[0], sh[1], sh[2], mapData, mapTiles);
-		} else {
-			/* load only a single tile, if no positions are specified */
-			CM_AddMapTile(name, day, 0, 0, 0, mapData, mapTiles);
-			return;
-		}
+	for (i = 0, started = 0; i < numTiles; i++) {
+		cmTileLoad_t *load = &cmTileLoads[i];
+		unsigned checksum;
+
+		/* keep the loader threads busy while the decoded tiles are merged */
+		for (; started < numTiles && started < i + numBuffers; started++)
+			CMod_StartTileLoad(&cmTileLoads[started], routing[started % numBuffers], threaded);
+
+		CMod_FinishTileLoad(load);
+		checksum = CM_AddMapTile(load, day, mapData, mapTiles);
+		Q_strcat(cacheKey, va("%s %i %i %i %u;", load->name, load->shift[0], load->shift[1], load->shift[2], checksum), sizeof(cacheKey));
 	}
 
-	Com_Error(ERR_DROP, "CM_LoadMap: invalid tile names");
+	for (i = 1; i < numBuffers; i++)
+		Mem_Free(routing[i]);
+	cmNumTileLoads = 0;
+
+	/* calculate the map bounds once all tiles are merged */
+	if (mapTiles->numTiles)
+		RT_GetMapSize(mapTiles, mapData->mapMin, mapData->mapMax);
+
+	if (assembled && !CMod_LoadRoutingCache(cacheKey, mapData)) {
+		CMod_RerouteMap(mapTiles, mapData);
+		CMod_SaveRoutingCache(cacheKey, mapData);
+	}
 }
 
 /**
@@ -1097,7 +1097,11 @@ static void Cmd_Test_f (void)
 void Cmd_PrintDebugCommands (void)
 {
 	const cmd_function_t *cmd;
-	const char* otherCommands[] = {"mem_stats", "cl_configstrings", "cl_userinfo", "devmap"};
+	const char* otherCommands[] = {"mem_stats", "cl_configstrings", "cl_userinfo", "devmap"
+#ifdef PROF_ENABLED
+		, "perf_dump"
+#endif
+	};
 	int num = lengthof(otherCommands);
 
 	Com_Printf("Debug commands:\n");
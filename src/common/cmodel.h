@@ -32,6 +32,8 @@ CMODEL
 #include "tracing.h"
 
 void CM_LoadMap(const char *tiles, qboolean day, const char *pos, mapData_t *mapData, mapTiles_t *mapTiles);
+void CM_Init(void);
+qboolean CM_RoutingCacheEnabled(void);
 cBspModel_t *CM_InlineModel(const mapTiles_t *mapTiles, const char *name);
 cBspModel_t *CM_SetInlineModelOrientation(mapTiles_t *mapTiles, const char *name, const vec3_t origin, const vec3_t angles);
 float CM_GetVisibility(const mapTiles_t *mapTiles, const pos3_t position);
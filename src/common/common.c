@@ -45,6 +45,7 @@ static vPrintfPtr_t vPrintfPtr = Com_vPrintf;
 cvar_t *developer;
 cvar_t *http_proxy;
 cvar_t *http_timeout;
+cvar_t *http_maxrequests;
 static const char *consoleLogName = "ufoconsole.log";
 static cvar_t *logfile_active; /* 1 = buffer log, 2 = flush after each print */
 static cvar_t *com_pipefile; /* name of the pipe to send commands to */
@@ -908,6 +909,52 @@ static void Com_DebugError_f (void)
 	}
 	Com_Printf("Usage: %s <ERR_FATAL|ERR_DROP|ERR_DISCONNECT> <msg>\n", Cmd_Argv(0));
 }
+
+/** @brief The id lookup tables of the script definitions and their counters for debug_lookups */
+static struct {
+	const char *name;
+	idTable_t *table;
+	idTableCounters_t counters;
+} com_lookupTables[] = {
+	{"items", &csi.odsByID},
+	{"containers", &csi.idsByName},
+	{"teams", &csi.teamDefByID},
+	{"chrtemplates", &csi.chrTemplatesByID},
+	{"ugvs", &csi.ugvsByID},
+	{"mapdefs", &csi.mdsByID}
+};
+
+/**
+ * @brief Prints how many lookups into the script definition tables were done and how many
+ * slots they have to compare
+ */
+static void Com_DebugLookups_f (void)
+{
+	int i;
+
+	Com_Printf("table        entries  removed  avg probes  max probes    lookups     misses\n");
+	for (i = 0; i < lengthof(com_lookupTables); i++) {
+		const idTable_t *table = com_lookupTables[i].table;
+		const idTableCounters_t *counters = &com_lookupTables[i].counters;
+		idTableStats_t stats;
+
+		IDT_GetStats(table, &stats);
+		Com_Printf("%-12s %7i %8i %11.2f %11i %10i %10i\n", com_lookupTables[i].name, table->numEntries,
+				stats.numRemoved, stats.avgProbes, stats.maxProbes, counters->numLookups, counters->numMisses);
+	}
+}
+
+/**
+ * @brief Lets the script definition tables count their lookups for debug_lookups
+ * @note Call this after @c csi was zeroed
+ */
+static void Com_InitLookupCounters (void)
+{
+	int i;
+
+	for (i = 0; i < lengthof(com_lookupTables); i++)
+		IDT_SetCounters(com_lookupTables[i].table, &com_lookupTables[i].counters);
+}
 #endif
 
 
@@ -1069,6 +1116,11 @@ static void Cbuf_Execute_timer (int now, void *data)
 	Cbuf_Execute();
 }
 
+static void HTTP_RunRequests_timer (int now, void *data)
+{
+	HTTP_RunRequests();
+}
+
 void Qcommon_SetPrintFunction (vPrintfPtr_t func)
 {
 	vPrintfPtr = func;
@@ -1111,6 +1163,9 @@ void Qcommon_Init (int argc, const char **argv)
 	Com_SetExceptionCallback(Qcommon_InitError);
 
 	OBJZERO(csi);
+#ifdef DEBUG
+	Com_InitLookupCounters();
+#endif
 
 	/* prepare enough of the subsystems to handle
 	 * cvar and command buffer management */
@@ -1152,6 +1207,7 @@ void Qcommon_Init (int argc, const char **argv)
 #ifdef DEBUG
 	Cmd_AddCommand("debug_help", Com_DebugHelp_f, "Show some debugging help");
 	Cmd_AddCommand("debug_error", Com_DebugError_f, "Just throw a fatal error to test error shutdown procedures");
+	Cmd_AddCommand("debug_lookups", Com_DebugLookups_f, "Show the id lookups into the script definition tables and their probe lengths");
 #endif
 	Cmd_AddCommand("setdeveloper", Com_DeveloperSet_f, "Set the developer cvar to only get the debug output you want");
 
@@ -1164,6 +1220,7 @@ void Qcommon_Init (int argc, const char **argv)
 	sv_gametype = Cvar_Get("sv_gametype", "1on1", CVAR_ARCHIVE | CVAR_SERVERINFO, "Sets the multiplayer gametype - see gametypelist command for a list of all gametypes");
 	http_proxy = Cvar_Get("http_proxy", "", CVAR_ARCHIVE, "Use this proxy for http transfers");
 	http_timeout = Cvar_Get("http_timeout", "3", CVAR_ARCHIVE, "Http connection and read timeout");
+	http_maxrequests = Cvar_Get("http_maxrequests", "4", CVAR_ARCHIVE, "Maximum amount of asynchronous http requests in flight");
 	port = Cvar_Get("port", DOUBLEQUOTE(PORT_SERVER), CVAR_NOSET, NULL);
 	masterserver_url = Cvar_Get("masterserver_url", MASTER_SERVER, CVAR_ARCHIVE, "URL of UFO:AI masterserver");
 #ifdef DEDICATED_ONLY
@@ -1190,6 +1247,9 @@ void Qcommon_Init (int argc, const char **argv)
 		Cmd_AddCommand("quit", Com_Quit, "Quits the game");
 
 	Mem_Init();
+#ifdef PROF_ENABLED
+	Prof_Init();
+#endif
 	Sys_Init();
 
 	NET_Init();
@@ -1248,6 +1308,8 @@ void Qcommon_Init (int argc, const char **argv)
 
 	Schedule_Timer(Cvar_Get("sv_freq", "10", CVAR_NOSET, NULL), &SV_Frame, NULL, NULL);
 
+	Schedule_Timer(Cvar_Get("http_freq", "20", 0, NULL), &HTTP_RunRequests_timer, NULL, NULL);
+
 	/** @todo This line wants to be removed */
 	Schedule_Timer(Cvar_Get("cbuf_freq", "10", 0, NULL), &Cbuf_Execute_timer, NULL, NULL);
 
@@ -1501,6 +1563,10 @@ void Qcommon_Frame (void)
 
 		NET_Wait(time_to_next);
 	} while (time_to_next > 0);
+
+#ifdef PROF_ENABLED
+	Prof_Frame();
+#endif
 }
 
 /**
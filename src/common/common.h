@@ -181,6 +181,7 @@ enum clc_ops_e {
 #include "net.h"
 #include "dbuffer.h"
 #include "netpack.h"
+#include "profiler.h"
 
 /*
 ==============================================================
@@ -241,6 +242,7 @@ char *Com_MD5File(const char *fn, int length);
 
 extern cvar_t *http_proxy;
 extern cvar_t *http_timeout;
+extern cvar_t *http_maxrequests;
 extern cvar_t *developer;
 extern cvar_t *sv_dedicated;
 extern cvar_t *sv_maxclients;
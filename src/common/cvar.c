@@ -72,6 +72,22 @@ qboolean Com_IsRenderModified (void)
  */
 static cvar_t *cvarVars;
 
+/**
+ * @brief Incremented each time cvars are freed, pointers to cvars cached
+ * before a change of this value must not be used anymore
+ * @sa Cvar_GetRevision
+ */
+static int cvarRevision;
+
+/**
+ * @brief Returns a value that changes every time a cvar is freed
+ * @note Can be used to validate cached cvar pointers
+ */
+int Cvar_GetRevision (void)
+{
+	return cvarRevision;
+}
+
 cvar_t *Cvar_GetFirst (void)
 {
 	return cvarVars;
@@ -330,6 +346,7 @@ qboolean Cvar_Delete (const char *varName)
 				changeListener = changeListener2;
 			}
 			Mem_Free(var);
+			cvarRevision++;
 
 			return qtrue;
 		}
@@ -1132,4 +1149,5 @@ void Cvar_Shutdown (void)
 {
 	cvarVars = NULL;
 	memset(cvarVarsHash, 0, sizeof(cvarVarsHash));
+	cvarRevision++;
 }
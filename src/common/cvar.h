@@ -209,6 +209,11 @@ qboolean Cvar_Delete(const char *varName);
  */
 cvar_t *Cvar_FindVar(const char *varName);
 
+/**
+ * @brief Returns a value that changes every time a cvar is freed
+ */
+int Cvar_GetRevision(void);
+
 /**
  * @brief Checks whether there are pending cvars for the given flags
  * @param flags The CVAR_* flags
@@ -399,6 +399,25 @@ size_t dbuffer_get_at (const struct dbuffer *buf, size_t offset, char *data, siz
 	return read;
 }
 
+/**
+ * @brief Gives direct access to the data at the start of a dbuffer
+ * @param[in] buf the source buffer
+ * @param[in] len number of bytes the caller wants to read
+ * @return pointer to the first @c len bytes of the buffer, or @c NULL if the
+ * buffer holds less data or the data is split over two elements
+ *
+ * @par
+ * This allows to decode several values in place without copying them
+ * out one by one. Use dbuffer_remove to consume the data afterwards.
+ * The pointer is no longer valid once the buffer was changed.
+ */
+const char *dbuffer_peek (const struct dbuffer *buf, size_t len)
+{
+	if (!buf || buf->head->len < len)
+		return NULL;
+	return buf->start;
+}
+
 /**
  * @brief Allocate a dbuffer
  * @param[in] old the source buffer
@@ -90,6 +90,8 @@ extern void dbuffer_add(struct dbuffer *, const char *, size_t);
 extern size_t dbuffer_get(const struct dbuffer *, char *, size_t);
 /* Read the given number of bytes from the given position */
 extern size_t dbuffer_get_at(const struct dbuffer *, size_t, char *, size_t);
+/* Access the given number of bytes at the start of the buffer in place */
+extern const char *dbuffer_peek(const struct dbuffer *, size_t);
 /* Remove the given number of bytes from the start of the buffer */
 extern size_t dbuffer_remove(struct dbuffer *, size_t);
 /* Read and remove in one pass */
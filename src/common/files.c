@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../shared/typedefs.h"
 #include "../shared/parse.h"
 #include <unistd.h>
+#include <sys/stat.h>
 
 /** counter for opened files - used to check against missing close calls */
 static int fs_openedFiles;
@@ -151,14 +152,9 @@ void FS_CloseFile (qFILE * f)
 }
 
 /**
- * @brief Finds and opens the file in the search path.
- * @param[in] filename
- * @param[out] file The file pointer
- * @param[in] mode read, write, append as an enum
- * @return the filesize or -1 in case of an error
- * @note Used for streaming data out of either a pak file or a separate file.
+ * @sa FS_OpenFile
  */
-int FS_OpenFile (const char *filename, qFILE *file, filemode_t mode)
+static int FS_OpenFileInSearchPath (const char *filename, qFILE *file, filemode_t mode)
 {
 	searchpath_t *search;
 	char netpath[MAX_OSPATH];
@@ -188,7 +184,7 @@ int FS_OpenFile (const char *filename, qFILE *file, filemode_t mode)
 		if (!strncmp(filename, link->from, link->fromlength)) {
 			int length;
 			Com_sprintf(netpath, sizeof(netpath), "%s%s", link->to, filename + link->fromlength);
-			length = FS_OpenFile(netpath, file, mode);
+			length = FS_OpenFileInSearchPath(netpath, file, mode);
 			Q_strncpyz(file->name, filename, sizeof(file->name));
 			if (length == -1)
 				Com_Printf("linked file could not be opened: %s\n", netpath);
@@ -238,6 +234,25 @@ int FS_OpenFile (const char *filename, qFILE *file, filemode_t mode)
 	return -1;
 }
 
+/**
+ * @brief Finds and opens the file in the search path.
+ * @param[in] filename
+ * @param[out] file The file pointer
+ * @param[in] mode read, write, append as an enum
+ * @return the filesize or -1 in case of an error
+ * @note Used for streaming data out of either a pak file or a separate file.
+ */
+int FS_OpenFile (const char *filename, qFILE *file, filemode_t mode)
+{
+	int length;
+
+	PROF_BEGIN(PROF_FS_OPENFILE);
+	length = FS_OpenFileInSearchPath(filename, file, mode);
+	PROF_END(PROF_FS_OPENFILE);
+
+	return length;
+}
+
 #define PK3_SEEK_BUFFER_SIZE 65536
 /**
  * @brief Sets the file position of the given file
@@ -316,6 +331,54 @@ int FS_CheckFile (const char *fmt, ...)
 	return result;
 }
 
+/**
+ * @brief Identifies the content of a file without opening or reading it
+ * @param[in] filename The file in the search path
+ * @param[out] stamp The crc32 from the directory of the pk3 the file is in - or the modification
+ * time for a file in the directory tree
+ * @return The length of the file (compressed for pk3 files) or -1 if it wasn't found
+ * @note Searches the same way as @c FS_OpenFile - so the stamp belongs to the file that is loaded
+ * @sa FS_CheckFile
+ */
+int FS_GetFileStamp (const char *filename, unsigned *stamp)
+{
+	const searchpath_t *search;
+	const filelink_t *link;
+	char netpath[MAX_OSPATH];
+	int i;
+
+	/* check for links first */
+	for (link = fs_links; link; link = link->next) {
+		if (!strncmp(filename, link->from, link->fromlength)) {
+			Com_sprintf(netpath, sizeof(netpath), "%s%s", link->to, filename + link->fromlength);
+			return FS_GetFileStamp(netpath, stamp);
+		}
+	}
+
+	for (search = fs_searchpaths; search; search = search->next) {
+		if (search->pack) {
+			const pack_t *pak = search->pack;
+			for (i = 0; i < pak->numfiles; i++) {
+				if (!Q_strcasecmp(pak->files[i].name, filename)) {
+					*stamp = pak->files[i].crc;
+					return pak->files[i].filelen;
+				}
+			}
+		} else {
+			struct stat st;
+
+			Com_sprintf(netpath, sizeof(netpath), "%s/%s", search->filename, filename);
+			if (stat(netpath, &st) == -1 || (st.st_mode & S_IFDIR))
+				continue;
+
+			*stamp = (unsigned)st.st_mtime;
+			return st.st_size;
+		}
+	}
+
+	return -1;
+}
+
 #define	MAX_READ	0x10000		/* read in blocks of 64k */
 /**
  * @brief Read a file into a given buffer in memory.
@@ -484,6 +547,7 @@ static pack_t *FS_LoadPackFile (const char *packfile)
 			unzGetCurrentFileInfoPosition(uf, &newfiles[i].filepos);
 			Q_strncpyz(newfiles[i].name, filenameInZip, sizeof(newfiles[i].name));
 			newfiles[i].filelen = file_info.compressed_size;
+			newfiles[i].crc = file_info.crc;
 			unzGoToNextFile(uf);
 		}
 		pack->files = newfiles;
@@ -1335,7 +1399,7 @@ static int CheckBSPFile (const char *filename)
 
 	if (header[0] != IDBSPHEADER)
 		return 2;
-	if (header[1] != BSPVERSION)
+	if (!BSP_IsSupportedVersion(header[1]))
 		return 3;
 
 	/* valid BSP-File */
@@ -84,6 +84,7 @@ typedef struct {
 	char name[MAX_QPATH];
 	unsigned long filepos;
 	unsigned long filelen;
+	unsigned long crc;			/**< crc32 of the uncompressed data as stored in the zip directory */
 } packfile_t;
 
 typedef struct pack_s {
@@ -161,6 +162,7 @@ int FS_Read(void *buffer, int len, qFILE * f);
 void FS_FreeFile(void *buffer);
 
 int FS_CheckFile(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+int FS_GetFileStamp(const char *filename, unsigned *stamp);
 
 int FS_BuildFileList(const char *files);
 const char* FS_NextFileFromFileList(const char *files);
@@ -546,6 +546,8 @@ void Grid_MoveCalc (const routing_t *map, const actorSizeEnum_t actorSize, pathi
 	/* this is the position of the current actor- so the actor can stand in the cell it is in when pathfinding */
 	pos3_t excludeFromForbiddenList;
 
+	PROF_BEGIN(PROF_GRID_MOVECALC);
+
 	/* reset move data */
 	OBJSET(path->area,     ROUTING_NOT_REACHABLE);
 	OBJSET(path->areaFrom, ROUTING_NOT_REACHABLE);
@@ -599,6 +601,9 @@ void Grid_MoveCalc (const routing_t *map, const actorSizeEnum_t actorSize, pathi
 	PQueueFree(&pqueue);
 
 	Com_DPrintf(DEBUG_PATHING, "Grid_MoveCalc: Done\n\n");
+
+	PROF_COUNT(PROF_COUNTER_PATHING_NODES, count);
+	PROF_END(PROF_GRID_MOVECALC);
 }
 
 /**
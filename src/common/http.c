@@ -246,10 +246,215 @@ void HTTP_GetURL (const char *url, http_callback_t callback)
 	Mem_Free(response);
 }
 
+/**
+ * @brief A request that is handled by the curl multi handle
+ * @sa HTTP_GetURLAsync
+ */
+typedef struct httpRequest_s {
+	dlhandle_t dl;
+	http_async_callback_t callback;
+	void *userdata;				/**< passed to the callback */
+	int timeout;				/**< seconds until curl gives up on this request */
+	qboolean running;			/**< @c true if the easy handle was added to the multi handle */
+	struct httpRequest_s *next;
+} httpRequest_t;
+
+static CURLM *httpMulti;
+/** @brief All queued and running requests in the order they were issued */
+static httpRequest_t *httpRequests;
+static int httpRequestsRunning;
+
+/**
+ * @brief Hands a queued request over to the multi handle
+ * @return @c false if curl refused the request
+ */
+static qboolean HTTP_StartRequest (httpRequest_t *req)
+{
+	dlhandle_t *dl = &req->dl;
+
+	dl->curl = curl_easy_init();
+	if (!dl->curl)
+		return qfalse;
+
+	curl_easy_setopt(dl->curl, CURLOPT_CONNECTTIMEOUT, req->timeout);
+	curl_easy_setopt(dl->curl, CURLOPT_TIMEOUT, req->timeout);
+	curl_easy_setopt(dl->curl, CURLOPT_ENCODING, "");
+	curl_easy_setopt(dl->curl, CURLOPT_NOPROGRESS, 1);
+	curl_easy_setopt(dl->curl, CURLOPT_FAILONERROR, 1);
+	curl_easy_setopt(dl->curl, CURLOPT_WRITEDATA, dl);
+	curl_easy_setopt(dl->curl, CURLOPT_WRITEFUNCTION, HTTP_Recv);
+	curl_easy_setopt(dl->curl, CURLOPT_PROXY, http_proxy->string);
+	curl_easy_setopt(dl->curl, CURLOPT_FOLLOWLOCATION, 1);
+	curl_easy_setopt(dl->curl, CURLOPT_MAXREDIRS, 5);
+	curl_easy_setopt(dl->curl, CURLOPT_WRITEHEADER, dl);
+	curl_easy_setopt(dl->curl, CURLOPT_HEADERFUNCTION, HTTP_Header);
+	curl_easy_setopt(dl->curl, CURLOPT_USERAGENT, GAME_TITLE" "UFO_VERSION);
+	curl_easy_setopt(dl->curl, CURLOPT_URL, dl->URL);
+	curl_easy_setopt(dl->curl, CURLOPT_NOSIGNAL, 1);
+	curl_easy_setopt(dl->curl, CURLOPT_PRIVATE, req);
+
+	if (curl_multi_add_handle(httpMulti, dl->curl) != CURLM_OK) {
+		curl_easy_cleanup(dl->curl);
+		dl->curl = NULL;
+		return qfalse;
+	}
+
+	req->running = qtrue;
+	httpRequestsRunning++;
+	return qtrue;
+}
+
+/**
+ * @brief Unlinks the request from the list and releases the curl handle
+ * @note The response buffer is not freed here
+ */
+static void HTTP_RemoveRequest (httpRequest_t *req)
+{
+	httpRequest_t **anchor;
+
+	for (anchor = &httpRequests; *anchor; anchor = &(*anchor)->next) {
+		if (*anchor == req) {
+			*anchor = req->next;
+			break;
+		}
+	}
+
+	if (req->running) {
+		curl_multi_remove_handle(httpMulti, req->dl.curl);
+		httpRequestsRunning--;
+	}
+	if (req->dl.curl)
+		curl_easy_cleanup(req->dl.curl);
+}
+
+/**
+ * @brief Removes the request and hands the response to its callback
+ * @param[in] success @c false if curl reported an error - the callback gets @c NULL in this case
+ */
+static void HTTP_FinishRequest (httpRequest_t *req, qboolean success)
+{
+	char *response = req->dl.tempBuffer;
+
+	/* unlink before the callback - it might issue new requests */
+	HTTP_RemoveRequest(req);
+
+	if (!success) {
+		Com_DPrintf(DEBUG_ENGINE, "HTTP request failed: %s\n", req->dl.URL);
+		if (response)
+			Mem_Free(response);
+		response = NULL;
+	}
+
+	if (req->callback != NULL)
+		req->callback(response, req->userdata);
+	if (response)
+		Mem_Free(response);
+	Mem_Free(req);
+}
+
+/**
+ * @brief Queues a request for the given url without blocking the caller
+ * @param[in] url The url to fetch
+ * @param[in] callback Called from @c HTTP_RunRequests with the response, or with @c NULL
+ * if the request failed or timed out. May be @c NULL.
+ * @param[in] userdata Handed to the callback of this request
+ * @param[in] timeout Timeout in seconds for this request, @c 0 uses @c http_timeout
+ * @note At most @c http_maxrequests requests are in flight, the others wait in the queue
+ * @sa HTTP_GetURL
+ */
+void HTTP_GetURLAsync (const char *url, http_async_callback_t callback, void *userdata, int timeout)
+{
+	httpRequest_t *req;
+	httpRequest_t **anchor;
+
+	if (!httpMulti) {
+		httpMulti = curl_multi_init();
+		if (!httpMulti) {
+			Com_Printf("HTTP_GetURLAsync: curl_multi_init failed\n");
+			if (callback != NULL)
+				callback(NULL, userdata);
+			return;
+		}
+	}
+
+	req = (httpRequest_t *)Mem_Alloc(sizeof(*req));
+	Q_strncpyz(req->dl.URL, url, sizeof(req->dl.URL));
+	req->callback = callback;
+	req->userdata = userdata;
+	req->timeout = timeout > 0 ? timeout : http_timeout->integer;
+
+	/* append to keep the requests in issue order */
+	for (anchor = &httpRequests; *anchor; anchor = &(*anchor)->next) {
+	}
+	*anchor = req;
+
+	if (httpRequestsRunning < max(http_maxrequests->integer, 1) && !HTTP_StartRequest(req))
+		HTTP_FinishRequest(req, qfalse);
+}
+
+/**
+ * @brief Drives the queued requests and calls the callbacks of the finished ones
+ * @note Called from the main loop, never blocks
+ * @sa HTTP_GetURLAsync
+ */
+void HTTP_RunRequests (void)
+{
+	httpRequest_t *req;
+	CURLMsg *msg;
+	int messagesInQueue;
+	int running;
+
+	if (!httpRequests)
+		return;
+
+	/* fill the free slots with queued requests */
+	for (req = httpRequests; req && httpRequestsRunning < max(http_maxrequests->integer, 1);) {
+		httpRequest_t *next = req->next;
+		if (!req->running && !HTTP_StartRequest(req))
+			HTTP_FinishRequest(req, qfalse);
+		req = next;
+	}
+
+	while (curl_multi_perform(httpMulti, &running) == CURLM_CALL_MULTI_PERFORM) {
+	}
+
+	while ((msg = curl_multi_info_read(httpMulti, &messagesInQueue)) != NULL) {
+		if (msg->msg != CURLMSG_DONE)
+			continue;
+
+		req = NULL;
+		curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **)&req);
+		if (!req)
+			continue;
+
+		HTTP_FinishRequest(req, msg->data.result == CURLE_OK);
+	}
+}
+
+/**
+ * @brief Drops all pending requests without calling their callbacks
+ */
+static void HTTP_AbortRequests (void)
+{
+	while (httpRequests) {
+		httpRequest_t *req = httpRequests;
+		HTTP_RemoveRequest(req);
+		if (req->dl.tempBuffer)
+			Mem_Free(req->dl.tempBuffer);
+		Mem_Free(req);
+	}
+
+	if (httpMulti) {
+		curl_multi_cleanup(httpMulti);
+		httpMulti = NULL;
+	}
+}
+
 /**
  * @brief UFO is exiting or we're changing servers. Clean up.
  */
 void HTTP_Cleanup (void)
 {
+	HTTP_AbortRequests();
 	curl_global_cleanup();
 }
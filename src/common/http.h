@@ -60,8 +60,12 @@ typedef struct upparam_s {
 } upparam_t;
 
 typedef void (*http_callback_t) (const char *response);
+/** @brief Completion callback of an asynchronous request - gets the user data of the request */
+typedef void (*http_async_callback_t) (const char *response, void *userdata);
 
 void HTTP_GetURL(const char *url, http_callback_t callback);
+void HTTP_GetURLAsync(const char *url, http_async_callback_t callback, void *userdata, int timeout);
+void HTTP_RunRequests(void);
 void HTTP_PutFile(const char *formName, const char *fileName, const char *url, const upparam_t *params);
 size_t HTTP_Recv(void *ptr, size_t size, size_t nmemb, void *stream);
 size_t HTTP_Header(void *ptr, size_t size, size_t nmemb, void *stream);
@@ -260,6 +260,9 @@ void *_Mem_Alloc (size_t size, qboolean zeroFill, memPool_t *pool, const int tag
 	if (size > 0x40000000)
 		Sys_Error("Mem_Alloc: Attempted allocation of '"UFO_SIZE_T"' bytes!\n" "alloc: %s:#%i\n", size, fileName, fileLine);
 
+	PROF_BEGIN(PROF_MEM_ALLOC);
+	PROF_COUNT(PROF_COUNTER_MEM_BYTES, size);
+
 	/* Add header and round to cacheline */
 	size = (size + sizeof(memBlock_t) + sizeof(memBlockFoot_t) + 31) & ~31;
 	mem = (memBlock_t *)malloc(size);
@@ -297,6 +300,8 @@ void *_Mem_Alloc (size_t size, qboolean zeroFill, memPool_t *pool, const int tag
 
 	TH_MutexUnlock(z_lock);
 
+	PROF_END(PROF_MEM_ALLOC);
+
 	return mem->memPointer;
 }
 
@@ -36,7 +36,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../ports/system.h"
 #endif
 
+#ifdef _WIN32
+/* winsock can only select() on 64 sockets by default */
 #define MAX_STREAMS 56
+#else
+/* enough for a loopback connection (two streams) for every client */
+#define MAX_STREAMS (MAX_CLIENTS * 2 + 56)
+#endif
 #define MAX_DATAGRAM_SOCKETS 7
 
 #ifdef _WIN32
@@ -91,6 +97,26 @@ typedef int SOCKET;
 
 static cvar_t* net_ipv4;
 
+/**
+ * @brief A block of data that is enqueued on several streams without being copied for each
+ * of them - it is freed when the last stream has sent its part
+ * @sa NET_StreamEnqueueShared
+ */
+struct net_shared {
+	int refcount;
+	size_t size;
+	char data[1];
+};
+
+/** @brief A part of a shared block in the outbound queue of a stream */
+struct net_shared_ref {
+	struct net_shared *shared;
+	size_t offset;			/**< the next byte of the block to send */
+	size_t end;
+	size_t before;			/**< bytes of the outbound buffer that have to be sent before this part */
+	struct net_shared_ref *next;
+};
+
 struct net_stream {
 	void *data;
 
@@ -105,9 +131,14 @@ struct net_stream {
 
 	struct dbuffer *inbound;
 	struct dbuffer *outbound;
+	/** the shared blocks are sent interleaved with the @c outbound buffer, in the order they were enqueued */
+	struct net_shared_ref *shared_queue;
+	struct net_shared_ref **shared_queue_tail;
+	size_t shared_before;	/**< sum of the @c before of all queued shared parts */
 
 	stream_onclose_func *onclose;
 	stream_callback_func *func;
+	stream_tap_func *tap;		/**< sees everything that is enqueued for sending */
 	struct net_stream *loopback_peer;
 };
 
@@ -251,16 +282,49 @@ static struct net_stream *NET_StreamNew (int index)
 	s->socket = INVALID_SOCKET;
 	s->inbound = NULL;
 	s->outbound = NULL;
+	s->shared_queue = NULL;
+	s->shared_queue_tail = &s->shared_queue;
+	s->shared_before = 0;
 	s->index = index;
 	s->family = 0;
 	s->addrlen = 0;
 	s->func = NULL;
+	s->tap = NULL;
 	if (streams[index])
 		NET_StreamFree(streams[index]);
 	streams[index] = s;
 	return s;
 }
 
+/**
+ * @return The amount of bytes that are waiting to be sent on the stream
+ */
+static size_t NET_StreamGetOutboundLength (const struct net_stream *s)
+{
+	const struct net_shared_ref *ref;
+	size_t len = dbuffer_len(s->outbound);
+
+	for (ref = s->shared_queue; ref; ref = ref->next)
+		len += ref->end - ref->offset;
+
+	return len;
+}
+
+/**
+ * @brief Removes the sent shared part from the head of the outbound queue
+ */
+static void NET_StreamDequeueShared (struct net_stream *s)
+{
+	struct net_shared_ref *ref = s->shared_queue;
+
+	s->shared_queue = ref->next;
+	if (!s->shared_queue)
+		s->shared_queue_tail = &s->shared_queue;
+	s->shared_before -= ref->before;
+	NET_SharedRelease(ref->shared);
+	Mem_Free(ref);
+}
+
 static void NET_ShowStreams_f (void)
 {
 	int i;
@@ -272,7 +336,7 @@ static void NET_ShowStreams_f (void)
 			Com_Printf("Steam %i is opened: %s on socket %i (closed: %i, finished: %i, outbound: "UFO_SIZE_T", inbound: "UFO_SIZE_T")\n", i,
 				NET_StreamPeerToName(streams[i], buf, sizeof(buf), qtrue),
 				streams[i]->socket, streams[i]->closed, streams[i]->finished,
-				dbuffer_len(streams[i]->outbound), dbuffer_len(streams[i]->inbound));
+				NET_StreamGetOutboundLength(streams[i]), dbuffer_len(streams[i]->inbound));
 			cnt++;
 		}
 	}
@@ -337,7 +401,7 @@ static void NET_StreamClose (struct net_stream *s)
 		return;
 
 	if (s->socket != INVALID_SOCKET) {
-		if (dbuffer_len(s->outbound))
+		if (NET_StreamGetOutboundLength(s))
 			Com_Printf("The outbound buffer for this socket (%d) is not empty\n", s->socket);
 		else if (dbuffer_len(s->inbound))
 			Com_Printf("The inbound buffer for this socket (%d) is not empty\n", s->socket);
@@ -365,6 +429,8 @@ static void NET_StreamClose (struct net_stream *s)
 		free_dbuffer(s->outbound);
 
 	s->outbound = NULL;
+	while (s->shared_queue)
+		NET_StreamDequeueShared(s);
 	s->socket = INVALID_SOCKET;
 
 	/* Note that this is potentially invalid after the callback returns */
@@ -477,10 +543,11 @@ void NET_Wait (int timeout)
 			continue;
 
 		if (FD_ISSET(s->socket, &write_fds_out)) {
+			struct net_shared_ref *ref = s->shared_queue;
 			char buf[4096];
 			int len;
 
-			if (dbuffer_len(s->outbound) == 0) {
+			if (dbuffer_len(s->outbound) == 0 && !ref) {
 				FD_CLR(s->socket, &write_fds);
 
 				/* Finished streams are closed when their outbound queues empty */
@@ -490,8 +557,13 @@ void NET_Wait (int timeout)
 				continue;
 			}
 
-			len = dbuffer_get(s->outbound, buf, sizeof(buf));
-			len = send(s->socket, buf, len, 0);
+			/* shared parts are sent straight from the shared block */
+			if (ref && ref->before == 0)
+				len = send(s->socket, ref->shared->data + ref->offset, ref->end - ref->offset, 0);
+			else {
+				len = dbuffer_get(s->outbound, buf, ref ? min(sizeof(buf), ref->before) : sizeof(buf));
+				len = send(s->socket, buf, len, 0);
+			}
 
 			if (len < 0) {
 				Com_Printf("write on socket %d failed: %s\n", s->socket, netStringError(netError));
@@ -501,7 +573,17 @@ void NET_Wait (int timeout)
 
 			Com_DPrintf(DEBUG_SERVER, "wrote %d bytes to stream %d (%s)\n", len, i, NET_StreamPeerToName(s, buf, sizeof(buf), qtrue));
 
-			dbuffer_remove(s->outbound, len);
+			if (ref && ref->before == 0) {
+				ref->offset += len;
+				if (ref->offset == ref->end)
+					NET_StreamDequeueShared(s);
+			} else {
+				dbuffer_remove(s->outbound, len);
+				if (ref) {
+					ref->before -= len;
+					s->shared_before -= len;
+				}
+			}
 		}
 
 		if (FD_ISSET(s->socket, &read_fds_out)) {
@@ -706,6 +788,23 @@ struct net_stream *NET_ConnectToLoopBack (stream_onclose_func *onclose)
 	return client;
 }
 
+/**
+ * @brief Creates a stream that isn't connected to anything
+ * @note Everything that is written to it is only passed to its tap and dropped afterwards
+ * @sa NET_StreamSetTap
+ */
+struct net_stream *NET_StreamNewDetached (void)
+{
+	const int index = NET_StreamGetFree();
+
+	if (index == -1) {
+		Com_Printf("Too many streams open, can't create a detached stream\n");
+		return NULL;
+	}
+
+	return NET_StreamNew(index);
+}
+
 /**
  * @brief Enqueue a network message into a stream
  * @sa NET_StreamDequeue
@@ -716,6 +815,9 @@ void NET_StreamEnqueue (struct net_stream *s, const char *data, int len)
 	if (len <= 0 || !s || s->closed || s->finished)
 		return;
 
+	if (s->tap)
+		s->tap(s, data, len);
+
 	if (s->outbound)
 		dbuffer_add(s->outbound, data, len);
 
@@ -728,6 +830,92 @@ void NET_StreamEnqueue (struct net_stream *s, const char *data, int len)
 	}
 }
 
+/**
+ * @brief Creates a block of data that can be enqueued on several streams without copying it
+ * @param[in] size The size of the block - it is filled via @c NET_SharedGetData
+ * @return The block with one reference, which belongs to the caller
+ * @sa NET_SharedRelease
+ */
+struct net_shared *NET_SharedNew (size_t size)
+{
+	struct net_shared *shared = (struct net_shared *)Mem_PoolAlloc(sizeof(*shared) + size, com_networkPool, 0);
+	shared->refcount = 1;
+	shared->size = size;
+	return shared;
+}
+
+/**
+ * @brief Changes the size of a block that is not yet enqueued anywhere
+ * @return The resized block - @c shared is invalid afterwards
+ */
+struct net_shared *NET_SharedResize (struct net_shared *shared, size_t size)
+{
+	assert(shared->refcount == 1);
+	shared = (struct net_shared *)Mem_ReAlloc(shared, sizeof(*shared) + size);
+	shared->size = size;
+	return shared;
+}
+
+char *NET_SharedGetData (struct net_shared *shared)
+{
+	return shared->data;
+}
+
+size_t NET_SharedGetSize (const struct net_shared *shared)
+{
+	return shared->size;
+}
+
+/**
+ * @brief Drops a reference to the block - the last one frees it
+ * @note The streams drop their references from @c NET_Wait, which might run in another
+ * thread than the one that filled the block
+ */
+void NET_SharedRelease (struct net_shared *shared)
+{
+	if (__sync_sub_and_fetch(&shared->refcount, 1) == 0)
+		Mem_Free(shared);
+}
+
+/**
+ * @brief Enqueue a part of a shared block into a stream. The stream only references the
+ * block - the data must not be changed anymore.
+ * @note Loopback streams get a copy, as their outbound buffer is the inbound buffer of their peer
+ * @sa NET_StreamEnqueue
+ * @sa NET_SharedNew
+ */
+void NET_StreamEnqueueShared (struct net_stream *s, struct net_shared *shared, size_t offset, size_t len)
+{
+	struct net_shared_ref *ref;
+
+	assert(offset + len <= shared->size);
+
+	if (len == 0 || !s || s->closed || s->finished)
+		return;
+
+	if (s->socket == INVALID_SOCKET) {
+		NET_StreamEnqueue(s, shared->data + offset, len);
+		return;
+	}
+
+	if (s->tap)
+		s->tap(s, shared->data + offset, len);
+
+	__sync_fetch_and_add(&shared->refcount, 1);
+	ref = (struct net_shared_ref *)Mem_PoolAlloc(sizeof(*ref), com_networkPool, 0);
+	ref->shared = shared;
+	ref->offset = offset;
+	ref->end = offset + len;
+	/* everything that is in the outbound buffer and not in front of another shared part */
+	ref->before = dbuffer_len(s->outbound) - s->shared_before;
+	ref->next = NULL;
+	s->shared_before += ref->before;
+	*s->shared_queue_tail = ref;
+	s->shared_queue_tail = &ref->next;
+
+	FD_SET(s->socket, &write_fds);
+}
+
 qboolean NET_StreamIsClosed (struct net_stream *s)
 {
 	return s ? (s->closed || s->finished) : qtrue;
@@ -777,6 +965,17 @@ void NET_StreamSetData (struct net_stream *s, void *data)
 	s->data = data;
 }
 
+/**
+ * @brief Sets a function that gets everything that is enqueued for sending on this stream
+ * @sa NET_StreamEnqueue
+ */
+void NET_StreamSetTap (struct net_stream *s, stream_tap_func *tap)
+{
+	if (!s)
+		return;
+	s->tap = tap;
+}
+
 /**
  * @brief Call NET_StreamFree to dump the whole thing right now
  * @sa NET_StreamClose
@@ -816,7 +1015,7 @@ void NET_StreamFinished (struct net_stream *s)
 
 	/* If there's nothing in the outbound buffer, any finished stream is
 	 * ready to be closed */
-	if (dbuffer_len(s->outbound) == 0)
+	if (NET_StreamGetOutboundLength(s) == 0)
 		NET_StreamClose(s);
 }
 
@@ -26,10 +26,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define _COMMON_NET_H
 
 struct net_stream;
+struct net_shared;
 struct datagram_socket;
 struct sockaddr;
 typedef void stream_onclose_func();
 typedef void stream_callback_func(struct net_stream *s);
+typedef void stream_tap_func(struct net_stream *s, const char *data, int len);
 typedef void datagram_callback_func(struct datagram_socket *s, const char *buf, int len, struct sockaddr *from);
 
 qboolean SV_Start(const char *node, const char *service, stream_callback_func *func);
@@ -47,13 +49,21 @@ void NET_Shutdown(void);
 void NET_Wait(int timeout);
 struct net_stream *NET_Connect(const char *node, const char *service, stream_onclose_func *onclose);
 struct net_stream *NET_ConnectToLoopBack(stream_onclose_func *onclose);
+struct net_stream *NET_StreamNewDetached(void);
 void NET_StreamEnqueue(struct net_stream *s, const char *data, int len);
+void NET_StreamEnqueueShared(struct net_stream *s, struct net_shared *shared, size_t offset, size_t len);
+struct net_shared *NET_SharedNew(size_t size);
+struct net_shared *NET_SharedResize(struct net_shared *shared, size_t size);
+char *NET_SharedGetData(struct net_shared *shared);
+size_t NET_SharedGetSize(const struct net_shared *shared);
+void NET_SharedRelease(struct net_shared *shared);
 qboolean NET_StreamIsClosed(struct net_stream *s);
 int NET_StreamGetLength(struct net_stream *s);
 int NET_StreamPeek(struct net_stream *s, char *data, int len);
 int NET_StreamDequeue(struct net_stream *s, char *data, int len);
 void *NET_StreamGetData(struct net_stream *s);
 void NET_StreamSetData(struct net_stream *s, void *data);
+void NET_StreamSetTap(struct net_stream *s, stream_tap_func *tap);
 const char *NET_StreamPeerToName(struct net_stream *s, char *dst, int len, qboolean appendPort);
 qboolean NET_StreamIsLoopback(struct net_stream *s);
 void NET_StreamFree(struct net_stream *s);
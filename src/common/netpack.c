@@ -28,6 +28,166 @@ const vec3_t bytedirs[] = {
 #include "../shared/vertex_normals.h"
 };
 
+/** @brief Bytes the format writers encode into on the stack before they add them to the dbuffer in one go */
+#define NET_FORMAT_SPAN		512
+/** @brief The biggest fixed size field of a format string (a position) */
+#define NET_FORMAT_MAXFIELD	12
+
+/** @brief Cells per side of a cube face for the direction lookup */
+#define NET_DIR_CELLS		16
+#define NET_DIR_NUMCELLS	(6 * NET_DIR_CELLS * NET_DIR_CELLS)
+#define NET_DIR_MAXCANDIDATES	(NET_DIR_NUMCELLS * 8)
+
+/**
+ * @brief Direction quantisation lookup
+ * The directions are projected onto a cube, every cell of the cube faces knows the
+ * few bytedirs that can be the closest ones for any direction inside the cell.
+ * @sa NET_InitDirLookup
+ */
+static struct {
+	qboolean initialized;
+	short cellStart[NET_DIR_NUMCELLS + 1];	/**< first candidate of each cell in @c candidates */
+	byte candidates[NET_DIR_MAXCANDIDATES];	/**< bytedirs indices, ascending per cell */
+} netDirLookup;
+
+/**
+ * @brief Maps a point on the cube face to the unit sphere
+ * @param[in] face major axis * 2 + 1 for the negative direction
+ */
+static void NET_DirFromCubeFace (int face, float u, float v, vec3_t dir)
+{
+	const int axis = face / 2;
+
+	dir[axis] = (face & 1) ? -1.0f : 1.0f;
+	dir[(axis + 1) % 3] = u;
+	dir[(axis + 2) % 3] = v;
+	VectorNormalize(dir);
+}
+
+/**
+ * @brief Collects the candidates for every cell of the direction lookup
+ * @note The bytedir closest to the cell center has the angle @c a to it. A direction
+ * inside the cell is at most @c r (the angular radius of the cell) away from the
+ * center, so only bytedirs within <tt>a + 2r</tt> of the center can be closer to it.
+ */
+static void NET_InitDirLookup (void)
+{
+	const float step = 2.0f / NET_DIR_CELLS;
+	int face, i, j, k, cell = 0, num = 0;
+
+	for (face = 0; face < 6; face++) {
+		for (i = 0; i < NET_DIR_CELLS; i++) {
+			for (j = 0; j < NET_DIR_CELLS; j++, cell++) {
+				const float u = -1.0f + i * step;
+				const float v = -1.0f + j * step;
+				float radius = 0.0f, bestd = -1.0f, limit;
+				vec3_t center, corner;
+
+				NET_DirFromCubeFace(face, u + step / 2, v + step / 2, center);
+				for (k = 0; k < 4; k++) {
+					NET_DirFromCubeFace(face, u + (k & 1) * step, v + (k >> 1) * step, corner);
+					radius = max(radius, acos(min(DotProduct(center, corner), 1.0f)));
+				}
+
+				for (k = 0; k < lengthof(bytedirs); k++)
+					bestd = max(bestd, DotProduct(center, bytedirs[k]));
+
+				/* a little slack for the rounding errors */
+				limit = cos(min(acos(min(bestd, 1.0f)) + 2.0f * radius + 0.01f, M_PI));
+
+				netDirLookup.cellStart[cell] = num;
+				for (k = 0; k < lengthof(bytedirs); k++) {
+					if (DotProduct(center, bytedirs[k]) < limit)
+						continue;
+					if (num >= NET_DIR_MAXCANDIDATES)
+						Sys_Error("NET_InitDirLookup: too many candidates");
+					netDirLookup.candidates[num++] = k;
+				}
+			}
+		}
+	}
+	netDirLookup.cellStart[cell] = num;
+	netDirLookup.initialized = qtrue;
+}
+
+/**
+ * @brief Quantises a direction to the index of the closest bytedirs entry
+ * @note Gives the same results as comparing the direction against all the bytedirs
+ */
+static byte NET_DirToByte (const vec3_t dir)
+{
+	const float ax = fabs(dir[0]), ay = fabs(dir[1]), az = fabs(dir[2]);
+	int axis, cell, i, best;
+	float major, bestd, cu, cv;
+	int iu, iv;
+
+	if (!netDirLookup.initialized)
+		NET_InitDirLookup();
+
+	if (ax >= ay && ax >= az)
+		axis = 0;
+	else if (ay >= az)
+		axis = 1;
+	else
+		axis = 2;
+
+	major = dir[axis];
+	/* null vector (or NaN) - no bytedir has a positive dot product with it */
+	if (!(fabs(major) > 0.0f))
+		return 0;
+
+	cu = (dir[(axis + 1) % 3] / fabs(major) + 1.0f) * NET_DIR_CELLS / 2;
+	cv = (dir[(axis + 2) % 3] / fabs(major) + 1.0f) * NET_DIR_CELLS / 2;
+	iu = cu > 0.0f ? (cu < NET_DIR_CELLS ? (int)cu : NET_DIR_CELLS - 1) : 0;
+	iv = cv > 0.0f ? (cv < NET_DIR_CELLS ? (int)cv : NET_DIR_CELLS - 1) : 0;
+	cell = ((axis * 2 + (major < 0.0f)) * NET_DIR_CELLS + iu) * NET_DIR_CELLS + iv;
+
+	bestd = 0;
+	best = 0;
+	for (i = netDirLookup.cellStart[cell]; i < netDirLookup.cellStart[cell + 1]; i++) {
+		const int index = netDirLookup.candidates[i];
+		const float d = DotProduct(dir, bytedirs[index]);
+		if (d > bestd) {
+			bestd = d;
+			best = index;
+		}
+	}
+	return best;
+}
+
+static inline byte *NET_PutShort (byte *p, int c)
+{
+	const unsigned short v = LittleShort(c);
+	memcpy(p, &v, 2);
+	return p + 2;
+}
+
+static inline byte *NET_PutLong (byte *p, int c)
+{
+	const int v = LittleLong(c);
+	memcpy(p, &v, 4);
+	return p + 4;
+}
+
+static inline int NET_GetShort (const byte *p)
+{
+	unsigned short v;
+	memcpy(&v, p, 2);
+	return LittleShort(v);
+}
+
+static inline int NET_GetLong (const byte *p)
+{
+	unsigned int v;
+	memcpy(&v, p, 4);
+	return LittleLong(v);
+}
+
+static inline byte NET_AngleToByte (float f)
+{
+	return (int) (f * 256 / 360) & 255;
+}
+
 void NET_WriteChar (struct dbuffer *buf, char c)
 {
 	dbuffer_add(buf, &c, 1);
@@ -104,7 +264,7 @@ void NET_WriteGPos (struct dbuffer *buf, const pos3_t pos)
 
 void NET_WriteAngle (struct dbuffer *buf, float f)
 {
-	NET_WriteByte(buf, (int) (f * 256 / 360) & 255);
+	NET_WriteByte(buf, NET_AngleToByte(f));
 }
 
 void NET_WriteAngle16 (struct dbuffer *buf, float f)
@@ -118,26 +278,7 @@ void NET_WriteAngle16 (struct dbuffer *buf, float f)
  */
 void NET_WriteDir (struct dbuffer *buf, const vec3_t dir)
 {
-	int i, best;
-	float bestd;
-	size_t bytedirsLength;
-
-	if (!dir) {
-		NET_WriteByte(buf, 0);
-		return;
-	}
-
-	bestd = 0;
-	best = 0;
-	bytedirsLength = lengthof(bytedirs);
-	for (i = 0; i < bytedirsLength; i++) {
-		const float d = DotProduct(dir, bytedirs[i]);
-		if (d > bestd) {
-			bestd = d;
-			best = i;
-		}
-	}
-	NET_WriteByte(buf, best);
+	NET_WriteByte(buf, dir ? NET_DirToByte(dir) : 0);
 }
 
 
@@ -145,69 +286,88 @@ void NET_WriteDir (struct dbuffer *buf, const vec3_t dir)
  * @brief Writes to buffer according to format; version without syntactic sugar
  * for variable arguments, to call it from other functions with variable arguments
  * @note short and char are promoted to int when passed to variadic functions!
+ * @note The fields are encoded into a span on the stack that is added to the
+ * buffer at once - only strings and byte arrays are added directly.
  */
 void NET_vWriteFormat (struct dbuffer *buf, const char *format, va_list ap)
 {
-	char typeID;
+	byte span[NET_FORMAT_SPAN];
+	byte *p = span;
+
+	Com_DPrintf(DEBUG_EVENTSYS, "format event data: %s\n", format);
 
 	while (*format) {
-		typeID = *format++;
+		const char typeID = *format++;
+
+		if (p + NET_FORMAT_MAXFIELD > span + sizeof(span)) {
+			dbuffer_add(buf, (const char *)span, p - span);
+			p = span;
+		}
 
 		switch (typeID) {
 		case 'c':
-			NET_WriteChar(buf, va_arg(ap, int));
-
+			*p++ = (char)va_arg(ap, int);
 			break;
 		case 'b':
-			NET_WriteByte(buf, va_arg(ap, int));
-
+			*p++ = (byte)va_arg(ap, int);
 			break;
 		case 's':
-			NET_WriteShort(buf, va_arg(ap, int));
-
+			p = NET_PutShort(p, va_arg(ap, int));
 			break;
 		case 'l':
-			NET_WriteLong(buf, va_arg(ap, int));
-
+			p = NET_PutLong(p, va_arg(ap, int));
 			break;
 		case 'p':
-			NET_WritePos(buf, va_arg(ap, float *));
-
+			{
+				const float *pos = va_arg(ap, float *);
+				p = NET_PutLong(p, (long) (pos[0] * 32.));
+				p = NET_PutLong(p, (long) (pos[1] * 32.));
+				p = NET_PutLong(p, (long) (pos[2] * 32.));
+			}
 			break;
 		case 'g':
-			NET_WriteGPos(buf, va_arg(ap, byte *));
+			{
+				const byte *pos = va_arg(ap, byte *);
+				*p++ = pos[0];
+				*p++ = pos[1];
+				*p++ = pos[2];
+			}
 			break;
 		case 'd':
-			NET_WriteDir(buf, va_arg(ap, float *));
-
+			{
+				const float *dir = va_arg(ap, float *);
+				*p++ = dir ? NET_DirToByte(dir) : 0;
+			}
 			break;
 		case 'a':
 			/* NOTE: float is promoted to double through ... */
-			NET_WriteAngle(buf, va_arg(ap, double));
-
+			*p++ = NET_AngleToByte(va_arg(ap, double));
 			break;
 		case '!':
 			break;
 		case '&':
+			dbuffer_add(buf, (const char *)span, p - span);
+			p = span;
 			NET_WriteString(buf, va_arg(ap, char *));
 			break;
 		case '*':
 			{
-				int i, n;
-				byte *p;
-
-				n = va_arg(ap, int);
-
-				p = va_arg(ap, byte *);
-				NET_WriteShort(buf, n);
-				for (i = 0; i < n; i++)
-					NET_WriteByte(buf, *p++);
+				const int n = va_arg(ap, int);
+				const byte *data = va_arg(ap, byte *);
+
+				p = NET_PutShort(p, n);
+				dbuffer_add(buf, (const char *)span, p - span);
+				p = span;
+				if (n > 0)
+					dbuffer_add(buf, (const char *)data, n);
 			}
 			break;
 		default:
 			Com_Error(ERR_DROP, "WriteFormat: Unknown type!");
 		}
 	}
+
+	dbuffer_add(buf, (const char *)span, p - span);
 	/* Too many arguments for the given format; too few cause crash above */
 /*	if (!ap)
 		Com_Error(ERR_DROP, "WriteFormat: Too many arguments!");*/
@@ -392,10 +552,15 @@ float NET_ReadAngle16 (struct dbuffer *buf)
 
 void NET_ReadData (struct dbuffer *buf, void *data, int len)
 {
-	int i;
+	size_t read;
+
+	if (len <= 0)
+		return;
 
-	for (i = 0; i < len; i++)
-		((byte *) data)[i] = NET_ReadByte(buf);
+	read = dbuffer_extract(buf, (char *)data, len);
+	/* the missing bytes are filled like NET_ReadByte reports them */
+	if (read < len)
+		memset((byte *)data + read, 0xFF, len - read);
 }
 
 void NET_ReadDir (struct dbuffer *buf, vec3_t dir)
@@ -407,8 +572,56 @@ void NET_ReadDir (struct dbuffer *buf, vec3_t dir)
 }
 
 
+/**
+ * @brief Counts the bytes of the fixed size fields at the start of a read format string
+ * @param[in] format The format string
+ * @param[out] length The number of format characters that are covered
+ * @return The number of bytes these fields need in the buffer
+ */
+static size_t NET_ReadFormatFixedSize (const char *format, int *length)
+{
+	const char *start = format;
+	size_t size = 0;
+
+	for (;; format++) {
+		switch (*format) {
+		case 'c':
+		case 'b':
+		case 'd':
+		case 'a':
+			size += 1;
+			continue;
+		case 's':
+			size += 2;
+			continue;
+		case 'l':
+			size += 4;
+			continue;
+		case 'g':
+			size += 3;
+			continue;
+		case 'p':
+			size += 12;
+			continue;
+		case '!':
+			/* the next field is skipped */
+			if (format[1] == '\0')
+				break;
+			format++;
+			continue;
+		}
+		break;
+	}
+
+	*length = format - start;
+	return size;
+}
+
 /**
  * @brief Reads from a buffer according to format; version without syntactic sugar for variable arguments, to call it from other functions with variable arguments
+ * @note Runs of fixed size fields are decoded in place if they are stored contiguously in
+ * the buffer - the field by field reading is only needed at the borders of the buffer elements
+ * or if the buffer holds less data than the format needs.
  * @sa SV_ReadFormat
  * @param[in] buf The buffer we read the data from
  * @param[in] format The format string may not be NULL
@@ -416,8 +629,70 @@ void NET_ReadDir (struct dbuffer *buf, vec3_t dir)
 void NET_vReadFormat (struct dbuffer *buf, const char *format, va_list ap)
 {
 	while (*format) {
-		const char typeID = *format++;
+		int length;
+		const size_t size = NET_ReadFormatFixedSize(format, &length);
+		const byte *p = size ? (const byte *)dbuffer_peek(buf, size) : NULL;
+		char typeID;
+
+		if (p) {
+			const char *end = format + length;
+
+			for (; format < end; format++) {
+				switch (*format) {
+				case 'c':
+					*va_arg(ap, int *) = (char)*p++;
+					break;
+				case 'b':
+					*va_arg(ap, int *) = *p++;
+					break;
+				case 's':
+					*va_arg(ap, int *) = NET_GetShort(p);
+					p += 2;
+					break;
+				case 'l':
+					*va_arg(ap, int *) = NET_GetLong(p);
+					p += 4;
+					break;
+				case 'p':
+					{
+						float *pos = *va_arg(ap, vec3_t *);
+						pos[0] = NET_GetLong(p) / 32.;
+						pos[1] = NET_GetLong(p + 4) / 32.;
+						pos[2] = NET_GetLong(p + 8) / 32.;
+						p += 12;
+					}
+					break;
+				case 'g':
+					{
+						byte *pos = *va_arg(ap, pos3_t *);
+						pos[0] = p[0];
+						pos[1] = p[1];
+						pos[2] = p[2];
+						p += 3;
+					}
+					break;
+				case 'd':
+					{
+						float *dir = *va_arg(ap, vec3_t *);
+						if (*p >= lengthof(bytedirs))
+							Com_Error(ERR_DROP, "NET_ReadDir: out of range");
+						VectorCopy(bytedirs[*p], dir);
+						p++;
+					}
+					break;
+				case 'a':
+					*va_arg(ap, float *) = (float) (char)*p++ * (360.0 / 256);
+					break;
+				case '!':
+					format++;
+					break;
+				}
+			}
+			dbuffer_remove(buf, size);
+			continue;
+		}
 
+		typeID = *format++;
 		switch (typeID) {
 		case 'c':
 			*va_arg(ap, int *) = NET_ReadChar(buf);
@@ -454,15 +729,10 @@ void NET_vReadFormat (struct dbuffer *buf, const char *format, va_list ap)
 		}
 		case '*':
 			{
-				int i;
-				byte *p;
 				const int n = NET_ReadShort(buf);
 
 				*va_arg(ap, int *) = n;
-				p = va_arg(ap, byte *);
-
-				for (i = 0; i < n; i++)
-					*p++ = NET_ReadByte(buf);
+				NET_ReadData(buf, va_arg(ap, byte *), n);
 			}
 			break;
 		default:
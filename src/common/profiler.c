@@ -0,0 +1,321 @@
+/**
+ * @file profiler.c
+ * @brief Timing zones and counters for the hot paths of the engine
+ * @note The zones can be nested and used from several threads at once. Every thread keeps its own
+ * stack of open zones, the statistics themselves are only updated with atomic operations.
+ * @sa perf_dump
+ */
+
+/*
+Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "common.h"
+#include "profiler.h"
+#include "../ports/system.h"
+#include <SDL_thread.h>
+
+#ifdef PROF_ENABLED
+
+#ifndef __GNUC__
+#error "The profiler needs the atomic builtins of gcc"
+#endif
+
+#define PROF_THREADLOCAL __thread
+#define Prof_AtomicAdd(var, value) ((void)__sync_fetch_and_add(&(var), (value)))
+#define Prof_AtomicGet(var) __sync_fetch_and_add(&(var), 0)
+
+/** the maximum nesting depth of the zones - deeper zones are not measured */
+#define PROF_MAX_DEPTH 32
+/** the size of the ring buffer for the trace events */
+#define PROF_MAX_EVENTS 65536
+
+static const char *const profZoneNames[] = {
+	"SV_Frame",
+	"G_RunFrame",
+	"AI_Run",
+	"Grid_MoveCalc",
+	"SV_Multicast",
+	"FS_OpenFile",
+	"Mem_PoolAlloc",
+	"R_RenderFrame"
+};
+CASSERT(lengthof(profZoneNames) == PROF_MAX_ZONES);
+
+static const char *const profCounterNames[] = {
+	"mem_bytes",
+	"multicast_bytes",
+	"pathing_nodes"
+};
+CASSERT(lengthof(profCounterNames) == PROF_MAX_COUNTERS);
+
+/** @note all times are given in nanoseconds */
+typedef struct profZoneStats_s {
+	uint64_t calls;
+	uint64_t time;			/**< including the time of the nested zones */
+	uint64_t selfTime;		/**< without the time of the nested zones */
+	uint64_t maxCall;
+	uint64_t frameStart;	/**< value of @c time at the last frame boundary */
+	uint64_t maxFrame;
+} profZoneStats_t;
+
+typedef struct profCounterStats_s {
+	uint64_t value;
+	uint64_t frameStart;	/**< value of @c value at the last frame boundary */
+	uint64_t maxFrame;
+} profCounterStats_t;
+
+/** @brief An open zone of the current thread */
+typedef struct profStackEntry_s {
+	profZone_t zone;
+	uint64_t start;
+	uint64_t children;		/**< time spent in the nested zones */
+} profStackEntry_t;
+
+/** @brief A finished zone for the chrome trace */
+typedef struct profEvent_s {
+	profZone_t zone;
+	unsigned int thread;
+	uint64_t start;
+	uint64_t duration;
+} profEvent_t;
+
+static profZoneStats_t profZones[PROF_MAX_ZONES];
+static profCounterStats_t profCounters[PROF_MAX_COUNTERS];
+static int profFrames;
+static uint64_t profStartTime;
+
+static profEvent_t profEvents[PROF_MAX_EVENTS];
+static unsigned int profNumEvents;
+static qboolean profTrace;
+static cvar_t *prof_trace;
+
+static PROF_THREADLOCAL profStackEntry_t profStack[PROF_MAX_DEPTH];
+static PROF_THREADLOCAL int profDepth;
+
+static void Prof_AtomicMax (uint64_t *var, uint64_t value)
+{
+	uint64_t old;
+
+	while ((old = *var) < value)
+		if (__sync_bool_compare_and_swap(var, old, value))
+			break;
+}
+
+/**
+ * @brief Opens a zone on the current thread
+ * @note Use the @c PROF_BEGIN macro - it compiles to nothing if the profiler is disabled
+ * @sa Prof_End
+ */
+void Prof_Begin (profZone_t zone)
+{
+	profStackEntry_t *entry;
+
+	/* only keep the balance for zones that are nested too deep */
+	if (profDepth++ >= PROF_MAX_DEPTH)
+		return;
+
+	entry = &profStack[profDepth - 1];
+	entry->zone = zone;
+	entry->children = 0;
+	entry->start = Sys_Nanoseconds();
+}
+
+/**
+ * @brief Closes the innermost zone of the current thread and adds its time to the statistics
+ * @sa Prof_Begin
+ */
+void Prof_End (profZone_t zone)
+{
+	const uint64_t end = Sys_Nanoseconds();
+	profZoneStats_t *stats = &profZones[zone];
+	const profStackEntry_t *entry;
+	uint64_t duration;
+
+	if (profDepth <= 0)
+		return;
+
+	if (--profDepth >= PROF_MAX_DEPTH)
+		return;
+
+	/* zones that were left by an error (longjmp) are dropped */
+	while (profDepth > 0 && profStack[profDepth].zone != zone)
+		profDepth--;
+
+	entry = &profStack[profDepth];
+	if (entry->zone != zone)
+		return;
+
+	duration = end - entry->start;
+	if (profDepth > 0)
+		profStack[profDepth - 1].children += duration;
+
+	Prof_AtomicAdd(stats->calls, 1);
+	Prof_AtomicAdd(stats->time, duration);
+	Prof_AtomicAdd(stats->selfTime, duration - entry->children);
+	Prof_AtomicMax(&stats->maxCall, duration);
+
+	if (profTrace) {
+		profEvent_t *event = &profEvents[__sync_fetch_and_add(&profNumEvents, 1) % PROF_MAX_EVENTS];
+		event->zone = zone;
+		event->thread = SDL_ThreadID();
+		event->start = entry->start;
+		event->duration = duration;
+	}
+}
+
+/**
+ * @note Use the @c PROF_COUNT macro - it compiles to nothing if the profiler is disabled
+ */
+void Prof_Count (profCounter_t counter, int value)
+{
+	Prof_AtomicAdd(profCounters[counter].value, value);
+}
+
+/**
+ * @brief Closes the statistics of the current frame
+ * @note A frame for the statistics is one iteration of the main loop
+ * @sa Qcommon_Frame
+ */
+void Prof_Frame (void)
+{
+	int i;
+
+	/* we are called from the main loop - nothing can be open here unless an error dropped it */
+	profDepth = 0;
+	profTrace = prof_trace->integer;
+
+	for (i = 0; i < PROF_MAX_ZONES; i++) {
+		profZoneStats_t *stats = &profZones[i];
+		const uint64_t time = Prof_AtomicGet(stats->time);
+
+		stats->maxFrame = max(stats->maxFrame, time - stats->frameStart);
+		stats->frameStart = time;
+	}
+
+	for (i = 0; i < PROF_MAX_COUNTERS; i++) {
+		profCounterStats_t *stats = &profCounters[i];
+		const uint64_t value = Prof_AtomicGet(stats->value);
+
+		stats->maxFrame = max(stats->maxFrame, value - stats->frameStart);
+		stats->frameStart = value;
+	}
+
+	profFrames++;
+}
+
+static void Prof_Reset (void)
+{
+	OBJZERO(profZones);
+	OBJZERO(profCounters);
+	profFrames = 0;
+	profNumEvents = 0;
+	profStartTime = Sys_Nanoseconds();
+}
+
+/**
+ * @brief Writes the recorded events in the trace event format of chrome://tracing
+ * @param[in] filename The file name relative to the gamedir
+ */
+static void Prof_WriteTrace (const char *filename)
+{
+	const qboolean trace = profTrace;
+	const unsigned int count = profNumEvents;
+	const unsigned int num = min(count, PROF_MAX_EVENTS);
+	unsigned int i;
+	qFILE f;
+
+	if (!num) {
+		Com_Printf("No trace events were recorded - set prof_trace to 1 first\n");
+		return;
+	}
+
+	/* writing the file would add its own events */
+	profTrace = qfalse;
+
+	FS_OpenFile(filename, &f, FILE_WRITE);
+	if (!f.f) {
+		Com_Printf("Could not open %s for writing\n", filename);
+		profTrace = trace;
+		return;
+	}
+
+	FS_Printf(&f, "{\"traceEvents\": [\n");
+	for (i = 0; i < num; i++) {
+		const profEvent_t *event = &profEvents[(count - num + i) % PROF_MAX_EVENTS];
+		const int64_t start = (int64_t)(event->start - profStartTime);
+		FS_Printf(&f, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}\n",
+				i ? "," : "", profZoneNames[event->zone], event->thread, start / 1000.0, event->duration / 1000.0);
+	}
+	FS_Printf(&f, "]}\n");
+	FS_CloseFile(&f);
+
+	Com_Printf("Wrote %u trace events to %s/%s\n", num, FS_Gamedir(), filename);
+	profTrace = trace;
+}
+
+/**
+ * @brief Prints the statistics since the last dump and starts a new measurement
+ */
+static void Prof_Dump_f (void)
+{
+	const double seconds = (Sys_Nanoseconds() - profStartTime) / 1000000000.0;
+	const int frames = max(profFrames, 1);
+	int i;
+
+	if (Cmd_Argc() > 2) {
+		Com_Printf("Usage: %s [<tracefile>]\n", Cmd_Argv(0));
+		return;
+	}
+
+	Com_Printf("Profile of %i frames in %.1fs:\n", profFrames, seconds);
+	Com_Printf("zone            calls/frame   ms/frame  self ms/frame  max ms/frame  max ms/call\n");
+	Com_Printf("--------------- ----------- ---------- -------------- ------------- ------------\n");
+	for (i = 0; i < PROF_MAX_ZONES; i++) {
+		const profZoneStats_t *stats = &profZones[i];
+		Com_Printf("%-15s %11.1f %10.3f %14.3f %13.3f %12.3f\n", profZoneNames[i],
+				(double)stats->calls / frames, stats->time / 1000000.0 / frames,
+				stats->selfTime / 1000000.0 / frames, stats->maxFrame / 1000000.0, stats->maxCall / 1000000.0);
+	}
+
+	Com_Printf("\ncounter                 per frame  max per frame\n");
+	Com_Printf("--------------- ----------------- --------------\n");
+	for (i = 0; i < PROF_MAX_COUNTERS; i++) {
+		const profCounterStats_t *stats = &profCounters[i];
+		Com_Printf("%-15s %17.1f %14.0f\n", profCounterNames[i], (double)stats->value / frames, (double)stats->maxFrame);
+	}
+
+	if (Cmd_Argc() == 2)
+		Prof_WriteTrace(Cmd_Argv(1));
+
+	Prof_Reset();
+}
+
+/**
+ * @sa Qcommon_Init
+ */
+void Prof_Init (void)
+{
+	prof_trace = Cvar_Get("prof_trace", "0", 0, "Record the profiling zones for the trace file of perf_dump");
+	Cmd_AddCommand("perf_dump", Prof_Dump_f, "Prints the profiling statistics per frame and optionally writes a chrome trace file");
+
+	Prof_Reset();
+}
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file profiler.h
+ * @brief Timing zones and counters for the hot paths of the engine
+ * @note Only compiled in with @c --enable-profiler - otherwise all the macros expand to nothing
+ * and release builds don't pay anything for the instrumentation.
+ */
+
+/*
+Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _COMMON_PROFILER_H
+#define _COMMON_PROFILER_H
+
+#include "../shared/shared.h"
+
+/**
+ * @brief The instrumented code paths
+ * @note Keep this in sync with the names in profiler.c
+ */
+typedef enum {
+	PROF_SV_FRAME,
+	PROF_G_RUNFRAME,
+	PROF_AI_RUN,
+	PROF_GRID_MOVECALC,
+	PROF_SV_MULTICAST,
+	PROF_FS_OPENFILE,
+	PROF_MEM_ALLOC,
+	PROF_R_RENDERFRAME,
+
+	PROF_MAX_ZONES
+} profZone_t;
+
+/**
+ * @brief Named counters that are summed up per frame
+ * @note Keep this in sync with the names in profiler.c
+ */
+typedef enum {
+	PROF_COUNTER_MEM_BYTES,			/**< bytes allocated by Mem_PoolAlloc */
+	PROF_COUNTER_MULTICAST_BYTES,	/**< bytes queued for the clients by SV_Multicast */
+	PROF_COUNTER_PATHING_NODES,		/**< grid cells expanded by Grid_MoveCalc */
+
+	PROF_MAX_COUNTERS
+} profCounter_t;
+
+/* the tools share some of the instrumented files but don't link the profiler */
+#if defined(PROFILER) && defined(COMPILE_UFO)
+#define PROF_ENABLED
+
+#ifdef GAME_INCLUDE
+/* the game library reaches the profiler of the engine via the game import functions - they are
+ * not set if the engine was built without the profiler */
+#define PROF_BEGIN(zone)			(gi.ProfBegin ? gi.ProfBegin(zone) : (void)0)
+#define PROF_END(zone)				(gi.ProfEnd ? gi.ProfEnd(zone) : (void)0)
+#define PROF_COUNT(counter, value)	(gi.ProfCount ? gi.ProfCount((counter), (value)) : (void)0)
+#else
+#define PROF_BEGIN(zone)			Prof_Begin(zone)
+#define PROF_END(zone)				Prof_End(zone)
+#define PROF_COUNT(counter, value)	Prof_Count((counter), (value))
+#endif
+
+void Prof_Init(void);
+void Prof_Begin(profZone_t zone);
+void Prof_End(profZone_t zone);
+void Prof_Count(profCounter_t counter, int value);
+void Prof_Frame(void);
+
+#else
+
+#define PROF_BEGIN(zone)			((void)0)
+#define PROF_END(zone)				((void)0)
+#define PROF_COUNT(counter, value)	((void)0)
+
+#endif
+
+#endif
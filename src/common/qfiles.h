@@ -35,6 +35,30 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define IDMDXHEADER "UFOMDX"
 #define MDX_VERSION		1
 
+/*========================================================================
+.AMC alias mesh cache file format - generated by ufomodel
+========================================================================*/
+
+#define IDAMCHEADER		(('C'<<24)+('M'<<16)+('A'<<8)+'U')
+#define AMC_VERSION		1
+
+/**
+ * @brief The vertex merging of R_ModCalcUniqueNormalsAndTangents for all meshes of a md2 or md3
+ * file. Every mesh is stored as @c dAMCMesh_t followed by @c numIndexes merged vertex indices of the
+ * triangles and @c numVerts indices of the vertices of the model file the merged vertices are taken from.
+ */
+typedef struct dAMCHeader_s {
+	int32_t ident;
+	int32_t version;
+	uint32_t checksum;		/**< checksum of the model file - the cache is ignored if the model changed */
+	int32_t numMeshes;
+} dAMCHeader_t;
+
+typedef struct dAMCMesh_s {
+	int32_t numVerts;		/**< the amount of vertices after merging */
+	int32_t numIndexes;
+} dAMCMesh_t;
+
 /*========================================================================
 .MD2 triangle model file format
 ========================================================================*/
@@ -370,7 +394,10 @@ typedef struct dpmvertex_s {
 /** little-endian "IBSP" */
 #define IDBSPHEADER	(('P'<<24)+('S'<<16)+('B'<<8)+'I')
 
-#define BSPVERSION	78
+#define BSPVERSION	79
+/** @brief The last version with the byte oriented run length encoding of the routing lump - such maps can still be loaded */
+#define BSPVERSION_OLDROUTING	78
+#define BSP_IsSupportedVersion(version) ((version) == BSPVERSION || (version) == BSPVERSION_OLDROUTING)
 
 /** @brief Directory of the different data blocks */
 typedef struct {
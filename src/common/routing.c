@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "common.h"
 #include "routing.h"
+#include "qfiles.h"
 
 /*
 ===============================================================================
@@ -332,6 +333,144 @@ void RT_GetMapSize (mapTiles_t *mapTiles, vec3_t map_min, vec3_t map_max)
 }
 
 
+/*
+===============================================================================
+ROUTING LUMP ENCODING
+===============================================================================
+*/
+
+/** @brief Token header flag: the token is a run of one repeated byte, otherwise the bytes follow literally */
+#define RT_TOKEN_RUN	0x80
+/** @brief Token header flag: more bytes with seven further bits of the count follow */
+#define RT_TOKEN_MORE	0x40
+/** @brief Shorter runs don't save anything, they are stored as a part of the literal */
+#define RT_MIN_RUN		4
+
+/**
+ * @brief Writes the header of a token - the lower six bits of the count are stored in the
+ * header itself, the rest follows seven bits per byte
+ */
+static byte *RT_PutToken (byte *dest, byte type, int count)
+{
+	*dest++ = type | (count & 0x3F) | (count > 0x3F ? RT_TOKEN_MORE : 0);
+	for (count >>= 6; count; count >>= 7)
+		*dest++ = (count & 0x7F) | (count > 0x7F ? 0x80 : 0);
+	return dest;
+}
+
+/**
+ * @brief Compresses routing data in the format of the routing lump
+ * @note Unlike the byte oriented encoding of @c BSPVERSION_OLDROUTING the runs and literals
+ * are not limited in their length, so the decoder gets along with a few big memset and
+ * memcpy calls for the mostly empty routing table.
+ * @param[in] data The data to compress
+ * @param[out] dest The buffer for the compressed data - must be able to hold
+ * @c RT_COMPRESSED_MAXLENGTH(length) bytes
+ * @param[in] length The length of @c data
+ * @return The end of the compressed data - the block is terminated by a zero byte
+ * @sa RT_DeCompressRouting
+ */
+byte *RT_CompressRouting (const byte *data, byte *dest, int length)
+{
+	const byte *end = data + length;
+	const byte *literal = data;
+
+	while (data < end) {
+		const byte *run = data + 1;
+		while (run < end && *run == *data)
+			run++;
+
+		if (run - data >= RT_MIN_RUN) {
+			if (data > literal) {
+				dest = RT_PutToken(dest, 0, data - literal);
+				memcpy(dest, literal, data - literal);
+				dest += data - literal;
+			}
+			dest = RT_PutToken(dest, RT_TOKEN_RUN, run - data);
+			*dest++ = *data;
+			literal = run;
+		}
+		data = run;
+	}
+
+	if (end > literal) {
+		dest = RT_PutToken(dest, 0, end - literal);
+		memcpy(dest, literal, end - literal);
+		dest += end - literal;
+	}
+
+	/* terminate the block */
+	*dest++ = 0;
+
+	return dest;
+}
+
+/**
+ * @brief Decompresses one block of the routing lump
+ * @note Doesn't call Com_Error - so it can be used by the loader threads
+ * @param[in,out] source The compressed data - set to the end of the block
+ * @param[in] end The end of the compressed data - nothing beyond it is read
+ * @param[out] dest Where to place the uncompressed data - may be @c NULL to only
+ * calculate the uncompressed length
+ * @param[in] length The size of @c dest
+ * @param[in] bspVersion The version of the bsp file the data comes from, @c BSPVERSION_OLDROUTING
+ * maps use the byte oriented run length encoding
+ * @return The uncompressed length or @c -1 if the data is broken or doesn't fit into @c dest
+ * @sa RT_CompressRouting
+ */
+int RT_DeCompressRouting (const byte **source, const byte *end, byte *dest, int length, int bspVersion)
+{
+	const byte *src = *source;
+	int written = 0;
+
+	while (src < end && *src) {
+		const byte header = *src++;
+		int count;
+
+		if (bspVersion == BSPVERSION_OLDROUTING) {
+			/* the amount of equal bytes of a run is c + 2 */
+			count = (header & ~RT_TOKEN_RUN) + ((header & RT_TOKEN_RUN) ? 2 : 0);
+		} else {
+			count = header & 0x3F;
+			if (header & RT_TOKEN_MORE) {
+				int shift = 6;
+				byte more;
+				do {
+					if (src >= end || shift > 20)
+						return -1;
+					more = *src++;
+					count |= (more & 0x7F) << shift;
+					shift += 7;
+				} while (more & 0x80);
+			}
+		}
+
+		if (count > length - written)
+			return -1;
+
+		if (header & RT_TOKEN_RUN) {
+			if (src >= end)
+				return -1;
+			if (dest)
+				memset(dest + written, *src, count);
+			src++;
+		} else {
+			if (count > end - src)
+				return -1;
+			if (dest)
+				memcpy(dest + written, src, count);
+			src += count;
+		}
+		written += count;
+	}
+
+	if (src >= end)
+		return -1;
+
+	*source = src + 1;
+	return written;
+}
+
 /*
 ===============================================================================
 NEW MAP TRACING FUNCTIONS
@@ -155,6 +155,11 @@ void RT_UpdateConnectionColumn(mapTiles_t *mapTiles, routing_t * map, const int
 qboolean RT_AllCellsBelowAreFilled(const routing_t * map, const int actorSize, const pos3_t pos);
 void RT_GetMapSize(mapTiles_t *mapTiles, vec3_t map_min, vec3_t map_max);
 
+/** @brief The max. size of @c length bytes of routing data after RT_CompressRouting */
+#define RT_COMPRESSED_MAXLENGTH(length) ((length) + (length) / 64 + 8)
+byte *RT_CompressRouting(const byte *data, byte *dest, int length);
+int RT_DeCompressRouting(const byte **source, const byte *end, byte *dest, int length, int bspVersion);
+
 
 /*
 ==========================================================
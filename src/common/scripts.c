@@ -1810,6 +1810,9 @@ static void Com_ParseItem (const char *name, const char **text)
 		return;
 	}
 
+	if (!IDT_Add(&csi.odsByID, od->id, od))
+		Com_Printf("Com_ParseItem: could not add \"%s\" to the lookup table\n", name);
+
 	do {
 		token = Com_EParse(text, errhead, name);
 		if (!*text)
@@ -1870,6 +1873,9 @@ static void Com_ParseItem (const char *name, const char **text)
 			break;
 	od->sy = i + 1;
 
+	/* the inventory code needs the rotated shape all the time */
+	od->shapeRotated = INVSH_ShapeRotate(od->shape);
+
 	if (od->thrown && od->deplete && od->oneshot && od->ammo) {
 		Sys_Error("Item %s has invalid parameters\n", od->id);
 	}
@@ -1937,6 +1943,8 @@ static void Com_ParseInventory (const char *name, const char **text)
 
 	csi.numIDs++;
 	Q_strncpyz(id->name, name, sizeof(id->name));
+	if (!IDT_Add(&csi.idsByName, id->name, id))
+		Com_Printf("Com_ParseInventory: could not add \"%s\" to the lookup table\n", name);
 
 	/* Special IDs for container. These are also used elsewhere, so be careful. */
 	if (Q_streq(name, "right")) {
@@ -2217,14 +2225,10 @@ const char* Com_GetActorSound (teamDef_t* td, int gender, actorSound_t soundType
  */
 const teamDef_t* Com_GetTeamDefinitionByID (const char *team)
 {
-	int i;
-
 	/* get team definition */
-	for (i = 0; i < csi.numTeamDefs; i++) {
-		const teamDef_t *t = &csi.teamDef[i];
-		if (Q_streq(team, t->id))
-			return t;
-	}
+	const teamDef_t *t = (const teamDef_t *)IDT_Get(&csi.teamDefByID, team);
+	if (t != NULL)
+		return t;
 
 	Com_Printf("Com_GetTeamDefinitionByID: could not find team definition for '%s' in team definitions\n", team);
 	return NULL;
@@ -2573,6 +2577,9 @@ static void Com_ParseTeam (const char *name, const char **text)
 		return;
 	}
 
+	if (!IDT_Add(&csi.teamDefByID, td->id, td))
+		Com_Printf("Com_ParseTeam: could not add \"%s\" to the lookup table\n", name);
+
 	do {
 		/* get the name type */
 		token = Com_EParse(text, errhead, name);
@@ -2645,12 +2652,10 @@ static void Com_ParseTeam (const char *name, const char **text)
  */
 const chrTemplate_t* Com_GetCharacterTemplateByID (const char *chrTemplate)
 {
-	int i;
-
 	/* get character template */
-	for (i = 0; i < csi.numChrTemplates; i++)
-		if (Q_streq(chrTemplate, csi.chrTemplates[i].id))
-			return &csi.chrTemplates[i];
+	const chrTemplate_t *ct = (const chrTemplate_t *)IDT_Get(&csi.chrTemplatesByID, chrTemplate);
+	if (ct != NULL)
+		return ct;
 
 	Com_Printf("Com_GetCharacterTemplateByID: could not find character template: '%s'\n", chrTemplate);
 	return NULL;
@@ -2695,6 +2700,8 @@ static void Com_ParseUGVs (const char *name, const char **text)
 		ugv->id = Mem_PoolStrDup(name, com_genericPool, 0);
 		ugv->idx = csi.numUGV;
 		csi.numUGV++;
+		if (!IDT_Add(&csi.ugvsByID, ugv->id, ugv))
+			Com_Printf("Com_ParseUGVs: could not add \"%s\" to the lookup table\n", name);
 	}
 }
 
@@ -2731,6 +2738,9 @@ static void Com_ParseCharacterTemplate (const char *name, const char **text)
 		return;
 	}
 
+	if (!IDT_Add(&csi.chrTemplatesByID, ct->id, ct))
+		Com_Printf("Com_ParseCharacterTemplate: could not add \"%s\" to the lookup table\n", name);
+
 	do {
 		token = Com_EParse(text, errhead, name);
 		if (!*text || *token == '}')
@@ -3082,17 +3092,9 @@ const char* Com_UFOCrashedTypeToShortName (ufoType_t type)
  */
 const ugv_t *Com_GetUGVByIDSilent (const char *ugvID)
 {
-	int i;
-
 	if (!ugvID)
 		return NULL;
-	for (i = 0; i < csi.numUGV; i++) {
-		const ugv_t *ugv = &csi.ugvs[i];
-		if (Q_streq(ugv->id, ugvID)) {
-			return ugv;
-		}
-	}
-	return NULL;
+	return (const ugv_t *)IDT_Get(&csi.ugvsByID, ugvID);
 }
 
 /**
@@ -3206,6 +3208,7 @@ static void Com_ParseMapDefinition (const char *name, const char **text)
 	const char *errhead = "Com_ParseMapDefinition: unexpected end of file (mapdef ";
 	mapDef_t *md;
 	const char *token;
+	qboolean valid = qtrue;
 
 	/* get it's body */
 	token = Com_Parse(text);
@@ -3241,18 +3244,26 @@ static void Com_ParseMapDefinition (const char *name, const char **text)
 
 	if (!md->map) {
 		Com_Printf("Com_ParseMapDefinition: mapdef \"%s\" with no map\n", name);
-		csi.numMDs--;
+		valid = qfalse;
 	}
 
 	if (!md->description) {
 		Com_Printf("Com_ParseMapDefinition: mapdef \"%s\" with no description\n", name);
-		csi.numMDs--;
+		valid = qfalse;
 	}
 
 	if (md->maxAliens <= 0) {
 		Com_Printf("Com_ParseMapDefinition: mapdef \"%s\" with invalid maxAlien value\n", name);
-		csi.numMDs--;
+		valid = qfalse;
 	}
+
+	if (valid && !IDT_Add(&csi.mdsByID, md->id, md)) {
+		Com_Printf("Com_ParseMapDefinition: could not add \"%s\" to the lookup table\n", name);
+		valid = qfalse;
+	}
+
+	if (!valid)
+		csi.numMDs--;
 }
 
 mapDef_t* Com_GetMapDefByIDX (int index)
@@ -3262,14 +3273,13 @@ mapDef_t* Com_GetMapDefByIDX (int index)
 
 mapDef_t* Com_GetMapDefinitionByID (const char *mapDefID)
 {
-	mapDef_t *md;;
+	mapDef_t *md;
 
 	assert(mapDefID);
 
-	MapDef_Foreach(md) {
-		if (Q_streq(md->id, mapDefID))
-			return md;
-	}
+	md = IDT_Get(&csi.mdsByID, mapDefID);
+	if (md != NULL)
+		return md;
 
 	Com_DPrintf(DEBUG_CLIENT, "Com_GetMapDefinition: Could not find mapdef with id: '%s'\n", mapDefID);
 	return NULL;
@@ -343,13 +343,14 @@ static inline int G_ActorGetTU (const edict_t *ent)
 void G_ActorGiveTimeUnits (edict_t *ent)
 {
 	const int tus = G_ActorGetTU(ent);
-	G_ActorSetTU(ent, tus);
 	G_RemoveDazed(ent);
+	G_ActorSetTU(ent, tus);
 }
 
 void G_ActorSetTU (edict_t *ent, int tus)
 {
 	ent->TU = max(tus, 0);
+	G_ReactionFireWatcherUpdate(ent);
 }
 
 void G_ActorUseTU (edict_t *ent, int tus)
@@ -454,6 +455,7 @@ static void G_ActorRevitalise (edict_t *ent)
 		G_GetFloorItems(ent);
 	}
 	G_ActorSetMaxs(ent);
+	G_ReactionFireWatcherUpdate(ent);
 
 	/* check if the player appears/perishes, seen from other teams */
 	G_CheckVis(ent, qtrue);
@@ -524,6 +526,8 @@ qboolean G_ActorDieOrStun (edict_t * ent, edict_t *attacker)
 	}
 
 	ent->solid = SOLID_NOT;
+	G_EdictsUpdateLists(ent);
+	G_ReactionFireWatcherUpdate(ent);
 
 	/* send death */
 	G_EventActorDie(ent);
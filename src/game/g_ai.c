@@ -1064,6 +1064,8 @@ void AI_Run (void)
 	if (level.framenum % 10)
 		return;
 
+	PROF_BEGIN(PROF_AI_RUN);
+
 	player = NULL;
 	while ((player = G_PlayerGetNextActiveAI(player))) {
 		/* set players to ai players and cycle over all of them */
@@ -1078,16 +1080,20 @@ void AI_Run (void)
 					else
 						AI_ActorThink(player, ent);
 					player->pers.last = ent;
-					return;
+					break;
 				}
 			}
 
 			/* nothing left to do, request endround */
-			G_ClientEndRound(player);
-			player->pers.last = NULL;
-			return;
+			if (!ent) {
+				G_ClientEndRound(player);
+				player->pers.last = NULL;
+			}
+			break;
 		}
 	}
+
+	PROF_END(PROF_AI_RUN);
 }
 
 /**
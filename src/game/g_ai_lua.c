@@ -95,6 +95,23 @@ static edict_t *AIL_ent; /**< Actor currently running the Lua AI. */
 static player_t *AIL_player; /**< Player currently running the Lua AI. */
 
 
+/*
+ * Lua states of the AI types.
+ */
+#define MAX_AI_TYPES 8
+
+/**
+ * @brief The lua state of an AI type with its compiled script. All actors of this type share it,
+ * the actor that is thinking is given to the think function.
+ */
+typedef struct aiType_s {
+	char type[MAX_QPATH];	/**< Lua file used by the AI. */
+	lua_State *L;
+} aiType_t;
+
+static aiType_t AIL_types[MAX_AI_TYPES];
+
+
 /*
  * Actor metatable.
  */
@@ -948,6 +965,88 @@ static int AIL_distance (lua_State *L)
 	return 1;
 }
 
+/**
+ * @brief Stops the think function once it has used up its instruction budget
+ * @sa ai_luabudget
+ */
+static void AIL_BudgetHook (lua_State *L, lua_Debug *ar)
+{
+	luaL_error(L, "instruction budget of %i exceeded", ai_luabudget->integer);
+}
+
+/**
+ * @brief Creates the lua state for an AI type and compiles its script
+ * @param[out] aiType The AI type to create the state for
+ * @param[in] type Type of AI (Lua file name without .lua).
+ * @return @c false if the script could not be loaded
+ */
+static qboolean AIL_InitType (aiType_t *aiType, const char *type)
+{
+	int size;
+	char path[MAX_VAR];
+	char *fbuf;
+	lua_State *L;
+
+	/* Create the new Lua state */
+	L = luaL_newstate();
+	if (L == NULL) {
+		gi.DPrintf("Unable to create Lua state.\n");
+		return qfalse;
+	}
+
+	/* Register metatables. */
+	actorL_register(L);
+	pos3L_register(L);
+
+	/* Register libraries. */
+	luaL_register(L, AI_METATABLE, AIL_methods);
+
+	/* Load the AI */
+	Com_sprintf(path, sizeof(path), "ai/%s.lua", type);
+	size = gi.FS_LoadFile(path, (byte **) &fbuf);
+	if (size <= 0) {
+		gi.DPrintf("Unable to load Lua file '%s'.\n", path);
+		lua_close(L);
+		return qfalse;
+	}
+	if (luaL_dobuffer(L, fbuf, size, path)) {
+		gi.DPrintf("Unable to parse Lua file '%s'\n", path);
+		gi.FS_FreeFile(fbuf);
+		lua_close(L);
+		return qfalse;
+	}
+	gi.FS_FreeFile(fbuf);
+
+	Q_strncpyz(aiType->type, type, sizeof(aiType->type));
+	aiType->L = L;
+
+	return qtrue;
+}
+
+/**
+ * @brief Returns the lua state of an AI type - the script is only loaded and compiled for the first actor of a type
+ * @param[in] type Type of AI (Lua file name without .lua).
+ * @return @c NULL if the script could not be loaded
+ */
+static lua_State *AIL_GetType (const char *type)
+{
+	int i;
+
+	for (i = 0; i < MAX_AI_TYPES; i++) {
+		aiType_t *aiType = &AIL_types[i];
+		if (aiType->L == NULL) {
+			if (!AIL_InitType(aiType, type))
+				return NULL;
+			return aiType->L;
+		}
+		if (Q_streq(aiType->type, type))
+			return aiType->L;
+	}
+
+	gi.DPrintf("Too many AI types - can't load '%s'.\n", type);
+	return NULL;
+}
+
 /**
  * @brief The think function for the ai controlled aliens
  * @param[in] player
@@ -960,6 +1059,7 @@ static int AIL_distance (lua_State *L)
 void AIL_ActorThink (player_t * player, edict_t * ent)
 {
 	lua_State *L;
+	aiActor_t actor;
 
 	/* The Lua State we will work with. */
 	L = ent->AI.L;
@@ -968,13 +1068,24 @@ void AIL_ActorThink (player_t * player, edict_t * ent)
 	AIL_ent = ent;
 	AIL_player = player;
 
+	/* the state is shared by all actors of this type - so tell the script who is thinking */
+	actor.ent = ent;
+
+	/* abort scripts that take too long */
+	if (ai_luabudget->integer > 0)
+		lua_sethook(L, AIL_BudgetHook, LUA_MASKCOUNT, ai_luabudget->integer);
+
 	/* Try to run the function. */
 	lua_getglobal(L, "think");
-	if (lua_pcall(L, 0, 0, 0)) { /* error has occured */
+	lua_pushactor(L, &actor);
+	if (lua_pcall(L, 1, 0, 0)) { /* error has occured */
 		gi.DPrintf("Error while running Lua: %s\n",
 			lua_isstring(L, -1) ? lua_tostring(L, -1) : "Unknown Error");
+		lua_pop(L, 1);
 	}
 
+	lua_sethook(L, NULL, 0, 0);
+
 	/* Cleanup */
 	AIL_ent = NULL;
 	AIL_player = NULL;
@@ -991,42 +1102,15 @@ void AIL_ActorThink (player_t * player, edict_t * ent)
 int AIL_InitActor (edict_t * ent, const char *type, const char *subtype)
 {
 	AI_t *AI;
-	int size;
-	char path[MAX_VAR];
-	char *fbuf;
 
 	/* Prepare the AI */
 	AI = &ent->AI;
 	Q_strncpyz(AI->type, type, sizeof(AI->type));
-	Q_strncpyz(AI->subtype, subtype, sizeof(AI->type));
+	Q_strncpyz(AI->subtype, subtype, sizeof(AI->subtype));
 
-	/* Create the new Lua state */
-	AI->L = luaL_newstate();
-	if (AI->L == NULL) {
-		gi.DPrintf("Unable to create Lua state.\n");
+	AI->L = AIL_GetType(type);
+	if (AI->L == NULL)
 		return -1;
-	}
-
-	/* Register metatables. */
-	actorL_register(AI->L);
-	pos3L_register(AI->L);
-
-	/* Register libraries. */
-	luaL_register(AI->L, AI_METATABLE, AIL_methods);
-
-	/* Load the AI */
-	Com_sprintf(path, sizeof(path), "ai/%s.lua", type);
-	size = gi.FS_LoadFile(path, (byte **) &fbuf);
-	if (size == 0) {
-		gi.DPrintf("Unable to load Lua file '%s'.\n", path);
-		return -1;
-	}
-	if (luaL_dobuffer(AI->L, fbuf, size, path)) {
-		gi.DPrintf("Unable to parse Lua file '%s'\n", path);
-		gi.FS_FreeFile(fbuf);
-		return -1;
-	}
-	gi.FS_FreeFile(fbuf);
 
 	return 0;
 }
@@ -1034,16 +1118,28 @@ int AIL_InitActor (edict_t * ent, const char *type, const char *subtype)
 /**
  * @brief Cleans up the AI part of the actor.
  * @param[in] ent Pointer to actor to cleanup AI.
+ * @note The lua state belongs to the AI type and is closed in @c AIL_CleanupTypes
  */
 static void AIL_CleanupActor (edict_t * ent)
 {
 	AI_t *AI = &ent->AI;
 
-	/* Cleanup. */
-	if (AI->L != NULL) {
-		lua_close(AI->L);
-		AI->L = NULL;
+	AI->L = NULL;
+}
+
+/**
+ * @brief Closes the lua states of all AI types
+ */
+static void AIL_CleanupTypes (void)
+{
+	int i;
+
+	for (i = 0; i < MAX_AI_TYPES; i++) {
+		aiType_t *aiType = &AIL_types[i];
+		if (aiType->L != NULL)
+			lua_close(aiType->L);
 	}
+	OBJZERO(AIL_types);
 }
 
 void AIL_Init (void)
@@ -1060,6 +1156,8 @@ void AIL_Shutdown (void)
 	gi.UnregisterConstVariable("luaaiteam::civilian");
 	gi.UnregisterConstVariable("luaaiteam::alien");
 	gi.UnregisterConstVariable("luaaiteam::all");
+
+	AIL_CleanupTypes();
 }
 
 /**
@@ -1071,4 +1169,6 @@ void AIL_Cleanup (void)
 
 	while ((ent = G_EdictsGetNextActor(ent)))
 		AIL_CleanupActor(ent);
+
+	AIL_CleanupTypes();
 }
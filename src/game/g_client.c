@@ -505,6 +505,8 @@ void G_ClientStateChange (const player_t* player, edict_t* ent, int reqState, qb
 		return;
 	}
 
+	G_ReactionFireWatcherUpdate(ent);
+
 	/* Only activate the events - network stuff is handled in the calling function */
 	if (!checkaction)
 		return;
@@ -1069,6 +1071,8 @@ edict_t* G_ClientGetFreeSpawnPointForActorSize (const player_t *player, const ac
 	if (!ent)
 		return NULL;
 
+	G_EdictsUpdateLists(ent);
+
 	level.num_spawned[ent->team]++;
 	ent->pnum = player->num;
 	ent->chr.fieldSize = actorSize;
@@ -1399,7 +1403,11 @@ void G_ClientUserinfoChanged (player_t * player, const char *userinfo)
 	Q_strncpyz(player->pers.netname, Info_ValueForKey(userinfo, "cl_name"), sizeof(player->pers.netname));
 	Q_strncpyz(player->pers.userinfo, userinfo, sizeof(player->pers.userinfo));
 	player->autostand = Info_IntegerForKey(userinfo, "cl_autostand");
-	player->reactionLeftover = Info_IntegerForKey(userinfo, "cl_reactionleftover");
+	if (player->reactionLeftover != Info_IntegerForKey(userinfo, "cl_reactionleftover")) {
+		player->reactionLeftover = Info_IntegerForKey(userinfo, "cl_reactionleftover");
+		/* the TUs the actors need for reaction fire have changed */
+		G_ReactionFireWatcherUpdateAll();
+	}
 	player->isReady = Info_IntegerForKey(userinfo, "cl_ready");
 
 	/* send the updated config string */
@@ -31,6 +31,16 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 /** This is where we store the edicts */
 static edict_t *g_edicts;
 
+/** @brief The first and the last edict of an edict list - see @c edictList_t */
+typedef struct edictListHead_s {
+	edict_t *first;
+	edict_t *last;
+} edictListHead_t;
+
+static edictListHead_t g_edictLists[EDL_MAX];
+/** the heads for @c EDL_LIVING_TEAM - @c g_edictLists[EDL_LIVING_TEAM] stays empty */
+static edictListHead_t g_edictTeamLists[MAX_TEAMS];
+
 /**
  * @brief Allocate space for the entity pointers.
  * @note No need to set it to zero, G_TagMalloc will do that for us
@@ -38,6 +48,8 @@ static edict_t *g_edicts;
 edict_t* G_EdictsInit (void)
 {
 	g_edicts = (edict_t *)G_TagMalloc(game.sv_maxentities * sizeof(g_edicts[0]), TAG_GAME);
+	OBJZERO(g_edictLists);
+	OBJZERO(g_edictTeamLists);
 	return g_edicts;
 }
 
@@ -47,6 +59,8 @@ edict_t* G_EdictsInit (void)
 void G_EdictsReset (void)
 {
 	memset(g_edicts, 0, game.sv_maxentities * sizeof(g_edicts[0]));
+	OBJZERO(g_edictLists);
+	OBJZERO(g_edictTeamLists);
 }
 
 /**
@@ -131,6 +145,9 @@ edict_t* G_EdictDuplicate (const edict_t *edict)
 		return NULL;
 	memcpy(duplicate, edict, sizeof(*edict));
 	duplicate->number = G_EdictsGetNumber(duplicate);
+	/* the links belong to the original */
+	OBJZERO(duplicate->lists);
+	G_EdictsUpdateLists(duplicate);
 	return duplicate;
 }
 
@@ -156,6 +173,113 @@ edict_t* G_EdictsGetNewEdict (void)
 		return ent;
 }
 
+/**
+ * @brief Removes the edict from the given list - nothing happens if it is not linked
+ */
+static void G_EdictsListUnlink (edict_t *ent, edictList_t list)
+{
+	edictLink_t *link = &ent->lists[list];
+	edictListHead_t *head = link->head;
+
+	if (head == NULL)
+		return;
+
+	if (link->prev)
+		link->prev->lists[list].next = link->next;
+	else
+		head->first = link->next;
+	if (link->next)
+		link->next->lists[list].prev = link->prev;
+	else
+		head->last = link->prev;
+
+	OBJZERO(*link);
+}
+
+/**
+ * @brief Adds the edict to the given list - keeps the list sorted by the position in the edict array
+ * @note New edicts are mostly appended to the edict array, that's why the search for
+ * the position starts at the end of the list
+ */
+static void G_EdictsListLink (edict_t *ent, edictList_t list, edictListHead_t *head)
+{
+	edictLink_t *link = &ent->lists[list];
+	edict_t *prev;
+
+	if (link->head == head)
+		return;
+	G_EdictsListUnlink(ent, list);
+
+	prev = head->last;
+	while (prev && G_EdictsGetNumber(prev) > G_EdictsGetNumber(ent))
+		prev = prev->lists[list].prev;
+
+	link->head = head;
+	link->prev = prev;
+	link->next = prev ? prev->lists[list].next : head->first;
+	if (link->next)
+		link->next->lists[list].prev = ent;
+	else
+		head->last = ent;
+	if (prev)
+		prev->lists[list].next = ent;
+	else
+		head->first = ent;
+}
+
+/**
+ * @brief Returns the edict that follows @c lastEnt in the edict array and is part of the given list
+ * @note @c lastEnt doesn't have to be linked (anymore) - it might e.g. have died while the caller was
+ * iterating the living actors
+ */
+static edict_t* G_EdictsListNext (const edict_t *lastEnt, edictList_t list, const edictListHead_t *head)
+{
+	edict_t *ent;
+
+	if (!lastEnt)
+		return head->first;
+	if (lastEnt->lists[list].head == head)
+		return lastEnt->lists[list].next;
+
+	/* the number of a freed edict is already zeroed - compare the array positions */
+	for (ent = head->first; ent; ent = ent->lists[list].next)
+		if (G_EdictsGetNumber(ent) > G_EdictsGetNumber(lastEnt))
+			break;
+	return ent;
+}
+
+/**
+ * @brief Adds the edict to or removes it from the edict lists that are used by the iterators below
+ * @note Must be called whenever the type, the team, the alive state or the in-use flag of an
+ * edict changes in a way the lists depend on - this is the case for spawning, dying and freeing.
+ * @sa G_ReactionFireWatcherUpdate
+ */
+void G_EdictsUpdateLists (edict_t *ent)
+{
+	const qboolean actor = ent->inuse && G_IsActor(ent);
+	const qboolean living = actor && G_IsLivingActor(ent);
+
+	if (actor)
+		G_EdictsListLink(ent, EDL_ACTORS, &g_edictLists[EDL_ACTORS]);
+	else
+		G_EdictsListUnlink(ent, EDL_ACTORS);
+
+	if (living)
+		G_EdictsListLink(ent, EDL_LIVING, &g_edictLists[EDL_LIVING]);
+	else
+		G_EdictsListUnlink(ent, EDL_LIVING);
+
+	if (living && ent->team >= 0 && ent->team < MAX_TEAMS)
+		G_EdictsListLink(ent, EDL_LIVING_TEAM, &g_edictTeamLists[ent->team]);
+	else
+		G_EdictsListUnlink(ent, EDL_LIVING_TEAM);
+
+	if (ent->inuse && G_IsTriggerNextMap(ent))
+		G_EdictsListLink(ent, EDL_NEXTMAPS, &g_edictLists[EDL_NEXTMAPS]);
+	else
+		G_EdictsListUnlink(ent, EDL_NEXTMAPS);
+}
+
 /**
  * @brief Iterate through the entities that are in use
  * @note we can hopefully get rid of this function once we know when it makes sense
@@ -179,13 +303,7 @@ edict_t* G_EdictsGetNextInUse (edict_t* lastEnt)
  */
 edict_t* G_EdictsGetTriggerNextMaps (edict_t* lastEnt)
 {
-	edict_t* ent = lastEnt;
-
-	while ((ent = G_EdictsGetNextInUse(ent))) {
-		if (G_IsTriggerNextMap(ent))
-			break;
-	}
-	return ent;
+	return G_EdictsListNext(lastEnt, EDL_NEXTMAPS, &g_edictLists[EDL_NEXTMAPS]);
 }
 
 /**
@@ -194,13 +312,7 @@ edict_t* G_EdictsGetTriggerNextMaps (edict_t* lastEnt)
  */
 edict_t* G_EdictsGetNextLivingActor (edict_t* lastEnt)
 {
-	edict_t* ent = lastEnt;
-
-	while ((ent = G_EdictsGetNextInUse(ent))) {
-		if (G_IsLivingActor(ent))
-			break;
-	}
-	return ent;
+	return G_EdictsListNext(lastEnt, EDL_LIVING, &g_edictLists[EDL_LIVING]);
 }
 
 /**
@@ -210,13 +322,10 @@ edict_t* G_EdictsGetNextLivingActor (edict_t* lastEnt)
  */
 edict_t* G_EdictsGetNextLivingActorOfTeam (edict_t* lastEnt, const int team)
 {
-	edict_t* ent = lastEnt;
+	if (team < 0 || team >= MAX_TEAMS)
+		return NULL;
 
-	while ((ent = G_EdictsGetNextLivingActor(ent))) {
-		if (ent->team == team)
-			break;
-	}
-	return ent;
+	return G_EdictsListNext(lastEnt, EDL_LIVING_TEAM, &g_edictTeamLists[team]);
 }
 
 /**
@@ -225,15 +334,9 @@ edict_t* G_EdictsGetNextLivingActorOfTeam (edict_t* lastEnt, const int team)
  */
 edict_t* G_EdictsGetNextActor (edict_t* lastEnt)
 {
-	edict_t* ent = lastEnt;
-
 	assert(lastEnt < &g_edicts[globals.num_edicts]);
 
-	while ((ent = G_EdictsGetNextInUse(ent))) {
-		if (G_IsActor(ent))
-			break;
-	}
-	return ent;
+	return G_EdictsListNext(lastEnt, EDL_ACTORS, &g_edictLists[EDL_ACTORS]);
 }
 
 /**
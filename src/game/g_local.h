@@ -261,6 +261,7 @@ extern cvar_t *ai_equipment;
 extern cvar_t *ai_numaliens;
 extern cvar_t *ai_numcivilians;
 extern cvar_t *ai_numactors;
+extern cvar_t *ai_luabudget;
 
 extern cvar_t *mob_death;
 extern cvar_t *mob_wound;
@@ -389,6 +390,12 @@ qboolean G_ReactionFireOnMovement(edict_t *target);
 void G_ReactionFireOnEndTurn(void);
 void G_ReactionFireTargetsInit (void);
 void G_ReactionFireTargetsCreate (const edict_t *shooter);
+void G_ReactionFireWatcherUpdate(edict_t *ent);
+void G_ReactionFireWatcherUpdateAll(void);
+#ifdef COMPILE_UNITTESTS
+void G_ReactionFireTargetsTestAdd(const edict_t *shooter, const edict_t *target, const int tusForShot);
+int G_ReactionFireTargetsTestGetTriggerTUs(const edict_t *shooter, const edict_t *target);
+#endif
 
 void G_CompleteRecalcRouting(void);
 void G_RecalcRouting(const char *model);
@@ -568,6 +575,7 @@ edict_t* G_EdictsGetNextActor(edict_t* lastEnt);
 edict_t* G_EdictsGetNextLivingActor(edict_t* lastEnt);
 edict_t* G_EdictsGetNextLivingActorOfTeam(edict_t* lastEnt, const int team);
 edict_t* G_EdictsGetTriggerNextMaps(edict_t* lastEnt);
+void G_EdictsUpdateLists(edict_t *ent);
 
 /** Functions to handle single edicts, trying to encapsulate edict->pos in the first place. */
 void G_EdictCalcOrigin(edict_t* ent);
@@ -657,9 +665,30 @@ struct player_s {
 typedef struct AI_s {
 	char type[MAX_QPATH];	/**< Lua file used by the AI. */
 	char subtype[MAX_VAR];	/**< Subtype to be used by AI. */
-	lua_State* L;			/**< The lua state used by the AI. */
+	lua_State* L;			/**< The lua state used by the AI - shared by all actors with the same type */
 } AI_t;
 
+/**
+ * @brief The edict lists that are kept up to date by @c G_EdictsUpdateLists
+ * @note The lists are sorted by the edict number, so iterating them gives the same order as
+ * walking the edict array
+ */
+typedef enum {
+	EDL_ACTORS,			/**< all actors in use - the dead ones, too */
+	EDL_LIVING,			/**< the living (and the stunned) actors */
+	EDL_LIVING_TEAM,	/**< the living actors of the team the edict was linked for */
+	EDL_NEXTMAPS,		/**< the trigger_nextmap edicts */
+
+	EDL_MAX
+} edictList_t;
+
+/** @brief The links of an edict into one of the edict lists - only touched in g_edicts.c */
+typedef struct edictLink_s {
+	edict_t *next;
+	edict_t *prev;
+	struct edictListHead_s *head;	/**< the list the edict is linked into or @c NULL */
+} edictLink_t;
+
 /**
  * @brief Everything that is not in the bsp tree is an edict, the spawnpoints,
  * the actors, the misc_models, the weapons and so on.
@@ -793,6 +822,8 @@ struct edict_s {
 	pos3_t *forbiddenListPos;	/**< this is used for e.g. misc_models with the solid flag set - this will
 								 * hold a list of grid positions that are blocked by the aabb of the model */
 	int forbiddenListSize;		/**< amount of entries in the forbiddenListPos */
+
+	edictLink_t lists[EDL_MAX];	/**< @sa G_EdictsUpdateLists */
 };
 
 #endif /* GAME_G_LOCAL_H */
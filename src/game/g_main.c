@@ -68,6 +68,7 @@ cvar_t *ai_equipment;
 cvar_t *ai_numaliens;
 cvar_t *ai_numcivilians;
 cvar_t *ai_numactors;
+cvar_t *ai_luabudget;
 
 /* morale cvars */
 cvar_t *mob_death;
@@ -193,6 +194,8 @@ static void G_Init (void)
 	ai_numcivilians = gi.Cvar_Get("ai_numcivilians", "10", 0, "How many civilians in this battle");
 	/* aliens in multiplayer */
 	ai_numactors = gi.Cvar_Get("ai_numactors", "8", CVAR_ARCHIVE, "How many (ai controlled) actors in this battle (multiplayer)");
+	/* bounds the time a broken or too expensive lua ai can take */
+	ai_luabudget = gi.Cvar_Get("ai_luabudget", "1000000", 0, "Maximum amount of lua instructions for one think of an ai actor - 0 means no limit");
 
 	mob_death = gi.Cvar_Get("mob_death", "10", CVAR_LATCH|CVAR_NOSET, NULL);
 	mob_wound = gi.Cvar_Get("mob_wound", "0.1", CVAR_LATCH|CVAR_NOSET, NULL);
@@ -444,6 +447,8 @@ qboolean G_RunFrame (void)
 	if (G_MatchDoEnd())
 		return qtrue;
 
+	PROF_BEGIN(PROF_G_RUNFRAME);
+
 	CheckNeedPass();
 
 	/* run ai */
@@ -452,5 +457,7 @@ qboolean G_RunFrame (void)
 
 	G_SendBoundingBoxes();
 
+	PROF_END(PROF_G_RUNFRAME);
+
 	return qfalse;
 }
@@ -17,6 +17,10 @@
  *		calls	G_ReactionFireOnEndTurn()
  *				calls	G_ReactionFireTryToShoot()
  *		calls	G_ReactionFireReset()
+ *
+ * Only the actors in the watcher index are checked as shooters. The index holds every actor
+ * that could reaction fire at all (reaction fire enabled, a working fire mode and enough TUs) and
+ * is kept up to date by G_ReactionFireWatcherUpdate() whenever one of these changes.
  */
 
 /*
@@ -59,6 +63,12 @@ typedef struct reactionFireTargets
 
 static reactionFireTargets_t rfData[MAX_RF_DATA];
 
+/** the actors that are able to reaction fire at all - see G_ReactionFireIsWatcher */
+static edict_t *rfWatchers[MAX_EDICTS];
+static int rfNumWatchers;
+/** the position of the actors in @c rfWatchers plus one or @c 0 - indexed by the entity number */
+static int rfWatcherIndex[MAX_EDICTS];
+
 /**
  * @brief Initialize the reaction fire table for all entities.
  */
@@ -70,6 +80,9 @@ void G_ReactionFireTargetsInit (void)
 		rfData[i].entnum = -1;
 		rfData[i].count = 0;
 	}
+
+	OBJZERO(rfWatcherIndex);
+	rfNumWatchers = 0;
 }
 
 /**
@@ -156,6 +169,24 @@ static void G_ReactionFireTargetsRemove (edict_t *shooter, const edict_t *target
 	shooter->reactionTarget = NULL;
 }
 
+/**
+ * @brief Forget all the reaction fire targets of the given shooter
+ * @note The trigger TUs of the targets are only valid as long as the shooter is watching - a
+ * shooter that watches again must not fire with the thresholds of an earlier turn
+ * @param[in] shooter The reaction firing actor
+ */
+static void G_ReactionFireTargetsClear (const edict_t *shooter)
+{
+	int i;
+
+	for (i = 0; i < MAX_RF_DATA; i++) {
+		if (rfData[i].entnum == shooter->number) {
+			rfData[i].count = 0;
+			break;
+		}
+	}
+}
+
 /**
  * @brief Check if the given shooter is ready to reaction fire at the given target.
  * @param[in] shooter The reaction firing actor
@@ -244,7 +275,8 @@ static int G_ReactionFireGetTUsForItem (const edict_t *ent, const edict_t *targe
 			const fireDef_t *fd = &fdArray[fmIdx];
 			const int tus = fd->time + reactionFire;
 
-			if (tus <= ent->TU && fd->range > VectorDist(ent->origin, target->origin)) {
+			/* without a target only the weapon and the TUs are checked */
+			if (tus <= ent->TU && (!target || fd->range > VectorDist(ent->origin, target->origin))) {
 				return tus;
 			}
 		}
@@ -253,6 +285,118 @@ static int G_ReactionFireGetTUsForItem (const edict_t *ent, const edict_t *targe
 	return -1;
 }
 
+/**
+ * @brief Checks whether the actor could reaction fire at anything at all - independent of the target
+ * and of the active team
+ * @note Everything that is checked here must call @c G_ReactionFireWatcherUpdate when it changes
+ * @sa G_ReactionFireIsPossible
+ */
+static qboolean G_ReactionFireIsWatcher (const edict_t *ent)
+{
+	if (!ent->inuse || !G_IsLivingActor(ent))
+		return qfalse;
+
+	if (G_IsDazed(ent))
+		return qfalse;
+
+	if (!G_IsShaken(ent) && !G_IsReaction(ent))
+		return qfalse;
+
+	if (!ACTOR_GET_INV(ent, ent->chr.RFmode.hand))
+		return qfalse;
+
+	return G_ReactionFireGetTUsForItem(ent, NULL, RIGHT(ent)) >= 0;
+}
+
+/**
+ * @brief Adds the actor to or removes it from the watcher index after anything changed that
+ * @c G_ReactionFireIsWatcher depends on (state, TUs, inventory, reaction fire settings)
+ * @param[in,out] ent The actor that was changed
+ */
+void G_ReactionFireWatcherUpdate (edict_t *ent)
+{
+	const int index = rfWatcherIndex[ent->number];
+
+	if (G_ReactionFireIsWatcher(ent)) {
+		if (!index) {
+			rfWatchers[rfNumWatchers++] = ent;
+			rfWatcherIndex[ent->number] = rfNumWatchers;
+		}
+	} else if (index) {
+		/* move the last watcher into the gap */
+		edict_t *last = rfWatchers[--rfNumWatchers];
+		rfWatchers[index - 1] = last;
+		rfWatcherIndex[last->number] = index;
+		rfWatcherIndex[ent->number] = 0;
+		/* the actor can't take the shot anymore */
+		ent->reactionTarget = NULL;
+		G_ReactionFireTargetsClear(ent);
+	}
+}
+
+#ifdef COMPILE_UNITTESTS
+/**
+ * @brief Adds a reaction fire target without the visibility checks of G_ReactionFireSearchTarget
+ */
+void G_ReactionFireTargetsTestAdd (const edict_t *shooter, const edict_t *target, const int tusForShot)
+{
+	G_ReactionFireTargetsAdd(shooter, target, tusForShot);
+}
+
+/**
+ * @return The TUs of the target at which the shooter fires, or @c -1 if the shooter doesn't know the target
+ */
+int G_ReactionFireTargetsTestGetTriggerTUs (const edict_t *shooter, const edict_t *target)
+{
+	int i, j;
+
+	for (i = 0; i < MAX_RF_DATA; i++) {
+		const reactionFireTargets_t *rfts = &rfData[i];
+		if (rfts->entnum != shooter->number)
+			continue;
+		for (j = 0; j < rfts->count; j++)
+			if (rfts->targets[j].target == target)
+				return rfts->targets[j].triggerTUs;
+	}
+
+	return -1;
+}
+#endif
+
+/**
+ * @brief Checks whether the actor is still in the watcher index
+ * @note A watcher might drop out while the others are shooting - e.g. because it was hit
+ */
+static inline qboolean G_ReactionFireIsWatching (const edict_t *ent)
+{
+	return rfWatcherIndex[ent->number] != 0;
+}
+
+/**
+ * @brief Checks the watcher index for all actors again
+ * @note Only needed if something changes that is not bound to a single actor - e.g. the
+ * reaction fire TU leftover of a player
+ */
+void G_ReactionFireWatcherUpdateAll (void)
+{
+	edict_t *ent = NULL;
+
+	while ((ent = G_EdictsGetNextActor(ent)))
+		G_ReactionFireWatcherUpdate(ent);
+}
+
+/**
+ * @brief Copies the watcher index
+ * @note The shots of the watchers change the index - so always loop over a copy
+ * @param[out] watchers The array to copy the watchers to, must have room for @c MAX_EDICTS entries
+ * @return The amount of watchers
+ */
+static int G_ReactionFireGetWatchers (edict_t **watchers)
+{
+	memcpy(watchers, rfWatchers, rfNumWatchers * sizeof(*watchers));
+	return rfNumWatchers;
+}
+
 /**
  * @brief Checks whether the actor has a reaction fire enabled weapon in one of his hands.
  * @param[in] ent The actor to check the weapons for
@@ -309,6 +453,8 @@ void G_ReactionFireUpdate (edict_t *ent, fireDefIndex_t fmIdx, actorHands_t hand
 	fm->hand = hand;
 	fm->weapon = od;
 
+	G_ReactionFireWatcherUpdate(ent);
+
 	if (!G_ActorHasWorkingFireModeSet(ent)) {
 		/* Disable reaction fire if no valid firemode was found. */
 		G_ClientStateChange(G_PLAYER_FROM_ENT(ent), ent, ~STATE_REACTION, qtrue);
@@ -492,51 +638,37 @@ static qboolean G_ReactionFireIsPossible (const edict_t *ent, const edict_t *tar
 
 /**
  * @brief Check whether 'target' has just triggered any new reaction fire
+ * @note This combines the old target search and the update of the reaction fire targets - the
+ * expensive visibility check is done only once per watcher
  * @param[in] target The entity triggering fire
- */
-static void G_ReactionFireTargetsUpdateAll (const edict_t *target)
-{
-	edict_t *shooter = NULL;
-
-	/* check all possible shooters */
-	while ((shooter = G_EdictsGetNextLivingActor(shooter))) {
-		/* check whether reaction fire is possible (friend/foe, LoS */
-		if (G_ReactionFireIsPossible(shooter, target)) {
-			const int TUs = G_ReactionFireGetTUsForItem(shooter, target, RIGHT(shooter));
-			if (TUs < 0)
-				continue;	/* no suitable weapon */
-			G_ReactionFireTargetsAdd(shooter, target, TUs);
-		} else {
-			G_ReactionFireTargetsRemove(shooter, target);
-		}
-	}
-}
-
-/**
- * @brief Check whether 'target' has just triggered any new reaction fire
- * @param[in] target The entity triggering fire
- * @sa G_CanReactionFire
- * @sa G_GetFiringTUs
+ * @sa G_ReactionFireIsPossible
  */
 static void G_ReactionFireSearchTarget (const edict_t *target)
 {
-	edict_t *ent = NULL;
+	edict_t *watchers[MAX_EDICTS];
+	const int numWatchers = G_ReactionFireGetWatchers(watchers);
+	int i;
 
 	/* check all possible shooters */
-	while ((ent = G_EdictsGetNextLivingActor(ent))) {
+	for (i = 0; i < numWatchers; i++) {
+		edict_t *ent = watchers[i];
 		int tus;
 
-		/* not if ent has reaction target already */
-		if (ent->reactionTarget)
-			continue;
-
-		/* check whether reaction fire is possible */
-		if (!G_ReactionFireIsPossible(ent, target))
+		/* check whether reaction fire is possible (friend/foe, LoS) */
+		if (!G_ReactionFireIsPossible(ent, target)) {
+			G_ReactionFireTargetsRemove(ent, target);
 			continue;
+		}
 
 		/* see how quickly ent can fire (if it can fire at all) */
 		tus = G_ReactionFireGetTUsForItem(ent, target, RIGHT(ent));
 		if (tus < 0)
+			continue;	/* no suitable weapon */
+
+		G_ReactionFireTargetsAdd(ent, target, tus);
+
+		/* not if ent has reaction target already */
+		if (ent->reactionTarget)
 			continue;
 
 		/* queue a reaction fire to take place */
@@ -618,6 +750,7 @@ static qboolean G_ReactionFireTryToShoot (edict_t *shooter, const edict_t *targe
 	if (tookShot) {
 		/* clear any shakenness */
 		G_RemoveShaken(shooter);
+		G_ReactionFireWatcherUpdate(shooter);
 
 		/* check whether further reaction fire is possible */
 		if (G_ReactionFireIsPossible(shooter, target)){
@@ -643,12 +776,20 @@ static qboolean G_ReactionFireTryToShoot (edict_t *shooter, const edict_t *targe
  */
 static qboolean G_ReactionFireCheckExecution (const edict_t *target)
 {
-	edict_t *shooter = NULL;
+	edict_t *watchers[MAX_EDICTS];
+	const int numWatchers = G_ReactionFireGetWatchers(watchers);
 	qboolean fired = qfalse;
+	int i;
 
 	/* check all possible shooters */
-	while ((shooter = G_EdictsGetNextLivingActor(shooter))) {
-		const int tus = G_ReactionFireGetTUsForItem(shooter, target, RIGHT(shooter));
+	for (i = 0; i < numWatchers; i++) {
+		edict_t *shooter = watchers[i];
+		int tus;
+
+		if (!G_ReactionFireIsWatching(shooter))
+			continue;
+
+		tus = G_ReactionFireGetTUsForItem(shooter, target, RIGHT(shooter));
 		if (tus > 1 && g_reactionnew->integer) {
 			if (G_ReactionFireTargetsExpired(shooter, target, 0)) {
 				shooter->reactionTarget = target;
@@ -686,8 +827,6 @@ qboolean G_ReactionFireOnMovement (edict_t *target)
 	/* Check to see whether this triggers any reaction fire */
 	G_ReactionFireSearchTarget(target);
 
-	G_ReactionFireTargetsUpdateAll(target);
-
 	return fired;
 }
 
@@ -699,21 +838,28 @@ qboolean G_ReactionFireOnMovement (edict_t *target)
  */
 void G_ReactionFirePreShot (const edict_t *target, const int fdTime)
 {
-	edict_t *shooter = NULL;
 	qboolean repeat = qtrue;
 
 	/* Check to see whether this triggers any reaction fire */
 	G_ReactionFireSearchTarget(target);
 
-	G_ReactionFireTargetsUpdateAll(target);
-
 	/* if any reaction fire occurs, we have to loop through all entities again to allow
 	 * multiple (fast) RF snap shots before a (slow) aimed shot from the target occurs (only if g_reactionnew is set to 1). */
 	while (repeat) {
+		edict_t *watchers[MAX_EDICTS];
+		const int numWatchers = G_ReactionFireGetWatchers(watchers);
+		int i;
+
 		repeat = qfalse;
 		/* check all ents to see who wins and who loses a draw */
-		while ((shooter = G_EdictsGetNextLivingActor(shooter))) {
-			int entTUs = G_ReactionFireGetTUsForItem(shooter, target, RIGHT(shooter));
+		for (i = 0; i < numWatchers; i++) {
+			edict_t *shooter = watchers[i];
+			int entTUs;
+
+			if (!G_ReactionFireIsWatching(shooter))
+				continue;
+
+			entTUs = G_ReactionFireGetTUsForItem(shooter, target, RIGHT(shooter));
 			if (entTUs > 1 && g_reactionnew->integer) {
 				if (G_ReactionFireTargetsExpired(shooter, target, fdTime)) {
 					shooter->reactionTarget = target;
@@ -797,6 +943,7 @@ void G_ReactionFireReset (int team)
 		ent->reactionTarget = NULL;
 		ent->reactionTUs = 0;
 		ent->reactionNoDraw = qfalse;
+		G_ReactionFireWatcherUpdate(ent);
 
 		G_EventActorStateChange(G_TeamToPM(ent->team), ent);
 	}
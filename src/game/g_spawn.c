@@ -153,6 +153,7 @@ static void ED_CallSpawn (edict_t * ent)
 		/* found it */
 		if (Q_streq(s->name, ent->classname)) {
 			s->spawn(ent);
+			G_EdictsUpdateLists(ent);
 			return;
 		}
 	}
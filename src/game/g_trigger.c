@@ -139,6 +139,7 @@ static qboolean Touch_NextMapTrigger (edict_t *self, edict_t *activator)
 	if (activator != NULL && activator->team == self->team) {
 		char command[MAX_VAR];
 		self->inuse = qfalse;
+		G_EdictsUpdateLists(self);
 		G_ClientPrintf(G_PLAYER_FROM_ENT(activator), PRINT_HUD, _("Switching map!\n"));
 		Com_sprintf(command, sizeof(command), "map %s %s\n",
 				level.day ? "day" : "night", self->nextmap);
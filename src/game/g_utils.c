@@ -40,6 +40,11 @@ void G_FreeEdict (edict_t *ent)
 	/* unlink from world */
 	gi.UnlinkEdict(ent);
 
+	/* drop it from the edict lists and the reaction fire watchers before the entity number is gone */
+	ent->inuse = qfalse;
+	G_EdictsUpdateLists(ent);
+	G_ReactionFireWatcherUpdate(ent);
+
 	OBJZERO(*ent);
 	ent->classname = "freed";
 	ent->inuse = qfalse;
@@ -33,8 +33,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../shared/typedefs.h"
 #include "../common/tracing.h"
 #include "../common/cvar.h"
+#include "../common/profiler.h"
 
-#define	GAME_API_VERSION	10
+#define	GAME_API_VERSION	11
 
 /** @brief edict->solid values */
 typedef enum {
@@ -225,6 +226,12 @@ typedef struct {
 	/** add commands to the server console as if they were typed in
 	 * for map changing, etc */
 	void (IMPORT *AddCommandString) (const char *text);
+
+	/** profiling of the hot paths - @c NULL if the engine was built without the profiler
+	 * @note Always part of the struct, so the layout doesn't depend on the build flags */
+	void (IMPORT *ProfBegin) (profZone_t zone);
+	void (IMPORT *ProfEnd) (profZone_t zone);
+	void (IMPORT *ProfCount) (profCounter_t counter, int value);
 } game_import_t;
 
 /** @brief functions exported by the game subsystem */
@@ -96,11 +96,9 @@ invList_t* INVSH_HasArmour (const inventory_t *inv)
 	return inv->c[CSI->idArmour];
 }
 
-static int cacheCheckToInventory = INV_DOES_NOT_FIT;
-
 /**
  * @brief Will check if the item-shape is colliding with something else in the container-shape at position x/y.
- * @note The function expects an already rotated shape for itemShape. Use INVSH_ShapeRotate if needed.
+ * @note The function expects an already rotated shape for itemShape. Use objDef_t::shapeRotated if needed.
  * @param[in] shape Pointer to 'uint32_t shape[SHAPE_BIG_MAX_HEIGHT]'
  */
 static qboolean INVSH_CheckShapeCollision (const uint32_t *shape, const uint32_t itemShape, const int x, const int y)
@@ -115,7 +113,7 @@ static qboolean INVSH_CheckShapeCollision (const uint32_t *shape, const uint32_t
 
 	for (i = 0; i < SHAPE_SMALL_MAX_HEIGHT; i++) {
 		/* 0xFF is the length of one row in a "small shape" i.e. SHAPE_SMALL_MAX_WIDTH */
-		const int itemRow = (itemShape >> (i * SHAPE_SMALL_MAX_WIDTH)) & 0xFF;
+		const uint32_t itemRow = (itemShape >> (i * SHAPE_SMALL_MAX_WIDTH)) & 0xFF;
 		/* Result has to be limited to 32bit (SHAPE_BIG_MAX_WIDTH) */
 		const uint32_t itemRowShifted = itemRow << x;
 
@@ -138,104 +136,194 @@ static qboolean INVSH_CheckShapeCollision (const uint32_t *shape, const uint32_t
 }
 
 /**
- * @brief Checks if an item-shape can be put into a container at a certain position... ignores any 'special' types of containers.
- * @param[in] i
- * @param[in] container The container (index) to look into.
- * @param[in] itemShape The shape info of an item to fit into the container.
- * @param[in] x The x value in the container (1 << x in the shape bitmask)
- * @param[in] y The x value in the container (SHAPE_BIG_MAX_HEIGHT is the max)
+ * @brief Builds the occupancy mask of a container - every bit that is set is either not part of the
+ * container shape or already used by an item
+ * @note Build the mask once and check as many positions and shapes against it as needed
+ * @param[in] i The inventory the container belongs to
+ * @param[in] container The container to build the mask for
  * @param[in] ignoredItem You can ignore one item in the container (most often the currently dragged one). Use NULL if you want to check against all items in the container.
- * @sa INVSH_CheckToInventory
- * @return qfalse if the item does not fit, qtrue if it fits.
+ * @param[out] mask Pointer to 'uint32_t mask[SHAPE_BIG_MAX_HEIGHT]'
+ * @sa INVSH_ShapeFitsMask
+ * @sa INVSH_FindShapeInMask
  */
-static qboolean INVSH_CheckToInventory_shape (const inventory_t * const i, const invDef_t * container, const uint32_t itemShape, const int x, const int y, const invList_t *ignoredItem)
+void INVSH_GetContainerMask (const inventory_t * const i, const invDef_t * container, const invList_t *ignoredItem, uint32_t *mask)
 {
-	invList_t *ic;
-	static uint32_t mask[SHAPE_BIG_MAX_HEIGHT];
+	const invList_t *ic;
+	int j;
 
-	assert(container);
+	/* extract shape info */
+	for (j = 0; j < SHAPE_BIG_MAX_HEIGHT; j++)
+		mask[j] = ~container->shape[j];
 
-	if (container->scroll)
-		Sys_Error("INVSH_CheckToInventory_shape: No scrollable container will ever use this. This type does not support grid-packing!");
+	/* Add other items to mask. (i.e. merge their shapes at their location into the generated mask) */
+	for (ic = i->c[container->id]; ic; ic = ic->next) {
+		if (ignoredItem == ic)
+			continue;
+
+		if (ic->item.rotated)
+			INVSH_MergeShapes(mask, ic->item.t->shapeRotated, ic->x, ic->y);
+		else
+			INVSH_MergeShapes(mask, ic->item.t->shape, ic->x, ic->y);
+	}
+}
 
+/**
+ * @brief Checks if an item-shape can be put at a certain position of an occupancy mask
+ * @param[in] mask The occupancy mask of the container
+ * @param[in] itemShape The (already rotated) shape of the item
+ * @param[in] x The x value in the container (1 << x in the shape bitmask)
+ * @param[in] y The y value in the container (SHAPE_BIG_MAX_HEIGHT is the max)
+ * @sa INVSH_GetContainerMask
+ */
+qboolean INVSH_ShapeFitsMask (const uint32_t *mask, const uint32_t itemShape, const int x, const int y)
+{
 	/* check bounds */
 	if (x < 0 || y < 0 || x >= SHAPE_BIG_MAX_WIDTH || y >= SHAPE_BIG_MAX_HEIGHT)
 		return qfalse;
 
-	if (!cacheCheckToInventory) {
-		int j;
-		/* extract shape info */
-		for (j = 0; j < SHAPE_BIG_MAX_HEIGHT; j++)
-			mask[j] = ~container->shape[j];
+	return !INVSH_CheckShapeCollision(mask, itemShape, x, y);
+}
 
-		/* Add other items to mask. (i.e. merge their shapes at their location into the generated mask) */
-		for (ic = i->c[container->id]; ic; ic = ic->next) {
-			if (ignoredItem == ic)
-				continue;
+/**
+ * @brief Calculates all the x positions in one row of the container an item-shape fits into
+ * @param[in] mask The occupancy mask of the container
+ * @param[in] itemShape The (already rotated) shape of the item
+ * @param[in] y The y value in the container
+ * @return A bitmask with bit x set if the item fits at position x/y
+ */
+static uint32_t INVSH_ShapeFreePositions (const uint32_t *mask, const uint32_t itemShape, const int y)
+{
+	uint32_t blocked = 0;
+	int i;
+
+	for (i = 0; i < SHAPE_SMALL_MAX_HEIGHT; i++) {
+		const uint32_t itemRow = (itemShape >> (i * SHAPE_SMALL_MAX_WIDTH)) & 0xFF;
+		int b;
+
+		if (!itemRow)
+			continue;
 
-			if (ic->item.rotated)
-				INVSH_MergeShapes(mask, INVSH_ShapeRotate(ic->item.t->shape), ic->x, ic->y);
-			else
-				INVSH_MergeShapes(mask, ic->item.t->shape, ic->x, ic->y);
+		/* This row is outside of the container - the item doesn't fit anywhere in row y */
+		if (y + i >= SHAPE_BIG_MAX_HEIGHT)
+			return 0;
+
+		/* bit b of the item row at position x collides with bit x + b of the mask - or is out of bounds */
+		for (b = 0; b < SHAPE_SMALL_MAX_WIDTH; b++) {
+			if (!(itemRow & (1 << b)))
+				continue;
+			blocked |= mask[y + i] >> b;
+			if (b)
+				blocked |= ~0U << (SHAPE_BIG_MAX_WIDTH - b);
 		}
 	}
 
-	/* Test for collisions with newly generated mask. */
-	if (INVSH_CheckShapeCollision(mask, itemShape, x, y))
-		return qfalse;
+	return ~blocked;
+}
 
-	/* Everything ok. */
-	return qtrue;
+/**
+ * @brief Searches the first position (row by row) an item-shape fits into
+ * @param[in] mask The occupancy mask of the container
+ * @param[in] itemShape The shape of the item
+ * @param[in] itemShapeRotated The rotated shape of the item or @c 0 if the item may not be rotated
+ * @param[out] px The x position in the container
+ * @param[out] py The y position in the container
+ * @return @c false if there is no free space
+ * @note Every row is checked for all x positions at once with bit operations
+ * @sa INVSH_GetContainerMask
+ */
+qboolean INVSH_FindShapeInMask (const uint32_t *mask, const uint32_t itemShape, const uint32_t itemShapeRotated, int* const px, int* const py)
+{
+	int x, y;
+
+	for (y = 0; y < SHAPE_BIG_MAX_HEIGHT; y++) {
+		uint32_t positions = INVSH_ShapeFreePositions(mask, itemShape, y);
+		if (itemShapeRotated)
+			positions |= INVSH_ShapeFreePositions(mask, itemShapeRotated, y);
+		if (!positions)
+			continue;
+
+		for (x = 0; !(positions & (1U << x)); x++) {}
+		*px = x;
+		*py = y;
+		return qtrue;
+	}
+
+	return qfalse;
 }
 
 /**
+ * @brief Checks the container type against the item type (armour, headgear, extension, two-handed items)
  * @param[in] i The inventory to check the item in.
  * @param[in] od The item to check in the inventory.
- * @param[in] container The index of the container in the inventory to check the item in.
- * @param[in] x The x value in the container (1 << x in the shape bitmask)
- * @param[in] y The y value in the container (SHAPE_BIG_MAX_HEIGHT is the max)
- * @param[in] ignoredItem You can ignore one item in the container (most often the currently dragged one). Use NULL if you want to check against all items in the container.
- * @return INV_DOES_NOT_FIT if the item does not fit
- * @return INV_FITS if it fits and
- * @return INV_FITS_ONLY_ROTATED if it fits only when rotated 90 degree (to the left).
- * @return INV_FITS_BOTH if it fits either normally or when rotated 90 degree (to the left).
+ * @param[in] container The container to check the item in.
+ * @return @c false if the item may never be put into this container
  */
-int INVSH_CheckToInventory (const inventory_t * const i, const objDef_t *od, const invDef_t * container, const int x, const int y, const invList_t *ignoredItem)
+static qboolean INVSH_CheckItemForContainer (const inventory_t * const i, const objDef_t *od, const invDef_t * container)
 {
-	int fits;
-	assert(i);
-	assert(container);
-	assert(od);
-
 	/* armour vs item */
 	if (INV_IsArmour(od)) {
 		if (!container->armour && !container->all) {
-			return INV_DOES_NOT_FIT;
+			return qfalse;
 		}
 	} else if (!od->extension && container->extension) {
-		return INV_DOES_NOT_FIT;
+		return qfalse;
 	} else if (!od->headgear && container->headgear) {
-		return INV_DOES_NOT_FIT;
+		return qfalse;
 	} else if (container->armour) {
-		return INV_DOES_NOT_FIT;
+		return qfalse;
 	}
 
 	/* twohanded item */
 	if (od->holdTwoHanded) {
 		if ((INV_IsRightDef(container) && i->c[CSI->idLeft]) || INV_IsLeftDef(container))
-			return INV_DOES_NOT_FIT;
+			return qfalse;
 	}
 
 	/* left hand is busy if right wields twohanded */
 	if (INV_IsLeftDef(container)) {
 		if (i->c[CSI->idRight] && i->c[CSI->idRight]->item.t->holdTwoHanded)
-			return INV_DOES_NOT_FIT;
+			return qfalse;
 
 		/* can't put an item that is 'fireTwoHanded' into the left hand */
 		if (od->fireTwoHanded)
-			return INV_DOES_NOT_FIT;
+			return qfalse;
 	}
 
+	return qtrue;
+}
+
+/**
+ * @return @c true if items in the given container may be rotated
+ */
+static inline qboolean INVSH_ContainerAllowsRotation (const invDef_t * container)
+{
+	/** @todo aren't both (equip and floor) temp container? */
+	return !INV_IsEquipDef(container) && !INV_IsFloorDef(container);
+}
+
+/**
+ * @param[in] i The inventory to check the item in.
+ * @param[in] od The item to check in the inventory.
+ * @param[in] container The index of the container in the inventory to check the item in.
+ * @param[in] x The x value in the container (1 << x in the shape bitmask)
+ * @param[in] y The y value in the container (SHAPE_BIG_MAX_HEIGHT is the max)
+ * @param[in] ignoredItem You can ignore one item in the container (most often the currently dragged one). Use NULL if you want to check against all items in the container.
+ * @return INV_DOES_NOT_FIT if the item does not fit
+ * @return INV_FITS if it fits and
+ * @return INV_FITS_ONLY_ROTATED if it fits only when rotated 90 degree (to the left).
+ * @return INV_FITS_BOTH if it fits either normally or when rotated 90 degree (to the left).
+ */
+int INVSH_CheckToInventory (const inventory_t * const i, const objDef_t *od, const invDef_t * container, const int x, const int y, const invList_t *ignoredItem)
+{
+	uint32_t mask[SHAPE_BIG_MAX_HEIGHT];
+	int fits;
+	assert(i);
+	assert(container);
+	assert(od);
+
+	if (!INVSH_CheckItemForContainer(i, od, container))
+		return INV_DOES_NOT_FIT;
+
 	/* Single item containers, e.g. hands, extension or headgear. */
 	if (container->single) {
 		if (i->c[container->id]) {
@@ -244,9 +332,10 @@ int INVSH_CheckToInventory (const inventory_t * const i, const objDef_t *od, con
 		} else {
 			fits = INV_DOES_NOT_FIT; /* equals 0 */
 
-			if (INVSH_CheckToInventory_shape(i, container, od->shape, x, y, ignoredItem))
+			INVSH_GetContainerMask(i, container, ignoredItem, mask);
+			if (INVSH_ShapeFitsMask(mask, od->shape, x, y))
 				fits |= INV_FITS;
-			if (INVSH_CheckToInventory_shape(i, container, INVSH_ShapeRotate(od->shape), x, y, ignoredItem))
+			if (INVSH_ShapeFitsMask(mask, od->shapeRotated, x, y))
 				fits |= INV_FITS_ONLY_ROTATED;
 
 			if (fits != INV_DOES_NOT_FIT)
@@ -263,11 +352,10 @@ int INVSH_CheckToInventory (const inventory_t * const i, const objDef_t *od, con
 
 	/* Check 'grid' containers. */
 	fits = INV_DOES_NOT_FIT; /* equals 0 */
-	if (INVSH_CheckToInventory_shape(i, container, od->shape, x, y, ignoredItem))
+	INVSH_GetContainerMask(i, container, ignoredItem, mask);
+	if (INVSH_ShapeFitsMask(mask, od->shape, x, y))
 		fits |= INV_FITS;
-	/** @todo aren't both (equip and floor) temp container? */
-	if (!INV_IsEquipDef(container) && !INV_IsFloorDef(container)
-	&& INVSH_CheckToInventory_shape(i, container, INVSH_ShapeRotate(od->shape), x, y, ignoredItem))
+	if (INVSH_ContainerAllowsRotation(container) && INVSH_ShapeFitsMask(mask, od->shapeRotated, x, y))
 		fits |= INV_FITS_ONLY_ROTATED;
 
 	return fits;	/**< Return INV_FITS_BOTH if both if statements where true above. */
@@ -485,11 +573,11 @@ invList_t *INVSH_SearchInInventoryByItem (const inventory_t* const i, const invD
  */
 void INVSH_FindSpace (const inventory_t* const inv, const item_t *item, const invDef_t * container, int* const px, int* const py, const invList_t *ignoredItem)
 {
-	int x, y;
+	uint32_t mask[SHAPE_BIG_MAX_HEIGHT];
+	const objDef_t *od = item->t;
 
 	assert(inv);
 	assert(container);
-	assert(!cacheCheckToInventory);
 
 	/* Scrollable container always have room. We return a dummy location. */
 	if (container->scroll) {
@@ -497,22 +585,20 @@ void INVSH_FindSpace (const inventory_t* const inv, const item_t *item, const in
 		return;
 	}
 
-	/** @todo optimize for single containers */
-
-	for (y = 0; y < SHAPE_BIG_MAX_HEIGHT; y++) {
-		for (x = 0; x < SHAPE_BIG_MAX_WIDTH; x++) {
-			const int checkedTo = INVSH_CheckToInventory(inv, item->t, container, x, y, ignoredItem);
-			if (checkedTo) {
-				cacheCheckToInventory = INV_DOES_NOT_FIT;
-				*px = x;
-				*py = y;
+	if (INVSH_CheckItemForContainer(inv, od, container)) {
+		/* single containers only have room if they are empty - the item is put to the first position then */
+		if (container->single) {
+			if (!inv->c[container->id]) {
+				*px = *py = 0;
 				return;
-			} else {
-				cacheCheckToInventory = INV_FITS;
 			}
+		} else {
+			/* the mask is only built once and all the positions of a row are checked at once */
+			INVSH_GetContainerMask(inv, container, ignoredItem, mask);
+			if (INVSH_FindShapeInMask(mask, od->shape, INVSH_ContainerAllowsRotation(container) ? od->shapeRotated : 0, px, py))
+				return;
 		}
 	}
-	cacheCheckToInventory = INV_DOES_NOT_FIT;
 
 #ifdef PARANOID
 	Com_DPrintf(DEBUG_SHARED, "INVSH_FindSpace: no space for %s: %s in %s\n",
@@ -530,17 +616,9 @@ void INVSH_FindSpace (const inventory_t* const inv, const item_t *item, const in
  */
 const objDef_t *INVSH_GetItemByIDSilent (const char *id)
 {
-	int i;
-
 	if (!id)
 		return NULL;
-	for (i = 0; i < CSI->numODs; i++) {	/* i = item index */
-		const objDef_t *item = &CSI->ods[i];
-		if (Q_streq(id, item->id)) {
-			return item;
-		}
-	}
-	return NULL;
+	return (const objDef_t *)IDT_Get(&CSI->odsByID, id);
 }
 
 /**
@@ -578,14 +656,7 @@ const objDef_t *INVSH_GetItemByID (const char *id)
  */
 const invDef_t *INVSH_GetInventoryDefinitionByID (const char *id)
 {
-	containerIndex_t i;
-	const invDef_t *container;
-
-	for (i = 0, container = CSI->ids; i < CSI->numIDs; container++, i++)
-		if (Q_streq(id, container->name))
-			return container;
-
-	return NULL;
+	return (const invDef_t *)IDT_Get(&CSI->idsByName, id);
 }
 
 /**
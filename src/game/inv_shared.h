@@ -231,6 +231,7 @@ typedef struct objDef_s {
 	char type[MAX_VAR];		/**< melee, rifle, ammo, armour. e.g. used in the ufopedia */
 	char armourPath[MAX_VAR];
 	uint32_t shape;			/**< The shape in inventory. */
+	uint32_t shapeRotated;	/**< The shape rotated by 90 degree to the left - calculated after parsing. */
 
 	float scale;			/**< scale value for images? and models */
 	vec3_t center;			/**< origin for models */
@@ -437,6 +438,9 @@ const invDef_t *INVSH_GetInventoryDefinitionByID(const char *id);
 const fireDef_t* FIRESH_GetFiredef(const objDef_t *obj, const weaponFireDefIndex_t weapFdsIdx, const fireDefIndex_t fdIdx);
 const fireDef_t *FIRESH_FiredefForWeapon(const item_t *item);
 #define FIRESH_IsMedikit(firedef) ((firedef)->damage[0] < 0)
+void INVSH_GetContainerMask(const inventory_t * const i, const invDef_t * container, const invList_t *ignoredItem, uint32_t *mask);
+qboolean INVSH_ShapeFitsMask(const uint32_t *mask, const uint32_t itemShape, const int x, const int y);
+qboolean INVSH_FindShapeInMask(const uint32_t *mask, const uint32_t itemShape, const uint32_t itemShapeRotated, int* const px, int* const py);
 void INVSH_MergeShapes(uint32_t *shape, const uint32_t itemShape, const int x, const int y);
 qboolean INVSH_CheckShape(const uint32_t *shape, const int x, const int y);
 int INVSH_ShapeSize(const uint32_t shape);
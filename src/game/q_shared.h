@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../shared/shared.h"
 #include "../shared/mathlib.h"
 #include "../shared/defines.h"
+#include "../shared/idtable.h"
 #include "../common/list.h"
 
 #include "inv_shared.h"
@@ -367,10 +368,12 @@ typedef struct csi_s {
 	/** Object definitions */
 	objDef_t ods[MAX_OBJDEFS];
 	int numODs;
+	idTable_t odsByID;	/**< ods by objDef_t::id */
 
 	/** Inventory definitions */
 	invDef_t ids[MAX_INVDEFS];
 	int numIDs;
+	idTable_t idsByName;	/**< ids by invDef_t::name */
 
 	/** Special container ids */
 	containerIndex_t idRight, idLeft, idExtension;
@@ -400,6 +403,7 @@ typedef struct csi_s {
 	/** team definitions */
 	teamDef_t teamDef[MAX_TEAMDEFS];
 	int numTeamDefs;
+	idTable_t teamDefByID;	/**< teamDef by teamDef_t::id */
 
 	/** the current assigned teams for this mission
 	 * @todo this does not belong here - this is only static data that is shared */
@@ -409,9 +413,11 @@ typedef struct csi_s {
 	/** character templates */
 	chrTemplate_t chrTemplates[MAX_CHARACTER_TEMPLATES];
 	int numChrTemplates;
+	idTable_t chrTemplatesByID;	/**< chrTemplates by chrTemplate_t::id */
 
 	ugv_t ugvs[MAX_UGV];
 	int numUGV;
+	idTable_t ugvsByID;	/**< ugvs by ugv_t::id */
 
 	gametype_t gts[MAX_GAMETYPES];
 	int numGTs;
@@ -419,6 +425,7 @@ typedef struct csi_s {
 	/** Map definitions */
 	mapDef_t mds[MAX_MAPDEFS];
 	int numMDs;
+	idTable_t mdsByID;	/**< mds by mapDef_t::id */
 } csi_t;
 
 extern csi_t csi;
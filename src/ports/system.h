@@ -65,6 +65,7 @@ void Sys_Mkfifo(const char *ospath, struct qFILE_s *f);
 char *Sys_Cwd(void);
 void Sys_SetAffinityAndPriority(void);
 int Sys_Milliseconds(void);
+uint64_t Sys_Nanoseconds(void);
 void Sys_Backtrace(void);
 
 
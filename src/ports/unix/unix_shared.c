@@ -54,6 +54,25 @@ int Sys_Milliseconds (void)
 	return (tp.tv_sec - secbase) * 1000 + tp.tv_usec / 1000;
 }
 
+/**
+ * @brief High resolution monotonic clock for timing measurements
+ * @note Only differences of two values are meaningful
+ */
+uint64_t Sys_Nanoseconds (void)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec tp;
+
+	clock_gettime(CLOCK_MONOTONIC, &tp);
+	return (uint64_t)tp.tv_sec * 1000000000 + tp.tv_nsec;
+#else
+	struct timeval tp;
+
+	gettimeofday(&tp, NULL);
+	return (uint64_t)tp.tv_sec * 1000000000 + tp.tv_usec * 1000;
+#endif
+}
+
 /**
  * @brief set/unset environment variables (empty value removes it)
  */
@@ -44,6 +44,23 @@ int Sys_Milliseconds (void)
 	return timeGetTime() - base;
 }
 
+/**
+ * @brief High resolution monotonic clock for timing measurements
+ * @note Only differences of two values are meaningful
+ */
+uint64_t Sys_Nanoseconds (void)
+{
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	if (!frequency.QuadPart)
+		QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000
+		+ (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+}
+
 void Sys_Mkdir (const char *path)
 {
 	_mkdir(path);
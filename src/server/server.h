@@ -76,6 +76,7 @@ typedef struct pending_event_s {
 typedef struct {
 	qboolean initialized;		/**< sv_init has completed */
 	int realtime;				/**< always increasing, no clamping, etc */
+	int frameTime;				/**< duration of the last server frame in microseconds */
 	struct datagram_socket *netDatagramSocket;
 	struct client_s *clients;	/**< [sv_maxclients->value]; */
 	int lastHeartbeat;			/**< time where the last heartbeat was send to the master server
@@ -182,6 +183,7 @@ int SV_CountPlayers(void);
 void SV_InitOperatorCommands(void);
 void SV_UserinfoChanged(client_t *cl);
 void SV_ReadPacket(struct net_stream *s);
+void SV_ConnectClient(struct net_stream *stream, char *userinfo, size_t userinfoSize, const char *peername);
 char *SV_GetConfigString(int index);
 int SV_GetConfigStringInteger(int index);
 char *SV_SetConfigString(int index, ...);
@@ -195,10 +197,32 @@ void SV_MapcycleInit(void);
 void SV_NextMapcycle(void);
 void SV_MapcycleClear(void);
 
+#ifdef DEDICATED_ONLY
+/* sv_masterserver.c */
+void SV_MasterserverInit(void);
+qboolean SV_MasterserverActive(void);
+void SV_MasterserverFrame(int now);
+void SV_MasterserverShutdown(void);
+
+/* sv_record.c */
+void SV_RecordInit(void);
+void SV_RecordStart(qboolean day, const char *levelstring, const char *assembly);
+void SV_RecordStop(void);
+void SV_RecordFrame(int now);
+void SV_RecordFrameEnd(void);
+void SV_RecordConnect(const client_t *cl, struct net_stream *stream, const char *userinfo, const char *peername);
+void SV_RecordClientMessage(const client_t *cl, int cmd, const struct dbuffer *msg);
+void SV_RecordDisconnect(const client_t *cl, const char *message);
+int SV_GetGameSeed(void);
+qboolean SV_ReplayActive(void);
+#endif
+
 /* sv_init.c */
 void SV_Map(qboolean day, const char *levelstring, const char *assembly);
 
 void SV_Multicast(int mask, struct dbuffer *msg);
+void SV_QueueEvent(int mask, const struct dbuffer *msg);
+void SV_FlushEvents(void);
 void SV_ClientCommand(client_t *client, const char *fmt, ...) __attribute__((format(printf,2,3)));
 void SV_ClientPrintf(client_t * cl, int level, const char *fmt, ...) __attribute__((format(printf,3,4)));
 void SV_BroadcastPrintf(int level, const char *fmt, ...) __attribute__((format(printf,2,3)));
@@ -30,6 +30,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "server.h"
 #include "../common/http.h"
+#include "sv_rma.h"
 
 void SV_Heartbeat_f (void)
 {
@@ -50,7 +51,7 @@ void SV_SetMaster_f (void)
 	Cvar_Set("public", "1");
 
 	Com_Printf("Master server at [%s] - sending a ping\n", masterserver_url->string);
-	HTTP_GetURL(va("%s/ufo/masterserver.php?ping&port=%s", masterserver_url->string, port->string), NULL);
+	HTTP_GetURLAsync(va("%s/ufo/masterserver.php?ping&port=%s", masterserver_url->string, port->string), NULL, NULL, 0);
 
 	if (!sv_dedicated->integer)
 		return;
@@ -134,6 +135,13 @@ static void SV_Map_f (void)
 	char bufAssembly[MAX_TOKEN_CHARS * MAX_TILESTRINGS];
 	qboolean day;
 
+#ifdef DEDICATED_ONLY
+	if (SV_MasterserverActive()) {
+		Com_Printf("This server runs in masterserver mode and can't host matches\n");
+		return;
+	}
+#endif
+
 	if (Cmd_Argc() < 3) {
 		Com_Printf("Usage: %s <day|night> <mapname> [<assembly>]\n", Cmd_Argv(0));
 		Com_Printf("Use 'maplist' to get a list of all installed maps\n");
@@ -463,6 +471,98 @@ static void SV_ListMaps_f (void)
 	Com_Printf("-----\n %i installed maps\n+name means random map assembly\n", fs_numInstalledMaps + 1);
 }
 
+/**
+ * @brief Assembles the given random map with every assembly and seed and loads it to
+ * fill the routing cache
+ * @param[in] name The name of the ump file (without the leading +)
+ * @param[in] numSeeds The amount of seeds (starting at 0) to try for assemblies that don't have a seedlist
+ * @param[out] mapData Scratch space for the map loading
+ * @param[out] mapTiles Scratch space for the map loading
+ * @return The amount of loaded assemblies
+ */
+static int SV_PrebuildRoutingCache (const char *name, int numSeeds, mapData_t *mapData, mapTiles_t *mapTiles)
+{
+	mapInfo_t *map = Mem_AllocType(mapInfo_t);
+	int i, cnt = 0;
+
+	SV_ParseUMP(name, map, qfalse);
+
+	for (i = 0; i < map->numAssemblies; i++) {
+		const mAssembly_t *mAsm = &map->mAssembly[i];
+		/* with a seedlist the seed is used as index into the list */
+		const int seeds = mAsm->numSeeds > 0 ? mAsm->numSeeds : numSeeds;
+		int seed;
+
+		for (seed = 0; seed < seeds; seed++) {
+			char asmMap[MAX_TOKEN_CHARS * MAX_TILESTRINGS];
+			char asmPos[MAX_TOKEN_CHARS * MAX_TILESTRINGS];
+			mapInfo_t *randomMap;
+
+			asmMap[0] = asmPos[0] = '\0';
+			randomMap = SV_AssembleMapWithSeed(name, mAsm->id, asmMap, asmPos, seed);
+			if (!randomMap) {
+				Com_Printf("Could not assemble '%s' of map '%s' with seed %i\n", mAsm->id, name, seed);
+				continue;
+			}
+			Mem_Free(randomMap);
+			if (asmPos[0] == '\0')
+				continue;
+
+			CM_LoadMap(asmMap, qtrue, asmPos, mapData, mapTiles);
+			cnt++;
+		}
+	}
+
+	Mem_Free(map);
+	return cnt;
+}
+
+/**
+ * @brief Fills the routing cache for the given (or all) random maps
+ * @note Only allowed while no map is running because the collision data of the running
+ * map would be replaced
+ * @sa CM_LoadMap
+ */
+static void SV_PrebuildRoutingCache_f (void)
+{
+	const int numSeeds = Cmd_Argc() > 2 ? atoi(Cmd_Argv(2)) : RMA_RANDOM_SEEDS;
+	mapData_t *mapData;
+	mapTiles_t *mapTiles;
+	int cnt = 0;
+
+	if (Com_ServerState()) {
+		Com_Printf("The routing cache can only be built while no map is running\n");
+		return;
+	}
+
+	if (!CM_RoutingCacheEnabled()) {
+		Com_Printf("The routing cache is disabled - see cm_routingcache\n");
+		return;
+	}
+
+	mapData = (mapData_t *)Mem_PoolAlloc(sizeof(*mapData), sv_genericPool, 0);
+	mapTiles = (mapTiles_t *)Mem_PoolAlloc(sizeof(*mapTiles), sv_genericPool, 0);
+
+	if (Cmd_Argc() > 1 && Cmd_Argv(1)[0] != '*') {
+		const char *name = Cmd_Argv(1);
+		cnt = SV_PrebuildRoutingCache(name[0] == '+' ? name + 1 : name, numSeeds, mapData, mapTiles);
+	} else {
+		int i;
+
+		FS_GetMaps(qfalse);
+		for (i = 0; i <= fs_numInstalledMaps; i++) {
+			if (fs_maps[i][0] != '+')
+				continue;
+			cnt += SV_PrebuildRoutingCache(fs_maps[i] + 1, numSeeds, mapData, mapTiles);
+		}
+	}
+
+	Mem_Free(mapData);
+	Mem_Free(mapTiles);
+
+	Com_Printf("Loaded %i assemblies into the routing cache\n", cnt);
+}
+
 /**
  * @brief List for SV_CompleteServerCommand
  * @sa ServerCommand
@@ -594,6 +694,7 @@ void SV_InitOperatorCommands (void)
 	Cmd_AddCommand("devmap", SV_Map_f, "Quit client and load the new map - deactivate the ai");
 	Cmd_AddParamCompleteFunction("devmap", SV_CompleteMapCommand);
 	Cmd_AddCommand("maplist", SV_ListMaps_f, "List of all available maps");
+	Cmd_AddCommand("sv_prebuildroutingcache", SV_PrebuildRoutingCache_f, "Assembles all random maps (or the given one) to fill the routing cache - usage: sv_prebuildroutingcache [<+map>|*] [<seeds>]");
 
 	Cmd_AddCommand("setmaster", SV_SetMaster_f, "Send ping command to masterserver (see cvar masterserver_url)");
 
@@ -329,8 +329,8 @@ static void SV_AbortEvents (void)
 		return;
 
 	p->pending = qfalse;
-	free_dbuffer(p->buf);
-	p->buf = NULL;
+	/* the buffer is reused for the next event */
+	dbuffer_remove(p->buf, dbuffer_len(p->buf));
 }
 
 /**
@@ -344,10 +344,10 @@ static void SV_EndEvents (void)
 		return;
 
 	NET_WriteByte(p->buf, EV_NULL);
-	SV_Multicast(p->playerMask, p->buf);
+	SV_QueueEvent(p->playerMask, p->buf);
 	p->pending = qfalse;
-	/* freed in SV_Multicast */
-	p->buf = NULL;
+	/* the buffer is reused for the next event */
+	dbuffer_remove(p->buf, dbuffer_len(p->buf));
 }
 
 typedef struct {
@@ -428,7 +428,8 @@ static void SV_AddEvent (unsigned int mask, int eType)
 	p->pending = qtrue;
 	p->playerMask = mask;
 	p->type = eType;
-	p->buf = new_dbuffer();
+	if (!p->buf)
+		p->buf = new_dbuffer();
 
 	/* write header */
 	NET_WriteByte(p->buf, svc_event);
@@ -635,6 +636,7 @@ void SV_RunGameFrame (void)
 	sv->endgame = svs.ge->RunFrame();
 	if (sv->state == ss_game_shutdown)
 		sv->endgame = qtrue;
+	SV_FlushEvents();
 }
 
 /**
@@ -743,7 +745,21 @@ void SV_InitGameProgs (void)
 	import.Cmd_Args = Cmd_Args;
 	import.AddCommandString = Cbuf_AddText;
 
+#ifdef PROF_ENABLED
+	import.ProfBegin = Prof_Begin;
+	import.ProfEnd = Prof_End;
+	import.ProfCount = Prof_Count;
+#else
+	import.ProfBegin = NULL;
+	import.ProfEnd = NULL;
+	import.ProfCount = NULL;
+#endif
+
+#ifdef DEDICATED_ONLY
+	import.seed = SV_GetGameSeed();
+#else
 	import.seed = Sys_Milliseconds();
+#endif
 	import.csi = &csi;
 
 	Com_Printf("setting game random seed to %i\n", import.seed);
@@ -87,6 +87,15 @@ static void SV_InitGame (void)
 	svs.clients = (client_t *)Mem_PoolAlloc(sizeof(client_t) * sv_maxclients->integer, sv_genericPool, 0);
 	svs.serverMutex = TH_MutexCreate("server");
 
+#ifdef DEDICATED_ONLY
+	if (SV_ReplayActive()) {
+		/* the clients of a replay are fed from the recording - there is no network */
+		svs.initialized = qtrue;
+		SV_InitGameProgs();
+		return;
+	}
+#endif
+
 	/* init network stuff */
 	if (sv_maxclients->integer > 1) {
 		svs.initialized = SV_Start(NULL, port->string, &SV_ReadPacket);
@@ -130,6 +139,10 @@ void SV_Map (qboolean day, const char *levelstring, const char *assembly)
 		return;
 	}
 
+#ifdef DEDICATED_ONLY
+	SV_RecordStart(day, levelstring, assembly);
+#endif
+
 	assert(levelstring[0] != '\0');
 
 	Com_DPrintf(DEBUG_SERVER, "SpawnServer: %s\n", levelstring);
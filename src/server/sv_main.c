@@ -138,8 +138,17 @@ client_t *SV_GetClient (int index)
  */
 void SV_DropClient (client_t * drop, const char *message)
 {
+	struct dbuffer *msg;
+
+#ifdef DEDICATED_ONLY
+	SV_RecordDisconnect(drop, message);
+#endif
+
+	/* the client should still get the events that happened before */
+	SV_FlushEvents();
+
 	/* add the disconnect */
-	struct dbuffer *msg = new_dbuffer();
+	msg = new_dbuffer();
 	NET_WriteByte(msg, svc_disconnect);
 	NET_WriteString(msg, message);
 	NET_WriteMsg(drop->stream, msg);
@@ -296,11 +305,7 @@ static void SVC_Info (struct net_stream *s)
 static void SVC_DirectConnect (struct net_stream *stream)
 {
 	char userinfo[MAX_INFO_STRING];
-	client_t *cl;
-	player_t *player;
-	int playernum;
 	int version;
-	qboolean connected;
 	char buf[256];
 	const char *peername = NET_StreamPeerToName(stream, buf, sizeof(buf), qfalse);
 
@@ -342,6 +347,24 @@ static void SVC_DirectConnect (struct net_stream *stream)
 	/* force the IP key/value pair so the game can filter based on ip */
 	Info_SetValueForKey(userinfo, sizeof(userinfo), "ip", peername);
 
+	SV_ConnectClient(stream, userinfo, sizeof(userinfo), peername);
+}
+
+/**
+ * @brief Accepts a new client on the given stream
+ * @param[in] stream The stream of the new client
+ * @param[in,out] userinfo The already validated userinfo of the client - the game might modify it
+ * @param[in] userinfoSize The size of the @c userinfo buffer
+ * @param[in] peername The address of the client
+ * @sa SVC_DirectConnect
+ */
+void SV_ConnectClient (struct net_stream *stream, char *userinfo, size_t userinfoSize, const char *peername)
+{
+	client_t *cl;
+	player_t *player;
+	int playernum;
+	qboolean connected;
+
 	/* find a client slot */
 	cl = NULL;
 	while ((cl = SV_GetNextClient(cl)) != NULL)
@@ -353,6 +376,13 @@ static void SVC_DirectConnect (struct net_stream *stream)
 		return;
 	}
 
+#ifdef DEDICATED_ONLY
+	SV_RecordConnect(cl, stream, userinfo, peername);
+#endif
+
+	/* don't send queued events of the previous client in this slot to the new one */
+	SV_FlushEvents();
+
 	/* build a new connection - accept the new client
 	 * this is the only place a client_t is ever initialized */
 	OBJZERO(*cl);
@@ -362,7 +392,7 @@ static void SVC_DirectConnect (struct net_stream *stream)
 	cl->player->num = playernum;
 
 	TH_MutexLock(svs.serverMutex);
-	connected = svs.ge->ClientConnect(player, userinfo, sizeof(userinfo));
+	connected = svs.ge->ClientConnect(player, userinfo, userinfoSize);
 	TH_MutexUnlock(svs.serverMutex);
 
 	/* get the game a chance to reject this connection or modify the userinfo */
@@ -517,23 +547,9 @@ void SV_ReadPacket (struct net_stream *s)
 
 #define	HEARTBEAT_SECONDS	30
 
-static SDL_Thread *masterServerHeartBeatThread;
-
 /**
  * @brief Send a message to the master every few minutes to
  * let it know we are alive, and log information
- */
-static int Master_HeartbeatThread (void * data)
-{
-	/* send to master */
-	Com_Printf("sending heartbeat\n");
-	HTTP_GetURL(va("%s/ufo/masterserver.php?heartbeat&port=%s", masterserver_url->string, port->string), NULL);
-
-	masterServerHeartBeatThread = NULL;
-	return 0;
-}
-
-/**
  * @sa CL_PingServers_f
  */
 static void Master_Heartbeat (void)
@@ -553,10 +569,9 @@ static void Master_Heartbeat (void)
 
 	svs.lastHeartbeat = svs.realtime;
 
-	if (masterServerHeartBeatThread != NULL)
-		SDL_WaitThread(masterServerHeartBeatThread, NULL);
-
-	masterServerHeartBeatThread = SDL_CreateThread(Master_HeartbeatThread, NULL);
+	/* send to master - don't block the frame if the masterserver is slow or unreachable */
+	Com_Printf("sending heartbeat\n");
+	HTTP_GetURLAsync(va("%s/ufo/masterserver.php?heartbeat&port=%s", masterserver_url->string, port->string), NULL, NULL, 0);
 }
 
 /**
@@ -669,6 +684,8 @@ static void SV_CheckTimeouts (void)
  */
 void SV_Frame (int now, void *data)
 {
+	uint64_t frameStart;
+
 	Com_ReadFromPipe();
 
 	/* change the gametype even if no server is running (e.g. the first time) */
@@ -686,6 +703,14 @@ void SV_Frame (int now, void *data)
 		} while (s);
 	}
 
+#ifdef DEDICATED_ONLY
+	/* the masterserver mode doesn't host any matches */
+	if (SV_MasterserverActive()) {
+		SV_MasterserverFrame(now);
+		return;
+	}
+#endif
+
 	/* if server is not active, do nothing */
 	if (!svs.initialized) {
 #ifdef DEDICATED_ONLY
@@ -695,7 +720,13 @@ void SV_Frame (int now, void *data)
 		return;
 	}
 
+	PROF_BEGIN(PROF_SV_FRAME);
+	frameStart = Sys_Nanoseconds();
+
 	svs.realtime = now;
+#ifdef DEDICATED_ONLY
+	SV_RecordFrame(now);
+#endif
 
 	/* keep the random time dependent */
 	rand();
@@ -711,8 +742,15 @@ void SV_Frame (int now, void *data)
 		SDL_CondSignal(svs.gameFrameCond);
 	SV_LogHandleOutput();
 
+	/* send the events that were generated by the client commands of this frame */
+	SV_FlushEvents();
+
 	/* next map in the cycle */
+#ifdef DEDICATED_ONLY
+	if (sv->endgame && sv_maxclients->integer > 1 && !SV_ReplayActive())
+#else
 	if (sv->endgame && sv_maxclients->integer > 1)
+#endif
 		SV_NextMapcycle();
 
 	/* send a heartbeat to the master if needed */
@@ -722,6 +760,12 @@ void SV_Frame (int now, void *data)
 	/* server is empty - so shutdown */
 	if (svs.abandon && svs.killserver)
 		SV_Shutdown("Server disconnected.", qfalse);
+
+	svs.frameTime = (Sys_Nanoseconds() - frameStart) / 1000;
+#ifdef DEDICATED_ONLY
+	SV_RecordFrameEnd();
+#endif
+	PROF_END(PROF_SV_FRAME);
 }
 
 /**
@@ -815,8 +859,14 @@ void SV_Init (void)
 	sv_reconnect_limit = Cvar_Get("sv_reconnect_limit", "3", CVAR_ARCHIVE, "Minimum seconds between connect messages");
 	sv_timeout = Cvar_Get("sv_timeout", "20", CVAR_ARCHIVE, "Seconds until a client times out");
 
+	CM_Init();
+
 	SV_MapcycleInit();
 	SV_LogInit();
+#ifdef DEDICATED_ONLY
+	SV_MasterserverInit();
+	SV_RecordInit();
+#endif
 }
 
 /**
@@ -827,8 +877,11 @@ void SV_Init (void)
 static void SV_FinalMessage (const char *message, qboolean reconnect)
 {
 	client_t *cl;
-	struct dbuffer *msg = new_dbuffer();
+	struct dbuffer *msg;
 
+	SV_FlushEvents();
+
+	msg = new_dbuffer();
 	if (reconnect)
 		NET_WriteByte(msg, svc_reconnect);
 	else
@@ -858,6 +911,9 @@ void SV_Clear (void)
 {
 	SV_MapcycleClear();
 	SV_LogShutdown();
+#ifdef DEDICATED_ONLY
+	SV_MasterserverShutdown();
+#endif
 }
 
 /**
@@ -873,6 +929,11 @@ void SV_Shutdown (const char *finalmsg, qboolean reconnect)
 	if (!svs.initialized)
 		return;
 
+#ifdef DEDICATED_ONLY
+	/* the recording ends with the match */
+	SV_RecordStop();
+#endif
+
 	if (svs.clients)
 		SV_FinalMessage(finalmsg, reconnect);
 
@@ -890,6 +951,11 @@ void SV_Shutdown (const char *finalmsg, qboolean reconnect)
 			Mem_Free(model->name);
 	}
 
+	/* the client streams are closed already - this just drops the queued events */
+	SV_FlushEvents();
+	if (sv->pendingEvent.buf)
+		free_dbuffer(sv->pendingEvent.buf);
+
 	/* free current level */
 	OBJZERO(*sv);
 
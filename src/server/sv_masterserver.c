@@ -0,0 +1,397 @@
+/**
+ * @file sv_masterserver.c
+ * @brief Native masterserver mode for the dedicated server
+ * @note Speaks the same http protocol as the php masterserver (tools/masterserver) - that
+ * is @c heartbeat, @c ping, @c shutdown, @c query and @c ip - but keeps the server list in
+ * memory. Start it with <tt>ufoded +set sv_masterserver 1</tt> and point the
+ * @c masterserver_url of the clients and game servers to it.
+ */
+
+/*
+ All original material Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+ See the GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ */
+
+#include "server.h"
+
+#define MAX_MASTER_ENTRIES 4096
+#define MASTER_HASH_SIZE 512
+/** @brief Longest http request header we accept */
+#define MAX_MASTER_REQUEST 2048
+/** @brief Interval in milliseconds in which timed out servers are removed */
+#define MASTER_EXPIRE_INTERVAL 1000
+
+/**
+ * @brief A game server that announced itself to the masterserver
+ */
+typedef struct masterEntry_s {
+	qboolean inuse;
+	char node[64];			/**< numeric ip of the game server */
+	int port;
+	int lastHeartbeat;		/**< Sys_Milliseconds of the last ping or heartbeat */
+	struct masterEntry_s *hashNext;
+} masterEntry_t;
+
+static cvar_t *sv_masterserver;
+static cvar_t *sv_masterserver_port;
+static cvar_t *sv_masterserver_timeout;
+
+static qboolean masterRunning;
+static masterEntry_t masterEntries[MAX_MASTER_ENTRIES];
+static masterEntry_t *masterHash[MASTER_HASH_SIZE];
+static int masterNumEntries;
+static int masterLastExpire;
+
+/** @brief The answer to the @c query action - rebuilt only if the list changed */
+static char *masterList;
+static size_t masterListLength;
+static qboolean masterListDirty = qtrue;
+
+static inline unsigned int SV_MasterHash (const char *node, int port)
+{
+	return (Com_HashKey(node, MASTER_HASH_SIZE) + port) % MASTER_HASH_SIZE;
+}
+
+static masterEntry_t *SV_MasterFind (const char *node, int port)
+{
+	masterEntry_t *entry;
+
+	for (entry = masterHash[SV_MasterHash(node, port)]; entry; entry = entry->hashNext)
+		if (entry->port == port && Q_streq(entry->node, node))
+			return entry;
+
+	return NULL;
+}
+
+static void SV_MasterRemove (masterEntry_t *entry)
+{
+	masterEntry_t **anchor;
+
+	for (anchor = &masterHash[SV_MasterHash(entry->node, entry->port)]; *anchor; anchor = &(*anchor)->hashNext) {
+		if (*anchor == entry) {
+			*anchor = entry->hashNext;
+			break;
+		}
+	}
+
+	OBJZERO(*entry);
+	masterNumEntries--;
+	masterListDirty = qtrue;
+}
+
+/**
+ * @brief Adds the server to the list or refreshes its heartbeat
+ */
+static void SV_MasterUpdate (const char *node, int port)
+{
+	masterEntry_t *entry = SV_MasterFind(node, port);
+	unsigned int hash;
+	int i;
+
+	if (entry) {
+		entry->lastHeartbeat = Sys_Milliseconds();
+		return;
+	}
+
+	for (i = 0; i < MAX_MASTER_ENTRIES; i++)
+		if (!masterEntries[i].inuse)
+			break;
+
+	if (i == MAX_MASTER_ENTRIES) {
+		Com_Printf("Masterserver list is full - ignoring %s %i\n", node, port);
+		return;
+	}
+
+	entry = &masterEntries[i];
+	entry->inuse = qtrue;
+	Q_strncpyz(entry->node, node, sizeof(entry->node));
+	entry->port = port;
+	entry->lastHeartbeat = Sys_Milliseconds();
+
+	hash = SV_MasterHash(node, port);
+	entry->hashNext = masterHash[hash];
+	masterHash[hash] = entry;
+
+	masterNumEntries++;
+	masterListDirty = qtrue;
+	Com_DPrintf(DEBUG_SERVER, "Masterserver: added %s %i\n", node, port);
+}
+
+/**
+ * @brief Drops all servers that didn't send a heartbeat within @c sv_masterserver_timeout seconds
+ */
+static void SV_MasterExpire (int now)
+{
+	const int timeout = sv_masterserver_timeout->integer * 1000;
+	int i;
+
+	for (i = 0; i < MAX_MASTER_ENTRIES; i++) {
+		masterEntry_t *entry = &masterEntries[i];
+		if (entry->inuse && now - entry->lastHeartbeat > timeout) {
+			Com_DPrintf(DEBUG_SERVER, "Masterserver: %s %i timed out\n", entry->node, entry->port);
+			SV_MasterRemove(entry);
+		}
+	}
+}
+
+/**
+ * @brief Returns the server list in the format the php masterserver uses: the amount
+ * of servers in the first line, followed by one <tt>ip port</tt> line per server
+ */
+static const char *SV_MasterGetList (size_t *length)
+{
+	if (masterListDirty) {
+		const size_t size = MAX_VAR + masterNumEntries * (sizeof(masterEntries[0].node) + 8);
+		char *pos;
+		int i;
+
+		if (masterList)
+			Mem_Free(masterList);
+		masterList = (char *)Mem_Alloc(size);
+
+		Com_sprintf(masterList, size, "%i\n", masterNumEntries);
+		pos = masterList + strlen(masterList);
+		for (i = 0; i < MAX_MASTER_ENTRIES; i++) {
+			const masterEntry_t *entry = &masterEntries[i];
+			if (!entry->inuse)
+				continue;
+			Com_sprintf(pos, size - (pos - masterList), "%s %i\n", entry->node, entry->port);
+			pos += strlen(pos);
+		}
+		masterListLength = pos - masterList;
+		masterListDirty = qfalse;
+	}
+
+	*length = masterListLength;
+	return masterList;
+}
+
+/**
+ * @brief Sends the http answer and closes the stream once it is written
+ */
+static void SV_MasterReply (struct net_stream *s, const char *status, const char *body, size_t length)
+{
+	char header[256];
+
+	Com_sprintf(header, sizeof(header), "HTTP/1.0 %s\r\nContent-Type: text/plain\r\nContent-Length: %i\r\nConnection: close\r\n\r\n",
+			status, (int)length);
+	NET_StreamEnqueue(s, header, strlen(header));
+	NET_StreamEnqueue(s, body, length);
+	NET_StreamFinished(s);
+}
+
+/**
+ * @brief Searches the given parameter in the query string of the request
+ * @param[in] query The query string (the part behind the '?' of the url)
+ * @param[in] name The parameter to search
+ * @param[out] value The value of the parameter - empty if it has none
+ * @return @c true if the parameter was given
+ */
+static qboolean SV_MasterGetParam (const char *query, const char *name, char *value, size_t valueLength)
+{
+	const size_t nameLength = strlen(name);
+
+	while (*query != '\0') {
+		const char *end = strchr(query, '&');
+		if (!end)
+			end = query + strlen(query);
+
+		if (!strncmp(query, name, nameLength) && (query + nameLength == end || query[nameLength] == '=')) {
+			const char *v = query + nameLength;
+			size_t len;
+			if (*v == '=')
+				v++;
+			len = min((size_t)(end - v), valueLength - 1);
+			memcpy(value, v, len);
+			value[len] = '\0';
+			return qtrue;
+		}
+
+		query = *end == '&' ? end + 1 : end;
+	}
+
+	value[0] = '\0';
+	return qfalse;
+}
+
+/**
+ * @brief Handles a complete http request
+ * @param[in] s The stream to answer on
+ * @param[in] request The request header - only the request line is evaluated
+ */
+static void SV_MasterExecute (struct net_stream *s, char *request)
+{
+	char node[64];
+	char value[16];
+	const char *query;
+	const char *peer;
+	char *end;
+	int port;
+
+	/* only the request line is of interest: GET /ufo/masterserver.php?action&port=x HTTP/1.1 */
+	end = strpbrk(request, "\r\n");
+	if (end)
+		*end = '\0';
+	if (strncmp(request, "GET ", 4)) {
+		SV_MasterReply(s, "405 Method Not Allowed", "", 0);
+		return;
+	}
+	end = strchr(request + 4, ' ');
+	if (end)
+		*end = '\0';
+	query = strchr(request + 4, '?');
+	query = query ? query + 1 : "";
+
+	peer = NET_StreamPeerToName(s, node, sizeof(node), qfalse);
+	if (peer != node)
+		Q_strncpyz(node, peer, sizeof(node));
+	/* report ipv4 clients of a dual stack socket with their ipv4 address */
+	if (!strncmp(node, "::ffff:", 7))
+		memmove(node, node + 7, strlen(node + 7) + 1);
+
+	port = PORT_SERVER;
+	if (SV_MasterGetParam(query, "port", value, sizeof(value))) {
+		port = atoi(value);
+		if (port <= 0 || port > 0xFFFF)
+			port = PORT_SERVER;
+	}
+
+	if (SV_MasterGetParam(query, "heartbeat", value, sizeof(value))
+	 || SV_MasterGetParam(query, "ping", value, sizeof(value))) {
+		SV_MasterUpdate(node, port);
+		SV_MasterReply(s, "200 OK", "", 0);
+	} else if (SV_MasterGetParam(query, "shutdown", value, sizeof(value))) {
+		masterEntry_t *entry = SV_MasterFind(node, port);
+		if (entry)
+			SV_MasterRemove(entry);
+		SV_MasterReply(s, "200 OK", "", 0);
+	} else if (SV_MasterGetParam(query, "query", value, sizeof(value))) {
+		size_t length;
+		const char *list = SV_MasterGetList(&length);
+		SV_MasterReply(s, "200 OK", list, length);
+	} else if (SV_MasterGetParam(query, "ip", value, sizeof(value))) {
+		SV_MasterReply(s, "200 OK", node, strlen(node));
+	} else {
+		const char *invalid = "Masterserver query: Invalid command";
+		SV_MasterReply(s, "200 OK", invalid, strlen(invalid));
+	}
+}
+
+/**
+ * @brief Stream callback for the masterserver socket
+ * @note Waits until the whole request header arrived
+ * @sa SV_Start
+ */
+static void SV_MasterReadRequest (struct net_stream *s)
+{
+	char request[MAX_MASTER_REQUEST];
+	int length;
+
+	if (NET_StreamIsClosed(s))
+		return;
+
+	length = NET_StreamPeek(s, request, sizeof(request) - 1);
+	request[length] = '\0';
+
+	if (!strstr(request, "\r\n\r\n") && !strstr(request, "\n\n")) {
+		if (length == sizeof(request) - 1)
+			SV_MasterReply(s, "413 Request Entity Too Large", "", 0);
+		/* otherwise wait for the rest of the header */
+		return;
+	}
+
+	SV_MasterExecute(s, request);
+}
+
+/**
+ * @return @c true if this dedicated server answers masterserver requests instead of hosting matches
+ */
+qboolean SV_MasterserverActive (void)
+{
+	return masterRunning;
+}
+
+/**
+ * @brief Called every server frame while in masterserver mode
+ * @sa SV_Frame
+ */
+void SV_MasterserverFrame (int now)
+{
+	if (now - masterLastExpire < MASTER_EXPIRE_INTERVAL)
+		return;
+
+	masterLastExpire = now;
+	SV_MasterExpire(now);
+}
+
+static void SV_MasterserverList_f (void)
+{
+	const int now = Sys_Milliseconds();
+	int i;
+
+	Com_Printf("%i servers\n", masterNumEntries);
+	for (i = 0; i < MAX_MASTER_ENTRIES; i++) {
+		const masterEntry_t *entry = &masterEntries[i];
+		if (entry->inuse)
+			Com_Printf("%-40s %5i (last heartbeat %is ago)\n", entry->node, entry->port, (now - entry->lastHeartbeat) / 1000);
+	}
+}
+
+/**
+ * @brief Starts listening for masterserver requests if @c sv_masterserver is set
+ * @note @c sv_masterserver can only be set from the commandline - the dedicated server
+ * doesn't host any matches in this mode
+ * @sa SV_Init
+ */
+void SV_MasterserverInit (void)
+{
+	sv_masterserver = Cvar_Get("sv_masterserver", "0", CVAR_NOSET, "Run the dedicated server as masterserver");
+	sv_masterserver_port = Cvar_Get("sv_masterserver_port", "80", CVAR_NOSET, "The http port the masterserver listens on");
+	sv_masterserver_timeout = Cvar_Get("sv_masterserver_timeout", "620", 0, "Seconds until a server without heartbeat is removed from the masterserver list");
+
+	if (!sv_masterserver->integer)
+		return;
+
+	if (!SV_Start(NULL, sv_masterserver_port->string, &SV_MasterReadRequest))
+		Com_Error(ERR_FATAL, "Could not start the masterserver on port %s", sv_masterserver_port->string);
+
+	masterRunning = qtrue;
+	masterLastExpire = Sys_Milliseconds();
+	Cmd_AddCommand("sv_masterserverlist", SV_MasterserverList_f, "Shows the servers that are registered at this masterserver");
+	Com_Printf("Masterserver listening on port %s\n", sv_masterserver_port->string);
+}
+
+/**
+ * @sa SV_Clear
+ */
+void SV_MasterserverShutdown (void)
+{
+	if (!masterRunning)
+		return;
+
+	SV_Stop();
+	Cmd_RemoveCommand("sv_masterserverlist");
+	if (masterList)
+		Mem_Free(masterList);
+	masterList = NULL;
+	masterListDirty = qtrue;
+	OBJZERO(masterEntries);
+	OBJZERO(masterHash);
+	masterNumEntries = 0;
+	masterRunning = qfalse;
+}
@@ -0,0 +1,717 @@
+/**
+ * @file sv_record.c
+ * @brief Records the client input of a match and replays it without network
+ * @note A recording holds the game seed, the cvars, the map and every client message and
+ * server frame in the order the server processed them. Everything the server sent to the
+ * clients is recorded, too - a replay feeds the client messages back at full speed and
+ * compares its own output byte by byte against the recorded one.
+ * @note Start a recording with <tt>sv_record <name></tt> before the map is started and replay it
+ * with <tt>ufoded +sv_replay <name></tt>. The replaying server needs the same scripts and maps.
+ */
+
+/*
+ All original material Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+ See the GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ */
+
+#include "server.h"
+
+#define RECORD_MAGIC "ufosvrec"
+#define RECORD_VERSION 1
+
+/**
+ * @brief The records of a recording
+ * @note Every record is stored like a network message - the length followed by the data
+ */
+typedef enum {
+	REC_HEADER,		/**< magic, version, protocol, seed, day, map, assembly and the cvars */
+	REC_FRAME,		/**< start of a server frame with its time */
+	REC_FRAMETIME,	/**< duration of the server frame in microseconds */
+	REC_CONNECT,	/**< client slot, userinfo and peername of a new client */
+	REC_MESSAGE,	/**< client slot, command and data of a client message */
+	REC_OUTPUT,		/**< client slot and data that was sent to a client */
+	REC_DISCONNECT	/**< client slot and reason of a dropped client */
+} recordType_t;
+
+/** @brief Frame time histogram buckets in microseconds */
+static const int frameTimeBuckets[] = {100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000};
+
+typedef struct frameHistogram_s {
+	int counts[lengthof(frameTimeBuckets) + 1];
+	int frames;
+	int maxTime;
+	double totalTime;
+} frameHistogram_t;
+
+/** @brief Output comparison of one client during the replay */
+typedef struct replayClient_s {
+	struct net_stream *stream;
+	struct dbuffer *expected;	/**< recorded output that wasn't compared yet */
+	struct dbuffer *produced;	/**< replayed output that wasn't compared yet */
+	size_t offset;				/**< bytes that were already compared */
+	qboolean diverged;
+} replayClient_t;
+
+static char recordPending[MAX_QPATH];
+static qFILE recordFile;
+static int recordSeed;
+static struct net_stream *recordStreams[MAX_CLIENTS];
+
+static qboolean replayActive;
+static int replaySeed;
+static int replayFrame;
+static replayClient_t replayClients[MAX_CLIENTS];
+
+/**
+ * @brief Writes a record and frees it
+ */
+static void SV_RecordWrite (struct dbuffer *buf)
+{
+	char tmp[4096];
+	const int len = LittleLong(dbuffer_len(buf));
+
+	FS_Write(&len, sizeof(len), &recordFile);
+	while (dbuffer_len(buf)) {
+		const int extracted = dbuffer_extract(buf, tmp, sizeof(tmp));
+		FS_Write(tmp, extracted, &recordFile);
+	}
+
+	free_dbuffer(buf);
+}
+
+static inline qboolean SV_RecordActive (void)
+{
+	return recordFile.f != NULL;
+}
+
+/**
+ * @brief Records everything the server sends to a client
+ * @sa NET_StreamSetTap
+ */
+static void SV_RecordOutput (struct net_stream *s, const char *data, int len)
+{
+	int i;
+
+	if (!SV_RecordActive())
+		return;
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (recordStreams[i] == s) {
+			struct dbuffer *buf = new_dbuffer();
+			NET_WriteByte(buf, REC_OUTPUT);
+			NET_WriteByte(buf, i);
+			dbuffer_add(buf, data, len);
+			SV_RecordWrite(buf);
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Returns the random seed for the game library
+ * @note A replay has to use the seed of the recorded match
+ * @sa SV_InitGameProgs
+ */
+int SV_GetGameSeed (void)
+{
+	if (replayActive)
+		return replaySeed;
+
+	recordSeed = Sys_Milliseconds();
+	return recordSeed;
+}
+
+/**
+ * @brief Starts the recording that was requested with @c sv_record
+ * @note Called after the game was initialized, but before the map is assembled
+ * @sa SV_Map
+ */
+void SV_RecordStart (qboolean day, const char *levelstring, const char *assembly)
+{
+	const cvar_t *var;
+	struct dbuffer *buf;
+	char filename[MAX_OSPATH];
+	int numCvars;
+
+	if (recordPending[0] == '\0' || replayActive)
+		return;
+
+	Com_sprintf(filename, sizeof(filename), "recordings/%s.rec", recordPending);
+	recordPending[0] = '\0';
+
+	FS_OpenFile(filename, &recordFile, FILE_WRITE);
+	if (!SV_RecordActive()) {
+		Com_Printf("Could not open %s for writing\n", filename);
+		return;
+	}
+
+	OBJZERO(recordStreams);
+
+	buf = new_dbuffer();
+	NET_WriteByte(buf, REC_HEADER);
+	NET_WriteString(buf, RECORD_MAGIC);
+	NET_WriteLong(buf, RECORD_VERSION);
+	NET_WriteLong(buf, PROTOCOL_VERSION);
+	NET_WriteLong(buf, recordSeed);
+	NET_WriteByte(buf, day);
+	NET_WriteString(buf, levelstring);
+	NET_WriteString(buf, assembly ? assembly : "");
+
+	numCvars = 0;
+	for (var = Cvar_GetFirst(); var; var = var->next)
+		if (!(var->flags & CVAR_NOSET))
+			numCvars++;
+	NET_WriteLong(buf, numCvars);
+	for (var = Cvar_GetFirst(); var; var = var->next) {
+		if (var->flags & CVAR_NOSET)
+			continue;
+		NET_WriteString(buf, var->name);
+		NET_WriteString(buf, var->string);
+	}
+
+	SV_RecordWrite(buf);
+
+	Com_Printf("Recording the match to %s\n", filename);
+}
+
+/**
+ * @sa SV_Shutdown
+ */
+void SV_RecordStop (void)
+{
+	int i;
+
+	if (!SV_RecordActive())
+		return;
+
+	for (i = 0; i < MAX_CLIENTS; i++)
+		NET_StreamSetTap(recordStreams[i], NULL);
+	OBJZERO(recordStreams);
+
+	FS_CloseFile(&recordFile);
+	recordFile.f = NULL;
+	Com_Printf("Recording stopped\n");
+}
+
+/**
+ * @sa SV_Frame
+ */
+void SV_RecordFrame (int now)
+{
+	struct dbuffer *buf;
+
+	if (!SV_RecordActive())
+		return;
+
+	buf = new_dbuffer();
+	NET_WriteByte(buf, REC_FRAME);
+	NET_WriteLong(buf, now);
+	SV_RecordWrite(buf);
+}
+
+/**
+ * @brief Records the time the frame took on the recording server
+ * @sa SV_Frame
+ */
+void SV_RecordFrameEnd (void)
+{
+	struct dbuffer *buf;
+
+	if (!SV_RecordActive())
+		return;
+
+	buf = new_dbuffer();
+	NET_WriteByte(buf, REC_FRAMETIME);
+	NET_WriteLong(buf, svs.frameTime);
+	SV_RecordWrite(buf);
+}
+
+/**
+ * @note Called before the game had a chance to modify the userinfo
+ * @sa SV_ConnectClient
+ */
+void SV_RecordConnect (const client_t *cl, struct net_stream *stream, const char *userinfo, const char *peername)
+{
+	const int slot = cl - SV_GetClient(0);
+	struct dbuffer *buf;
+	int i;
+
+	if (!SV_RecordActive())
+		return;
+
+	/* a stream of a dropped client might be at the same address now */
+	for (i = 0; i < MAX_CLIENTS; i++)
+		if (recordStreams[i] == stream)
+			recordStreams[i] = NULL;
+
+	buf = new_dbuffer();
+	NET_WriteByte(buf, REC_CONNECT);
+	NET_WriteByte(buf, slot);
+	NET_WriteString(buf, userinfo);
+	NET_WriteString(buf, peername);
+	SV_RecordWrite(buf);
+
+	recordStreams[slot] = stream;
+	NET_StreamSetTap(stream, SV_RecordOutput);
+}
+
+/**
+ * @note The command was already read from @c msg - the rest is recorded as it is
+ * @sa SV_ExecuteClientMessage
+ */
+void SV_RecordClientMessage (const client_t *cl, int cmd, const struct dbuffer *msg)
+{
+	struct dbuffer *buf;
+	char tmp[4096];
+	size_t pos;
+
+	if (!SV_RecordActive())
+		return;
+
+	buf = new_dbuffer();
+	NET_WriteByte(buf, REC_MESSAGE);
+	NET_WriteByte(buf, cl - SV_GetClient(0));
+	NET_WriteByte(buf, cmd);
+	for (pos = 0; pos < dbuffer_len(msg);) {
+		const size_t len = dbuffer_get_at(msg, pos, tmp, sizeof(tmp));
+		dbuffer_add(buf, tmp, len);
+		pos += len;
+	}
+	SV_RecordWrite(buf);
+}
+
+/**
+ * @brief Records a dropped client
+ * @note Drops that a client message caused are replayed by that message already, but
+ * timeouts, kicks and closed streams happen outside of the recorded client messages
+ * @sa SV_DropClient
+ */
+void SV_RecordDisconnect (const client_t *cl, const char *message)
+{
+	struct dbuffer *buf;
+
+	if (!SV_RecordActive())
+		return;
+
+	buf = new_dbuffer();
+	NET_WriteByte(buf, REC_DISCONNECT);
+	NET_WriteByte(buf, cl - SV_GetClient(0));
+	NET_WriteString(buf, message);
+	SV_RecordWrite(buf);
+}
+
+static void SV_Record_f (void)
+{
+	if (Cmd_Argc() != 2) {
+		Com_Printf("Usage: %s <name>\n", Cmd_Argv(0));
+		return;
+	}
+
+	/* neither the threaded game frame nor the parallel map assembly are deterministic */
+	if (sv_threads->integer) {
+		Com_Printf("Set sv_threads to 0 to record a match\n");
+		return;
+	}
+
+	Q_strncpyz(recordPending, Cmd_Argv(1), sizeof(recordPending));
+	if (svs.initialized)
+		Com_Printf("The recording starts with the next map\n");
+	else
+		Com_Printf("The recording starts with the map\n");
+}
+
+static void SV_StopRecord_f (void)
+{
+	recordPending[0] = '\0';
+	if (!SV_RecordActive())
+		Com_Printf("Not recording\n");
+	SV_RecordStop();
+}
+
+/*
+==============================================================================
+REPLAY
+==============================================================================
+*/
+
+qboolean SV_ReplayActive (void)
+{
+	return replayActive;
+}
+
+/**
+ * @brief Collects the output of the replayed server
+ * @sa NET_StreamSetTap
+ */
+static void SV_ReplayOutput (struct net_stream *s, const char *data, int len)
+{
+	int i;
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (replayClients[i].stream == s) {
+			dbuffer_add(replayClients[i].produced, data, len);
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Compares the output of the replay with the recorded output as far as both are available
+ */
+static void SV_ReplayCompare (replayClient_t *client, int slot)
+{
+	char expected[4096];
+	char produced[4096];
+
+	while (!client->diverged) {
+		const size_t len = min(min(dbuffer_len(client->expected), dbuffer_len(client->produced)), sizeof(expected));
+		size_t i;
+
+		if (len == 0)
+			return;
+
+		dbuffer_extract(client->expected, expected, len);
+		dbuffer_extract(client->produced, produced, len);
+
+		for (i = 0; i < len; i++) {
+			if (expected[i] != produced[i]) {
+				Com_Printf("Output for client %i differs at byte "UFO_SIZE_T" in frame %i\n", slot, client->offset + i, replayFrame);
+				client->diverged = qtrue;
+				break;
+			}
+		}
+		client->offset += len;
+	}
+}
+
+/**
+ * @brief Extracts the next record from the recording
+ * @return @c NULL at the end of the recording
+ */
+static struct dbuffer *SV_ReplayNextRecord (struct dbuffer *recording)
+{
+	char tmp[4096];
+	struct dbuffer *buf;
+	int len;
+
+	if (dbuffer_len(recording) < 4)
+		return NULL;
+
+	len = NET_ReadLong(recording);
+	if (len < 0 || len > dbuffer_len(recording)) {
+		Com_Printf("The recording is truncated\n");
+		return NULL;
+	}
+
+	buf = new_dbuffer();
+	while (len > 0) {
+		const int extracted = dbuffer_extract(recording, tmp, min(len, sizeof(tmp)));
+		dbuffer_add(buf, tmp, extracted);
+		len -= extracted;
+	}
+
+	return buf;
+}
+
+/**
+ * @brief Reads the client slot of a record
+ * @return @c -1 if the slot is out of range - the recording is corrupt then
+ */
+static int SV_ReplayReadSlot (struct dbuffer *buf)
+{
+	const int slot = NET_ReadByte(buf);
+
+	if (slot < 0 || slot >= MAX_CLIENTS) {
+		Com_Printf("Invalid client slot %i in frame %i\n", slot, replayFrame);
+		return -1;
+	}
+
+	return slot;
+}
+
+static void SV_ReplayAddFrameTime (frameHistogram_t *histogram, int usec)
+{
+	int i;
+
+	for (i = 0; i < lengthof(frameTimeBuckets); i++)
+		if (usec < frameTimeBuckets[i])
+			break;
+
+	histogram->counts[i]++;
+	histogram->frames++;
+	histogram->totalTime += usec;
+	histogram->maxTime = max(histogram->maxTime, usec);
+}
+
+static void SV_ReplayPrintHistograms (const frameHistogram_t *recorded, const frameHistogram_t *replayed)
+{
+	int i;
+
+	Com_Printf("frame time     recorded   replayed\n");
+	for (i = 0; i <= lengthof(frameTimeBuckets); i++) {
+		char label[32];
+		if (i < lengthof(frameTimeBuckets))
+			Com_sprintf(label, sizeof(label), "< %.2fms", frameTimeBuckets[i] / 1000.0f);
+		else
+			Com_sprintf(label, sizeof(label), ">= %.2fms", frameTimeBuckets[i - 1] / 1000.0f);
+		Com_Printf("%-12s %10i %10i\n", label, recorded->counts[i], replayed->counts[i]);
+	}
+	Com_Printf("%-12s %10.3f %10.3f\n", "mean ms", recorded->totalTime / 1000.0 / max(recorded->frames, 1),
+			replayed->totalTime / 1000.0 / max(replayed->frames, 1));
+	Com_Printf("%-12s %10.3f %10.3f\n", "max ms", recorded->maxTime / 1000.0f, replayed->maxTime / 1000.0f);
+}
+
+/**
+ * @brief Reads the header of a recording and applies its cvars
+ * @return @c false if the recording can't be replayed with this server
+ */
+static qboolean SV_ReplayParseHeader (struct dbuffer *buf, qboolean *day, char *levelstring, size_t levelLength, char *assembly, size_t assemblyLength)
+{
+	char magic[16];
+	int version, protocol, numCvars;
+
+	if (NET_ReadByte(buf) != REC_HEADER) {
+		Com_Printf("This is not a server recording\n");
+		return qfalse;
+	}
+
+	NET_ReadString(buf, magic, sizeof(magic));
+	version = NET_ReadLong(buf);
+	protocol = NET_ReadLong(buf);
+	if (!Q_streq(magic, RECORD_MAGIC) || version != RECORD_VERSION) {
+		Com_Printf("Unsupported recording version\n");
+		return qfalse;
+	}
+	if (protocol != PROTOCOL_VERSION) {
+		Com_Printf("The recording was made with protocol %i, this server speaks %i\n", protocol, PROTOCOL_VERSION);
+		return qfalse;
+	}
+
+	replaySeed = NET_ReadLong(buf);
+	*day = NET_ReadByte(buf);
+	NET_ReadString(buf, levelstring, levelLength);
+	NET_ReadString(buf, assembly, assemblyLength);
+
+	numCvars = NET_ReadLong(buf);
+	while (numCvars-- > 0) {
+		char name[MAX_VAR];
+		char value[MAX_STRING_CHARS];
+		const cvar_t *var;
+
+		NET_ReadString(buf, name, sizeof(name));
+		NET_ReadString(buf, value, sizeof(value));
+
+		/* the replay runs without network and threads */
+		if (Q_streq(name, "port") || Q_streq(name, "sv_public") || Q_streq(name, "sv_threads"))
+			continue;
+		var = Cvar_FindVar(name);
+		if (var && (var->flags & CVAR_NOSET))
+			continue;
+		Cvar_ForceSet(name, value);
+	}
+
+	Cvar_ForceSet("sv_threads", "0");
+	Cvar_ForceSet("sv_public", "0");
+
+	return qtrue;
+}
+
+/**
+ * @brief Feeds the events of a recording to the server as fast as possible
+ * @note Commands the game adds to the command buffer are executed after the replay
+ */
+static void SV_Replay_f (void)
+{
+	frameHistogram_t recorded, replayed;
+	char levelstring[MAX_QPATH];
+	char assembly[MAX_QPATH];
+	struct dbuffer *recording;
+	struct dbuffer *buf;
+	qboolean day, corrupt;
+	byte *data;
+	int size, i, diverged;
+	uint64_t replayStart;
+
+	if (Cmd_Argc() != 2) {
+		Com_Printf("Usage: %s <name>\n", Cmd_Argv(0));
+		return;
+	}
+
+	if (svs.initialized) {
+		Com_Printf("Shut down the running server first\n");
+		return;
+	}
+
+	size = FS_LoadFile(va("recordings/%s.rec", Cmd_Argv(1)), &data);
+	if (size <= 0) {
+		Com_Printf("Could not load the recording %s\n", Cmd_Argv(1));
+		return;
+	}
+	recording = new_dbuffer();
+	dbuffer_add(recording, (const char *)data, size);
+	FS_FreeFile(data);
+
+	buf = SV_ReplayNextRecord(recording);
+	if (!buf || !SV_ReplayParseHeader(buf, &day, levelstring, sizeof(levelstring), assembly, sizeof(assembly))) {
+		free_dbuffer(buf);
+		free_dbuffer(recording);
+		return;
+	}
+	free_dbuffer(buf);
+
+	OBJZERO(recorded);
+	OBJZERO(replayed);
+	OBJZERO(replayClients);
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		replayClients[i].expected = new_dbuffer();
+		replayClients[i].produced = new_dbuffer();
+	}
+	replayFrame = 0;
+	replayActive = qtrue;
+	corrupt = qfalse;
+
+	Com_Printf("Replaying %s on map %s\n", Cmd_Argv(1), levelstring);
+	SV_Map(day, levelstring, assembly[0] != '\0' ? assembly : NULL);
+
+	replayStart = Sys_Nanoseconds();
+	while (!corrupt && svs.initialized && (buf = SV_ReplayNextRecord(recording)) != NULL) {
+		const recordType_t type = NET_ReadByte(buf);
+		switch (type) {
+		case REC_FRAME:
+			SV_Frame(NET_ReadLong(buf), NULL);
+			SV_ReplayAddFrameTime(&replayed, svs.frameTime);
+			replayFrame++;
+			break;
+		case REC_FRAMETIME:
+			SV_ReplayAddFrameTime(&recorded, NET_ReadLong(buf));
+			break;
+		case REC_CONNECT: {
+			char userinfo[MAX_INFO_STRING];
+			char peername[256];
+			const int slot = SV_ReplayReadSlot(buf);
+			replayClient_t *client;
+
+			if (slot == -1) {
+				corrupt = qtrue;
+				break;
+			}
+			client = &replayClients[slot];
+
+			NET_ReadString(buf, userinfo, sizeof(userinfo));
+			NET_ReadString(buf, peername, sizeof(peername));
+
+			client->stream = NET_StreamNewDetached();
+			NET_StreamSetTap(client->stream, SV_ReplayOutput);
+			SV_ConnectClient(client->stream, userinfo, sizeof(userinfo), peername);
+			break;
+		}
+		case REC_MESSAGE: {
+			const int slot = SV_ReplayReadSlot(buf);
+			const int cmd = NET_ReadByte(buf);
+			client_t *cl;
+
+			if (slot == -1) {
+				corrupt = qtrue;
+				break;
+			}
+			cl = SV_GetClient(slot);
+			if (slot >= sv_maxclients->integer || cl->state == cs_free)
+				Com_Printf("Recorded message for the unconnected client %i in frame %i\n", slot, replayFrame);
+			else
+				SV_ExecuteClientMessage(cl, cmd, buf);
+			break;
+		}
+		case REC_OUTPUT: {
+			char tmp[4096];
+			const int slot = SV_ReplayReadSlot(buf);
+
+			if (slot == -1) {
+				corrupt = qtrue;
+				break;
+			}
+			while (dbuffer_len(buf)) {
+				const int len = dbuffer_extract(buf, tmp, sizeof(tmp));
+				dbuffer_add(replayClients[slot].expected, tmp, len);
+			}
+			break;
+		}
+		case REC_DISCONNECT: {
+			char message[MAX_STRING_CHARS];
+			const int slot = SV_ReplayReadSlot(buf);
+			client_t *cl;
+
+			if (slot == -1) {
+				corrupt = qtrue;
+				break;
+			}
+			NET_ReadString(buf, message, sizeof(message));
+			/* a drop that a replayed client message caused already happened */
+			cl = SV_GetClient(slot);
+			if (slot < sv_maxclients->integer && cl->state != cs_free)
+				SV_DropClient(cl, message);
+			break;
+		}
+		default:
+			Com_Printf("Unknown record type %i in frame %i\n", type, replayFrame);
+			break;
+		}
+		free_dbuffer(buf);
+
+		for (i = 0; i < MAX_CLIENTS; i++)
+			SV_ReplayCompare(&replayClients[i], i);
+	}
+
+	Com_Printf("Replayed %i frames in %.3fs\n", replayFrame, (Sys_Nanoseconds() - replayStart) / 1000000000.0);
+	SV_ReplayPrintHistograms(&recorded, &replayed);
+
+	diverged = 0;
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		replayClient_t *client = &replayClients[i];
+		if (!client->diverged && dbuffer_len(client->expected) != dbuffer_len(client->produced)) {
+			Com_Printf("Output for client %i differs in length: "UFO_SIZE_T" recorded bytes left, "UFO_SIZE_T" replayed bytes left\n",
+					i, dbuffer_len(client->expected), dbuffer_len(client->produced));
+			client->diverged = qtrue;
+		}
+		if (client->diverged)
+			diverged++;
+		free_dbuffer(client->expected);
+		free_dbuffer(client->produced);
+	}
+	OBJZERO(replayClients);
+
+	if (corrupt)
+		Com_Printf("Replay FAILED: the recording is corrupt\n");
+	else if (diverged)
+		Com_Printf("Replay FAILED: the output of %i clients differs from the recording\n", diverged);
+	else
+		Com_Printf("Replay OK: the output matches the recording\n");
+
+	SV_Shutdown("Replay finished", qfalse);
+	replayActive = qfalse;
+	free_dbuffer(recording);
+}
+
+/**
+ * @sa SV_Init
+ */
+void SV_RecordInit (void)
+{
+	Cmd_AddCommand("sv_record", SV_Record_f, "Records the next match for sv_replay - usage: sv_record <name>");
+	Cmd_AddCommand("sv_stoprecord", SV_StopRecord_f, "Stops the recording of the match");
+	Cmd_AddCommand("sv_replay", SV_Replay_f, "Replays a recorded match without network and compares the output - usage: sv_replay <name>");
+}
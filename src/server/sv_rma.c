@@ -1935,7 +1935,7 @@ static int cmpTileAreaSize (const void * a, const void * b)
 }
 #endif
 
-static mapInfo_t* SV_DoMapAssemble (mapInfo_t *map, const char *assembly, char *asmMap, char *asmPos, const unsigned int seed)
+static mapInfo_t* SV_DoMapAssemble (mapInfo_t *map, const char *assembly, char *asmMap, char *asmPos, const int seed)
 {
 	int i;
 	mAssembly_t *mAsm = &map->mAssembly[map->mAsm];
@@ -1981,7 +1981,7 @@ static mapInfo_t* SV_DoMapAssemble (mapInfo_t *map, const char *assembly, char *
 		if (mAsm->numSeeds > 0) {
 			/* if the map has a seedlist defined, use that */
 			seedUsed = mAsm->seeds[rand() % mAsm->numSeeds];
-			if (seed) {
+			if (seed >= 0) {
 				/* if a seed was passed, we are in cunit test mode */
 				if (seed >= mAsm->numSeeds)
 					/* if the given seed is outside the seedlist, assume that we already tested it and pretend that it's ok */
@@ -1992,10 +1992,10 @@ static mapInfo_t* SV_DoMapAssemble (mapInfo_t *map, const char *assembly, char *
 			Com_Printf("Picked seed: %i for <%s>\n", seedUsed, assembly);
 		} else {
 			/* no seedlist */
-			if (seed)
+			if (seed >= 0)
 				seedUsed = seed;
 			else
-				seedUsed = rand() % 50;	/* limit the possible seeds to (testable) values between 0 and 49 */
+				seedUsed = rand() % RMA_RANDOM_SEEDS;
 		}
 		Com_SetRandomSeed(seedUsed);
 		Com_Printf("Using RMA%i seed: %i for <%s>\n", sv_rma->integer, seedUsed, assembly);
@@ -2005,7 +2005,7 @@ static mapInfo_t* SV_DoMapAssemble (mapInfo_t *map, const char *assembly, char *
 			if (mAsm->numSeeds > 0) {
 				/* if we are allowed to restart the search with a fixed seed
 				 * from the assembly definition, do so */
-				Com_SetRandomSeed(mAsm->seeds[seed % mAsm->numSeeds]);
+				Com_SetRandomSeed(mAsm->seeds[max(seed, 0) % mAsm->numSeeds]);
 				return SV_DoMapAssemble(map, assembly, asmMap, asmPos, seed);
 			}
 			return NULL;
@@ -2035,15 +2035,13 @@ static mapInfo_t* SV_DoMapAssemble (mapInfo_t *map, const char *assembly, char *
  * Each of the map tiles in this string has a corresponding entry in the pos string, too.
  * @param[out] asmPos The pos string for the assembly. For each tile from the @c asmMap
  * string this string contains three coordinates for shifting the given tile names.
- * @param[in] seed random seed to use (for cunit tests). If 0, the called functions can use their own seed setting.
- * @sa B_AssembleMap_f
- * @sa SV_AddTile
- * @sa SV_AddMandatoryParts
- * @sa SV_ParseAssembly
- * @sa SV_ParseMapTile
+ * @param[in] seed The index into the seedlist of the assembly or the seed for assemblies
+ * without a seedlist. If -1, the called functions can use their own seed setting.
+ * @sa SV_AssembleMap
+ * @sa SV_PrebuildRoutingCache
  * @note Make sure to free the returned pointer
  */
-mapInfo_t* SV_AssembleMap (const char *name, const char *assembly, char *asmMap, char *asmPos, const unsigned int seed)
+mapInfo_t* SV_AssembleMapWithSeed (const char *name, const char *assembly, char *asmMap, char *asmPos, const int seed)
 {
 	mapInfo_t *map;
 
@@ -2087,3 +2085,27 @@ mapInfo_t* SV_AssembleMap (const char *name, const char *assembly, char *asmMap,
 
 	return map;
 }
+
+/**
+ * @brief Assembles a "random" map
+ * and parses the *.ump files for assembling the "random" maps and places the 'fixed' tiles.
+ * For a more detailed description of the whole algorithm see SV_AddMapTiles.
+ * @param[in] name The name of the map (ump) file to parse
+ * @param[in] assembly The random map assembly that should be used from the given rma
+ * @param[out] asmMap The output string of the random map assembly that contains all the
+ * map tiles that should be assembled. The order is the same as in the @c asmPos string.
+ * Each of the map tiles in this string has a corresponding entry in the pos string, too.
+ * @param[out] asmPos The pos string for the assembly. For each tile from the @c asmMap
+ * string this string contains three coordinates for shifting the given tile names.
+ * @param[in] seed random seed to use (for cunit tests). If 0, the called functions can use their own seed setting.
+ * @sa B_AssembleMap_f
+ * @sa SV_AddTile
+ * @sa SV_AddMandatoryParts
+ * @sa SV_ParseAssembly
+ * @sa SV_ParseMapTile
+ * @note Make sure to free the returned pointer
+ */
+mapInfo_t* SV_AssembleMap (const char *name, const char *assembly, char *asmMap, char *asmPos, const unsigned int seed)
+{
+	return SV_AssembleMapWithSeed(name, assembly, asmMap, asmPos, seed ? (int)seed : -1);
+}
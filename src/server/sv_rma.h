@@ -54,6 +54,8 @@ typedef struct mTileSet_s {
 } mTileSet_t;
 
 #define MAX_ASSEMBLY_SEEDS 32
+/** @brief Assemblies without a seedlist pick a random seed below this (testable) limit */
+#define RMA_RANDOM_SEEDS 50
 
 /**
  * @brief Stores the parsed data of an assembly definition.
@@ -136,6 +138,7 @@ typedef struct mapInfo_s {
 } mapInfo_t;
 
 mapInfo_t* SV_AssembleMap(const char *name, const char *assembly, char *asmMap, char *asmPos, const unsigned int seed);
+mapInfo_t* SV_AssembleMapWithSeed(const char *name, const char *assembly, char *asmMap, char *asmPos, const int seed);
 
 /* the next two functions are only exported for cunits tests */
 void SV_ParseUMP(const char *name, mapInfo_t *map, qboolean inherit);
@@ -34,6 +34,126 @@ EVENT MESSAGES
 =============================================================================
 */
 
+/** @brief Consecutive events for the same players - stored back to back in @c eventData */
+typedef struct eventRun_s {
+	int playerMask;
+	int start;		/**< offset of the first event in @c eventData */
+	int length;		/**< length of all events of this run including their length headers */
+} eventRun_t;
+
+#define MAX_EVENT_RUNS 64
+
+/** @brief The events that were not yet sent to the clients - already in the stream
+ * format (length header and message). The block is shared by the streams of all the
+ * clients that get the events, none of them gets a copy.
+ * @sa SV_QueueEvent
+ * @sa SV_FlushEvents */
+static struct net_shared *eventData;
+static int eventDataLength;
+/** @brief size of the last event block - the next one starts with it */
+static size_t eventDataSize;
+static eventRun_t eventRuns[MAX_EVENT_RUNS];
+static int numEventRuns;
+
+/**
+ * @brief Queues an event message for the given players. The queued events are sent with
+ * @c SV_FlushEvents, which is called once per frame and before any other message is sent
+ * to a client to keep the order of the messages.
+ * @param[in] mask Bitmask of the players to send the event to
+ * @param[in] msg The event message - the buffer is not freed
+ * @sa SV_Multicast
+ */
+void SV_QueueEvent (int mask, const struct dbuffer *msg)
+{
+	const int msgLength = dbuffer_len(msg);
+	const int length = LittleLong(msgLength);
+	eventRun_t *run;
+	char *data;
+	int pos;
+
+	if (numEventRuns > 0 && eventRuns[numEventRuns - 1].playerMask == mask) {
+		run = &eventRuns[numEventRuns - 1];
+	} else {
+		if (numEventRuns == MAX_EVENT_RUNS)
+			SV_FlushEvents();
+		run = &eventRuns[numEventRuns++];
+		run->playerMask = mask;
+		run->start = eventDataLength;
+		run->length = 0;
+	}
+
+	/* the block of the last frame belongs to the client streams now - start the new one
+	 * with the size of the last one */
+	if (!eventData)
+		eventData = NET_SharedNew(eventDataSize);
+	if (eventDataLength + msgLength + sizeof(length) > NET_SharedGetSize(eventData)) {
+		eventDataSize = max(eventDataSize * 2, eventDataLength + msgLength + sizeof(length));
+		eventData = NET_SharedResize(eventData, eventDataSize);
+	}
+
+	data = NET_SharedGetData(eventData);
+	memcpy(data + eventDataLength, &length, sizeof(length));
+	eventDataLength += sizeof(length);
+	for (pos = 0; pos < msgLength;)
+		pos += dbuffer_get_at(msg, pos, data + eventDataLength + pos, msgLength - pos);
+	eventDataLength += msgLength;
+
+	run->length += msgLength + sizeof(length);
+}
+
+/**
+ * @brief Sends all queued events to the clients
+ * @note Runs that follow each other and are both sent to a client are written to its
+ * stream in one go. The streams only reference the shared event block, which is freed
+ * when the last of them has sent it.
+ * @sa SV_QueueEvent
+ */
+void SV_FlushEvents (void)
+{
+	client_t *cl;
+	int j;
+
+	TH_MutexLock(svs.serverMutex);
+
+	if (numEventRuns == 0) {
+		TH_MutexUnlock(svs.serverMutex);
+		return;
+	}
+
+	cl = NULL;
+	j = -1;
+	while ((cl = SV_GetNextClient(cl)) != NULL) {
+		int i, start = -1, end = 0;
+
+		j++;
+		if (cl->state < cs_connected)
+			continue;
+
+		for (i = 0; i < numEventRuns; i++) {
+			const eventRun_t *run = &eventRuns[i];
+			if (!(run->playerMask & (1 << j)))
+				continue;
+			if (start != -1 && end != run->start) {
+				NET_StreamEnqueueShared(cl->stream, eventData, start, end - start);
+				start = -1;
+			}
+			if (start == -1)
+				start = run->start;
+			end = run->start + run->length;
+		}
+
+		if (start != -1)
+			NET_StreamEnqueueShared(cl->stream, eventData, start, end - start);
+	}
+
+	NET_SharedRelease(eventData);
+	eventData = NULL;
+	numEventRuns = 0;
+	eventDataLength = 0;
+
+	TH_MutexUnlock(svs.serverMutex);
+}
+
 /**
  * @sa SV_BroadcastCommand
  */
@@ -41,8 +161,11 @@ void SV_ClientCommand (client_t *client, const char *fmt, ...)
 {
 	va_list ap;
 	char str[1024];
-	struct dbuffer *msg = new_dbuffer();
+	struct dbuffer *msg;
+
+	SV_FlushEvents();
 
+	msg = new_dbuffer();
 	NET_WriteByte(msg, svc_stufftext);
 
 	va_start(ap, fmt);
@@ -64,6 +187,8 @@ void SV_ClientPrintf (client_t * cl, int level, const char *fmt, ...)
 	if (level > cl->messagelevel)
 		return;
 
+	SV_FlushEvents();
+
 	msg = new_dbuffer();
 	NET_WriteByte(msg, svc_print);
 	NET_WriteByte(msg, level);
@@ -85,6 +210,8 @@ void SV_BroadcastPrintf (int level, const char *fmt, ...)
 	client_t *cl;
 	char str[1024];
 
+	SV_FlushEvents();
+
 	msg = new_dbuffer();
 	NET_WriteByte(msg, svc_print);
 	NET_WriteByte(msg, level);
@@ -132,6 +259,11 @@ void SV_Multicast (int mask, struct dbuffer *msg)
 	client_t *cl;
 	int j;
 
+	PROF_BEGIN(PROF_SV_MULTICAST);
+
+	/* keep the order of the messages */
+	SV_FlushEvents();
+
 	/* send the data to all relevant clients */
 	cl = NULL;
 	j = -1;
@@ -144,7 +276,10 @@ void SV_Multicast (int mask, struct dbuffer *msg)
 
 		/* write the message */
 		NET_WriteConstMsg(cl->stream, msg);
+		PROF_COUNT(PROF_COUNTER_MULTICAST_BYTES, dbuffer_len(msg));
 	}
 
 	free_dbuffer(msg);
+
+	PROF_END(PROF_SV_MULTICAST);
 }
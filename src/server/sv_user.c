@@ -72,6 +72,7 @@ static void SV_New_f (client_t *cl)
 
 	/* serverdata needs to go over for all types of servers
 	 * to make sure the protocol is right, and to set the gamedir */
+	SV_FlushEvents();
 
 	/* send the serverdata */
 	{
@@ -236,6 +237,10 @@ void SV_ExecuteClientMessage (client_t * cl, int cmd, struct dbuffer *msg)
 	if (cmd == -1)
 		return;
 
+#ifdef DEDICATED_ONLY
+	SV_RecordClientMessage(cl, cmd, msg);
+#endif
+
 	switch (cmd) {
 	default:
 		Com_Printf("SV_ExecuteClientMessage: unknown command char '%d'\n", cmd);
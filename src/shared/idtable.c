@@ -0,0 +1,200 @@
+/**
+ * @file idtable.c
+ * @brief Id lookup tables of the script definitions
+ * @note Open addressing hash tables without any memory allocation, they
+ * can live in the structures of the definitions they are indexing (e.g. csi_t)
+ */
+
+/*
+Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "idtable.h"
+#include "shared.h"
+
+#ifdef __GNUC__
+/* the lookups can run in the client and in the server thread at once */
+#define IDT_Count(var) ((void)__sync_fetch_and_add(&(var), 1))
+#else
+#define IDT_Count(var) ((var)++)
+#endif
+
+/**
+ * @brief Case sensitive string hash (FNV-1a)
+ */
+static inline unsigned int IDT_HashKey (const char *id)
+{
+	unsigned int hash = 2166136261u;
+
+	while (*id) {
+		hash ^= (byte)*id++;
+		hash *= 16777619u;
+	}
+
+	return hash & (IDTABLE_SIZE - 1);
+}
+
+/**
+ * @brief Adds a definition to the table
+ * @param[in,out] table The table to add the definition to
+ * @param[in] id The id of the definition, the string is not copied
+ * @param[in] data The definition
+ * @return @c false if the id is already in the table (the first definition is kept)
+ * or if the table is full, @c true otherwise
+ */
+qboolean IDT_Add (idTable_t *table, const char *id, void *data)
+{
+	unsigned int hash = IDT_HashKey(id);
+	idTableSlot_t *freeSlot = NULL;
+	int i;
+
+	assert(data);
+
+	for (i = 0; i < IDTABLE_SIZE; i++) {
+		idTableSlot_t *slot = &table->slots[hash];
+		if (slot->id == NULL) {
+			if (freeSlot == NULL)
+				freeSlot = slot;
+			break;
+		}
+		if (slot->data == NULL) {
+			/* removed entry - can be reused, but the id might follow */
+			if (freeSlot == NULL)
+				freeSlot = slot;
+		} else if (Q_streq(slot->id, id)) {
+			return qfalse;
+		}
+		hash = (hash + 1) & (IDTABLE_SIZE - 1);
+	}
+
+	if (freeSlot == NULL)
+		return qfalse;
+
+	freeSlot->id = id;
+	freeSlot->data = data;
+	table->numEntries++;
+	return qtrue;
+}
+
+/**
+ * @brief Removes a definition from the table
+ * @param[in,out] table The table to remove the definition from
+ * @param[in] id The id of the definition
+ * @param[in] data The definition, only an entry pointing to it is removed
+ */
+void IDT_Remove (idTable_t *table, const char *id, const void *data)
+{
+	unsigned int hash = IDT_HashKey(id);
+	int i;
+
+	for (i = 0; i < IDTABLE_SIZE; i++) {
+		idTableSlot_t *slot = &table->slots[hash];
+		if (slot->id == NULL)
+			return;
+		if (slot->data == data && Q_streq(slot->id, id)) {
+			/* keep the id to not break the probe sequence of other entries */
+			slot->data = NULL;
+			table->numEntries--;
+			return;
+		}
+		hash = (hash + 1) & (IDTABLE_SIZE - 1);
+	}
+}
+
+/**
+ * @brief Searches a definition by its id
+ * @param[in] table The table to search in - it is not changed, so the lookup is safe to
+ * be used from several threads at once. Only the counters of the table are updated.
+ * @param[in] id The id of the definition
+ * @return The definition, or @c NULL if nothing was found
+ * @note The table doesn't own the definitions, that's why they are not const
+ */
+void *IDT_Get (const idTable_t *table, const char *id)
+{
+	idTableCounters_t *counters = table->counters;
+	unsigned int hash = IDT_HashKey(id);
+	int i;
+
+	if (counters)
+		IDT_Count(counters->numLookups);
+
+	for (i = 0; i < IDTABLE_SIZE; i++) {
+		const idTableSlot_t *slot = &table->slots[hash];
+		if (slot->id == NULL)
+			break;
+		if (slot->data != NULL && Q_streq(slot->id, id))
+			return slot->data;
+		hash = (hash + 1) & (IDTABLE_SIZE - 1);
+	}
+
+	if (counters)
+		IDT_Count(counters->numMisses);
+	return NULL;
+}
+
+/**
+ * @brief Removes all the entries of a table, the counters are kept
+ */
+void IDT_Clear (idTable_t *table)
+{
+	OBJZERO(table->slots);
+	table->numEntries = 0;
+}
+
+/**
+ * @brief Calculates how many slots the lookups of the entries of a table have to compare
+ * @param[in] table The table to get the statistics for
+ * @param[out] stats The probe lengths of the table
+ */
+void IDT_GetStats (const idTable_t *table, idTableStats_t *stats)
+{
+	int i, numProbes = 0;
+
+	OBJZERO(*stats);
+	for (i = 0; i < IDTABLE_SIZE; i++) {
+		const idTableSlot_t *slot = &table->slots[i];
+		int probes;
+
+		if (slot->id == NULL)
+			continue;
+		if (slot->data == NULL) {
+			stats->numRemoved++;
+			continue;
+		}
+
+		probes = ((i - IDT_HashKey(slot->id)) & (IDTABLE_SIZE - 1)) + 1;
+		if (probes > stats->maxProbes)
+			stats->maxProbes = probes;
+		numProbes += probes;
+	}
+
+	if (table->numEntries > 0)
+		stats->avgProbes = (float)numProbes / table->numEntries;
+}
+
+/**
+ * @brief Lets the lookups of a table count into the given counters
+ * @param[in,out] table The table to count the lookups of
+ * @param[in] counters The counters, or @c NULL to stop counting. They have to live as
+ * long as the table.
+ */
+void IDT_SetCounters (idTable_t *table, idTableCounters_t *counters)
+{
+	table->counters = counters;
+}
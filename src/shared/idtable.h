@@ -0,0 +1,72 @@
+/**
+ * @file idtable.h
+ * @brief Header for the id lookup tables of the script definitions
+ */
+
+/*
+ Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+ See the GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ */
+
+#ifndef IDTABLE_H
+#define IDTABLE_H
+
+#include "ufotypes.h"
+
+/** @brief Number of slots of an id table, must be a power of two and
+ * at least twice the size of the biggest definition array */
+#define IDTABLE_SIZE 256
+
+typedef struct idTableSlot_s {
+	const char *id;		/**< id of the definition - not copied, it must live as long as the definition */
+	void *data;			/**< the definition, @c NULL if the entry was removed */
+} idTableSlot_t;
+
+/**
+ * @brief Lookup counters of a table - see IDT_SetCounters
+ * @note They are not part of the table, so a lookup doesn't change the table
+ */
+typedef struct idTableCounters_s {
+	int numLookups;
+	int numMisses;
+} idTableCounters_t;
+
+/**
+ * @brief Maps script ids to definitions. A zeroed table is a valid empty table.
+ */
+typedef struct idTable_s {
+	idTableSlot_t slots[IDTABLE_SIZE];
+	int numEntries;
+	idTableCounters_t *counters;	/**< @c NULL if the lookups are not counted */
+} idTable_t;
+
+/** @brief The probe lengths of a table - see IDT_GetStats */
+typedef struct idTableStats_s {
+	int numRemoved;		/**< slots of removed entries that still lengthen the probe sequences */
+	int maxProbes;		/**< the most slots that are compared to find an entry */
+	float avgProbes;	/**< the average amount of slots that are compared to find an entry */
+} idTableStats_t;
+
+qboolean IDT_Add(idTable_t *table, const char *id, void *data);
+void IDT_Remove(idTable_t *table, const char *id, const void *data);
+void *IDT_Get(const idTable_t *table, const char *id);
+void IDT_Clear(idTable_t *table);
+void IDT_GetStats(const idTable_t *table, idTableStats_t *stats);
+void IDT_SetCounters(idTable_t *table, idTableCounters_t *counters);
+
+#endif
@@ -300,53 +300,47 @@ static void readMem(png_struct* const png, png_byte* const dst, png_size_t const
 	}
 }
 
-static SDL_Surface* Img_LoadPNG(char const* const name)
+static SDL_Surface* Img_DecodePNG(byte* const buf, size_t const len)
 {
 	SDL_Surface* res = 0;
-	size_t       len;
-	byte         *buf;
-	if ((buf = readFile(name, "png", &len))) {
-		png_struct* png;
-		if ((png = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0))) {
-			png_info* info = png_create_info_struct(png);
-			if (info) {
-				bufState_t state = { buf, buf + len };
-				png_set_read_fn(png, &state, &readMem);
-
-				png_read_info(png, info);
-
-				png_uint_32 height;
-				png_uint_32 width;
-				int         bit_depth;
-				int         color_type;
-				png_get_IHDR(png, info, &width, &height, &bit_depth, &color_type, 0, 0, 0);
-
-				/* Ensure that we always get a RGBA image with 8 bits per channel. */
-				png_set_gray_to_rgb(png);
-				png_set_strip_16(png);
-				png_set_packing(png);
-				png_set_expand(png);
-				png_set_add_alpha(png, 255, PNG_FILLER_AFTER);
-
-				SDL_Surface* s;
-				if ((s = createSurface(height, width))) {
-					png_start_read_image(png);
-
-					png_byte*    dst   = (png_byte*)(s->pixels);
-					size_t const pitch = s->pitch;
-					for (size_t n = height; n != 0; dst += pitch, --n) {
-						png_read_row(png, dst, 0);
-					}
-
-					png_read_end(png, info);
-					res = s;
+	png_struct* png;
+	if ((png = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0))) {
+		png_info* info = png_create_info_struct(png);
+		if (info) {
+			bufState_t state = { buf, buf + len };
+			png_set_read_fn(png, &state, &readMem);
+
+			png_read_info(png, info);
+
+			png_uint_32 height;
+			png_uint_32 width;
+			int         bit_depth;
+			int         color_type;
+			png_get_IHDR(png, info, &width, &height, &bit_depth, &color_type, 0, 0, 0);
+
+			/* Ensure that we always get a RGBA image with 8 bits per channel. */
+			png_set_gray_to_rgb(png);
+			png_set_strip_16(png);
+			png_set_packing(png);
+			png_set_expand(png);
+			png_set_add_alpha(png, 255, PNG_FILLER_AFTER);
+
+			SDL_Surface* s;
+			if ((s = createSurface(height, width))) {
+				png_start_read_image(png);
+
+				png_byte*    dst   = (png_byte*)(s->pixels);
+				size_t const pitch = s->pitch;
+				for (size_t n = height; n != 0; dst += pitch, --n) {
+					png_read_row(png, dst, 0);
 				}
-			}
 
-			png_destroy_read_struct(&png, &info, 0);
+				png_read_end(png, info);
+				res = s;
+			}
 		}
 
-		FS_FreeFile(buf);
+		png_destroy_read_struct(&png, &info, 0);
 	}
 
 	return res;
@@ -380,66 +374,77 @@ static void djepg_skip_input_data(jpeg_decompress_struct* const cinfo, long cons
 }
 #endif
 
-static SDL_Surface* Img_LoadJPG(char const* const name)
+static SDL_Surface* Img_DecodeJPG(byte* const buf, size_t const len)
 {
 	SDL_Surface* res = 0;
-	size_t       len;
-	byte         *buf;
-	if ((buf = readFile(name, "jpg", &len)) != NULL) {
-		jpeg_decompress_struct cinfo;
-		jpeg_error_mgr         jerr;
+	jpeg_decompress_struct cinfo;
+	jpeg_error_mgr         jerr;
 
-		cinfo.err = jpeg_std_error(&jerr);
-		jpeg_create_decompress(&cinfo);
+	cinfo.err = jpeg_std_error(&jerr);
+	jpeg_create_decompress(&cinfo);
 
 #if JPEG_LIB_VERSION < 80
-		jpeg_source_mgr src;
-		src.next_input_byte   = buf;
-		src.bytes_in_buffer   = len;
-		src.init_source       = &djepg_nop;
-		src.fill_input_buffer = &djepg_fill_input_buffer;
-		src.skip_input_data   = &djepg_skip_input_data;
-		src.resync_to_restart = &jpeg_resync_to_restart;
-		src.term_source       = &djepg_nop;
-		cinfo.src             = &src;
+	jpeg_source_mgr src;
+	src.next_input_byte   = buf;
+	src.bytes_in_buffer   = len;
+	src.init_source       = &djepg_nop;
+	src.fill_input_buffer = &djepg_fill_input_buffer;
+	src.skip_input_data   = &djepg_skip_input_data;
+	src.resync_to_restart = &jpeg_resync_to_restart;
+	src.term_source       = &djepg_nop;
+	cinfo.src             = &src;
 #else
-		jpeg_mem_src(&cinfo, buf, len);
+	jpeg_mem_src(&cinfo, buf, len);
 #endif
 
-		jpeg_read_header(&cinfo, qtrue);
-
-		cinfo.out_color_space = JCS_RGB;
+	jpeg_read_header(&cinfo, qtrue);
 
-		SDL_Surface* s;
-		if ((s = createSurface(cinfo.image_height, cinfo.image_width))) {
-			jpeg_start_decompress(&cinfo);
+	cinfo.out_color_space = JCS_RGB;
 
-			byte*        dst   = (byte*)(s->pixels);
-			size_t const pitch = s->pitch;
-			for (size_t n = cinfo.image_height; n != 0; dst += pitch, --n) {
-				JSAMPLE* lines[1] = { dst };
-				jpeg_read_scanlines(&cinfo, lines, 1);
-
-				/* Convert RGB to RGBA. */
-				for (size_t x = cinfo.image_width; x-- != 0;) {
-					dst[4 * x + 0] = dst[3 * x + 0];
-					dst[4 * x + 1] = dst[3 * x + 1];
-					dst[4 * x + 2] = dst[3 * x + 2];
-					dst[4 * x + 3] = 255;
-				}
+	SDL_Surface* s;
+	if ((s = createSurface(cinfo.image_height, cinfo.image_width))) {
+		jpeg_start_decompress(&cinfo);
+
+		byte*        dst   = (byte*)(s->pixels);
+		size_t const pitch = s->pitch;
+		for (size_t n = cinfo.image_height; n != 0; dst += pitch, --n) {
+			JSAMPLE* lines[1] = { dst };
+			jpeg_read_scanlines(&cinfo, lines, 1);
+
+			/* Convert RGB to RGBA. */
+			for (size_t x = cinfo.image_width; x-- != 0;) {
+				dst[4 * x + 0] = dst[3 * x + 0];
+				dst[4 * x + 1] = dst[3 * x + 1];
+				dst[4 * x + 2] = dst[3 * x + 2];
+				dst[4 * x + 3] = 255;
 			}
-
-			jpeg_finish_decompress(&cinfo);
-			res = s;
 		}
 
-		jpeg_destroy_decompress(&cinfo);
-		FS_FreeFile(buf);
+		jpeg_finish_decompress(&cinfo);
+		res = s;
 	}
 
+	jpeg_destroy_decompress(&cinfo);
+
 	return res;
 }
 
+/**
+ * @brief Decodes an image file that was already loaded into memory
+ * @param[in] buf The content of the image file
+ * @param[in] len The size of @c buf
+ * @param[in] type The image type (file extension) as given by @c Img_GetImageTypes
+ * @note Make sure to free the given @c SDL_Surface after you are done with it.
+ */
+SDL_Surface* Img_DecodeImage (byte* buf, size_t len, char const* type)
+{
+	if (Q_streq(type, "png"))
+		return Img_DecodePNG(buf, len);
+	if (Q_streq(type, "jpg"))
+		return Img_DecodeJPG(buf, len);
+	return 0;
+}
+
 /**
  * @brief Loads the specified image from the game filesystem and populates
  * the provided SDL_Surface.
@@ -449,10 +454,15 @@ static SDL_Surface* Img_LoadJPG(char const* const name)
  */
 SDL_Surface* Img_LoadImage (char const* name)
 {
-	SDL_Surface* s;
-	if ((s = Img_LoadPNG(name)))
-		return s;
-	if ((s = Img_LoadJPG(name)))
-		return s;
+	for (char const* const* type = IMAGE_TYPES; *type; ++type) {
+		size_t len;
+		byte*  buf;
+		if ((buf = readFile(name, *type, &len))) {
+			SDL_Surface* const s = Img_DecodeImage(buf, len, *type);
+			FS_FreeFile(buf);
+			if (s)
+				return s;
+		}
+	}
 	return 0;
 }
@@ -34,6 +34,7 @@
 
 char const* const* Img_GetImageTypes(void);
 SDL_Surface* Img_LoadImage(char const* name);
+SDL_Surface* Img_DecodeImage(byte* buf, size_t len, char const* type);
 void R_WriteCompressedTGA(qFILE *f, const byte *buffer, int width, int height);
 void R_WritePNG(qFILE *f, byte *buffer, int width, int height);
 void R_WriteJPG(qFILE *f, byte *buffer, int width, int height, int quality);
@@ -134,6 +134,36 @@ int UTF8_encoded_len (int c)
 	return 0;
 }
 
+/**
+ * @brief Decode the character at the start of a string and move the string pointer behind it
+ * @param[in,out] str Pointer to the string, advanced to the next character
+ * @return Unicode code of the character or -1 for a broken sequence - the pointer
+ * is only advanced by one byte then
+ */
+int UTF8_next (const char **str)
+{
+	const unsigned char *s = (const unsigned char *)*str;
+	const int len = UTF8_char_len(s[0]);
+	int c, i;
+
+	if (len == 0) {
+		(*str)++;
+		return -1;
+	}
+
+	c = s[0] & (0xff >> (len + (len > 1)));
+	for (i = 1; i < len; i++) {
+		if (!UTF8_CONTINUATION_BYTE(s[i])) {
+			(*str)++;
+			return -1;
+		}
+		c = (c << 6) | (s[i] & 0x3f);
+	}
+
+	*str += len;
+	return c;
+}
+
 /**
  * @brief Count the number of character (not the number of bytes) of a zero termination string
  * @note the \\0 termination character is not counted
@@ -39,6 +39,7 @@ int UTF8_delete_char(char *s, int pos);
 int UTF8_insert_char(char *s, int n, int pos, int codepoint);
 int UTF8_char_len(unsigned char c);
 int UTF8_encoded_len(int codepoint);
+int UTF8_next(const char **str);
 size_t UTF8_strlen(const char *str);
 char *UTF8_strncpyz(char *dest, const char *src, size_t limit);
 
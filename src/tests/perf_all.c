@@ -0,0 +1,386 @@
+/**
+ * @file perf_all.c
+ * @brief Runner of the perfall benchmark suite
+ * @note Every benchmark is run for a few samples, the median of the samples is written
+ * into a json file. If a baseline file (the json output of an earlier run) is given, the
+ * results are compared against it and slowdowns above the threshold are reported as
+ * regressions - the exit code is @c 1 in that case.
+ */
+
+/*
+Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "perf_shared.h"
+#include "../server/server.h"
+#include "../ports/system.h"
+
+#define MAX_PERF_SAMPLES 32
+#define MAX_PERF_BENCHMARKS 64
+
+typedef struct perfConfig_s {
+	int samples;
+	float threshold;			/**< allowed slowdown in percent before a benchmark counts as regression */
+	const char *output;
+	const char *baseline;
+	const char *only;
+	qboolean verbose;
+} perfConfig_t;
+
+typedef struct perfResult_s {
+	qboolean skipped;
+	double minMs;
+	double medianMs;
+	double usecPerIteration;	/**< based on the median sample */
+} perfResult_t;
+
+typedef struct perfBaseline_s {
+	char name[MAX_VAR];
+	double usecPerIteration;
+} perfBaseline_t;
+
+static perfConfig_t config = { 5, 10.0f, "perfall.json", NULL, NULL, qfalse };
+
+static perfBaseline_t baseline[MAX_PERF_BENCHMARKS];
+static int numBaseline;
+
+void Sys_Init(void);
+void Sys_Init (void)
+{
+}
+
+static void PERF_InitError (void)
+{
+	Sys_Error("Error during initialization");
+}
+
+static void PERF_RunError (void)
+{
+	Sys_Error("There was a Com_Error or Com_Drop call during the execution of a benchmark");
+}
+
+/**
+ * @brief Brings up the subsystems the benchmarks rely on
+ * @sa TEST_Init
+ */
+void PERF_Init (void)
+{
+	Com_SetExceptionCallback(PERF_InitError);
+
+	com_aliasSysPool = Mem_CreatePool("Common: Alias system");
+	com_cmdSysPool = Mem_CreatePool("Common: Command system");
+	com_cmodelSysPool = Mem_CreatePool("Common: Collision model");
+	com_cvarSysPool = Mem_CreatePool("Common: Cvar system");
+	com_fileSysPool = Mem_CreatePool("Common: File system");
+	com_genericPool = Mem_CreatePool("Generic");
+
+	Mem_Init();
+	Cbuf_Init();
+	Cmd_Init();
+	Cvar_Init();
+	FS_InitFilesystem(qtrue);
+	FS_AddGameDirectory("./unittest", qfalse);
+	Swap_Init();
+	SV_Init();
+	NET_Init();
+
+	FS_ExecAutoexec();
+
+	OBJZERO(csi);
+
+	Com_SetExceptionCallback(PERF_RunError);
+
+	http_timeout = Cvar_Get("noname", "", 0, NULL);
+	http_proxy = Cvar_Get("noname", "", 0, NULL);
+}
+
+/**
+ * @sa TEST_Shutdown
+ */
+void PERF_Shutdown (void)
+{
+	SV_Shutdown("perf shutdown", qfalse);
+	FS_Shutdown();
+	Cmd_Shutdown();
+	Cvar_Shutdown();
+	Mem_Shutdown();
+	Com_Shutdown();
+	Cbuf_Shutdown();
+	NET_Shutdown();
+
+	com_aliasSysPool = NULL;
+	com_cmdSysPool = NULL;
+	com_cmodelSysPool = NULL;
+	com_cvarSysPool = NULL;
+	com_fileSysPool = NULL;
+	com_genericPool = NULL;
+}
+
+/**
+ * @brief Engine output is only shown in verbose mode, it would distort the timings otherwise
+ */
+static void PERF_vPrintf (const char *fmt, va_list argptr)
+{
+	char text[1024];
+
+	if (!config.verbose)
+		return;
+
+	Q_vsnprintf(text, sizeof(text), fmt, argptr);
+	fprintf(stderr, "%s", text);
+}
+
+static int PERF_CompareSamples (const void *a, const void *b)
+{
+	const uint64_t sampleA = *(const uint64_t *)a;
+	const uint64_t sampleB = *(const uint64_t *)b;
+
+	return sampleA < sampleB ? -1 : sampleA > sampleB;
+}
+
+static void PERF_Run (const perfBenchmark_t *benchmark, perfResult_t *result)
+{
+	uint64_t samples[MAX_PERF_SAMPLES];	/**< nanoseconds */
+	int i;
+
+	OBJZERO(*result);
+
+	if (benchmark->init && !benchmark->init()) {
+		result->skipped = qtrue;
+		if (benchmark->shutdown)
+			benchmark->shutdown();
+		return;
+	}
+
+	/* warm up the caches */
+	benchmark->run();
+
+	for (i = 0; i < config.samples; i++) {
+		const uint64_t start = Sys_Nanoseconds();
+		int j;
+
+		for (j = 0; j < benchmark->iterations; j++)
+			benchmark->run();
+
+		samples[i] = Sys_Nanoseconds() - start;
+	}
+
+	if (benchmark->shutdown)
+		benchmark->shutdown();
+
+	qsort(samples, config.samples, sizeof(*samples), PERF_CompareSamples);
+	result->minMs = samples[0] / 1000000.0;
+	result->medianMs = samples[config.samples / 2] / 1000000.0;
+	result->usecPerIteration = samples[config.samples / 2] / 1000.0 / benchmark->iterations;
+}
+
+/**
+ * @brief Reads the results of an earlier run
+ * @note Only understands the format that is written by @c PERF_WriteResults - one benchmark per line
+ */
+static qboolean PERF_LoadBaseline (const char *path)
+{
+	char line[512];
+	FILE *f = fopen(path, "r");
+
+	if (!f)
+		return qfalse;
+
+	while (fgets(line, sizeof(line), f) && numBaseline < MAX_PERF_BENCHMARKS) {
+		const char *name = strstr(line, "\"name\": \"");
+		const char *value = strstr(line, "\"usec_per_iteration\": ");
+		perfBaseline_t *entry;
+		const char *end;
+
+		if (!name || !value)
+			continue;
+
+		name += strlen("\"name\": \"");
+		end = strchr(name, '"');
+		if (!end)
+			continue;
+
+		entry = &baseline[numBaseline++];
+		Q_strncpyz(entry->name, name, min(sizeof(entry->name), (size_t)(end - name + 1)));
+		entry->usecPerIteration = atof(value + strlen("\"usec_per_iteration\": "));
+	}
+
+	fclose(f);
+	return qtrue;
+}
+
+static const perfBaseline_t *PERF_GetBaseline (const char *name)
+{
+	int i;
+
+	for (i = 0; i < numBaseline; i++)
+		if (Q_streq(baseline[i].name, name))
+			return &baseline[i];
+
+	return NULL;
+}
+
+static qboolean PERF_IsRegression (const perfResult_t *result, const perfBaseline_t *base)
+{
+	if (result->skipped || !base || base->usecPerIteration <= 0.0)
+		return qfalse;
+	return result->usecPerIteration > base->usecPerIteration * (1.0 + config.threshold / 100.0);
+}
+
+static qboolean PERF_WriteResults (const perfResult_t *results, int numResults)
+{
+	FILE *f = fopen(config.output, "w");
+	qboolean first = qtrue;
+	int i;
+
+	if (!f)
+		return qfalse;
+
+	fprintf(f, "{\n\"version\": \"%s\",\n\"samples\": %i,\n\"benchmarks\": [\n", UFO_VERSION, config.samples);
+	for (i = 0; i < numResults; i++) {
+		const perfBenchmark_t *benchmark = &perfBenchmarks[i];
+		const perfResult_t *result = &results[i];
+		const perfBaseline_t *base;
+
+		if (result->skipped)
+			continue;
+
+		base = PERF_GetBaseline(benchmark->name);
+		fprintf(f, "%s{\"name\": \"%s\", \"iterations\": %i, \"min_ms\": %.3f, \"median_ms\": %.3f, \"usec_per_iteration\": %.3f",
+				first ? "" : ",\n", benchmark->name, benchmark->iterations, result->minMs, result->medianMs, result->usecPerIteration);
+		if (base)
+			fprintf(f, ", \"baseline_usec_per_iteration\": %.3f, \"regression\": %s", base->usecPerIteration,
+					PERF_IsRegression(result, base) ? "true" : "false");
+		fprintf(f, "}");
+		first = qfalse;
+	}
+	fprintf(f, "\n]\n}\n");
+
+	fclose(f);
+	return qtrue;
+}
+
+static void PERF_Parameters (const int argc, const char **argv)
+{
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (Q_strstart(argv[i], "--samples=")) {
+			config.samples = atoi(argv[i] + 10);
+			if (config.samples < 1 || config.samples > MAX_PERF_SAMPLES) {
+				fprintf(stderr, "Error: samples must be between 1 and %i\n", MAX_PERF_SAMPLES);
+				exit(2);
+			}
+		} else if (Q_strstart(argv[i], "--output=")) {
+			config.output = argv[i] + 9;
+		} else if (Q_strstart(argv[i], "--baseline=")) {
+			config.baseline = argv[i] + 11;
+		} else if (Q_strstart(argv[i], "--threshold=")) {
+			config.threshold = atof(argv[i] + 12);
+		} else if (Q_strstart(argv[i], "--only=")) {
+			config.only = argv[i] + 7;
+		} else if (Q_streq(argv[i], "-v") || Q_streq(argv[i], "--verbose")) {
+			config.verbose = qtrue;
+		} else if (Q_streq(argv[i], "-l") || Q_streq(argv[i], "--list")) {
+			const perfBenchmark_t *benchmark;
+			for (benchmark = perfBenchmarks; benchmark->name; benchmark++)
+				printf("* %s\n", benchmark->name);
+			exit(0);
+		} else if (Q_streq(argv[i], "-h") || Q_streq(argv[i], "--help")) {
+			printf("Usage:\n");
+			printf("-h  --help                 | show this help screen\n");
+			printf("-l  --list                 | list the benchmarks, and exit.\n");
+			printf("-v  --verbose              | show the engine output\n");
+			printf("    --samples=N            | samples per benchmark, the median is reported (default 5)\n");
+			printf("    --output=FILE          | json result file (default perfall.json)\n");
+			printf("    --baseline=FILE        | compare against the json result of an earlier run\n");
+			printf("    --threshold=PERCENT    | slowdown that counts as regression (default 10)\n");
+			printf("    --only=NAME            | only run the given benchmark\n");
+			exit(0);
+		} else {
+			fprintf(stderr, "Error: Param \"%s\" unknown\n", argv[i]);
+			fprintf(stderr, "Use \"%s -h\" to show the help screen\n", argv[0]);
+			exit(2);
+		}
+	}
+}
+
+/**
+ * @brief Runs all benchmarks
+ * @return @c 0 on success, @c 1 if there were regressions against the baseline, @c 2 on errors
+ */
+int main (int argc, const char **argv)
+{
+	perfResult_t results[MAX_PERF_BENCHMARKS];
+	const perfBenchmark_t *benchmark;
+	int regressions = 0;
+	int i;
+
+	Sys_InitSignals();
+
+	PERF_Parameters(argc, argv);
+
+	if (config.baseline && !PERF_LoadBaseline(config.baseline)) {
+		fprintf(stderr, "Error: Could not read baseline \"%s\"\n", config.baseline);
+		return 2;
+	}
+
+	Qcommon_SetPrintFunction(PERF_vPrintf);
+
+	for (i = 0, benchmark = perfBenchmarks; benchmark->name; benchmark++, i++) {
+		perfResult_t *result = &results[i];
+		const perfBaseline_t *base;
+
+		if (config.only && !Q_streq(config.only, benchmark->name)) {
+			OBJZERO(*result);
+			result->skipped = qtrue;
+			continue;
+		}
+
+		PERF_Run(benchmark, result);
+		if (result->skipped) {
+			printf("%-24s skipped\n", benchmark->name);
+			continue;
+		}
+
+		base = PERF_GetBaseline(benchmark->name);
+		printf("%-24s %10.3f usec/iteration (median %.3f ms, min %.3f ms)", benchmark->name,
+				result->usecPerIteration, result->medianMs, result->minMs);
+		if (base)
+			printf(" baseline %10.3f usec/iteration", base->usecPerIteration);
+		if (PERF_IsRegression(result, base)) {
+			printf(" REGRESSION");
+			regressions++;
+		}
+		printf("\n");
+	}
+
+	if (!PERF_WriteResults(results, i)) {
+		fprintf(stderr, "Error: Could not write \"%s\"\n", config.output);
+		return 2;
+	}
+
+	if (regressions)
+		printf("%i benchmarks are more than %.1f%% slower than the baseline\n", regressions, config.threshold);
+
+	return regressions != 0;
+}
@@ -0,0 +1,487 @@
+/**
+ * @file perf_benchmarks.c
+ * @brief The benchmarks of the perfall suite
+ * @note All benchmarks are deterministic (fixed positions and seeds) to keep the runs comparable
+ */
+
+/*
+Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "perf_shared.h"
+#include "../common/cmodel.h"
+#include "../common/grid.h"
+#include "../common/tracing.h"
+#include "../server/server.h"
+#include "../server/sv_rma.h"
+#include "../client/client.h"
+#include "../client/battlescape/cl_particle.h"
+#include "../client/renderer/r_state.h"
+#include "../client/ui/ui_main.h"
+#include "../client/cgame/cl_game.h"
+#include "../client/cgame/campaign/cp_campaign.h"
+#include "../client/cgame/campaign/cp_map.h"
+#include "../client/cgame/campaign/cp_overlay.h"
+
+/*
+ * Routing and tracing on the unittest map
+ */
+
+static const char *perfMapName = "test_routing";
+static mapData_t perfMapData;
+static mapTiles_t perfMapTiles;
+static pathing_t *perfPath;
+
+static qboolean PERF_InitRouting (void)
+{
+	PERF_Init();
+	Com_ParseScripts(qtrue);
+
+	if (FS_CheckFile("maps/%s.bsp", perfMapName) == -1) {
+		Com_Printf("Map resource '%s.bsp' for the benchmark is missing.\n", perfMapName);
+		return qfalse;
+	}
+
+	CM_LoadMap(perfMapName, qtrue, "", &perfMapData, &perfMapTiles);
+	perfPath = Mem_AllocType(pathing_t);
+	return qtrue;
+}
+
+static void PERF_ShutdownRouting (void)
+{
+	perfPath = NULL;
+	PERF_Shutdown();
+}
+
+static void PERF_GridMoveCalc (void)
+{
+	const routing_t *routing = &perfMapData.map[ACTOR_SIZE_NORMAL - 1];
+	vec3_t vec;
+	pos3_t pos;
+
+	VectorSet(vec, 80, 80, 32);
+	VecToPos(vec, pos);
+	Grid_MoveCalc(routing, ACTOR_SIZE_NORMAL, perfPath, pos, 0, MAX_ROUTE, NULL, 0);
+}
+
+/** @brief Traces between the points of a fixed grid that spans the map */
+static void PERF_TraceLines (qboolean boxTrace)
+{
+	const box_t box = {{-8, -8, -8}, {8, 8, 8}};
+	int x, y;
+
+	for (x = 0; x < 8; x++) {
+		for (y = 0; y < 8; y++) {
+			vec3_t start, end;
+			VectorSet(start, -240 + x * 64, -240 + y * 64, 32);
+			VectorSet(end, 240 - y * 64, 240 - x * 64, 96);
+			if (boxTrace)
+				TR_SingleTileBoxTrace(&perfMapTiles, start, end, &box, TRACING_ALL_VISIBLE_LEVELS, MASK_ALL, 0);
+			else
+				TR_TestLine(&perfMapTiles, start, end, TRACING_ALL_VISIBLE_LEVELS);
+		}
+	}
+}
+
+static void PERF_TestLine (void)
+{
+	PERF_TraceLines(qfalse);
+}
+
+static void PERF_BoxTrace (void)
+{
+	PERF_TraceLines(qtrue);
+}
+
+static qboolean PERF_InitMapLoad (void)
+{
+	if (!PERF_InitRouting())
+		return qfalse;
+
+	/* measure the tile loading and not the cache */
+	CM_Init();
+	Cvar_Set("cm_routingcache", "0");
+	return qtrue;
+}
+
+/** @brief Loads an assembly of eight copies of the unittest map - set @c cm_loadthreads to measure the loader threads */
+static void PERF_MapLoad (void)
+{
+	CM_LoadMap("test_routing test_routing test_routing test_routing test_routing test_routing test_routing test_routing", qtrue,
+			"-96 -96 0 -32 -96 0 32 -96 0 96 -96 0 -96 32 0 -32 32 0 32 32 0 96 32 0", &perfMapData, &perfMapTiles);
+}
+
+/*
+ * Random map assembly
+ */
+
+#define PERF_RMA_SEEDS 5
+
+static char perfAsmMap[MAX_TOKEN_CHARS * MAX_TILESTRINGS];
+static char perfAsmPos[MAX_TOKEN_CHARS * MAX_TILESTRINGS];
+static int perfRmaRun;
+
+static qboolean PERF_InitAssembly (void)
+{
+	PERF_Init();
+	Com_ParseScripts(qtrue);
+	/* the sequential assembly is reproducible for a given seed */
+	sv_threads->integer = 0;
+	perfRmaRun = 0;
+	return qtrue;
+}
+
+static void PERF_Assembly (void)
+{
+	const int seed = perfRmaRun++ % PERF_RMA_SEEDS;
+	mapInfo_t *randomMap;
+
+	srand(seed);
+	randomMap = SV_AssembleMap("forest", "large", perfAsmMap, perfAsmPos, seed);
+	if (!randomMap)
+		Sys_Error("Could not assemble forest with seed %i", seed);
+	Mem_Free(randomMap);
+}
+
+/*
+ * Script parsing - measured including the subsystem init it needs
+ */
+
+static void PERF_ParseScripts (void)
+{
+	PERF_Init();
+	Com_ParseScripts(qtrue);
+	PERF_Shutdown();
+}
+
+/*
+ * Campaign savegames
+ */
+
+static const int TAG_INVENTORY = 1538;
+
+static void PERF_FreeInventory (void *data)
+{
+	Mem_Free(data);
+}
+
+static void *PERF_AllocInventoryMemory (size_t size)
+{
+	return Mem_PoolAlloc(size, com_genericPool, TAG_INVENTORY);
+}
+
+static void PERF_FreeAllInventory (void)
+{
+	Mem_FreeTag(com_genericPool, TAG_INVENTORY);
+}
+
+static const inventoryImport_t perfInventoryImport = { PERF_FreeInventory, PERF_FreeAllInventory, PERF_AllocInventoryMemory };
+
+static void PERF_Dummy_f (void)
+{
+}
+
+/**
+ * @sa ResetCampaignData in test_campaign.c
+ */
+static void PERF_ResetCampaignData (void)
+{
+	const campaign_t *campaign;
+
+	CP_ResetCampaignData();
+	CP_ParseCampaignData();
+	campaign = CP_GetCampaign(cp_campaign->string);
+	CP_ReadCampaignData(campaign);
+
+	INV_DestroyInventory(&cls.i);
+	INV_InitInventory("perfCampaign", &cls.i, &csi, &perfInventoryImport);
+
+	CP_UpdateCredits(MAX_CREDITS);
+
+	MAP_Shutdown();
+	MAP_Init(campaign->map);
+
+	ccs.curCampaign = campaign;
+}
+
+/**
+ * @sa UFO_InitSuiteCampaign
+ */
+static qboolean PERF_InitCampaign (void)
+{
+	const char *error;
+
+	PERF_Init();
+
+	cl_genericPool = Mem_CreatePool("Client: Generic");
+	cp_campaignPool = Mem_CreatePool("Client: Local (per game)");
+	cp_campaign = Cvar_Get("cp_campaign", "main", 0, NULL);
+	cp_missiontest = Cvar_Get("cp_missiontest", "0", 0, NULL);
+	vid_imagePool = Mem_CreatePool("Vid: Image system");
+
+	r_state.active_texunit = &r_state.texunits[0];
+	R_FontInit();
+	UI_Init();
+	GAME_InitStartup();
+
+	OBJZERO(cls);
+	Com_ParseScripts(qfalse);
+
+	Cmd_ExecuteString("game_setmode campaigns");
+	Cmd_AddCommand("msgoptions_set", PERF_Dummy_f, NULL);
+
+	cl_geoscape_overlay = Cvar_Get("cl_geoscape_overlay", "0", 0, NULL);
+	cl_3dmap = Cvar_Get("cl_3dmap", "1", 0, NULL);
+
+	CL_SetClientState(ca_disconnected);
+	cls.realtime = Sys_Milliseconds();
+
+	PERF_ResetCampaignData();
+	CP_InitOverlay();
+	SAV_Init();
+	Cvar_Set("save_compressed", "0");
+
+	/* a savegame from a running campaign gives more realistic numbers than an empty campaign */
+	if (!SAV_GameLoad("3090011", &error)) {
+		Com_Printf("Could not load the savegame for the benchmark: %s\n", error);
+		return qfalse;
+	}
+
+	return qtrue;
+}
+
+static void PERF_ShutdownCampaign (void)
+{
+	UI_Shutdown();
+	CP_ResetCampaignData();
+	PERF_Shutdown();
+}
+
+static void PERF_CampaignSaveLoad (void)
+{
+	Cmd_ExecuteString("game_quicksave");
+	PERF_ResetCampaignData();
+	Cmd_ExecuteString("game_quickload");
+}
+
+/*
+ * Memory and buffers
+ */
+
+static memPool_t *perfPool;
+
+static qboolean PERF_InitMemory (void)
+{
+	PERF_Init();
+	perfPool = Mem_CreatePool("Perf: Benchmark");
+	return qtrue;
+}
+
+static void PERF_ShutdownMemory (void)
+{
+	perfPool = NULL;
+	PERF_Shutdown();
+}
+
+/** @brief Grows a buffer in network sized chunks and drains it again like a net stream does */
+static void PERF_DBufferChurn (void)
+{
+	char chunk[1400];
+	struct dbuffer *buf = new_dbuffer();
+	struct dbuffer *copy;
+	int i;
+
+	memset(chunk, 'x', sizeof(chunk));
+
+	for (i = 0; i < 64; i++) {
+		dbuffer_add(buf, chunk, sizeof(chunk) - i);
+		if (i % 4 == 3)
+			dbuffer_extract(buf, chunk, sizeof(chunk) / 2);
+	}
+
+	copy = dbuffer_dup(buf);
+	while (dbuffer_len(copy) > 0)
+		dbuffer_remove(copy, 512);
+
+	free_dbuffer(copy);
+	free_dbuffer(buf);
+}
+
+/** @brief Packs and unpacks a stream of actor move events the way the server and the client do */
+static void PERF_NetFormat (void)
+{
+	struct dbuffer *buf = new_dbuffer();
+	const vec3_t origin = {128.0f, -256.0f, 64.0f};
+	const pos3_t pos = {12, 34, 2};
+	int i;
+
+	for (i = 0; i < 2048; i++)
+		NET_WriteFormat(buf, "bsbgpdas", 7, i, 3, pos, origin, bytedirs[i % NUMVERTEXNORMALS], 45.0f, -i);
+
+	for (i = 0; i < 2048; i++) {
+		int type, num, state, state2;
+		pos3_t readPos;
+		vec3_t readOrigin, dir;
+		float angle;
+		NET_ReadFormat(buf, "bsbgpdas", &type, &num, &state, &readPos, &readOrigin, &dir, &angle, &state2);
+	}
+
+	free_dbuffer(buf);
+}
+
+/** @brief Allocates many small blocks of mixed sizes, frees every second one and drops the rest with the pool */
+static void PERF_MemPoolAlloc (void)
+{
+	void *blocks[1024];
+	int i;
+
+	for (i = 0; i < lengthof(blocks); i++)
+		blocks[i] = Mem_PoolAlloc(16 + (i % 32) * 24, perfPool, 0);
+
+	for (i = 0; i < lengthof(blocks); i += 2)
+		Mem_Free(blocks[i]);
+
+	Mem_FreePool(perfPool);
+}
+
+/*
+ * Particle simulation - no renderer needed as long as the particles don't use art or lights
+ */
+
+#define PERF_PARTICLES 1024
+#define PERF_PARTICLE_FRAMES 32
+
+/** @brief Sparks of an explosion - they live shorter than the frames of one iteration */
+static const char *perfParticleDef =
+	"{\n"
+	"	init {\n"
+	"		blend add\n"
+	"		size \"4 4\"\n"
+	"		life 0.4\n"
+	"		tps 20\n"
+	"		thinkfade out\n"
+	"		a \"0 0 -400\"\n"
+	"		omega \"0 0 90\"\n"
+	"		crand vector \"64 64 64\"\n"
+	"		pop *v\n"
+	"	}\n"
+	"	run {\n"
+	"		push *t\n"
+	"		mul float 2.0\n"
+	"		pop *scale.1\n"
+	"	}\n"
+	"	think {\n"
+	"		color \"1 0.5 0 1\"\n"
+	"	}\n"
+	"}\n";
+
+static qboolean PERF_InitParticles (void)
+{
+	const char *text = perfParticleDef;
+
+	PERF_Init();
+	PTL_InitStartup();
+	CL_InitParticles();
+	CL_ParseParticle("perf_sparks", &text);
+
+	OBJZERO(cl);
+	cls.state = ca_active;
+	return qtrue;
+}
+
+static void PERF_ShutdownParticles (void)
+{
+	cls.state = ca_disconnected;
+	PTL_InitStartup();
+	PERF_Shutdown();
+}
+
+static void PERF_ParticleRun (void)
+{
+	const vec3_t origin = {0, 0, 64};
+	int i;
+
+	srand(0);
+	for (i = 0; i < PERF_PARTICLES; i++)
+		CL_ParticleSpawn("perf_sparks", 0, origin, NULL, NULL);
+
+	cls.frametime = 0.016f;
+	for (i = 0; i < PERF_PARTICLE_FRAMES; i++) {
+		cl.time += 16;
+		CL_ParticleRun();
+	}
+}
+
+/*
+ * Text layout - works on the glyph metrics of SDL_ttf, no GL context needed
+ */
+
+#define PERF_FONT_TEXTS 256
+
+static qboolean PERF_InitFont (void)
+{
+	PERF_Init();
+	R_FontInit();
+
+	if (FS_CheckFile("media/DejaVuSans.ttf") == -1) {
+		Com_Printf("Font resource for the benchmark is missing.\n");
+		return qfalse;
+	}
+
+	R_FontRegister("f_perf", 14, "media/DejaVuSans.ttf", NULL);
+	return qtrue;
+}
+
+static void PERF_ShutdownFont (void)
+{
+	R_FontShutdown();
+	PERF_Shutdown();
+}
+
+/** @brief Wraps texts that change every time like timers or the console do, so the wrap cache never hits */
+static void PERF_FontWrap (void)
+{
+	static int serial;
+	int i;
+
+	for (i = 0; i < PERF_FONT_TEXTS; i++) {
+		const char *text = va("%i: Our researchers have completed the autopsy of the alien. "
+				"They suggest that we build a containment facility to keep live specimens.", serial++);
+
+		R_FontTextSize("f_perf", text, 120 + (i % 8) * 40, LONGLINES_WRAP, NULL, NULL, NULL, NULL);
+		R_FontTextSize("f_perf", text, 200, LONGLINES_PRETTYCHOP, NULL, NULL, NULL, NULL);
+	}
+}
+
+const perfBenchmark_t perfBenchmarks[] = {
+	{"grid_movecalc", PERF_InitRouting, PERF_GridMoveCalc, PERF_ShutdownRouting, 500},
+	{"tr_testline", PERF_InitRouting, PERF_TestLine, PERF_ShutdownRouting, 500},
+	{"tr_boxtrace", PERF_InitRouting, PERF_BoxTrace, PERF_ShutdownRouting, 500},
+	{"cm_loadmap", PERF_InitMapLoad, PERF_MapLoad, PERF_ShutdownRouting, 10},
+	{"rma_assembly", PERF_InitAssembly, PERF_Assembly, PERF_Shutdown, PERF_RMA_SEEDS},
+	{"parse_scripts", NULL, PERF_ParseScripts, NULL, 3},
+	{"campaign_saveload", PERF_InitCampaign, PERF_CampaignSaveLoad, PERF_ShutdownCampaign, 5},
+	{"dbuffer_churn", PERF_InitMemory, PERF_DBufferChurn, PERF_ShutdownMemory, 2000},
+	{"net_format", PERF_InitMemory, PERF_NetFormat, PERF_ShutdownMemory, 200},
+	{"mem_poolalloc", PERF_InitMemory, PERF_MemPoolAlloc, PERF_ShutdownMemory, 500},
+	{"ptl_run", PERF_InitParticles, PERF_ParticleRun, PERF_ShutdownParticles, 20},
+	{"font_wrap", PERF_InitFont, PERF_FontWrap, PERF_ShutdownFont, 20},
+
+	{NULL, NULL, NULL, NULL, 0}
+};
@@ -0,0 +1,50 @@
+/**
+ * @file perf_shared.h
+ * @brief Shared declarations of the perfall benchmark suite
+ */
+
+/*
+Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef PERF_SHARED_H
+#define PERF_SHARED_H
+
+#include "../common/common.h"
+#include "../shared/shared.h"
+
+/**
+ * @brief A single benchmark
+ * @note Only @c run is measured - @c init and @c shutdown set up and tear down the subsystems
+ * the benchmark needs and are called once per benchmark
+ */
+typedef struct perfBenchmark_s {
+	const char *name;
+	qboolean (*init)(void);	/**< @c false if the benchmark can't run (e.g. missing map resources) */
+	void (*run)(void);		/**< one iteration of the benchmark */
+	void (*shutdown)(void);
+	int iterations;			/**< iterations per sample */
+} perfBenchmark_t;
+
+extern const perfBenchmark_t perfBenchmarks[];
+
+void PERF_Init(void);
+void PERF_Shutdown(void);
+
+#endif
@@ -48,6 +48,8 @@ typedef int (*testSuite_t) (void);
 #include "test_mapdef.h"
 #include "test_dbuffer.h"
 #include "test_renderer.h"
+#include "test_cinematic.h"
+#include "test_particles.h"
 #include "test_scripts.h"
 
 static const testSuite_t testSuites[] = {
@@ -64,6 +66,8 @@ static const testSuite_t testSuites[] = {
 	UFO_AddMapDefTests,
 	UFO_AddDBufferTests,
 	UFO_AddRendererTests,
+	UFO_AddCinematicTests,
+	UFO_AddParticleTests,
 	UFO_AddScriptsTests,
 	UFO_AddMathlibExtraTests,
 	NULL
@@ -296,6 +296,20 @@ static void testEmployeeHandling (void)
 		CU_ASSERT_TRUE(E_DeleteEmployee(e));
 	}
 
+	{
+		employee_t *e = E_CreateEmployee(EMPL_SCIENTIST, NULL);
+		const int ucn = e->chr.ucn;
+		CU_ASSERT_PTR_NOT_NULL(e);
+		CU_ASSERT_PTR_EQUAL(E_GetEmployeeFromChrUCN(ucn), e);
+		CU_ASSERT_PTR_EQUAL(E_GetEmployeeByTypeFromChrUCN(EMPL_SCIENTIST, ucn), e);
+		CU_ASSERT_PTR_NULL(E_GetEmployeeByTypeFromChrUCN(EMPL_SOLDIER, ucn));
+		CU_ASSERT_EQUAL(E_CountByType(EMPL_SCIENTIST), 1);
+		CU_ASSERT_EQUAL(E_CountHired(NULL, EMPL_SCIENTIST), 0);
+		CU_ASSERT_TRUE(E_DeleteEmployee(e));
+		CU_ASSERT_PTR_NULL(E_GetEmployeeFromChrUCN(ucn));
+		CU_ASSERT_EQUAL(E_CountByType(EMPL_SCIENTIST), 0);
+	}
+
 	{
 		int i, cnt;
 		employee_t *e;
@@ -0,0 +1,176 @@
+/**
+ * @file test_cinematic.c
+ * @brief Test cases for code below client/cinematic
+ */
+
+/*
+Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "test_shared.h"
+#include "test_cinematic.h"
+#include "../client/cinematic/cl_cinematic_roq.h"
+#include "../client/cinematic/cl_cinematic_ogm.h"
+
+/** @brief Frame width of the block copy tests - not a multiple of four to get unaligned rows */
+#define ROQ_TEST_WIDTH 37
+#define ROQ_TEST_HEIGHT 24
+
+/**
+ * The suite initialization function.
+ * Returns zero on success, non-zero otherwise.
+ */
+static int UFO_InitSuiteCinematic (void)
+{
+	TEST_Init();
+	CIN_OGM_Init();
+	return 0;
+}
+
+/**
+ * The suite cleanup function.
+ * Returns zero on success, non-zero otherwise.
+ */
+static int UFO_CleanSuiteCinematic (void)
+{
+	TEST_Shutdown();
+	return 0;
+}
+
+static void TEST_FillRandom (byte *data, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		data[i] = rand() & 0xFF;
+}
+
+/**
+ * @brief The vectorised block copies of the RoQ decoder must write exactly the pixels the
+ * generic ones write - and nothing else
+ */
+static void testRoQBlockCopies (void)
+{
+	unsigned int previous[ROQ_TEST_WIDTH * ROQ_TEST_HEIGHT];
+	unsigned int generic[ROQ_TEST_WIDTH * ROQ_TEST_HEIGHT];
+	unsigned int vectorised[ROQ_TEST_WIDTH * ROQ_TEST_HEIGHT];
+	unsigned int vector[4];
+	int type, x, y;
+
+	srand(0);
+
+	for (type = 0; type < ROQ_COPY_MAX; type++) {
+		const qboolean motion = type == ROQ_COPY_MOTION4X4 || type == ROQ_COPY_MOTION8X8;
+		const int size = type == ROQ_COPY_VECTOR2X2 ? 2 : (type == ROQ_COPY_MOTION8X8 ? 8 : 4);
+
+		for (y = 0; y + size <= ROQ_TEST_HEIGHT; y += 3) {
+			for (x = 0; x + size <= ROQ_TEST_WIDTH; x++) {
+				const unsigned int *src;
+
+				TEST_FillRandom((byte *)previous, sizeof(previous));
+				TEST_FillRandom((byte *)generic, sizeof(generic));
+				TEST_FillRandom((byte *)vector, sizeof(vector));
+				memcpy(vectorised, generic, sizeof(vectorised));
+
+				/* motion blocks are taken from the previous frame at another position */
+				src = motion ? previous + (ROQ_TEST_HEIGHT - size - y) * ROQ_TEST_WIDTH + (ROQ_TEST_WIDTH - size - x) : vector;
+
+				CIN_ROQ_PrivateCopyBlock((roqBlockCopy_t)type, qtrue, generic + y * ROQ_TEST_WIDTH + x, src, ROQ_TEST_WIDTH);
+				CIN_ROQ_PrivateCopyBlock((roqBlockCopy_t)type, qfalse, vectorised + y * ROQ_TEST_WIDTH + x, src, ROQ_TEST_WIDTH);
+
+				CU_ASSERT_EQUAL(memcmp(generic, vectorised, sizeof(generic)), 0);
+			}
+		}
+	}
+}
+
+#ifdef HAVE_THEORA_THEORA_H
+/**
+ * @brief The row by row Theora colour conversion must give exactly the same frame as the
+ * pixel by pixel one for every chroma layout and for widths that are no multiple of the
+ * vector size
+ */
+static void testTheoraYUVtoRGB24 (void)
+{
+	/* 4:2:0, 4:2:2 and 4:4:4 - the shifts of the chroma planes in width and height */
+	const int chromaShifts[][2] = {{1, 1}, {1, 0}, {0, 0}};
+	const int widths[] = {1, 2, 7, 8, 9, 15, 16, 17, 33, 63, 255, 321};
+	const int heights[] = {1, 2, 3, 9};
+	const int padding = 5;
+	size_t c, w, h;
+
+	srand(0);
+
+	for (c = 0; c < lengthof(chromaShifts); c++) {
+		const int uvWShift = chromaShifts[c][0];
+		const int uvHShift = chromaShifts[c][1];
+
+		for (w = 0; w < lengthof(widths); w++) {
+			for (h = 0; h < lengthof(heights); h++) {
+				const int width = widths[w];
+				const int height = heights[h];
+				const int yStride = width + padding;
+				const int uvStride = ((width + (1 << uvWShift) - 1) >> uvWShift) + padding;
+				const int uvHeight = (height + (1 << uvHShift) - 1) >> uvHShift;
+				byte *yPlane = (byte *)Mem_Alloc(yStride * height);
+				byte *uPlane = (byte *)Mem_Alloc(uvStride * uvHeight);
+				byte *vPlane = (byte *)Mem_Alloc(uvStride * uvHeight);
+				uint32_t *generic = (uint32_t *)Mem_Alloc(width * height * sizeof(*generic));
+				uint32_t *vectorised = (uint32_t *)Mem_Alloc(width * height * sizeof(*vectorised));
+
+				TEST_FillRandom(yPlane, yStride * height);
+				TEST_FillRandom(uPlane, uvStride * uvHeight);
+				TEST_FillRandom(vPlane, uvStride * uvHeight);
+
+				CIN_THEORA_PrivateFrameYUVtoRGB24(qtrue, yPlane, uPlane, vPlane, width, height, yStride, uvStride, 0,
+						uvWShift, 0, uvHShift, generic);
+				CIN_THEORA_PrivateFrameYUVtoRGB24(qfalse, yPlane, uPlane, vPlane, width, height, yStride, uvStride, 0,
+						uvWShift, 0, uvHShift, vectorised);
+
+				CU_ASSERT_EQUAL(memcmp(generic, vectorised, width * height * sizeof(*generic)), 0);
+
+				Mem_Free(yPlane);
+				Mem_Free(uPlane);
+				Mem_Free(vPlane);
+				Mem_Free(generic);
+				Mem_Free(vectorised);
+			}
+		}
+	}
+}
+#endif
+
+int UFO_AddCinematicTests (void)
+{
+	/* add a suite to the registry */
+	CU_pSuite CinematicSuite = CU_add_suite("CinematicTests", UFO_InitSuiteCinematic, UFO_CleanSuiteCinematic);
+	if (CinematicSuite == NULL)
+		return CU_get_error();
+
+	/* add the tests to the suite */
+	if (CU_ADD_TEST(CinematicSuite, testRoQBlockCopies) == NULL)
+		return CU_get_error();
+
+#ifdef HAVE_THEORA_THEORA_H
+	if (CU_ADD_TEST(CinematicSuite, testTheoraYUVtoRGB24) == NULL)
+		return CU_get_error();
+#endif
+
+	return CUE_SUCCESS;
+}
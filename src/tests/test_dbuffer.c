@@ -131,6 +131,110 @@ static void testDBufferNetHandling (void)
 	free_dbuffer(buf);
 }
 
+static void testDBufferPeek (void)
+{
+	char data[128];
+	struct dbuffer* buf = new_dbuffer();
+	const char *p;
+
+	CU_ASSERT_PTR_NULL(dbuffer_peek(buf, 1));
+	dbuffer_add(buf, "abc", 3);
+	p = dbuffer_peek(buf, 3);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(p);
+	CU_ASSERT_EQUAL(0, memcmp(p, "abc", 3));
+	CU_ASSERT_PTR_NULL(dbuffer_peek(buf, 4));
+	CU_ASSERT_EQUAL(3, dbuffer_len(buf));
+
+	/* a span that crosses the end of the first element is not accessible in place */
+	OBJZERO(data);
+	while (dbuffer_len(buf) < 3990)
+		dbuffer_add(buf, data, min(sizeof(data), 3990 - dbuffer_len(buf)));
+	dbuffer_add(buf, data, sizeof(data));
+	CU_ASSERT_PTR_NOT_NULL(dbuffer_peek(buf, 3990));
+	CU_ASSERT_PTR_NULL(dbuffer_peek(buf, 4010));
+	CU_ASSERT_EQUAL(4118, dbuffer_len(buf));
+	free_dbuffer(buf);
+}
+
+/**
+ * @brief Writes and reads the same format at every offset around the end of a buffer element
+ */
+static void testDBufferNetFormat (void)
+{
+	int offset;
+
+	for (offset = 3970; offset < 4010; offset++) {
+		struct dbuffer* buf = new_dbuffer();
+		char pad[4010];
+		char str[32];
+		int b, s, l, c;
+		vec3_t pos, dir;
+		pos3_t gpos;
+		float angle;
+		int size;
+		byte data[5] = {1, 2, 3, 4, 5};
+		byte dataIn[5];
+		const vec3_t posOut = {12.0f, -64.0f, 4096.0f};
+		const pos3_t gposOut = {17, 200, 3};
+
+		OBJZERO(pad);
+		dbuffer_add(buf, pad, offset);
+		NET_WriteFormat(buf, "bslcpgda&*", 200, -1234, 123456789, -5, posOut, gposOut, bytedirs[42], 90.0f, "string", 5, data);
+		CU_ASSERT_EQUAL(dbuffer_extract(buf, pad, offset), offset);
+
+		NET_ReadFormat(buf, "bslcpgda&*", &b, &s, &l, &c, &pos, &gpos, &dir, &angle, str, sizeof(str), &size, dataIn);
+		CU_ASSERT_EQUAL(b, 200);
+		CU_ASSERT_EQUAL(s, -1234);
+		CU_ASSERT_EQUAL(l, 123456789);
+		CU_ASSERT_EQUAL(c, -5);
+		CU_ASSERT_TRUE(VectorCompareEps(pos, posOut, 1.0f));
+		CU_ASSERT_TRUE(VectorCompare(gpos, gposOut));
+		CU_ASSERT_TRUE(VectorCompare(dir, bytedirs[42]));
+		CU_ASSERT_DOUBLE_EQUAL(angle, 90.0, 1.5);
+		CU_ASSERT_STRING_EQUAL(str, "string");
+		CU_ASSERT_EQUAL(size, 5);
+		CU_ASSERT_EQUAL(memcmp(dataIn, data, sizeof(data)), 0);
+		CU_ASSERT_EQUAL(dbuffer_len(buf), 0);
+		free_dbuffer(buf);
+	}
+}
+
+/**
+ * @brief The direction lookup must pick the same bytedir as comparing against all of them
+ */
+static void testDBufferNetDir (void)
+{
+	int i;
+
+	srand(0);
+	for (i = 0; i < 100000; i++) {
+		struct dbuffer* buf;
+		vec3_t dir;
+		float bestd = -999999.0f;
+		int j, best = 0;
+
+		dir[0] = crand();
+		dir[1] = crand();
+		dir[2] = crand();
+		if (VectorNormalize(dir) == 0.0f)
+			continue;
+
+		buf = new_dbuffer();
+
+		for (j = 0; j < NUMVERTEXNORMALS; j++) {
+			const float d = DotProduct(dir, bytedirs[j]);
+			if (d > bestd) {
+				bestd = d;
+				best = j;
+			}
+		}
+
+		NET_WriteDir(buf, dir);
+		CU_ASSERT_EQUAL(NET_ReadByte(buf), best);
+		free_dbuffer(buf);
+	}
+}
+
 int UFO_AddDBufferTests (void)
 {
 	/* add a suite to the registry */
@@ -148,5 +252,14 @@ int UFO_AddDBufferTests (void)
 	if (CU_ADD_TEST(DBufferSuite, testDBufferNetHandling) == NULL)
 		return CU_get_error();
 
+	if (CU_ADD_TEST(DBufferSuite, testDBufferPeek) == NULL)
+		return CU_get_error();
+
+	if (CU_ADD_TEST(DBufferSuite, testDBufferNetFormat) == NULL)
+		return CU_get_error();
+
+	if (CU_ADD_TEST(DBufferSuite, testDBufferNetDir) == NULL)
+		return CU_get_error();
+
 	return CUE_SUCCESS;
 }
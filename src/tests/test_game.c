@@ -379,6 +379,130 @@ static void testInventoryTempContainerLinks (void)
 	}
 }
 
+/**
+ * @brief A reaction fire shooter that stops watching must forget the trigger TUs of its targets
+ */
+static void testReactionFireWatcherRejoin (void)
+{
+	const char *mapName = "test_game";
+	if (FS_CheckFile("maps/%s.bsp", mapName) != -1) {
+		edict_t *shooter;
+		edict_t *target;
+		const int tus = 4;
+
+		/* the other tests didn't call the server shutdown function to clean up */
+		OBJZERO(*sv);
+		SV_Map(qtrue, mapName, NULL);
+		level.activeTeam = TEAM_ALIEN;
+
+		shooter = G_EdictsGetNextLivingActorOfTeam(NULL, TEAM_ALIEN);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(shooter);
+		target = G_EdictsGetNextLivingActorOfTeam(shooter, TEAM_ALIEN);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(target);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(RIGHT(shooter));
+
+		G_ReactionFireUpdate(shooter, 0, ACTOR_HAND_RIGHT, RIGHT(shooter)->item.t);
+		G_ClientStateChange(G_PLAYER_FROM_ENT(shooter), shooter, STATE_REACTION, qfalse);
+		CU_ASSERT_TRUE_FATAL(G_IsReaction(shooter));
+
+		G_ReactionFireTargetsTestAdd(shooter, target, tus);
+		CU_ASSERT_EQUAL(G_ReactionFireTargetsTestGetTriggerTUs(shooter, target), target->TU - tus);
+
+		/* drop out of the watchers - the targets are gone */
+		G_SetDazed(shooter);
+		G_ReactionFireWatcherUpdate(shooter);
+		CU_ASSERT_EQUAL(G_ReactionFireTargetsTestGetTriggerTUs(shooter, target), -1);
+
+		/* watch again - the threshold is taken from the current TUs of the target */
+		G_RemoveDazed(shooter);
+		G_ReactionFireWatcherUpdate(shooter);
+		target->TU -= 2;
+		G_ReactionFireTargetsTestAdd(shooter, target, tus);
+		CU_ASSERT_EQUAL(G_ReactionFireTargetsTestGetTriggerTUs(shooter, target), target->TU - tus);
+
+		SV_ShutdownGameProgs();
+	} else {
+		UFO_CU_FAIL_MSG(va("Map resource '%s.bsp' for test is missing.", mapName));
+	}
+}
+
+/**
+ * @brief Checks the edict lists of the iterators against a walk over all the edicts in use
+ */
+static void GAMETEST_CheckEdictLists (void)
+{
+	edict_t *ent = NULL;
+	edict_t *actor = NULL;
+	edict_t *living = NULL;
+	edict_t *alien = NULL;
+
+	while ((ent = G_EdictsGetNextInUse(ent))) {
+		if (G_IsActor(ent)) {
+			actor = G_EdictsGetNextActor(actor);
+			CU_ASSERT_PTR_EQUAL(actor, ent);
+		}
+		if (G_IsLivingActor(ent)) {
+			living = G_EdictsGetNextLivingActor(living);
+			CU_ASSERT_PTR_EQUAL(living, ent);
+			if (ent->team == TEAM_ALIEN) {
+				alien = G_EdictsGetNextLivingActorOfTeam(alien, TEAM_ALIEN);
+				CU_ASSERT_PTR_EQUAL(alien, ent);
+			}
+		}
+	}
+	CU_ASSERT_PTR_NULL(G_EdictsGetNextActor(actor));
+	CU_ASSERT_PTR_NULL(G_EdictsGetNextLivingActor(living));
+	CU_ASSERT_PTR_NULL(G_EdictsGetNextLivingActorOfTeam(alien, TEAM_ALIEN));
+}
+
+static void testEdictLists (void)
+{
+	const char *mapName = "test_game";
+	if (FS_CheckFile("maps/%s.bsp", mapName) != -1) {
+		edict_t *ent;
+		edict_t *next;
+		edict_t *actor;
+
+		/* the other tests didn't call the server shutdown function to clean up */
+		OBJZERO(*sv);
+		SV_Map(qtrue, mapName, NULL);
+		level.activeTeam = TEAM_ALIEN;
+
+		GAMETEST_CheckEdictLists();
+
+		/* an actor that dies while the living actors are iterated must not break the iteration */
+		ent = G_EdictsGetNextLivingActorOfTeam(NULL, TEAM_ALIEN);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(ent);
+		next = G_EdictsGetNextLivingActorOfTeam(ent, TEAM_ALIEN);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(next);
+		ent->HP = 0;
+		CU_ASSERT_TRUE(G_ActorDieOrStun(ent, NULL));
+		CU_ASSERT_PTR_EQUAL(G_EdictsGetNextLivingActorOfTeam(ent, TEAM_ALIEN), next);
+		CU_ASSERT_PTR_EQUAL(G_EdictsGetNextLivingActorOfTeam(NULL, TEAM_ALIEN), next);
+		GAMETEST_CheckEdictLists();
+
+		/* the dead are still actors until they are freed */
+		actor = NULL;
+		while ((actor = G_EdictsGetNextActor(actor)))
+			if (actor == ent)
+				break;
+		CU_ASSERT_PTR_EQUAL(actor, ent);
+		G_FreeEdict(ent);
+		GAMETEST_CheckEdictLists();
+
+		/* a freed edict must not restart the iteration */
+		ent = next;
+		next = G_EdictsGetNextLivingActorOfTeam(ent, TEAM_ALIEN);
+		G_FreeEdict(ent);
+		CU_ASSERT_PTR_EQUAL(G_EdictsGetNextLivingActorOfTeam(ent, TEAM_ALIEN), next);
+		GAMETEST_CheckEdictLists();
+
+		SV_ShutdownGameProgs();
+	} else {
+		UFO_CU_FAIL_MSG(va("Map resource '%s.bsp' for test is missing.", mapName));
+	}
+}
+
 int UFO_AddGameTests (void)
 {
 	/* add a suite to the registry */
@@ -409,5 +533,11 @@ int UFO_AddGameTests (void)
 	if (CU_ADD_TEST(GameSuite, testInventoryTempContainerLinks) == NULL)
 		return CU_get_error();
 
+	if (CU_ADD_TEST(GameSuite, testEdictLists) == NULL)
+		return CU_get_error();
+
+	if (CU_ADD_TEST(GameSuite, testReactionFireWatcherRejoin) == NULL)
+		return CU_get_error();
+
 	return CUE_SUCCESS;
 }
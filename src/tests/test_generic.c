@@ -30,9 +30,16 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../shared/shared.h"
 #include "../shared/infostring.h"
 #include "../shared/stringhunk.h"
+#include "../shared/idtable.h"
 #include "../shared/entitiesdef.h"
 #include "../ports/system.h"
 #include "test_generic.h"
+#include <SDL_thread.h>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#endif
 
 /**
  * The suite initialization function.
@@ -100,6 +107,49 @@ static void testStringHunks (void)
 	STRHUNK_Delete(&hunk);
 }
 
+static void testIDTables (void)
+{
+	static idTable_t table;
+	const char *ids[] = {"a", "b", "c", "dummy", "dummy2"};
+	int values[lengthof(ids)];
+	idTableStats_t stats;
+	idTableCounters_t counters;
+	int i;
+
+	OBJZERO(table);
+	OBJZERO(counters);
+	IDT_SetCounters(&table, &counters);
+	for (i = 0; i < lengthof(ids); i++)
+		CU_ASSERT_TRUE(IDT_Add(&table, ids[i], &values[i]));
+	CU_ASSERT_EQUAL(table.numEntries, lengthof(ids));
+
+	/* the first definition is kept */
+	CU_ASSERT_FALSE(IDT_Add(&table, "b", &values[0]));
+
+	for (i = 0; i < lengthof(ids); i++)
+		CU_ASSERT_PTR_EQUAL(IDT_Get(&table, ids[i]), &values[i]);
+	CU_ASSERT_PTR_NULL(IDT_Get(&table, "d"));
+	CU_ASSERT_EQUAL(counters.numLookups, lengthof(ids) + 1);
+	CU_ASSERT_EQUAL(counters.numMisses, 1);
+	IDT_GetStats(&table, &stats);
+	CU_ASSERT_EQUAL(stats.numRemoved, 0);
+	CU_ASSERT_TRUE(stats.maxProbes >= 1);
+	CU_ASSERT_TRUE(stats.avgProbes >= 1.0f);
+
+	IDT_Remove(&table, "c", &values[2]);
+	CU_ASSERT_PTR_NULL(IDT_Get(&table, "c"));
+	IDT_GetStats(&table, &stats);
+	CU_ASSERT_EQUAL(stats.numRemoved, 1);
+	CU_ASSERT_PTR_EQUAL(IDT_Get(&table, "dummy2"), &values[4]);
+	CU_ASSERT_TRUE(IDT_Add(&table, "c", &values[0]));
+	CU_ASSERT_PTR_EQUAL(IDT_Get(&table, "c"), &values[0]);
+
+	IDT_Clear(&table);
+	CU_ASSERT_EQUAL(table.numEntries, 0);
+	CU_ASSERT_PTR_NULL(IDT_Get(&table, "a"));
+	CU_ASSERT_EQUAL(counters.numMisses, 3);
+}
+
 static void testConstInt (void)
 {
 	const constListEntry_t list[] = {
@@ -372,6 +422,7 @@ static void testStringCopiers (void)
 	long time;
 	const int copies = 10000;
 	char dest[8192];
+	const char *utf8 = "a\xD0\x80\xE2\x82\xAC\xF0\x9D\x84\x9E\x80" "b";
 	int i;
 
 	Com_Printf("\n");
@@ -449,6 +500,16 @@ static void testStringCopiers (void)
 	UTF8_strncpyz(dest, "aab\xD0\x80\xD0\x80", 7);
 	CU_ASSERT_NOT_EQUAL(dest[3], '\0');
 	CU_ASSERT_EQUAL(dest[5], '\0');
+
+	/* UTF8_next */
+	CU_ASSERT_EQUAL(UTF8_next(&utf8), 'a');
+	CU_ASSERT_EQUAL(UTF8_next(&utf8), 0x400);
+	CU_ASSERT_EQUAL(UTF8_next(&utf8), 0x20AC);
+	CU_ASSERT_EQUAL(UTF8_next(&utf8), 0x1D11E);
+	/* a broken sequence only skips one byte */
+	CU_ASSERT_EQUAL(UTF8_next(&utf8), -1);
+	CU_ASSERT_EQUAL(UTF8_next(&utf8), 'b');
+	CU_ASSERT_EQUAL(utf8[0], '\0');
 }
 
 static void testStringFunctions (void)
@@ -520,6 +581,105 @@ static void testHttpHelperFunctions (void)
 	CU_ASSERT_STRING_EQUAL(uriPath, "/ufo/masterserver.php?query");
 }
 
+#ifndef _WIN32
+/** @brief The stub masterserver answers this late */
+#define HTTP_STUB_DELAY 1000
+#define HTTP_STUB_REQUESTS 2
+
+static int httpStubSocket;
+
+/**
+ * @brief A slow masterserver - answers every request after a delay with the requested path
+ */
+static int TEST_HTTPStubServer (void *data)
+{
+	int i;
+
+	for (i = 0; i < HTTP_STUB_REQUESTS; i++) {
+		char request[1024];
+		char path[256];
+		char response[512];
+		const int client = accept(httpStubSocket, NULL, NULL);
+		int len;
+
+		if (client < 0)
+			return -1;
+
+		len = recv(client, request, sizeof(request) - 1, 0);
+		request[max(len, 0)] = '\0';
+		if (sscanf(request, "GET %255s", path) != 1)
+			path[0] = '\0';
+
+		SDL_Delay(HTTP_STUB_DELAY);
+		Com_sprintf(response, sizeof(response), "HTTP/1.0 200 OK\r\nContent-Length: %i\r\n\r\n%s", (int)strlen(path), path);
+		send(client, response, strlen(response), 0);
+		close(client);
+	}
+
+	return 0;
+}
+
+typedef struct httpStubResult_s {
+	char response[256];
+	qboolean done;
+} httpStubResult_t;
+
+static void TEST_HTTPStubCallback (const char *response, void *userdata)
+{
+	httpStubResult_t *result = (httpStubResult_t *)userdata;
+
+	Q_strncpyz(result->response, response ? response : "failed", sizeof(result->response));
+	result->done = qtrue;
+}
+
+/**
+ * @brief Two masterserver queries to a slow loopback server must neither block the frames
+ * nor mix up their callbacks
+ */
+static void testHttpAsyncSlowServer (void)
+{
+	httpStubResult_t results[HTTP_STUB_REQUESTS];
+	struct sockaddr_in addr;
+	socklen_t addrLength = sizeof(addr);
+	SDL_Thread *thread;
+	int i, start, frames = 0, maxFrameTime = 0;
+
+	httpStubSocket = socket(AF_INET, SOCK_STREAM, 0);
+	CU_ASSERT_TRUE_FATAL(httpStubSocket >= 0);
+	OBJZERO(addr);
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	CU_ASSERT_EQUAL_FATAL(bind(httpStubSocket, (struct sockaddr *)&addr, sizeof(addr)), 0);
+	CU_ASSERT_EQUAL_FATAL(listen(httpStubSocket, HTTP_STUB_REQUESTS), 0);
+	CU_ASSERT_EQUAL_FATAL(getsockname(httpStubSocket, (struct sockaddr *)&addr, &addrLength), 0);
+	thread = SDL_CreateThread(TEST_HTTPStubServer, NULL);
+
+	OBJZERO(results);
+	for (i = 0; i < HTTP_STUB_REQUESTS; i++)
+		HTTP_GetURLAsync(va("http://127.0.0.1:%i/ufo/masterserver.php?query%i", ntohs(addr.sin_port), i),
+				TEST_HTTPStubCallback, &results[i], 10);
+
+	/* the frame loop of the game - just with the http requests */
+	start = Sys_Milliseconds();
+	while ((!results[0].done || !results[1].done) && Sys_Milliseconds() - start < 10 * HTTP_STUB_DELAY * HTTP_STUB_REQUESTS) {
+		const int frameStart = Sys_Milliseconds();
+		HTTP_RunRequests();
+		maxFrameTime = max(maxFrameTime, Sys_Milliseconds() - frameStart);
+		frames++;
+		Sys_Sleep(10);
+	}
+
+	SDL_WaitThread(thread, NULL);
+	close(httpStubSocket);
+
+	CU_ASSERT_STRING_EQUAL(results[0].response, "/ufo/masterserver.php?query0");
+	CU_ASSERT_STRING_EQUAL(results[1].response, "/ufo/masterserver.php?query1");
+	/* the frames kept running while the stub delayed its answers */
+	CU_ASSERT_TRUE(frames >= HTTP_STUB_DELAY / 20);
+	CU_ASSERT_TRUE(maxFrameTime < HTTP_STUB_DELAY / 10);
+}
+#endif
+
 static void testNetResolv (void)
 {
 	char ipServer[MAX_VAR];
@@ -611,6 +771,9 @@ int UFO_AddGenericTests (void)
 	if (CU_ADD_TEST(GenericSuite, testStringHunks) == NULL)
 		return CU_get_error();
 
+	if (CU_ADD_TEST(GenericSuite, testIDTables) == NULL)
+		return CU_get_error();
+
 	if (CU_ADD_TEST(GenericSuite, testConstInt) == NULL)
 		return CU_get_error();
 
@@ -647,6 +810,11 @@ int UFO_AddGenericTests (void)
 	if (CU_ADD_TEST(GenericSuite, testHttpHelperFunctions) == NULL)
 		return CU_get_error();
 
+#ifndef _WIN32
+	if (CU_ADD_TEST(GenericSuite, testHttpAsyncSlowServer) == NULL)
+		return CU_get_error();
+#endif
+
 	if (CU_ADD_TEST(GenericSuite, testNetResolv) == NULL)
 		return CU_get_error();
 
@@ -360,6 +360,57 @@ static void testItemToHeadgear (void)
 	CU_ASSERT_PTR_NULL(i.AddToInventory(&i, &inv, &item, container, NONE, NONE, 1));
 }
 
+/**
+ * @brief Fills the backpack until it is full and compares every position INVSH_FindSpace returns with
+ * the first position INVSH_CheckToInventory accepts
+ */
+static void testFindSpace (void)
+{
+	inventory_t inv;
+	const char *itemIDs[] = {"assault", "fraggrenade", "medikit", "plasblade"};
+	const invDef_t *container;
+	int n;
+
+	ResetInventoryList();
+
+	OBJZERO(inv);
+
+	container = INVSH_GetInventoryDefinitionByID("backpack");
+	CU_ASSERT_PTR_NOT_NULL_FATAL(container);
+
+	for (n = 0; n < lengthof(itemIDs); n++) {
+		const objDef_t *od = INVSH_GetItemByIDSilent(itemIDs[n]);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(od);
+		CU_ASSERT_EQUAL(od->shapeRotated, INVSH_ShapeRotate(od->shape));
+
+		for (;;) {
+			item_t item;
+			int x, y, expectedX = NONE, expectedY = NONE;
+
+			OBJZERO(item);
+			item.t = od;
+
+			for (y = 0; y < SHAPE_BIG_MAX_HEIGHT && expectedX == NONE; y++) {
+				for (x = 0; x < SHAPE_BIG_MAX_WIDTH; x++) {
+					if (INVSH_CheckToInventory(&inv, od, container, x, y, NULL)) {
+						expectedX = x;
+						expectedY = y;
+						break;
+					}
+				}
+			}
+
+			INVSH_FindSpace(&inv, &item, container, &x, &y, NULL);
+			CU_ASSERT_EQUAL(x, expectedX);
+			CU_ASSERT_EQUAL(y, expectedY);
+			if (x == NONE || x != expectedX || y != expectedY)
+				break;
+
+			CU_ASSERT_PTR_NOT_NULL_FATAL(i.AddToInventory(&i, &inv, &item, container, x, y, 1));
+		}
+	}
+}
+
 int UFO_AddInventoryTests (void)
 {
 	/* add a suite to the registry */
@@ -380,6 +431,8 @@ int UFO_AddInventoryTests (void)
 		return CU_get_error();
 	if (CU_ADD_TEST(InventorySuite, testItemToHeadgear) == NULL)
 		return CU_get_error();
+	if (CU_ADD_TEST(InventorySuite, testFindSpace) == NULL)
+		return CU_get_error();
 
 	return CUE_SUCCESS;
 }
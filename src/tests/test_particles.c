@@ -0,0 +1,213 @@
+/**
+ * @file test_particles.c
+ * @brief Test cases for the particle scripts
+ */
+
+/*
+Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "test_shared.h"
+#include "test_particles.h"
+#include "../client/client.h"
+#include "../client/battlescape/cl_particle.h"
+#include "../client/renderer/r_particle.h"
+
+/** @brief Uses every command that doesn't need the renderer - with values, particle references,
+ * vector components and stack references */
+static const char *testParticleDef =
+	"{\n"
+	"	init {\n"
+	"		size \"4 8\"\n"
+	"		life 2.5\n"
+	"		tps 10\n"
+	"		blend add\n"
+	"		thinkfade out\n"
+	"		a \"0 0 -400\"\n"
+	"		crand vector \"64 64 64\"\n"
+	"		pop *v\n"
+	"		rand color \"1 1 1 0.5\"\n"
+	"		pop *color\n"
+	"	}\n"
+	"	run {\n"
+	"		push *t\n"
+	"		mul float 2.0\n"
+	"		pop *scale.1\n"
+	"		push *s\n"
+	"		add *v\n"
+	"		sub *a\n"
+	"		pop *offset\n"
+	"		push *v\n"
+	"		mul *a\n"
+	"		div vector \"2 4 8\"\n"
+	"		kpop *omega\n"
+	"		mul *t\n"
+	"		div float 3\n"
+	"		pop *angles\n"
+	"		push *size\n"
+	"		push #.2\n"
+	"		sin *t\n"
+	"		cos 0.25\n"
+	"		v3\n"
+	"		kpop *lightcolor\n"
+	"		pop *lightcolor\n"
+	"		push *t\n"
+	"		push float 1\n"
+	"		v2\n"
+	"		push float 0.5\n"
+	"		push float 0.25\n"
+	"		v2\n"
+	"		v2\n"
+	"		add *color\n"
+	"		pop *color\n"
+	"		tan *dt\n"
+	"		pop *scroll_s\n"
+	"		crand float 2\n"
+	"		pop *lightintensity\n"
+	"		push *v.3\n"
+	"		add float 1\n"
+	"		pop *v.3\n"
+	"	}\n"
+	"	think {\n"
+	"		color \"1 0.5 0 1\"\n"
+	"		push *color\n"
+	"		push #.4\n"
+	"		pop *scroll_t\n"
+	"		push *s\n"
+	"		push #\n"
+	"		pop *s\n"
+	"	}\n"
+	"	physics {\n"
+	"		size \"2 2\"\n"
+	"		kill\n"
+	"		size \"9 9\"\n"
+	"	}\n"
+	"}\n";
+
+/** @brief Pops a float into a vector - the interpreter converts the types, so it is not compiled */
+static const char *testParticleDefInterpreted =
+	"{\n"
+	"	init {\n"
+	"		push float 1\n"
+	"		pop *v\n"
+	"	}\n"
+	"}\n";
+
+/**
+ * The suite initialization function.
+ * Returns zero on success, non-zero otherwise.
+ */
+static int UFO_InitSuiteParticles (void)
+{
+	const char *text;
+
+	TEST_Init();
+	PTL_InitStartup();
+
+	text = testParticleDef;
+	CL_ParseParticle("test_compiled", &text);
+	text = testParticleDefInterpreted;
+	CL_ParseParticle("test_interpreted", &text);
+
+	OBJZERO(cl);
+	return 0;
+}
+
+/**
+ * The suite cleanup function.
+ * Returns zero on success, non-zero otherwise.
+ */
+static int UFO_CleanSuiteParticles (void)
+{
+	PTL_InitStartup();
+	TEST_Shutdown();
+	return 0;
+}
+
+/**
+ * @brief Runs the functions of the test particle with the interpreter and compiled and checks
+ * that both give exactly the same particle
+ */
+static void testCompiledFunctions (void)
+{
+	const char *functions[] = {"init", "run", "think", "run", "think", "physics"};
+	ptl_t *interpreted = &r_particleArray[0];
+	ptl_t *compiled = &r_particleArray[1];
+	size_t i;
+	int frame;
+
+	OBJZERO(*interpreted);
+	interpreted->ctrl = CL_ParticleGet("test_compiled");
+	CU_ASSERT_PTR_NOT_NULL_FATAL(interpreted->ctrl);
+	interpreted->inuse = qtrue;
+	VectorSet(interpreted->s, 10, 20, 30);
+	*compiled = *interpreted;
+
+	for (frame = 0; frame < 8; frame++) {
+		interpreted->t = compiled->t = frame * 0.1f;
+		interpreted->dt = compiled->dt = 0.016f;
+
+		for (i = 0; i < lengthof(functions); i++) {
+			/* the same random numbers for both */
+			srand(frame * 100 + i);
+			CU_ASSERT_TRUE(CL_ParticlePrivateRunFunction(interpreted, functions[i], qfalse));
+			srand(frame * 100 + i);
+			CU_ASSERT_TRUE(CL_ParticlePrivateRunFunction(compiled, functions[i], qtrue));
+
+			CU_ASSERT_EQUAL(memcmp(interpreted, compiled, sizeof(*compiled)), 0);
+		}
+
+		/* the physics function kills the particle and stops before the last command */
+		CU_ASSERT_FALSE(compiled->inuse);
+		CU_ASSERT_EQUAL(compiled->size[0], 2.0f);
+		interpreted->inuse = compiled->inuse = qtrue;
+		interpreted->invis = compiled->invis = qfalse;
+	}
+
+	CU_ASSERT_EQUAL(compiled->scale[0], 2.0f * compiled->t);
+}
+
+static void testInterpretedFunctions (void)
+{
+	ptl_t *p = &r_particleArray[0];
+
+	OBJZERO(*p);
+	p->ctrl = CL_ParticleGet("test_interpreted");
+	CU_ASSERT_PTR_NOT_NULL_FATAL(p->ctrl);
+	CU_ASSERT_FALSE(CL_ParticlePrivateRunFunction(p, "init", qtrue));
+	CU_ASSERT_TRUE(CL_ParticlePrivateRunFunction(p, "init", qfalse));
+	CU_ASSERT_EQUAL(p->v[0], 1.0f);
+}
+
+int UFO_AddParticleTests (void)
+{
+	/* add a suite to the registry */
+	CU_pSuite ParticleSuite = CU_add_suite("ParticleTests", UFO_InitSuiteParticles, UFO_CleanSuiteParticles);
+	if (ParticleSuite == NULL)
+		return CU_get_error();
+
+	/* add the tests to the suite */
+	if (CU_ADD_TEST(ParticleSuite, testCompiledFunctions) == NULL)
+		return CU_get_error();
+
+	if (CU_ADD_TEST(ParticleSuite, testInterpretedFunctions) == NULL)
+		return CU_get_error();
+
+	return CUE_SUCCESS;
+}
@@ -26,8 +26,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "test_shared.h"
 #include "test_renderer.h"
 #include "../client/cl_video.h"
+#include "../client/cl_renderer.h"
 #include "../client/renderer/r_image.h"
 #include "../client/renderer/r_model.h"
+#include "../client/renderer/r_font.h"
 
 /**
  * The suite initialization function.
@@ -158,6 +160,197 @@ static void testCharacterAnimationFiles (void)
 	FS_NextFileFromFileList(NULL);
 }
 
+/**
+ * @brief The scalar version of @c R_ScaleTexture as reference for the vectorised code paths
+ */
+static void TEST_ScaleTextureReference (const unsigned *in, int inwidth, int inheight, unsigned *out, int outwidth, int outheight)
+{
+	const unsigned fracstep = inwidth * 0x10000 / outwidth;
+	int i, j;
+
+	for (i = 0; i < outheight; i++, out += outwidth) {
+		const unsigned *inrow = in + inwidth * (int) ((i + 0.25) * inheight / outheight);
+		const unsigned *inrow2 = in + inwidth * (int) ((i + 0.75) * inheight / outheight);
+
+		for (j = 0; j < outwidth; j++) {
+			const byte *pix1 = (const byte *) (inrow + (((fracstep >> 2) + j * fracstep) >> 16));
+			const byte *pix2 = (const byte *) (inrow + ((3 * (fracstep >> 2) + j * fracstep) >> 16));
+			const byte *pix3 = (const byte *) (inrow2 + (((fracstep >> 2) + j * fracstep) >> 16));
+			const byte *pix4 = (const byte *) (inrow2 + ((3 * (fracstep >> 2) + j * fracstep) >> 16));
+			int k;
+
+			for (k = 0; k < 4; k++)
+				((byte *) (out + j))[k] = (pix1[k] + pix2[k] + pix3[k] + pix4[k]) >> 2;
+		}
+	}
+}
+
+static void testScaleTexture (void)
+{
+	/* odd sizes to also hit the remainder loop of the vectorised paths */
+	const int sizes[][4] = {{64, 64, 32, 32}, {37, 23, 64, 32}, {100, 75, 128, 128}, {13, 7, 3, 5}, {256, 1, 61, 1}};
+	int i, j;
+
+	srand(0);
+	for (i = 0; i < lengthof(sizes); i++) {
+		const int inwidth = sizes[i][0], inheight = sizes[i][1];
+		const int outwidth = sizes[i][2], outheight = sizes[i][3];
+		unsigned *in = (unsigned *)Mem_Alloc(inwidth * inheight * sizeof(unsigned));
+		unsigned *out = (unsigned *)Mem_Alloc(outwidth * outheight * sizeof(unsigned));
+		unsigned *reference = (unsigned *)Mem_Alloc(outwidth * outheight * sizeof(unsigned));
+
+		for (j = 0; j < inwidth * inheight * 4; j++)
+			((byte *)in)[j] = rand() & 0xFF;
+
+		R_ScaleTexture(in, inwidth, inheight, out, outwidth, outheight);
+		TEST_ScaleTextureReference(in, inwidth, inheight, reference, outwidth, outheight);
+		CU_ASSERT_EQUAL(memcmp(out, reference, outwidth * outheight * sizeof(unsigned)), 0);
+
+		Mem_Free(in);
+		Mem_Free(out);
+		Mem_Free(reference);
+	}
+}
+
+/**
+ * @brief The scalar version of @c R_MipMap as reference for the vectorised code paths
+ */
+static void TEST_MipMapReference (const unsigned *in, int width, int height, unsigned *out)
+{
+	const int outwidth = max(width >> 1, 1);
+	const int outheight = max(height >> 1, 1);
+	int i, j, k;
+
+	for (i = 0; i < outheight; i++) {
+		const int y1 = min(2 * i, height - 1), y2 = min(2 * i + 1, height - 1);
+		for (j = 0; j < outwidth; j++) {
+			const int x1 = min(2 * j, width - 1), x2 = min(2 * j + 1, width - 1);
+			const byte *pix1 = (const byte *) (in + y1 * width + x1);
+			const byte *pix2 = (const byte *) (in + y1 * width + x2);
+			const byte *pix3 = (const byte *) (in + y2 * width + x1);
+			const byte *pix4 = (const byte *) (in + y2 * width + x2);
+
+			for (k = 0; k < 4; k++)
+				((byte *) (out + i * outwidth + j))[k] = (pix1[k] + pix2[k] + pix3[k] + pix4[k] + 2) >> 2;
+		}
+	}
+}
+
+static void testMipMap (void)
+{
+	/* rows and columns of one pixel and widths that leave a remainder for the vectorised paths */
+	const int sizes[][2] = {{64, 64}, {8, 2}, {2, 8}, {1, 16}, {16, 1}, {2, 2}, {12, 6}, {1, 1}};
+	int i, j;
+
+	srand(0);
+	for (i = 0; i < lengthof(sizes); i++) {
+		const int width = sizes[i][0], height = sizes[i][1];
+		const int outsize = max(width >> 1, 1) * max(height >> 1, 1);
+		unsigned *in = (unsigned *)Mem_Alloc(width * height * sizeof(unsigned));
+		unsigned *out = (unsigned *)Mem_Alloc(outsize * sizeof(unsigned));
+		unsigned *reference = (unsigned *)Mem_Alloc(outsize * sizeof(unsigned));
+
+		for (j = 0; j < width * height * 4; j++)
+			((byte *)in)[j] = rand() & 0xFF;
+
+		R_MipMap(in, width, height, out);
+		TEST_MipMapReference(in, width, height, reference);
+		CU_ASSERT_EQUAL(memcmp(out, reference, outsize * sizeof(unsigned)), 0);
+
+		Mem_Free(in);
+		Mem_Free(out);
+		Mem_Free(reference);
+	}
+}
+
+static void testGammaTexture (void)
+{
+	byte pixels[256 * 4];
+	byte corrected[256 * 4];
+	int i;
+
+	for (i = 0; i < lengthof(pixels); i++)
+		pixels[i] = i / 4;
+
+	memcpy(corrected, pixels, sizeof(corrected));
+	R_GammaTexture((unsigned *)corrected, lengthof(corrected) / 4, 1.0f);
+	CU_ASSERT_EQUAL(memcmp(corrected, pixels, sizeof(pixels)), 0);
+
+	memcpy(corrected, pixels, sizeof(corrected));
+	R_GammaTexture((unsigned *)corrected, lengthof(corrected) / 4, 2.0f);
+	for (i = 0; i < lengthof(pixels); i++) {
+		if (i % 4 == 3 || pixels[i] == 0 || pixels[i] == 255)
+			CU_ASSERT_EQUAL(corrected[i], pixels[i]);
+		else
+			CU_ASSERT_TRUE(corrected[i] > pixels[i]);
+	}
+}
+
+static void testImageHasAlpha (void)
+{
+	byte pixels[11 * 4];
+	int i;
+
+	memset(pixels, 255, sizeof(pixels));
+	for (i = 0; i < lengthof(pixels); i += 4)
+		pixels[i] = i;
+	CU_ASSERT_FALSE(R_ImageHasAlpha((const unsigned *)pixels, lengthof(pixels) / 4));
+
+	/* in the vectorised part and in the remainder */
+	for (i = 0; i < lengthof(pixels) / 4; i++) {
+		pixels[i * 4 + 3] = 254;
+		CU_ASSERT_TRUE(R_ImageHasAlpha((const unsigned *)pixels, lengthof(pixels) / 4));
+		CU_ASSERT_EQUAL(R_ImageHasAlpha((const unsigned *)pixels, i), qfalse);
+		pixels[i * 4 + 3] = 255;
+	}
+}
+
+/**
+ * @brief The text layout only works on the cached glyph metrics - so it can be checked without a GL context
+ */
+static void testFontLayout (void)
+{
+	const char *text = "The quick brown fox jumps over the lazy dog. Sphinx of black quartz, judge my vow.";
+	const font_t *font;
+	int width, height, lines, fullWidth, ttfWidth;
+	qboolean truncated;
+
+	R_FontInit();
+	R_FontRegister("f_test", 14, "media/DejaVuSans.ttf", NULL);
+	font = R_GetFont("f_test");
+	CU_ASSERT_PTR_NOT_NULL_FATAL(font);
+
+	R_FontTextSize("f_test", text, 0, LONGLINES_WRAP, &fullWidth, &height, &lines, &truncated);
+	CU_ASSERT_EQUAL(lines, 1);
+	CU_ASSERT_EQUAL(height, font->height);
+	CU_ASSERT_FALSE(truncated);
+	/* the glyph metrics and the kerning pairs must add up to what SDL_ttf renders */
+	TTF_SizeUTF8(font->font, text, &ttfWidth, NULL);
+	CU_ASSERT(abs(fullWidth - ttfWidth) <= 2);
+
+	R_FontTextSize("f_test", text, fullWidth / 2, LONGLINES_WRAP, &width, &height, &lines, &truncated);
+	CU_ASSERT(lines >= 2);
+	CU_ASSERT(width <= fullWidth / 2);
+	CU_ASSERT_EQUAL(height, (lines - 1) * font->lineSkip + font->height);
+	CU_ASSERT_FALSE(truncated);
+
+	R_FontTextSize("f_test", text, fullWidth / 2, LONGLINES_PRETTYCHOP, &width, NULL, &lines, &truncated);
+	CU_ASSERT_EQUAL(lines, 1);
+	CU_ASSERT(width <= fullWidth / 2);
+	CU_ASSERT_TRUE(truncated);
+
+	/* mandatory breaks and empty lines */
+	R_FontTextSize("f_test", "a\nb\n\nc", 0, LONGLINES_WRAP, NULL, NULL, &lines, NULL);
+	CU_ASSERT_EQUAL(lines, 4);
+
+	/* non-ascii glyphs */
+	R_FontTextSize("f_test", "Командующий, я чрезвычайно рад доложить", 100, LONGLINES_WRAP, &width, NULL, &lines, NULL);
+	CU_ASSERT(lines >= 2);
+	CU_ASSERT(width <= 100);
+
+	R_FontShutdown();
+}
+
 int UFO_AddRendererTests (void)
 {
 	/* add a suite to the registry */
@@ -173,5 +366,20 @@ int UFO_AddRendererTests (void)
 	if (CU_ADD_TEST(RendererSuite, testCharacterAnimationFiles) == NULL)
 		return CU_get_error();
 
+	if (CU_ADD_TEST(RendererSuite, testScaleTexture) == NULL)
+		return CU_get_error();
+
+	if (CU_ADD_TEST(RendererSuite, testMipMap) == NULL)
+		return CU_get_error();
+
+	if (CU_ADD_TEST(RendererSuite, testGammaTexture) == NULL)
+		return CU_get_error();
+
+	if (CU_ADD_TEST(RendererSuite, testImageHasAlpha) == NULL)
+		return CU_get_error();
+
+	if (CU_ADD_TEST(RendererSuite, testFontLayout) == NULL)
+		return CU_get_error();
+
 	return CUE_SUCCESS;
 }
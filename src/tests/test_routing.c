@@ -28,6 +28,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../common/common.h"
 #include "../common/cmodel.h"
 #include "../common/grid.h"
+#include "../common/routing.h"
+#include "../common/qfiles.h"
 #include "../game/g_local.h"
 #include "../server/server.h"
 
@@ -66,6 +68,68 @@ static void testMapLoading (void)
 	}
 }
 
+static void testRoutingCompression (void)
+{
+	static byte data[4096], out[4096];
+	static byte packed[RT_COMPRESSED_MAXLENGTH(sizeof(data))];
+	/* "aaaaab" in the byte oriented encoding - a run of 3 + 2 bytes and a literal of one byte */
+	const byte oldPacked[] = {0x83, 'a', 0x01, 'b', 0x00};
+	const byte *src;
+	byte *end;
+	int i;
+
+	/* long runs of empty cells mixed with short patterns */
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = (i / 300) % 2 ? i % 7 / 3 : 0;
+
+	end = RT_CompressRouting(data, packed, sizeof(data));
+	CU_ASSERT_TRUE(end - packed <= RT_COMPRESSED_MAXLENGTH(sizeof(data)));
+	src = packed;
+	CU_ASSERT_EQUAL(RT_DeCompressRouting(&src, end, out, sizeof(out), BSPVERSION), sizeof(data));
+	CU_ASSERT_PTR_EQUAL(src, end);
+	CU_ASSERT_EQUAL(memcmp(data, out, sizeof(data)), 0);
+
+	/* broken data is rejected */
+	src = packed;
+	CU_ASSERT_EQUAL(RT_DeCompressRouting(&src, end - 1, out, sizeof(out), BSPVERSION), -1);
+	src = packed;
+	CU_ASSERT_EQUAL(RT_DeCompressRouting(&src, end, out, sizeof(out) - 1, BSPVERSION), -1);
+
+	/* maps of the old version can still be loaded */
+	src = oldPacked;
+	CU_ASSERT_EQUAL(RT_DeCompressRouting(&src, oldPacked + sizeof(oldPacked), out, sizeof(out), BSPVERSION_OLDROUTING), 6);
+	CU_ASSERT_EQUAL(memcmp(out, "aaaaab", 6), 0);
+}
+
+/**
+ * @brief The routing of an assembly must not depend on the threads that decoded the tiles
+ */
+static void testMapLoadingThreaded (void)
+{
+	static mapData_t mapDataThreaded;
+	const char *tiles = "test_routing test_routing test_routing";
+	const char *pos = "0 0 0 8 0 0 0 8 0";
+
+	if (FS_CheckFile("maps/%s.bsp", mapName) == -1) {
+		UFO_CU_FAIL_MSG_FATAL(va("Map resource '%s.bsp' for test is missing.", mapName));
+	}
+
+	CM_Init();
+	Cvar_Set("cm_routingcache", "0");
+
+	Cvar_Set("cm_loadthreads", "0");
+	CM_LoadMap(tiles, qtrue, pos, &mapData, &mapTiles);
+	Cvar_Set("cm_loadthreads", "2");
+	CM_LoadMap(tiles, qtrue, pos, &mapDataThreaded, &mapTiles);
+
+	CU_ASSERT_EQUAL(mapTiles.numTiles, 3);
+	CU_ASSERT_EQUAL(mapData.mapChecksum, mapDataThreaded.mapChecksum);
+	CU_ASSERT_TRUE(VectorCompare(mapData.mapMin, mapDataThreaded.mapMin));
+	CU_ASSERT_TRUE(VectorCompare(mapData.mapMax, mapDataThreaded.mapMax));
+	CU_ASSERT_EQUAL(memcmp(mapData.reroute, mapDataThreaded.reroute, sizeof(mapData.reroute)), 0);
+	CU_ASSERT_EQUAL(memcmp(mapData.map, mapDataThreaded.map, sizeof(mapData.map)), 0);
+}
+
 static void testMove (void)
 {
 	routing_t *routing;
@@ -351,6 +415,12 @@ int UFO_AddRoutingTests (void)
 	if (CU_ADD_TEST(routingSuite, testMapLoading) == NULL)
 		return CU_get_error();
 
+	if (CU_ADD_TEST(routingSuite, testRoutingCompression) == NULL)
+		return CU_get_error();
+
+	if (CU_ADD_TEST(routingSuite, testMapLoadingThreaded) == NULL)
+		return CU_get_error();
+
 	if (CU_ADD_TEST(routingSuite, testMove) == NULL)
 		return CU_get_error();
 
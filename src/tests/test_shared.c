@@ -95,6 +95,7 @@ void TEST_Init (void)
 
 	http_timeout = Cvar_Get("noname", "", 0, NULL);
 	http_proxy = Cvar_Get("noname", "", 0, NULL);
+	http_maxrequests = Cvar_Get("noname", "", 0, NULL);
 }
 
 
@@ -281,6 +281,45 @@ static void testSamples (void)
 	TEST_ParseScript("ufos/uisample/*.ufo");
 }
 
+/**
+ * @brief test that compiled strings with injection give the same result as the string interpreter
+ */
+static void testCompiledInjection (void)
+{
+	const char *strings[] = {
+		"set foo <cvar:test_injection>;",
+		"<cvar:test_injection><cvar:test_injection> and text",
+		"<path:this> <1> <unknown>",
+		"a <b> < c <cvar:test_injection",
+		"x<path:foo>.<cvar:test_injection>"
+	};
+	uiCallContext_t context;
+	int i;
+
+	OBJZERO(context);
+	Cvar_Set("test_injection", "value");
+
+	for (i = 0; i < lengthof(strings); i++) {
+		uiAction_t action;
+		char compiled[256];
+
+		OBJZERO(action);
+		action.type = EA_CMD;
+		action.d.terminal.d1.constString = strings[i];
+		UI_CompileInjectedString(&action);
+		CU_ASSERT_PTR_NOT_NULL(action.d.terminal.d2.data);
+
+		Q_strncpyz(compiled, UI_GenInjectedActionString(&action, qtrue, &context), sizeof(compiled));
+		CU_ASSERT_STRING_EQUAL(compiled, UI_GenInjectedString(strings[i], qtrue, &context));
+
+		/* cached cvar pointers must not be used after the cvar was freed */
+		Cvar_Delete("test_injection");
+		Q_strncpyz(compiled, UI_GenInjectedActionString(&action, qtrue, &context), sizeof(compiled));
+		CU_ASSERT_STRING_EQUAL(compiled, UI_GenInjectedString(strings[i], qtrue, &context));
+		Cvar_Set("test_injection", "value");
+	}
+}
+
 int UFO_AddUILevel2Tests (void)
 {
 	/* add a suite to the registry */
@@ -318,5 +357,7 @@ int UFO_AddUILevel2Tests (void)
 		return CU_get_error();
 	if (CU_ADD_TEST(UISuite, testSamples) == NULL)
 		return CU_get_error();
+	if (CU_ADD_TEST(UISuite, testCompiledInjection) == NULL)
+		return CU_get_error();
 	return CUE_SUCCESS;
 }
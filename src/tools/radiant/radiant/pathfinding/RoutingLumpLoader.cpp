@@ -4,6 +4,7 @@
 #include "ifilesystem.h"
 #include "gtkutil/dialog.h"
 #include "radiant_i18n.h"
+#include <cstring>
 
 #include "../../../shared/ufotypes.h"
 #include "../../../shared/typedefs.h"
@@ -18,12 +19,13 @@ namespace routing
 
 	/**
 	 * @param[in] source Source will be set to the end of the compressed data block!
-	 * @sa CompressRouting (ufo2map)
+	 * @param[in] version The bsp version - @c BSPVERSION_OLDROUTING maps use the byte oriented encoding
+	 * @sa RT_CompressRouting
+	 * @sa RT_DeCompressRouting
 	 * @sa CMod_LoadRouting
 	 */
-	static int CMod_DeCompressRouting (byte ** source, byte * dataStart)
+	static int CMod_DeCompressRouting (byte ** source, byte * dataStart, unsigned int version)
 	{
-		int i, c;
 		byte *data_p;
 		byte *src;
 
@@ -31,19 +33,36 @@ namespace routing
 		src = *source;
 
 		while (*src) {
-			if (*src & 0x80) {
-				/* repetitions */
-				c = *src++ & ~0x80;
+			const byte header = *src++;
+			int c;
+
+			if (version == BSPVERSION_OLDROUTING) {
 				/* Remember that the total bytes that are the same is c + 2 */
-				for (i = 0; i < c + 2; i++)
-					*data_p++ = *src;
+				c = (header & ~0x80) + ((header & 0x80) ? 2 : 0);
+			} else {
+				/* the lower six bits of the count are in the header, seven more per following byte */
+				c = header & 0x3F;
+				if (header & 0x40) {
+					int shift = 6;
+					byte more;
+					do {
+						more = *src++;
+						c |= (more & 0x7F) << shift;
+						shift += 7;
+					} while (more & 0x80);
+				}
+			}
+
+			if (header & 0x80) {
+				/* repetitions */
+				memset(data_p, *src, c);
 				src++;
 			} else {
 				/* identities */
-				c = *src++;
-				for (i = 0; i < c; i++)
-					*data_p++ = *src++;
+				memcpy(data_p, src, c);
+				src += c;
 			}
+			data_p += c;
 		}
 
 		src++;
@@ -139,6 +158,7 @@ namespace routing
 
 	/**
 	 * @param[in] l Routing lump ... (routing data lump from bsp file)
+	 * @param[in] version The version of the bsp file
 	 * @param[in] sX The x position on the world plane (grid position) - values from -(PATHFINDING_WIDTH/2) up to PATHFINDING_WIDTH/2 are allowed
 	 * @param[in] sY The y position on the world plane (grid position) - values from -(PATHFINDING_WIDTH/2) up to PATHFINDING_WIDTH/2 are allowed
 	 * @param[in] sZ The height level on the world plane (grid position) - values from 0 - PATHFINDING_HEIGHT are allowed
@@ -146,7 +166,7 @@ namespace routing
 	 * @todo TEST z-level routing
 	 */
 	static void CMod_LoadRouting (RoutingLump& routingLump, const std::string& name, const lump_t * l,
-			byte* cModelBase, int sX, int sY, int sZ)
+			byte* cModelBase, unsigned int version, int sX, int sY, int sZ)
 	{
 		static routing_t tempMap[ACTOR_MAX_SIZE];
 		static routing_t clMap[ACTOR_MAX_SIZE];
@@ -169,11 +189,11 @@ namespace routing
 
 		source = cModelBase + GUINT32_TO_LE(l->fileofs);
 
-		i = CMod_DeCompressRouting(&source, (byte*) curTile.wpMins);
+		i = CMod_DeCompressRouting(&source, (byte*) curTile.wpMins, version);
 		length = i;
-		i = CMod_DeCompressRouting(&source, (byte*) curTile.wpMaxs);
+		i = CMod_DeCompressRouting(&source, (byte*) curTile.wpMaxs, version);
 		length += i;
-		i = CMod_DeCompressRouting(&source, (byte*) tempMap);
+		i = CMod_DeCompressRouting(&source, (byte*) tempMap, version);
 		length += i;
 
 		if (length != targetLength) {
@@ -255,7 +275,14 @@ namespace routing
 		dBspHeader_t *header = (dBspHeader_t *) buf;
 		stream.read(buf, size);
 
-		CMod_LoadRouting(_routingLump, file.getName(), &header->lumps[LUMP_ROUTING], (byte *) buf, 0, 0, 0);
+		const unsigned int version = GUINT32_TO_LE(header->version);
+		if (!BSP_IsSupportedVersion(version)) {
+			g_warning("%s has version %u, not %u", file.getName().c_str(), version, BSPVERSION);
+			free(buf);
+			return;
+		}
+
+		CMod_LoadRouting(_routingLump, file.getName(), &header->lumps[LUMP_ROUTING], (byte *) buf, version, 0, 0, 0);
 		free(buf);
 	}
 
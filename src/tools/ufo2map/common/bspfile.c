@@ -27,57 +27,40 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "bspfile.h"
 #include "scriplib.h"
 #include "../bsp.h"
+#include "../../../common/routing.h"
 #include <errno.h>
 
 /**
- * @brief Compress the routing data of a map
- * @sa CMod_DeCompressRouting
- * @sa CMod_LoadRouting
+ * @brief Converts the routing lump of a map that was compiled with @c BSPVERSION_OLDROUTING
+ * to the current encoding - the file is written back with @c BSPVERSION
+ * @sa RT_DeCompressRouting
  */
-byte *CompressRouting (byte *dataStart, byte *destStart, int l)
+static void ConvertOldRouting (const char *filename)
 {
-	int c;
-	byte val;
-	byte *data, *dend, *dest_p, *count_p;
-
-	dest_p = destStart;
-	data = dataStart;
-	dend = dataStart + l;
-
-	while (data < dend) {
-		if (data + 1 < dend && *data == *(data + 1)) {
-			/* repetitions */
-			val = *data++;
-			data++; /* Advance data again.  The first two bytes are identical!!! */
-			c = 0; /* This means 2 bytes are the same.  Total bytes the same is 2 + c */
-			/* Loop while the piece of data being looked at equals val */
-			while (data + 1 < dend && val == *(data)) {
-				if (c >= SCHAR_MAX) /* must fit into one byte */
-					break;
-				data++;
-				c++;
-			}
-			count_p = dest_p;
-			*dest_p++ = (byte)(c) | 0x80;
-			*dest_p++ = val;
-		} else {
-			/* identities */
-			count_p = dest_p++;
-			c = 0;
-			while ((data + 1 < dend && *data != *(data + 1)) || data == dend - 1) {
-				if (c >= SCHAR_MAX) /* must fit into one byte */
-					break;
-				*dest_p++ = *data++;
-				c++;
-			}
-			*count_p = (byte)c;
-		}
+	const int blockLength[] = {sizeof(ipos3_t), sizeof(ipos3_t), sizeof(routing_t) * ACTOR_MAX_SIZE};
+	const int length = blockLength[0] + blockLength[1] + blockLength[2];
+	byte *data = (byte *)Mem_Alloc(length);
+	const byte *src = curTile->routedata;
+	const byte *end = curTile->routedata + curTile->routedatasize;
+	byte *dest;
+	int i, offset = 0;
+
+	for (i = 0; i < lengthof(blockLength); i++) {
+		if (RT_DeCompressRouting(&src, end, data + offset, blockLength[i], BSPVERSION_OLDROUTING) != blockLength[i])
+			Sys_Error("%s has a broken routing lump", filename);
+		offset += blockLength[i];
 	}
 
-	/* terminate compressed data */
-	*dest_p++ = 0;
+	dest = curTile->routedata;
+	offset = 0;
+	for (i = 0; i < lengthof(blockLength); i++) {
+		dest = RT_CompressRouting(data + offset, dest, blockLength[i]);
+		offset += blockLength[i];
+	}
+	curTile->routedatasize = dest - curTile->routedata;
+	assert(curTile->routedatasize <= MAX_MAP_ROUTING);
 
-	return dest_p;
+	Mem_Free(data);
 }
 
 /**
@@ -248,7 +231,7 @@ dMapTile_t *LoadBSPFile (const char *filename)
 
 	if (header->ident != IDBSPHEADER)
 		Sys_Error("%s is not a IBSP file", filename);
-	if (header->version != BSPVERSION)
+	if (!BSP_IsSupportedVersion(header->version))
 		Sys_Error("%s is version %i, not %i", filename, header->version, BSPVERSION);
 
 	curTile->nummodels = CopyLump(header, LUMP_MODELS, curTile->models, sizeof(dBspModel_t));
@@ -268,6 +251,8 @@ dMapTile_t *LoadBSPFile (const char *filename)
 	curTile->lightdatasize[LIGHTMAP_NIGHT] = CopyLump(header, LUMP_LIGHTING_NIGHT, curTile->lightdata[LIGHTMAP_NIGHT], 1);
 	curTile->lightdatasize[LIGHTMAP_DAY] = CopyLump(header, LUMP_LIGHTING_DAY, curTile->lightdata[LIGHTMAP_DAY], 1);
 	curTile->entdatasize = CopyLump(header, LUMP_ENTITIES, curTile->entdata, 1);
+	if (header->version == BSPVERSION_OLDROUTING)
+		ConvertOldRouting(filename);
 
 	/* Because the tracing functions use cBspBrush_t and not dBspBrush_t,
 	 * copy data from curTile->dbrushes into curTile->cbrushes */
@@ -67,6 +67,5 @@ vec_t FloatForKey(const entity_t *ent, const char *key);
 void GetVectorFromString(const char *value, vec3_t vec);
 void GetVectorForKey(const entity_t *ent, const char *key, vec3_t vec);
 epair_t *ParseEpair(void);
-byte *CompressRouting(byte *dataStart, byte *destStart, int l);
 
 #endif /* _BSP_FILE */
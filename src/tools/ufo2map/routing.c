@@ -189,11 +189,11 @@ void DoRouting (void)
 	data = curTile->routedata;
 	for (i = 0; i < 3; i++)
 		wpMins[i] = LittleLong(wpMins[i]);
-	data = CompressRouting((byte*)wpMins, data, sizeof(wpMins));
+	data = RT_CompressRouting((const byte*)wpMins, data, sizeof(wpMins));
 	for (i = 0; i < 3; i++)
 		wpMaxs[i] = LittleLong(wpMaxs[i]);
-	data = CompressRouting((byte*)wpMaxs, data, sizeof(wpMaxs));
-	data = CompressRouting((byte*)Nmap, data, sizeof(Nmap));
+	data = RT_CompressRouting((const byte*)wpMaxs, data, sizeof(wpMaxs));
+	data = RT_CompressRouting((const byte*)Nmap, data, sizeof(Nmap));
 
 	curTile->routedatasize = data - curTile->routedata;
 
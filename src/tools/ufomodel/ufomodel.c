@@ -35,9 +35,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "../../client/renderer/r_model.h"
 #include "../../client/renderer/r_state.h"
 #include "../../shared/images.h"
+#include "../../shared/mutex.h"
+#include "../../common/list.h"
+#include "../../common/md4.h"
 
 #define VERSION "0.2"
 
+#define MAX_THREADS 32
+
 rstate_t r_state;
 image_t *r_noTexture;
 
@@ -45,6 +50,7 @@ typedef enum {
 	ACTION_NONE,
 
 	ACTION_MDX,
+	ACTION_AMC,
 	ACTION_SKINEDIT,
 	ACTION_CHECK,
 	ACTION_SKINFIX,
@@ -57,6 +63,7 @@ typedef struct modelConfig_s {
 	char fileName[MAX_QPATH];
 	ufoModelAction_t action;
 	float smoothness;
+	int threads;
 	char inputName[MAX_QPATH];
 } modelConfig_t;
 
@@ -179,8 +186,10 @@ void Com_Error (int code, const char *fmt, ...)
 /**
  * @brief Loads in a model for the given name
  * @param[in] name Filename relative to base dir and with extension (models/model.md2)
+ * @param[out] checksum The checksum of the model file, can be @c NULL
+ * @note The vertices of the meshes are not merged
  */
-static model_t *LoadModel (const char *name)
+static model_t *LoadModel (const char *name, unsigned *checksum)
 {
 	model_t *mod;
 	byte *buf;
@@ -193,6 +202,9 @@ static model_t *LoadModel (const char *name)
 		return NULL;
 	}
 
+	if (checksum)
+		*checksum = Com_BlockChecksum(buf, modfilelen);
+
 	mod = (model_t *)Mem_PoolAlloc(sizeof(*mod), vid_modelPool, 0);
 	Q_strncpyz(mod->name, name, sizeof(mod->name));
 
@@ -209,7 +221,7 @@ static model_t *LoadModel (const char *name)
 
 	case IDMD3HEADER:
 		/* MD3 header */
-		R_ModLoadAliasMD3Model(mod, buf, modfilelen);
+		R_ModLoadAliasMD3Model(mod, buf, modfilelen, qfalse);
 		break;
 
 	default:
@@ -273,7 +285,7 @@ static int PrecalcNormalsAndTangents (const char *filename)
 		return 0;
 	}
 
-	mod = LoadModel(filename);
+	mod = LoadModel(filename, NULL);
 	if (!mod)
 		Com_Error(ERR_DROP, "Could not load %s", filename);
 
@@ -311,10 +323,177 @@ static void PrecalcNormalsAndTangentsBatch (const char *pattern)
 	Com_Printf("%i/%i\n", cntCalculated, cntAll);
 }
 
+/** @brief The vertex merging of one mesh for the mesh cache */
+typedef struct meshCacheEntry_s {
+	int numVerts;
+	int numIndexes;
+	int32_t indexes[MAX_ALIAS_VERTS];
+	int32_t sourceVerts[MAX_ALIAS_VERTS];
+} meshCacheEntry_t;
+
+/** @brief protects the filesystem, the model loading and the console output of the mesh cache threads */
+static threads_mutex_t *meshCacheLock;
+static linkedList_t *meshCacheFiles;
+static int meshCacheCalculated;
+
+static void WriteMeshCache (const char *fileName, unsigned checksum, const meshCacheEntry_t *entries, int numMeshes)
+{
+	dAMCHeader_t header;
+	qFILE f;
+	int i, j;
+
+	Com_Printf("  \\ - writing to file '%s'\n", fileName);
+
+	FS_OpenFile(fileName, &f, FILE_WRITE);
+	if (!f.f) {
+		Com_Printf("  \\ - can not open '%s' for writing\n", fileName);
+		return;
+	}
+
+	header.ident = LittleLong(IDAMCHEADER);
+	header.version = LittleLong(AMC_VERSION);
+	header.checksum = LittleLong(checksum);
+	header.numMeshes = LittleLong(numMeshes);
+	FS_Write(&header, sizeof(header), &f);
+
+	for (i = 0; i < numMeshes; i++) {
+		const meshCacheEntry_t *entry = &entries[i];
+		dAMCMesh_t mesh;
+
+		mesh.numVerts = LittleLong(entry->numVerts);
+		mesh.numIndexes = LittleLong(entry->numIndexes);
+		FS_Write(&mesh, sizeof(mesh), &f);
+
+		for (j = 0; j < entry->numIndexes; j++) {
+			const int32_t idx = LittleLong(entry->indexes[j]);
+			FS_Write(&idx, sizeof(idx), &f);
+		}
+		for (j = 0; j < entry->numVerts; j++) {
+			const int32_t idx = LittleLong(entry->sourceVerts[j]);
+			FS_Write(&idx, sizeof(idx), &f);
+		}
+	}
+
+	FS_CloseFile(&f);
+}
+
+/**
+ * @brief Generates the mesh cache file for a md2 or md3 model
+ * @note Can be called from several threads at once - only the vertex merging itself runs in parallel
+ * @sa R_ModLoadMeshCache
+ */
+static int PrecalcMeshCache (const char *filename)
+{
+	char amcFileName[MAX_QPATH];
+	meshCacheEntry_t *entries;
+	model_t *mod;
+	unsigned checksum;
+	int i, numMeshes;
+
+	Com_StripExtension(filename, amcFileName, sizeof(amcFileName));
+	Q_strcat(amcFileName, ".amc", sizeof(amcFileName));
+
+	TH_MutexLock(meshCacheLock);
+	Com_Printf("- model '%s'\n", filename);
+
+	if (!config.overwrite && FS_CheckFile("%s", amcFileName) != -1) {
+		Com_Printf("  \\ - amc already exists\n");
+		TH_MutexUnlock(meshCacheLock);
+		return 0;
+	}
+
+	mod = LoadModel(filename, &checksum);
+	if (!mod)
+		Com_Error(ERR_DROP, "Could not load %s", filename);
+	TH_MutexUnlock(meshCacheLock);
+
+	if (mod->type != mod_alias_md2 && mod->type != mod_alias_md3) {
+		Com_Printf("  \\ - only md2 and md3 models have a mesh cache\n");
+		return 0;
+	}
+
+	/* the lod meshes of md2 models are stored in the cache files of the lod models */
+	numMeshes = mod->type == mod_alias_md2 ? 1 : mod->alias.num_meshes;
+	entries = (meshCacheEntry_t *)Mem_PoolAlloc(sizeof(*entries) * numMeshes, vid_modelPool, 0);
+	for (i = 0; i < numMeshes; i++) {
+		const mAliasMesh_t *mesh = &mod->alias.meshes[i];
+		entries[i].numIndexes = mesh->num_tris * 3;
+		entries[i].numVerts = R_ModFindUniqueVertices(mesh, config.smoothness, entries[i].indexes, entries[i].sourceVerts);
+	}
+
+	TH_MutexLock(meshCacheLock);
+	Com_Printf("- model '%s': # meshes '%i', # frames '%i'\n", filename, numMeshes, mod->alias.num_frames);
+	WriteMeshCache(amcFileName, checksum, entries, numMeshes);
+	TH_MutexUnlock(meshCacheLock);
+
+	Mem_Free(entries);
+
+	return 1;
+}
+
+static int MeshCacheThread (void *data)
+{
+	for (;;) {
+		char filename[MAX_QPATH];
+		int calculated;
+
+		TH_MutexLock(meshCacheLock);
+		if (meshCacheFiles == NULL) {
+			TH_MutexUnlock(meshCacheLock);
+			break;
+		}
+		Q_strncpyz(filename, (const char *)meshCacheFiles->data, sizeof(filename));
+		LIST_RemoveEntry(&meshCacheFiles, meshCacheFiles);
+		TH_MutexUnlock(meshCacheLock);
+
+		calculated = PrecalcMeshCache(filename);
+
+		TH_MutexLock(meshCacheLock);
+		meshCacheCalculated += calculated;
+		TH_MutexUnlock(meshCacheLock);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Generates the mesh cache files for all md2 and md3 models with @c config.threads threads
+ */
+static void PrecalcMeshCacheBatch (void)
+{
+	const char *patterns[] = {"**.md2", "**.md3"};
+	SDL_Thread *threads[MAX_THREADS];
+	int i, cntAll;
+
+	for (i = 0; i < lengthof(patterns); i++) {
+		const char *filename;
+
+		FS_BuildFileList(patterns[i]);
+		while ((filename = FS_NextFileFromFileList(patterns[i])) != NULL)
+			LIST_AddString(&meshCacheFiles, filename);
+		FS_NextFileFromFileList(NULL);
+	}
+
+	cntAll = LIST_Count(meshCacheFiles);
+	meshCacheCalculated = 0;
+
+	if (config.threads <= 1) {
+		MeshCacheThread(NULL);
+	} else {
+		for (i = 0; i < config.threads; i++)
+			threads[i] = SDL_CreateThread(MeshCacheThread, NULL);
+		for (i = 0; i < config.threads; i++)
+			SDL_WaitThread(threads[i], NULL);
+	}
+
+	Com_Printf("%i/%i\n", meshCacheCalculated, cntAll);
+}
+
 static void Usage (void)
 {
 	Com_Printf("Usage:\n");
 	Com_Printf(" -mdx                     generate mdx files\n");
+	Com_Printf(" -amc                     generate the mesh cache files for md2 and md3 models\n");
 	Com_Printf(" -skinfix                 fix skins for md2 models\n");
 	Com_Printf(" -glcmds                  remove the unused glcmds from md2 models\n");
 	Com_Printf(" -check                   perform general checks for all the models\n");
@@ -322,6 +501,7 @@ static void Usage (void)
 	Com_Printf(" -overwrite               overwrite existing mdx files\n");
 	Com_Printf(" -s <float>               sets the smoothness value for normal-smoothing (in the range -1.0 to 1.0)\n");
 	Com_Printf(" -f <filename>            build tangentspace for the specified model file\n");
+	Com_Printf(" -t <threads>             amount of threads for generating the mesh cache files\n");
 	Com_Printf(" -v --verbose             print debug messages\n");
 	Com_Printf(" -h --help                show this help screen\n");
 }
@@ -329,6 +509,7 @@ static void Usage (void)
 static void UM_DefaultParameter (void)
 {
 	config.smoothness = 0.5;
+	config.threads = 1;
 }
 
 /**
@@ -349,8 +530,16 @@ static void UM_Parameter (int argc, char **argv)
 				Usage();
 				Exit(1);
 			}
+		} else if (Q_streq(argv[i], "-t") && (i + 1 < argc)) {
+			config.threads = atoi(argv[++i]);
+			if (config.threads < 1 || config.threads > MAX_THREADS) {
+				Usage();
+				Exit(1);
+			}
 		} else if (Q_streq(argv[i], "-mdx")) {
 			config.action = ACTION_MDX;
+		} else if (Q_streq(argv[i], "-amc")) {
+			config.action = ACTION_AMC;
 		} else if (Q_streq(argv[i], "-glcmds")) {
 			config.action = ACTION_GLCMDSREMOVE;
 		} else if (Q_streq(argv[i], "-skinfix")) {
@@ -700,6 +889,15 @@ int main (int argc, char **argv)
 		}
 		break;
 
+	case ACTION_AMC:
+		meshCacheLock = TH_MutexCreate("meshcache");
+		if (config.inputName[0] == '\0')
+			PrecalcMeshCacheBatch();
+		else
+			PrecalcMeshCache(config.inputName);
+		TH_MutexDestroy(meshCacheLock);
+		break;
+
 	case ACTION_SKINEDIT:
 		ModelWorker(MD2SkinEdit, config.fileName, NULL);
 		break;
@@ -0,0 +1,698 @@
+/**
+ * @file ufoswarm.c
+ * @brief Dedicated server with a swarm of headless clients for load testing
+ * @note This replaces the client stub of the dedicated server. Every bot of the swarm talks the
+ * client protocol over its own loopback connection to the server of this process: it runs through
+ * the connection handshake, joins a team, spawns its soldiers and moves and shoots at a given rate.
+ * The swarm measures the time until the server answers an action and samples the duration of the
+ * server frames, so there is no GPU and no second process needed.
+ * @note Usage: <tt>ufoswarm +set sv_maxclients 8 +map <map> +swarm_start 8</tt> - @c swarm_report prints
+ * the statistics, @c swarm_stop disconnects the bots and prints the statistics one last time.
+ * @sa sv_clientstub.c
+ */
+
+/*
+Copyright (C) 2002-2011 UFO: Alien Invasion.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "../common/common.h"
+#include "../server/server.h"
+#include "../ports/system.h"
+#include "../shared/parse.h"
+
+#define SWARM_MAX_ACTORS 12
+#define SWARM_MAX_ENEMIES 64
+/** actions that are not answered within this time are counted as lost */
+#define SWARM_ACTION_TIMEOUT 2000
+
+typedef enum {
+	SWARM_FREE,
+	SWARM_CONNECTING,	/**< waiting for client_connect */
+	SWARM_CONNECTED,	/**< waiting for the server to spawn the soldiers */
+	SWARM_SPAWNED,		/**< team info is sent - waiting for the match start */
+	SWARM_PLAYING
+} swarmState_t;
+
+typedef struct swarmActor_s {
+	int entnum;
+	pos3_t pos;
+} swarmActor_t;
+
+typedef struct swarmBot_s {
+	struct net_stream *stream;
+	swarmState_t state;
+	unsigned int seed;		/**< every bot has its own random sequence to make the runs reproducible */
+	int playerNum;
+	int team;
+	int activeTeam;
+
+	swarmActor_t actors[SWARM_MAX_ACTORS];
+	int numActors;
+	swarmActor_t enemies[SWARM_MAX_ENEMIES];	/**< the enemies that are visible for the bot */
+	int numEnemies;
+
+	int nextAction;
+	int actionsThisRound;
+	int actionSent;			/**< time the pending action was sent or @c 0 */
+	uint64_t actionStart;
+} swarmBot_t;
+
+/** @brief Histogram buckets in microseconds */
+static const int swarmBuckets[] = {1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000};
+
+typedef struct swarmHistogram_s {
+	int counts[lengthof(swarmBuckets) + 1];
+	int samples;
+	int maxTime;
+	double totalTime;
+} swarmHistogram_t;
+
+typedef struct swarmStats_s {
+	swarmHistogram_t latency;	/**< time between an action and the first event the server sends back */
+	swarmHistogram_t frames;	/**< duration of the server frames */
+	int moves;
+	int shots;
+	int endRounds;
+	int lostActions;
+	int framesOverBudget;
+	int lastServerFrame;
+	uint64_t startTime;
+} swarmStats_t;
+
+static swarmBot_t swarmBots[MAX_CLIENTS];
+static int swarmNumBots;
+static qboolean swarmScheduled;
+static swarmStats_t swarmStats;
+
+static cvar_t *swarm_freq;
+static cvar_t *swarm_actionrate;
+static cvar_t *swarm_actions;
+static cvar_t *swarm_shootchance;
+static cvar_t *swarm_soldiers;
+static cvar_t *swarm_teams;
+static cvar_t *swarm_teamdef;
+static cvar_t *swarm_seed;
+
+static int SWARM_Rand (swarmBot_t *bot, int range)
+{
+	bot->seed = bot->seed * 1103515245 + 12345;
+	return (bot->seed >> 16) % range;
+}
+
+static void SWARM_AddSample (swarmHistogram_t *histogram, int usec)
+{
+	int i;
+
+	for (i = 0; i < lengthof(swarmBuckets); i++)
+		if (usec < swarmBuckets[i])
+			break;
+
+	histogram->counts[i]++;
+	histogram->samples++;
+	histogram->totalTime += usec;
+	histogram->maxTime = max(histogram->maxTime, usec);
+}
+
+static void SWARM_PrintHistogram (const char *title, const swarmHistogram_t *histogram)
+{
+	int i;
+
+	Com_Printf("%s: %i samples, mean %.2fms, max %.2fms\n", title, histogram->samples,
+			histogram->totalTime / 1000.0 / max(histogram->samples, 1), histogram->maxTime / 1000.0f);
+	for (i = 0; i <= lengthof(swarmBuckets); i++) {
+		if (!histogram->counts[i])
+			continue;
+		if (i < lengthof(swarmBuckets))
+			Com_Printf("  < %7.1fms %8i\n", swarmBuckets[i] / 1000.0f, histogram->counts[i]);
+		else
+			Com_Printf("  >=%7.1fms %8i\n", swarmBuckets[i - 1] / 1000.0f, histogram->counts[i]);
+	}
+}
+
+static void SWARM_StringCmd (swarmBot_t *bot, const char *cmd)
+{
+	struct dbuffer *msg = new_dbuffer();
+	NET_WriteByte(msg, clc_stringcmd);
+	NET_WriteString(msg, cmd);
+	NET_WriteMsg(bot->stream, msg);
+}
+
+/**
+ * @brief Searches a rifle like weapon that can be fired with one magazine for the soldiers
+ */
+static const objDef_t *SWARM_GetWeapon (void)
+{
+	int i;
+
+	for (i = 0; i < csi.numODs; i++) {
+		const objDef_t *od = &csi.ods[i];
+		if (od->weapon && od->isPrimary && !od->isVirtual && !od->isDummy && !od->oneshot && od->numAmmos > 0)
+			return od;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Sends the soldiers of the bot to the server
+ * @sa GAME_SendCurrentTeamSpawningInfo
+ * @sa G_ClientTeamInfo
+ */
+static void SWARM_SendTeamInfo (swarmBot_t *bot)
+{
+	const objDef_t *weapon = SWARM_GetWeapon();
+	const int num = min(swarm_soldiers->integer, SWARM_MAX_ACTORS);
+	struct dbuffer *msg = new_dbuffer();
+	int i, j;
+
+	NET_WriteByte(msg, clc_teaminfo);
+	NET_WriteByte(msg, num);
+
+	for (i = 0; i < num; i++) {
+		character_t chr;
+
+		OBJZERO(chr);
+		Com_GetCharacterValues(swarm_teamdef->string, &chr);
+		CHRSH_CharGenAbilitySkills(&chr, qtrue);
+		/* the unique character numbers must only be unique per team */
+		chr.ucn = (bot - swarmBots) * SWARM_MAX_ACTORS + i;
+
+		/* @sa GAME_NetSendCharacter */
+		NET_WriteByte(msg, chr.fieldSize);
+		NET_WriteShort(msg, chr.ucn);
+		NET_WriteString(msg, chr.name);
+		NET_WriteString(msg, chr.path);
+		NET_WriteString(msg, chr.body);
+		NET_WriteString(msg, chr.head);
+		NET_WriteByte(msg, chr.skin);
+		NET_WriteShort(msg, chr.HP);
+		NET_WriteShort(msg, chr.maxHP);
+		NET_WriteByte(msg, chr.teamDef->idx);
+		NET_WriteByte(msg, chr.gender);
+		NET_WriteByte(msg, chr.STUN);
+		NET_WriteByte(msg, chr.morale);
+		for (j = 0; j < SKILL_NUM_TYPES + 1; j++)
+			NET_WriteLong(msg, chr.score.experience[j]);
+		for (j = 0; j < SKILL_NUM_TYPES; j++)
+			NET_WriteByte(msg, chr.score.skills[j]);
+		for (j = 0; j < SKILL_NUM_TYPES + 1; j++)
+			NET_WriteByte(msg, chr.score.initialSkills[j]);
+		for (j = 0; j < KILLED_NUM_TYPES; j++)
+			NET_WriteShort(msg, chr.score.kills[j]);
+		for (j = 0; j < KILLED_NUM_TYPES; j++)
+			NET_WriteShort(msg, chr.score.stuns[j]);
+		NET_WriteShort(msg, chr.score.assignedMissions);
+
+		/* a loaded weapon in the right hand - @sa GAME_NetSendItem */
+		if (weapon) {
+			NET_WriteShort(msg, 1);
+			NET_WriteFormat(msg, "sbsbbbbs", weapon->idx, weapon->ammo, weapon->ammos[0]->idx, csi.idRight, 0, 0, 0, 1);
+		} else {
+			NET_WriteShort(msg, 0);
+		}
+	}
+
+	NET_WriteMsg(bot->stream, msg);
+}
+
+/**
+ * @brief Sends the next random action if it is the turn of the bot
+ */
+static void SWARM_Think (swarmBot_t *bot, int now)
+{
+	swarmActor_t *actor;
+	struct dbuffer *msg;
+
+	if (bot->state != SWARM_PLAYING || bot->team != bot->activeTeam)
+		return;
+
+	if (bot->actionSent) {
+		if (now - bot->actionSent < SWARM_ACTION_TIMEOUT)
+			return;
+		swarmStats.lostActions++;
+		bot->actionSent = 0;
+	}
+
+	if (now < bot->nextAction)
+		return;
+	bot->nextAction = now + 1000 / max(swarm_actionrate->integer, 1);
+
+	msg = new_dbuffer();
+	if (bot->actionsThisRound >= swarm_actions->integer || !bot->numActors) {
+		/* end the round - the other teams get their turn */
+		NET_WriteByte(msg, clc_endround);
+		NET_WriteMsg(bot->stream, msg);
+		bot->actionsThisRound = 0;
+		bot->activeTeam = TEAM_NO_ACTIVE;
+		swarmStats.endRounds++;
+		return;
+	}
+
+	actor = &bot->actors[SWARM_Rand(bot, bot->numActors)];
+	if (bot->numEnemies && SWARM_Rand(bot, 100) < swarm_shootchance->value * 100) {
+		const swarmActor_t *target = &bot->enemies[SWARM_Rand(bot, bot->numEnemies)];
+		NET_WriteFormat(msg, "bbs", clc_action, PA_SHOOT, actor->entnum);
+		NET_WriteFormat(msg, pa_format[PA_SHOOT], target->pos, ST_RIGHT, 0, 0);
+		swarmStats.shots++;
+	} else {
+		pos3_t to;
+		to[0] = max(0, min(PATHFINDING_WIDTH - 1, actor->pos[0] + SWARM_Rand(bot, 9) - 4));
+		to[1] = max(0, min(PATHFINDING_WIDTH - 1, actor->pos[1] + SWARM_Rand(bot, 9) - 4));
+		to[2] = actor->pos[2];
+		NET_WriteFormat(msg, "bbs", clc_action, PA_MOVE, actor->entnum);
+		NET_WriteFormat(msg, pa_format[PA_MOVE], to);
+		swarmStats.moves++;
+	}
+	NET_WriteMsg(bot->stream, msg);
+
+	bot->actionsThisRound++;
+	bot->actionSent = now;
+	bot->actionStart = Sys_Nanoseconds();
+}
+
+static swarmActor_t *SWARM_FindActor (swarmActor_t *list, int num, int entnum)
+{
+	int i;
+
+	for (i = 0; i < num; i++)
+		if (list[i].entnum == entnum)
+			return &list[i];
+
+	return NULL;
+}
+
+static void SWARM_RemoveActor (swarmActor_t *list, int *num, int entnum)
+{
+	swarmActor_t *actor = SWARM_FindActor(list, *num, entnum);
+
+	if (actor)
+		*actor = list[--(*num)];
+}
+
+static void SWARM_ActorSeen (swarmBot_t *bot, int entnum, int team, int playerNum, const pos3_t pos)
+{
+	swarmActor_t *actor;
+
+	if (team == bot->team && playerNum == bot->playerNum) {
+		actor = SWARM_FindActor(bot->actors, bot->numActors, entnum);
+		if (!actor && bot->numActors < SWARM_MAX_ACTORS)
+			actor = &bot->actors[bot->numActors++];
+	} else if (team != bot->team && team != TEAM_CIVILIAN) {
+		actor = SWARM_FindActor(bot->enemies, bot->numEnemies, entnum);
+		if (!actor && bot->numEnemies < SWARM_MAX_ENEMIES)
+			actor = &bot->enemies[bot->numEnemies++];
+	} else {
+		return;
+	}
+
+	if (actor) {
+		actor->entnum = entnum;
+		VectorCopy(pos, actor->pos);
+	}
+}
+
+/**
+ * @brief Reads the parts of the events the bots need to know where their actors and the enemies are
+ * @note Every event is sent in its own message - so the rest of the event can be ignored
+ * @sa CL_ParseEvent
+ */
+static void SWARM_ParseEvent (swarmBot_t *bot, struct dbuffer *msg)
+{
+	const int eType = NET_ReadByte(msg) & ~EVENT_INSTANTLY;
+	int entnum, team, playerNum;
+	pos3_t pos;
+
+	/* the first event after an action is the answer of the server */
+	if (bot->actionSent) {
+		SWARM_AddSample(&swarmStats.latency, (Sys_Nanoseconds() - bot->actionStart) / 1000);
+		bot->actionSent = 0;
+	}
+
+	switch (eType) {
+	case EV_RESET:
+		bot->team = NET_ReadByte(msg);
+		bot->activeTeam = NET_ReadByte(msg);
+		break;
+	case EV_ENDROUND:
+		bot->activeTeam = NET_ReadByte(msg);
+		bot->actionsThisRound = 0;
+		break;
+	case EV_ACTOR_APPEAR:
+		entnum = NET_ReadShort(msg);
+		NET_ReadShort(msg);
+		team = NET_ReadByte(msg);
+		NET_ReadByte(msg);
+		NET_ReadByte(msg);
+		NET_ReadShort(msg);
+		playerNum = NET_ReadByte(msg);
+		NET_ReadGPos(msg, pos);
+		SWARM_ActorSeen(bot, entnum, team, playerNum, pos);
+		break;
+	case EV_ACTOR_ADD:
+		entnum = NET_ReadShort(msg);
+		team = NET_ReadByte(msg);
+		NET_ReadByte(msg);
+		NET_ReadByte(msg);
+		playerNum = NET_ReadByte(msg);
+		NET_ReadGPos(msg, pos);
+		SWARM_ActorSeen(bot, entnum, team, playerNum, pos);
+		break;
+	case EV_ACTOR_MOVE: {
+		swarmActor_t *actor;
+		entnum = NET_ReadShort(msg);
+		NET_ReadByte(msg);
+		NET_ReadGPos(msg, pos);
+		actor = SWARM_FindActor(bot->actors, bot->numActors, entnum);
+		if (!actor)
+			actor = SWARM_FindActor(bot->enemies, bot->numEnemies, entnum);
+		if (actor)
+			VectorCopy(pos, actor->pos);
+		break;
+	}
+	case EV_ACTOR_DIE:
+		entnum = NET_ReadShort(msg);
+		SWARM_RemoveActor(bot->actors, &bot->numActors, entnum);
+		SWARM_RemoveActor(bot->enemies, &bot->numEnemies, entnum);
+		break;
+	case EV_ENT_PERISH:
+		entnum = NET_ReadShort(msg);
+		SWARM_RemoveActor(bot->enemies, &bot->numEnemies, entnum);
+		break;
+	default:
+		break;
+	}
+}
+
+static void SWARM_Disconnect (swarmBot_t *bot)
+{
+	if (bot->state == SWARM_FREE)
+		return;
+
+	NET_StreamFinished(bot->stream);
+	OBJZERO(*bot);
+}
+
+/**
+ * @brief The commands the server stuffs into the console of the client
+ * @sa SV_ClientCommand
+ */
+static void SWARM_ParseStuffText (swarmBot_t *bot, struct dbuffer *msg)
+{
+	char text[1024];
+	const char *s;
+
+	NET_ReadString(msg, text, sizeof(text));
+	s = text;
+
+	for (;;) {
+		const char *token = Com_Parse(&s);
+		if (!s)
+			break;
+
+		if (Q_streq(token, "precache")) {
+			/* we don't load any media @sa CL_RequestNextDownload */
+			SWARM_StringCmd(bot, "begin\n");
+		} else if (Q_streq(token, "spawnsoldiers")) {
+			SWARM_SendTeamInfo(bot);
+			bot->state = SWARM_SPAWNED;
+		} else if (Q_streq(token, "startmatch")) {
+			SWARM_StringCmd(bot, "startmatch\n");
+			bot->state = SWARM_PLAYING;
+		}
+	}
+}
+
+/**
+ * @sa CL_ReadPackets
+ * @sa CL_ConnectionlessPacket
+ * @sa CL_ParseServerMessage
+ */
+static void SWARM_ReadPackets (swarmBot_t *bot)
+{
+	struct dbuffer *msg;
+
+	while (bot->state != SWARM_FREE && (msg = NET_ReadMsg(bot->stream))) {
+		const int cmd = NET_ReadByte(msg);
+		char s[1024];
+
+		switch (cmd) {
+		case clc_oob:
+			NET_ReadStringLine(msg, s, sizeof(s));
+			if (bot->state == SWARM_CONNECTING && Q_strstart(s, "client_connect")) {
+				SWARM_StringCmd(bot, "new\n");
+				bot->state = SWARM_CONNECTED;
+			} else if (Q_strstart(s, "print")) {
+				NET_ReadString(msg, s, sizeof(s));
+				Com_Printf("swarm bot %i: %s", (int)(bot - swarmBots), s);
+			}
+			break;
+		case svc_ping: {
+			struct dbuffer *ack = new_dbuffer();
+			NET_WriteByte(ack, clc_ack);
+			NET_WriteMsg(bot->stream, ack);
+			break;
+		}
+		case svc_serverdata:
+			NET_ReadLong(msg);
+			bot->playerNum = NET_ReadShort(msg);
+			break;
+		case svc_stufftext:
+			SWARM_ParseStuffText(bot, msg);
+			break;
+		case svc_event:
+			SWARM_ParseEvent(bot, msg);
+			break;
+		case svc_disconnect:
+		case svc_reconnect:
+			NET_ReadString(msg, s, sizeof(s));
+			Com_Printf("swarm bot %i was disconnected: %s\n", (int)(bot - swarmBots), s);
+			free_dbuffer(msg);
+			SWARM_Disconnect(bot);
+			swarmNumBots--;
+			return;
+		default:
+			break;
+		}
+		free_dbuffer(msg);
+	}
+}
+
+static void SWARM_Frame (int now, void *data)
+{
+	int i;
+
+	if (!swarmNumBots) {
+		swarmScheduled = qfalse;
+		return;
+	}
+
+	/* sample every server frame - needs swarm_freq to be higher than sv_freq */
+	if (svs.initialized && svs.realtime != swarmStats.lastServerFrame) {
+		const int budget = 1000000 / max(Cvar_GetInteger("sv_freq"), 1);
+		swarmStats.lastServerFrame = svs.realtime;
+		SWARM_AddSample(&swarmStats.frames, svs.frameTime);
+		if (svs.frameTime > budget)
+			swarmStats.framesOverBudget++;
+	}
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		swarmBot_t *bot = &swarmBots[i];
+		if (bot->state == SWARM_FREE)
+			continue;
+		SWARM_ReadPackets(bot);
+		SWARM_Think(bot, now);
+	}
+
+	Schedule_Event(now + 1000 / max(swarm_freq->integer, 1), &SWARM_Frame, NULL, NULL, NULL);
+}
+
+static void SWARM_Report_f (void)
+{
+	const double seconds = (Sys_Nanoseconds() - swarmStats.startTime) / 1000000000.0;
+	int states[SWARM_PLAYING + 1];
+	int i;
+
+	OBJZERO(states);
+	for (i = 0; i < MAX_CLIENTS; i++)
+		states[swarmBots[i].state]++;
+
+	Com_Printf("swarm of %i bots after %.1fs: %i connecting, %i connected, %i spawned, %i playing\n", swarmNumBots, seconds,
+			states[SWARM_CONNECTING], states[SWARM_CONNECTED], states[SWARM_SPAWNED], states[SWARM_PLAYING]);
+	Com_Printf("actions: %i moves, %i shots, %i round ends, %i without answer\n", swarmStats.moves, swarmStats.shots,
+			swarmStats.endRounds, swarmStats.lostActions);
+	SWARM_PrintHistogram("action round trip", &swarmStats.latency);
+	SWARM_PrintHistogram("server frames", &swarmStats.frames);
+	Com_Printf("  %i frames over the budget of %.1fms\n", swarmStats.framesOverBudget, 1000.0f / max(Cvar_GetInteger("sv_freq"), 1));
+}
+
+/**
+ * @brief Connects the bots to the server of this process
+ * @sa CL_Connect
+ */
+static void SWARM_Start_f (void)
+{
+	char userinfo[MAX_INFO_STRING];
+	int count, i;
+
+	if (Cmd_Argc() != 2) {
+		Com_Printf("Usage: %s <bots>\n", Cmd_Argv(0));
+		return;
+	}
+
+	if (!svs.initialized) {
+		Com_Printf("Start a map first\n");
+		return;
+	}
+
+	count = atoi(Cmd_Argv(1));
+	if (swarmNumBots + count > sv_maxclients->integer)
+		Com_Printf("Only %i clients are allowed on the server (sv_maxclients)\n", sv_maxclients->integer);
+
+	if (!swarmNumBots) {
+		OBJZERO(swarmStats);
+		swarmStats.startTime = Sys_Nanoseconds();
+	}
+	if (!swarmScheduled) {
+		Schedule_Event(Sys_Milliseconds(), &SWARM_Frame, NULL, NULL, NULL);
+		swarmScheduled = qtrue;
+	}
+
+	for (i = 0; i < MAX_CLIENTS && count > 0; i++) {
+		swarmBot_t *bot = &swarmBots[i];
+		if (bot->state != SWARM_FREE)
+			continue;
+
+		bot->stream = NET_ConnectToLoopBack(NULL);
+		if (!bot->stream)
+			break;
+
+		bot->state = SWARM_CONNECTING;
+		bot->seed = swarm_seed->integer + i;
+		bot->team = TEAM_NO_ACTIVE;
+		bot->activeTeam = TEAM_NO_ACTIVE;
+
+		userinfo[0] = '\0';
+		Info_SetValueForKey(userinfo, sizeof(userinfo), "cl_name", va("swarm%i", i));
+		Info_SetValueForKeyAsInteger(userinfo, sizeof(userinfo), "cl_teamnum", i % max(swarm_teams->integer, 1) + 1);
+		Info_SetValueForKeyAsInteger(userinfo, sizeof(userinfo), "cl_ready", 1);
+		NET_OOB_Printf(bot->stream, "connect %i \"%s\"\n", PROTOCOL_VERSION, userinfo);
+
+		swarmNumBots++;
+		count--;
+	}
+
+	if (count > 0)
+		Com_Printf("Could not connect %i of the bots\n", count);
+}
+
+static void SWARM_Stop_f (void)
+{
+	int i;
+
+	if (!swarmNumBots) {
+		Com_Printf("No swarm is running\n");
+		return;
+	}
+
+	SWARM_Report_f();
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		swarmBot_t *bot = &swarmBots[i];
+		if (bot->state == SWARM_FREE)
+			continue;
+		SWARM_StringCmd(bot, "disconnect\n");
+		SWARM_Disconnect(bot);
+	}
+	swarmNumBots = 0;
+}
+
+/*
+ * The client interface of the engine - @sa sv_clientstub.c
+ */
+
+void CL_Init (void)
+{
+	swarm_freq = Cvar_Get("swarm_freq", "40", 0, "Frames per second of the swarm - must be higher than sv_freq");
+	swarm_actionrate = Cvar_Get("swarm_actionrate", "2", 0, "Actions per second of every bot");
+	swarm_actions = Cvar_Get("swarm_actions", "8", 0, "Actions of every bot before it ends its round");
+	swarm_shootchance = Cvar_Get("swarm_shootchance", "0.3", 0, "Chance that a bot shoots at a visible enemy instead of moving");
+	swarm_soldiers = Cvar_Get("swarm_soldiers", "4", 0, "Soldiers every bot spawns");
+	swarm_teams = Cvar_Get("swarm_teams", "2", 0, "Number of teams the bots are distributed to");
+	swarm_teamdef = Cvar_Get("swarm_teamdef", "phalanx", 0, "Team definition of the soldiers of the bots");
+	swarm_seed = Cvar_Get("swarm_seed", "0", 0, "Seed for the random actions of the bots");
+
+	Cmd_AddCommand("swarm_start", SWARM_Start_f, "Connects bots to the server - usage: swarm_start <bots>");
+	Cmd_AddCommand("swarm_stop", SWARM_Stop_f, "Disconnects all bots and prints the statistics");
+	Cmd_AddCommand("swarm_report", SWARM_Report_f, "Prints the latency and server frame statistics of the swarm");
+}
+
+void CL_InitAfter (void)
+{
+}
+
+void CL_Drop (void)
+{
+}
+
+void Con_Print (const char *txt)
+{
+}
+
+void CL_Shutdown (void)
+{
+}
+
+void CL_Frame (int now, void *data)
+{
+}
+
+void CL_SlowFrame (int now, void *data)
+{
+}
+
+qboolean CL_ParseClientData (const char *type, const char *name, const char **text)
+{
+	return qtrue;
+}
+
+void Cmd_ForwardToServer (void)
+{
+	const char *cmd;
+
+	cmd = Cmd_Argv(0);
+	Com_Printf("Unknown command \"%s\"\n", cmd);
+}
+
+void SCR_BeginLoadingPlaque (void)
+{
+}
+
+void SCR_EndLoadingPlaque (void)
+{
+}
+
+int CL_Milliseconds (void)
+{
+	return Sys_Milliseconds();
+}
+
+void Key_Init (void)
+{
+	Cmd_AddCommand("bind", Cmd_Dummy_f, NULL);
+}